@@ -19,8 +19,11 @@
 #ifndef SUSTAINMLCPP_CORE_CALLABLE_HPP
 #define SUSTAINMLCPP_CORE_CALLABLE_HPP
 
+#include <atomic>
 #include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <tuple>
 
@@ -55,6 +58,83 @@ struct gen_seq<0, Ts...> : index<Ts...> {};
 
 } // namespace helper
 
+/**
+ * @brief Handle through which the user reports that the output of a task
+ * is ready, passed to Callable::on_new_task_available_async.
+ *
+ * Copies of a handle refer to the same task. The first call to complete()
+ * publishes the output of the task and releases its input samples, further
+ * calls have no effect. It can be called from any thread, as long as the node
+ * has not been destroyed.
+ *
+ * If every copy is destroyed without completing the task, the task is
+ * completed reporting an error.
+ */
+class CompletionHandle
+{
+public:
+
+    CompletionHandle() = default;
+
+#ifndef SWIG_WRAPPER
+    /**
+     * @brief Constructor
+     *
+     * @param on_complete Function run once on completion. Its argument tells
+     * whether the task was abandoned rather than completed.
+     */
+    explicit CompletionHandle(
+            std::function<void(bool)> on_complete)
+        : state_(std::make_shared<State>(std::move(on_complete)))
+    {
+    }
+
+#endif // SWIG_WRAPPER
+
+    /**
+     * @brief Completes the task, publishing its output.
+     */
+    void complete()
+    {
+        if (state_ && !state_->completed.exchange(true))
+        {
+            state_->on_complete(false);
+        }
+    }
+
+    /**
+     * @brief Returns whether the task has already been completed.
+     */
+    bool is_completed() const
+    {
+        return !state_ || state_->completed.load();
+    }
+
+private:
+
+    struct State
+    {
+        explicit State(
+                std::function<void(bool)> fn)
+            : on_complete(std::move(fn))
+        {
+        }
+
+        ~State()
+        {
+            if (!completed.load() && on_complete)
+            {
+                on_complete(true);
+            }
+        }
+
+        std::atomic<bool> completed{false};
+        std::function<void(bool)> on_complete;
+    };
+
+    std::shared_ptr<State> state_;
+};
+
 /**
  * @brief This class is used for registering an input callback
  * with a variable number of arguments and generic types.
@@ -82,12 +162,32 @@ public:
     virtual void on_new_task_available(
             _TYPES& ... fn) = 0;
 
+    /**
+     * @brief Asynchronous user callback
+     *
+     * The output may be filled after returning, from any thread, calling
+     * completion.complete() once it is ready. The arguments remain valid
+     * until then. By default it invokes the synchronous callback and
+     * completes the task right away.
+     */
+    virtual void on_new_task_available_async(
+            _TYPES& ... fn,
+            CompletionHandle completion)
+    {
+        on_new_task_available(fn ...);
+        completion.complete();
+    }
+
     /**
      * @brief Invokes the user callback with the arguments stored in user_cb_args_
+     *
+     * @param task_id Task identifier
+     * @param completion Handle that completes the task
      */
     template <std::size_t... Is>
     void invoke_user_cb(
             types::TaskId task_id,
+            CompletionHandle completion,
             helper::index<Is...>)
     {
         tuple* args;
@@ -95,7 +195,7 @@ public:
             std::lock_guard<std::mutex> lock (mtx_);
             args = &user_cb_args_[task_id];
         }
-        on_new_task_available(*std::get<Is>(*args)...);
+        on_new_task_available_async(*std::get<Is>(*args)..., std::move(completion));
     }
 
     /**
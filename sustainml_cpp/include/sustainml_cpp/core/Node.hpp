@@ -21,8 +21,11 @@
 #define SUSTAINMLCPP_CORE_NODE_HPP
 
 #include <sustainml_cpp/config/Macros.hpp>
+#include <sustainml_cpp/core/Callable.hpp>
 #include <sustainml_cpp/types/types.hpp>
 
+#include <chrono>
+#include <functional>
 #include <utility>
 #include <vector>
 #include <memory>
@@ -108,6 +111,14 @@ public:
      */
     SUSTAINML_CPP_DLL_API const Status& status();
 
+    /**
+     * @brief Retrieves the status of a task run by this node.
+     * Only the last finished tasks are remembered, TASK_WAITING is returned
+     * for unknown ones.
+     */
+    SUSTAINML_CPP_DLL_API TaskStatus task_status(
+            const types::TaskId& task_id);
+
 protected:
 
     /**
@@ -143,11 +154,24 @@ protected:
      *
      * @param inputs A vector containing the required samples. All the samples
      * must correspond to the same task_id.
+     * @return false if the task could not be handed to the user. Otherwise
+     * the task remains in flight until its CompletionHandle is completed.
      */
-    virtual void publish_to_user(
+    virtual bool publish_to_user(
             const types::TaskId& task_id,
             const std::vector<std::pair<int, void*>> inputs) = 0;
 
+    /**
+     * @brief Creates the handle with which the user completes a task.
+     * Completing it runs on_complete and then frees the slot of the task
+     * in the Dispatcher.
+     *
+     * @param on_complete Publishes the output of the task. Its argument tells
+     * whether the task was abandoned rather than completed.
+     */
+    CompletionHandle make_completion_handle(
+            std::function<void(bool)> on_complete);
+
     /**
      * @brief Publishes the internal status of the node to DDS.
      */
@@ -159,11 +183,43 @@ protected:
     void status(
             const Status& status);
 
+    /**
+     * @brief Records that a task has started running.
+     * The node status is only published if no other task is running.
+     */
+    void task_started(
+            const types::TaskId& task_id);
+
+    /**
+     * @brief Records that a task has finished.
+     * The node status is only published if no other task is running.
+     *
+     * @param task_id Task identifier
+     * @param error Whether the task failed
+     */
+    void task_finished(
+            const types::TaskId& task_id,
+            bool error);
+
     /**
      * @brief Retrieves the inner writers
      */
     const std::vector<eprosima::fastdds::dds::DataWriter*>& writers();
 
+    /**
+     * @brief Current time to time the write of an output with.
+     * The clock is only read if metrics are enabled, see Options::metrics_period.
+     */
+    std::chrono::steady_clock::time_point output_write_start();
+
+    /**
+     * @brief Records the latency of the write of an output.
+     *
+     * @param start Time returned by output_write_start before writing it
+     */
+    void record_output_write(
+            const std::chrono::steady_clock::time_point& start);
+
 private:
 
     /**
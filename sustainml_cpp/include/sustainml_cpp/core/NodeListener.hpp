@@ -21,9 +21,17 @@
 #define SUSTAINMLCPP_CORE_NODELISTENER_HPP
 
 #include <sustainml_cpp/core/Node.hpp>
+#include <sustainml_cpp/interfaces/IntraProcessReader.hpp>
 #include <sustainml_cpp/interfaces/QueueQueryable.hpp>
 
+#include <fastdds/dds/core/LoanableSequence.hpp>
 #include <fastdds/dds/subscriber/DataReaderListener.hpp>
+#include <fastdds/dds/subscriber/SampleInfo.hpp>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
 
 namespace sustainml {
 namespace core {
@@ -33,28 +41,48 @@ namespace core {
     /**
     * @brief Aggregates a sample queue in which to place new incoming
     * samples and notifies the Dispatcher.
-    * Implements the DataReaderListener callbacks.
+    * Implements the DataReaderListener callbacks, and receives the samples
+    * of the nodes of the same process through the IntraProcessBus.
     */
     template <typename T>
-    class NodeListener : public eprosima::fastdds::dds::DataReaderListener
+    class NodeListener : public eprosima::fastdds::dds::DataReaderListener,
+                         public interfaces::IntraProcessReader
     {
 
     public:
 
         NodeListener(
             Node* node,
-            interfaces::QueueQueryable<T>* qq);
+            interfaces::QueueQueryable<T>* qq,
+            const Options& opts = Options());
 
         virtual ~NodeListener();
 
         /**
-        * @brief Stops the listener.
+        * @brief Stops the listener. No intra-process sample is received once it returns.
         *
         */
         void stop();
 
+        /**
+        * @brief Resumes taking samples from a DataReader whose samples were
+        * left in its history because the queue pool was exhausted, and
+        * inserting the intra-process samples kept for the same reason.
+        * Does nothing if the listener is not stalled.
+        */
+        void resume();
+
+        /**
+        * @brief Posts resume() to the listener thread of the node, if the listener
+        * is stalled. Called whenever a cache is released, which may happen in
+        * the user's thread.
+        */
+        void request_resume();
+
         /**
         * @brief Callback executed when a new sample is available on the DataReader.
+        * Samples are taken in batches of up to Options::listener_batch_size, inserted
+        * in the queue at once and notified to the Dispatcher together.
         *
         * @param reader The DataReader having new available samples.
         */
@@ -71,11 +99,94 @@ namespace core {
             eprosima::fastdds::dds::DataReader* reader,
             const eprosima::fastdds::dds::SubscriptionMatchedStatus & status);
 
+        /**
+        * @brief Callback executed when a node of the same process publishes a sample.
+        * It is copied into a cache of the queue, or kept until one is released
+        * if the pool is exhausted.
+        *
+        * @param sample Shared pointer to the impl type of T.
+        */
+        void on_intra_process_sample(
+            const std::shared_ptr<const void>& sample) override;
+
     private:
 
+        using impl_ptr = std::shared_ptr<const typename T::impl_type>;
+
+        //! Shared with the posted resume jobs, which skip the listener once it is stopped
+        struct ResumeTarget
+        {
+            std::mutex mtx;
+            NodeListener* listener;
+        };
+
+        /**
+        * @brief Inserts an intra-process sample in the queue and notifies the Dispatcher.
+        *
+        * @return false if there was no cache for it.
+        */
+        bool insert_intra_process_sample(
+            SamplesQueue<T>* queue,
+            const impl_ptr& sample);
+
+        /**
+        * @brief Inserts the pending intra-process samples while there are caches.
+        */
+        void insert_pending_samples();
+
+        /**
+        * @brief Keeps an intra-process sample until a cache is released. Beyond the
+        * history depth of the reader the oldest pending sample is discarded, as the
+        * DataReader would.
+        */
+        void push_pending_sample_nts(
+            const impl_ptr& sample);
+
+        /**
+        * @brief Number of samples the history of the readers holds, at least 1.
+        */
+        static std::size_t history_depth(
+            const Options& opts);
+
+        /**
+        * @brief Gets a new cache from the queue. If the pool is exhausted, the
+        * reader is recorded so that resume() takes the pending samples later on.
+        *
+        * @param reader The DataReader whose samples are being taken.
+        * @param queue The queue providing the caches.
+        * @return Pointer to the cache. nullptr if the listener has stalled.
+        */
+        T* get_new_cache_or_stall(
+            eprosima::fastdds::dds::DataReader* reader,
+            SamplesQueue<T>* queue);
+
         Node* node_;
         interfaces::QueueQueryable<T>* queue_queryable_;
+        const std::size_t batch_size_;
+        //! Whether received samples may reference payloads in shared memory, see Options::shared_payloads
+        const bool shared_payloads_;
+        //! Owned buffers the samples are taken into, reused by every on_data_available
+        eprosima::fastdds::dds::LoanableSequence<typename T::impl_type> data_;
+        eprosima::fastdds::dds::SampleInfoSeq infos_;
+        //! Guards data_ and infos_, as the listener thread may resume while a DDS callback runs
+        std::mutex take_mtx_;
         std::atomic<bool> stop_;
+        //! DataReader with samples pending to be taken, nullptr if not stalled
+        std::atomic<eprosima::fastdds::dds::DataReader*> stalled_reader_;
+        //! Intra-process samples waiting for a cache, oldest first
+        std::deque<impl_ptr> pending_samples_;
+        //! Maximum number of pending samples, the history depth of the reader
+        const std::size_t max_pending_samples_;
+        std::mutex pending_mtx_;
+        //! Whether a thread is inserting the pending samples
+        std::atomic<bool> inserting_pending_;
+        //! Whether a cache was released while the pending samples were being inserted
+        std::atomic<bool> pending_resumed_;
+        //! Whether pending_samples_ holds any sample
+        std::atomic<bool> has_pending_;
+        std::shared_ptr<ResumeTarget> resume_target_;
+        //! Whether a resume job is posted and has not started yet
+        std::atomic<bool> resume_posted_;
 
     };
 
@@ -19,6 +19,8 @@
 #ifndef SUSTAINMLCPP_CORE_REQUESTREPLYLISTENER_HPP
 #define SUSTAINMLCPP_CORE_REQUESTREPLYLISTENER_HPP
 
+#include <mutex>
+
 #include <sustainml_cpp/types/types.hpp>
 
 namespace sustainml {
@@ -37,8 +39,14 @@ public:
 
     /**
      * @brief Constructor
+     *
+     * @param concurrent Whether on_configuration_request may be called for several requests
+     * at the same time, from the RPC server threads of the node. Otherwise requests are handed
+     * over one at a time.
      */
-    RequestReplyListener()
+    RequestReplyListener(
+            bool concurrent = false)
+        : concurrent_(concurrent)
     {
     }
 
@@ -61,6 +69,33 @@ public:
     {
     }
 
+    /**
+     * @brief Hands a configuration request over to on_configuration_request, serializing
+     * it with the other requests unless the listener is concurrent.
+     *
+     * @param req The request message
+     * @param res The response message to send
+     */
+    void dispatch_configuration_request(
+            types::RequestType& req,
+            types::ResponseType& res)
+    {
+        if (concurrent_)
+        {
+            on_configuration_request(req, res);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(dispatch_mtx_);
+        on_configuration_request(req, res);
+    }
+
+private:
+
+    const bool concurrent_;
+
+    std::mutex dispatch_mtx_;
+
 };
 
 } // namespace core
@@ -23,15 +23,17 @@
 #include <sustainml_cpp/core/Node.hpp>
 #include <sustainml_cpp/interfaces/SampleQueryable.hpp>
 
-#include <map>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <core/Options.hpp>
 
 namespace sustainml {
 namespace utils {
-template<class T> class SamplePool;
+template<class T> class LockFreeSamplePool;
+template<class V> class TaskIndex;
+struct SamplePoolStats;
 } // namespace utils
 namespace core {
 
@@ -39,7 +41,7 @@ class Node;
 
 /**
  * @brief Queue implementation for storing samples.
- * Samplesa are stored in a map indexed by the task_id.
+ * Samples are stored in a hash index keyed by the task_id.
  */
 template <typename T>
 class SamplesQueue : public interfaces::SampleQueryable
@@ -74,14 +76,30 @@ public:
 
     /**
      * @brief Inserts an element into the queue.
+     * If its task is already in the queue, Options::duplicate_task_policy decides
+     * which of both samples is kept. The discarded one is returned to the pool.
      *
      * Thread safe operation.
      *
-     * @param elem element to insert.
+     * @param elem element to insert. Set to nullptr if it has been discarded.
+     * @return true if the task is new and the Dispatcher must be notified.
      */
-    void insert_element(
+    bool insert_element(
             T*& elem);
 
+    /**
+     * @brief Inserts several elements into the queue under a single lock.
+     * Duplicated tasks are handled as in insert_element.
+     *
+     * Thread safe operation.
+     *
+     * @param elems elements to insert.
+     * @param new_tasks Receives the task ids the Dispatcher must be notified of.
+     */
+    void insert_elements(
+            const std::vector<T*>& elems,
+            std::vector<types::TaskId>& new_tasks);
+
     /**
      * @brief Remove an element from the queue.
      *
@@ -90,7 +108,7 @@ public:
      * @param id Sample key to remove.
      */
     void remove_element_by_taskid(
-            const types::TaskId& id);
+            const types::TaskId& id) override;
 
     /**
      * @brief Retrieves a type-erased pointer of a sample by id.
@@ -115,19 +133,59 @@ public:
      */
     const int& get_id() override;
 
+    /**
+     * @brief Copies the occupancy counters of the underlying pool.
+     *
+     * Thread safe operation.
+     *
+     * @param stats Destination of the counters.
+     */
+    void pool_stats(
+            sustainml::utils::SamplePoolStats& stats) override;
+
+    /**
+     * @brief Retrieves the number of samples in the queue.
+     *
+     * Thread safe operation.
+     */
+    std::size_t size() override;
+
+protected:
+
+    /**
+     * @brief Hook executed every time a cache is returned to the pool.
+     * It is called without holding the queue lock.
+     */
+    virtual void on_cache_released()
+    {
+    }
+
 private:
 
+    /**
+     * @brief Inserts an element applying the duplicate task policy.
+     *
+     * @param elem element to insert.
+     * @param discarded Receives the sample to return to the pool, if any.
+     * @return true if the task is new.
+     */
+    bool insert_element_nts(
+            T* elem,
+            T*& discarded);
+
     Node* node_;
 
     //task_id to <sample, sample_processed>
-    std::map<types::TaskId, std::pair<T*, bool>> queue_;
+    std::unique_ptr<sustainml::utils::TaskIndex<std::pair<T*, bool>>> queue_;
 
-    sustainml::utils::SamplePool<T>* pool_;
+    std::unique_ptr<sustainml::utils::LockFreeSamplePool<T>> pool_;
 
     std::mutex mtx_;
 
     const int queue_id;
 
+    const DuplicateTaskPolicy duplicate_task_policy_;
+
 };
 
 } // namespace core
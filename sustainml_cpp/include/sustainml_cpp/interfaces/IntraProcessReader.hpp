@@ -0,0 +1,46 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file IntraProcessReader.hpp
+ */
+
+#ifndef SUSTAINMLCPP_INTERFACES_INTRAPROCESSREADER_HPP
+#define SUSTAINMLCPP_INTERFACES_INTRAPROCESSREADER_HPP
+
+#include <memory>
+
+namespace sustainml {
+namespace interfaces {
+
+    struct IntraProcessReader
+    {
+        virtual ~IntraProcessReader() = default;
+
+        /**
+        * @brief Called by the thread of a node of the same process publishing
+        * a sample. The sample is shared by all the readers of the topic and
+        * must not be modified.
+        *
+        * @param sample Pointer to the impl type of the topic.
+        */
+        virtual void on_intra_process_sample(
+            const std::shared_ptr<const void>& sample) = 0;
+
+    };
+
+} // namespace interfaces
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_INTERFACES_INTRAPROCESSREADER_HPP
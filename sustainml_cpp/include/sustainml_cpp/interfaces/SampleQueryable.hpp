@@ -19,11 +19,15 @@
 #ifndef SUSTAINMLCPP_INTERFACES_SAMPLEQUERYABLE_HPP
 #define SUSTAINMLCPP_INTERFACES_SAMPLEQUERYABLE_HPP
 
+#include <cstddef>
 #include <vector>
 
 #include <types/types.hpp>
 
 namespace sustainml {
+namespace utils {
+struct SamplePoolStats;
+} // namespace utils
 namespace interfaces {
 
 struct SampleQueryable
@@ -38,6 +42,14 @@ struct SampleQueryable
     virtual void* retrieve_sample_from_taskid(
             const types::TaskId& id) = 0;
 
+    /**
+     * @brief Removes the sample of a task, if any, returning its cache to the pool.
+     *
+     * @param id task_id key of the sample.
+     */
+    virtual void remove_element_by_taskid(
+            const types::TaskId& id) = 0;
+
     /**
      * @brief Retrieves the id of the sample queryable.
      *
@@ -45,6 +57,19 @@ struct SampleQueryable
      */
     virtual const int& get_id() = 0;
 
+    /**
+     * @brief Retrieves the number of samples stored.
+     */
+    virtual std::size_t size() = 0;
+
+    /**
+     * @brief Copies the occupancy counters of the pool of the samples.
+     *
+     * @param stats Destination of the counters.
+     */
+    virtual void pool_stats(
+            utils::SamplePoolStats& stats) = 0;
+
 };
 
 } // namespace interfaces
@@ -56,6 +56,16 @@ struct AppRequirementsTaskListener : public AppRequirementsCallable
     {
     }
 
+    virtual void on_new_task_available_async(
+            types::UserInput& user_input,
+            types::NodeStatus& status,
+            types::AppRequirements& output,
+            core::CompletionHandle completion) override
+    {
+        on_new_task_available(user_input, status, output);
+        completion.complete();
+    }
+
 };
 
 /**
@@ -116,11 +126,25 @@ private:
      *
      * @param inputs A vector containing the required samples. All the samples
      * must correspond to the same task_id.
+     * @return false if the task could not be handed to the user.
      */
-    void publish_to_user(
+    bool publish_to_user(
             const types::TaskId& task_id,
             const std::vector<std::pair<int, void*>> inputs) override;
 
+    /**
+     * @brief Publishes the output of a task and releases its inputs,
+     * once the user has completed it.
+     *
+     * @param task_id Task identifier
+     * @param task_data_cache Status and output of the task
+     * @param abandoned Whether the user dropped the task without completing it
+     */
+    void complete_task(
+            const types::TaskId& task_id,
+            types::NodeTaskOutputData<types::AppRequirements>* task_data_cache,
+            bool abandoned);
+
     AppRequirementsTaskListener& user_listener_;
 
     std::unique_ptr<core::QueuedNodeListener<types::UserInput>> listener_user_input_queue_;
@@ -59,6 +59,18 @@ struct CarbonFootprintTaskListener : public CarbonFootprintCallable
     {
     }
 
+    virtual void on_new_task_available_async(
+            types::MLModel& model,
+            types::UserInput& ui,
+            types::HWResource& hw,
+            types::NodeStatus& status,
+            types::CO2Footprint& output,
+            core::CompletionHandle completion) override
+    {
+        on_new_task_available(model, ui, hw, status, output);
+        completion.complete();
+    }
+
 };
 
 /**
@@ -122,11 +134,25 @@ private:
      *
      * @param inputs A vector containing the required samples. All the samples
      * must correspond to the same task_id.
+     * @return false if the task could not be handed to the user.
      */
-    void publish_to_user(
+    bool publish_to_user(
             const types::TaskId& task_id,
             const std::vector<std::pair<int, void*>> inputs) override;
 
+    /**
+     * @brief Publishes the output of a task and releases its inputs,
+     * once the user has completed it.
+     *
+     * @param task_id Task identifier
+     * @param task_data_cache Status and output of the task
+     * @param abandoned Whether the user dropped the task without completing it
+     */
+    void complete_task(
+            const types::TaskId& task_id,
+            types::NodeTaskOutputData<types::CO2Footprint>* task_data_cache,
+            bool abandoned);
+
     CarbonFootprintTaskListener& user_listener_;
 
     std::unique_ptr<core::QueuedNodeListener<types::MLModel>> listener_ml_model_queue_;
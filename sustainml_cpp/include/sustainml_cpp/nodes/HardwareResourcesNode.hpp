@@ -58,6 +58,18 @@ struct HardwareResourcesTaskListener : public HardwareResourcesCallable
     {
     }
 
+    virtual void on_new_task_available_async(
+            types::MLModel& model,
+            types::AppRequirements& requirements,
+            types::HWConstraints& constraints,
+            types::NodeStatus& status,
+            types::HWResource& output,
+            core::CompletionHandle completion) override
+    {
+        on_new_task_available(model, requirements, constraints, status, output);
+        completion.complete();
+    }
+
 };
 
 /**
@@ -120,11 +132,25 @@ private:
      *
      * @param inputs A vector containing the required samples. All the samples
      * must correspond to the same task_id.
+     * @return false if the task could not be handed to the user.
      */
-    void publish_to_user(
+    bool publish_to_user(
             const types::TaskId& task_id,
             const std::vector<std::pair<int, void*>> inputs) override;
 
+    /**
+     * @brief Publishes the output of a task and releases its inputs,
+     * once the user has completed it.
+     *
+     * @param task_id Task identifier
+     * @param task_data_cache Status and output of the task
+     * @param abandoned Whether the user dropped the task without completing it
+     */
+    void complete_task(
+            const types::TaskId& task_id,
+            types::NodeTaskOutputData<types::HWResource>* task_data_cache,
+            bool abandoned);
+
     HardwareResourcesTaskListener& user_listener_;
 
     std::unique_ptr<core::QueuedNodeListener<types::MLModel>> listener_ml_model_queue_;
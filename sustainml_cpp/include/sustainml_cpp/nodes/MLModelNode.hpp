@@ -34,6 +34,7 @@ template<class T> class QueuedNodeListener;
 
 namespace utils {
 template<class T> class SamplePool;
+class SharedPayloadStore;
 } // namespace utils
 
 namespace ml_model_module {
@@ -62,6 +63,22 @@ struct MLModelTaskListener : public MLModelCallable
     {
     }
 
+    virtual void on_new_task_available_async(
+            types::MLModelMetadata& model_metadata,
+            types::AppRequirements& requirements,
+            types::HWConstraints& constraints,
+            types::MLModel& ml_model_baseline,
+            types::HWResource& hw_baseline,
+            types::CO2Footprint& carbonf_baseline,
+            types::NodeStatus& status,
+            types::MLModel& output,
+            core::CompletionHandle completion) override
+    {
+        on_new_task_available(model_metadata, requirements, constraints, ml_model_baseline, hw_baseline,
+                carbonf_baseline, status, output);
+        completion.complete();
+    }
+
 };
 
 /**
@@ -126,11 +143,25 @@ private:
      *
      * @param inputs A vector containing the required samples. All the samples
      * must correspond to the same task_id.
+     * @return false if the task could not be handed to the user.
      */
-    void publish_to_user(
+    bool publish_to_user(
             const types::TaskId& task_id,
             const std::vector<std::pair<int, void*>> inputs) override;
 
+    /**
+     * @brief Publishes the output of a task and releases its inputs,
+     * once the user has completed it.
+     *
+     * @param task_id Task identifier
+     * @param task_data_cache Status and output of the task
+     * @param abandoned Whether the user dropped the task without completing it
+     */
+    void complete_task(
+            const types::TaskId& task_id,
+            types::NodeTaskOutputData<types::MLModel>* task_data_cache,
+            bool abandoned);
+
     MLModelTaskListener& user_listener_;
 
     std::unique_ptr<core::QueuedNodeListener<types::MLModelMetadata>> listener_model_metadata_queue_;
@@ -146,6 +177,9 @@ private:
 
     std::unique_ptr<utils::SamplePool<types::NodeTaskOutputData<types::MLModel>>> task_data_pool_;
 
+    //! Only set if Options::shared_payloads is enabled
+    std::unique_ptr<utils::SharedPayloadStore> shared_payload_store_;
+
 };
 
 } // namespace ml_model_module
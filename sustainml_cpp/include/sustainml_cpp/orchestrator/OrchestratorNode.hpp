@@ -20,8 +20,13 @@
 #define SUSTAINMLCPP_ORCHESTRATOR_ORCHESTRATORNODE_HPP
 
 #include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <vector>
 
 #include <sustainml_cpp/core/Constants.hpp>
 #include <sustainml_cpp/types/types.hpp>
@@ -43,11 +48,56 @@ class DataWriter;
 } // namespace eprosima
 
 namespace sustainml {
+
+namespace core {
+struct Options;
+} // namespace core
+
 namespace orchestrator {
 
 class ModuleNodeProxy;
 template<typename ... Args> class TaskDB;
+class TaskDataWaiters;
 class TaskManager;
+class TaskTracer;
+
+/**
+ * @brief Occupancy and eviction counters of the Orchestrator task DB.
+ */
+struct TaskDBStats
+{
+    //! Number of problems currently in memory
+    std::size_t live_problems{0};
+    //! Number of (problem, iteration) entries currently in memory
+    std::size_t live_entries{0};
+    //! Approximate size in bytes of the data currently in memory
+    std::size_t live_bytes{0};
+    //! Number of problems evicted since startup
+    std::size_t evicted_problems{0};
+    //! Number of evicted problems written to the spill directory
+    std::size_t spilled_problems{0};
+    //! Number of problems read back from the spill directory
+    std::size_t restored_problems{0};
+};
+
+/**
+ * @brief Time spent by a node on a task, taken from the source timestamps of
+ * the samples it exchanged.
+ */
+struct TaskSpan
+{
+    //! Node of the span, NodeID::ID_ORCHESTRATOR for the span of the whole task
+    NodeID node_id{NodeID::UNKNOWN};
+    //! Node whose output was the last input of this one, NodeID::ID_ORCHESTRATOR
+    //! for the user input. NodeID::UNKNOWN for the span of the whole task
+    NodeID parent_id{NodeID::UNKNOWN};
+    //! Write of the last input of the node, in ns since the epoch
+    int64_t start_ns{0};
+    //! Write of the output of the node, in ns since the epoch
+    int64_t end_ns{0};
+    //! Whether the span is on the chain of nodes that finished the task last
+    bool critical{false};
+};
 
 /**
  * @brief This class is meant for the user to implement
@@ -105,6 +155,18 @@ public:
             OrchestratorNodeHandle& handler,
             uint32_t domain = 0);
 
+    /**
+     * @brief Construct a new Orchestrator Node object
+     *
+     * @param handler OrchestratorNodeHandle object to handle the callbacks
+     * @param opts Options object with the domain and the task DB retention limits
+     *
+     * @note The deletion of the handler is responsibility of the user.
+     */
+    OrchestratorNode(
+            OrchestratorNodeHandle& handler,
+            const core::Options& opts);
+
     /**
      * @brief Destroy the Orchestrator Node object
      *
@@ -113,16 +175,43 @@ public:
     ~OrchestratorNode();
 
     /**
-     * @brief Get the task data from DB given the task_id and node identifier.
+     * @brief Get a copy of the task data from DB given the task_id and node identifier.
      * @param [in] task_id id identifier of the task that has new data available
      * @param [in] node_id id identifier of the node that triggered the new status
-     * @param [in,out]  data pointer that will be redirected to the data
+     * @param [out] data object of the output type of the node, owned by the caller, into which the data is copied
      * @return RetCode_t indicating the result of the operation
      */
     RetCode_t get_task_data(
             const types::TaskId& task_id,
             const NodeID& node_id,
-            void*& data);
+            void* data);
+
+    /**
+     * @brief Get a snapshot of the task data from DB given the task_id and node identifier.
+     * @param [in] task_id id identifier of the task that has new data available
+     * @param [in] node_id id identifier of the node that triggered the new status
+     * @param [out] data snapshot of the data, of the output type of the node. It is never modified
+     * and stays valid while it is held, even if the task is evicted from the DB.
+     * @return RetCode_t indicating the result of the operation
+     */
+    RetCode_t get_task_data(
+            const types::TaskId& task_id,
+            const NodeID& node_id,
+            std::shared_ptr<const void>& data);
+
+    /**
+     * @brief Waits until the output of a node for a task has been received. Only the threads
+     * waiting for that output are woken up when it arrives.
+     * @param [in] task_id identifier of the task
+     * @param [in] node_id identifier of the node whose output to wait for
+     * @param [in] timeout_ms maximum time to wait, in milliseconds
+     * @return RETCODE_OK once the output can be retrieved with get_task_data(), RETCODE_TIMEOUT
+     * if it did not arrive in time, RETCODE_ERROR if the node is terminated or does not exist.
+     */
+    RetCode_t wait_for_task_data(
+            const types::TaskId& task_id,
+            const NodeID& node_id,
+            uint32_t timeout_ms);
 
     /**
      * @brief Get the node status from DB given node identifier.
@@ -139,6 +228,7 @@ public:
      * where to fill the UserInput entry structure.
      * @note It must be called before start_task()
      * @return A pair containing the TaskId and a pointer to the UserInput structure.
+     * The structure is owned by the node and stays valid until start_task() returns.
      */
     std::pair<types::TaskId, types::UserInput*> prepare_new_task();
 
@@ -147,8 +237,9 @@ public:
      * where to fill the UserInput entry structure.
      * @param [in] task_id identifier of the previous task from which to iterate
      * @param [in] last_task_id identifier of the last task from the problem
-     * @note It must be called before start_task()
-     * @return A pair containing the TaskId and a pointer to the UserInput structure.
+     * @note It must be called before start_iteration()
+     * @return A pair containing the TaskId and a pointer to the UserInput structure, filled with
+     * the one of the previous task. It is owned by the node and stays valid until start_iteration() returns.
      */
     std::pair<types::TaskId, types::UserInput*> prepare_new_iteration(
             const types::TaskId& task_id,
@@ -156,7 +247,7 @@ public:
 
     /**
      * @brief This method triggers a new task with a previously prepared task_id and
-     * a pointer to the UserInput data structure.
+     * a pointer to the UserInput data structure, which is stored in the DB.
      * @param [in] task_id id task identifier of the desired task
      * @param [in]      ui pointer to the user input data
      */
@@ -165,7 +256,7 @@ public:
             types::UserInput* ui);
 
     /**
-     * @brief This method triggers a new iteration on a previous task.
+     * @brief This method triggers a new iteration on a previous task. The user input is stored in the DB.
      * @param [in] task_id id task identifier of the desired task
      * @param [in]      ui pointer to the user input data
      */
@@ -188,6 +279,30 @@ public:
     types::ResponseType configuration_request(
             const types::RequestType& req);
 
+    /**
+     * @brief Sends a configuration request to a node without waiting for the response. Any number
+     * of requests may be in flight at once, to the same node or to different ones.
+     * @param [in] req configuration request, contain which node and configuration file
+     * @param [in] timeout_ms deadline of the request, in milliseconds
+     * @param [in] callback called once with the response, which is not successful if the request failed,
+     * expired or was cancelled. It is called from an internal thread, or from this one if the request
+     * could not be sent, so it must not block.
+     * @return Identifier of the request to cancel it, 0 if it could not be sent.
+     */
+    uint64_t configuration_request_async(
+            const types::RequestType& req,
+            uint32_t timeout_ms,
+            std::function<void(const types::ResponseType&)> callback);
+
+    /**
+     * @brief Cancels a request sent with configuration_request_async(). Its callback is called with
+     * a failed response before returning.
+     * @param [in] request_id identifier returned by configuration_request_async()
+     * @return false if the request is no longer in flight.
+     */
+    bool cancel_configuration_request(
+            uint64_t request_id);
+
     /**
      * @brief Public method to get the mutex in order to correctly synchronise user
      * handle calls.
@@ -212,6 +327,32 @@ public:
      */
     void print_db();
 
+    /**
+     * @brief Returns the occupancy and eviction counters of the task DB.
+     */
+    TaskDBStats get_task_db_stats() const;
+
+    /**
+     * @brief Returns the span tree of one of the last tasks, from the write of its
+     * user input to the outputs received so far.
+     * @param [in] task_id identifier of the task
+     * @return The span of the whole task followed by the span of each node,
+     * whose parent_id links it to the node it waited for. Empty if the task is unknown.
+     */
+    std::vector<TaskSpan> get_task_trace(
+            const types::TaskId& task_id) const;
+
+    /**
+     * @brief Writes the span tree of a task to a file in the Chrome trace event
+     * format, which can be loaded in chrome://tracing or Perfetto.
+     * @param [in] task_id identifier of the task
+     * @param [in] path file to write
+     * @return false if the task is unknown or the file could not be written.
+     */
+    bool export_task_trace(
+            const types::TaskId& task_id,
+            const std::string& path) const;
+
     /**
      * @brief Called by the user to run the run.
      */
@@ -235,6 +376,19 @@ protected:
      */
     bool init();
 
+    /**
+     * @brief Records the write of the user input of a task in the task trace
+     */
+    void record_task_input(
+            const types::TaskId& task_id);
+
+    /**
+     * @brief Takes the user input handed out for a task by prepare_new_task() or prepare_new_iteration()
+     * @return The prepared user input, nullptr if there is none
+     */
+    std::unique_ptr<types::UserInput> take_prepared_input(
+            const types::TaskId& task_id);
+
     /**
      * @brief Publishes node baselines
      */
@@ -243,6 +397,9 @@ protected:
 
     uint32_t domain_;
 
+    //! Whether received models may reference payloads in shared memory, see Options::shared_payloads
+    bool shared_payloads_;
+
     /**
      * @brief Handle to manage the node status and node output callbacks
      * @note The deletion of the handler is responsibility of the user.
@@ -268,6 +425,16 @@ protected:
 
     TaskManager* task_man_;
 
+    //! User inputs handed out by prepare_new_task() and prepare_new_iteration(), until their task starts
+    std::map<types::TaskId, std::unique_ptr<types::UserInput>> prepared_inputs_;
+    std::mutex prepared_inputs_mtx_;
+
+    //! Timestamps of the last tasks
+    std::unique_ptr<TaskTracer> task_tracer_;
+
+    //! Threads waiting in wait_for_task_data()
+    std::unique_ptr<TaskDataWaiters> task_waiters_;
+
     std::mutex mtx_;
 
     std::atomic_bool initialized_{false};
@@ -276,6 +443,8 @@ protected:
 
     // Opaque holder for per-service RPC clients (defined in OrchestratorNode.cpp)
     void* rpc_client_holder_{nullptr};
+    //! Guards rpc_client_holder_, held while sending a request so that destroy() waits for it
+    std::mutex rpc_client_mtx_;
 
     /**
      * @brief This class implements the callbacks for the DomainParticipant
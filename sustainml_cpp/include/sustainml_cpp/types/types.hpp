@@ -383,6 +383,12 @@ public:
      */
     AppRequirementsImpl* get_impl();
 
+    /*!
+     * @brief This function returns the implementation
+     * @return Constant pointer to implementation
+     */
+    const AppRequirementsImpl* get_impl() const;
+
     /*!
      * @brief Resets the structure to default values
      */
@@ -409,6 +415,8 @@ class CO2Footprint
 {
 public:
 
+    using impl_type = CO2FootprintImpl;
+
     /*!
      * @brief Default constructor.
      */
@@ -579,6 +587,12 @@ public:
      */
     CO2FootprintImpl* get_impl();
 
+    /*!
+     * @brief This function returns the implementation
+     * @return Constant pointer to implementation
+     */
+    const CO2FootprintImpl* get_impl() const;
+
     /*!
      * @brief Resets the structure to default values
      */
@@ -761,6 +775,12 @@ public:
      */
     HWConstraintsImpl* get_impl();
 
+    /*!
+     * @brief This function returns the implementation
+     * @return Constant pointer to implementation
+     */
+    const HWConstraintsImpl* get_impl() const;
+
     /*!
      * @brief Resets the structure to default values
      */
@@ -786,6 +806,8 @@ class HWResource
 {
 public:
 
+    using impl_type = HWResourceImpl;
+
     /*!
      * @brief Default constructor.
      */
@@ -1003,6 +1025,12 @@ public:
      */
     HWResourceImpl* get_impl();
 
+    /*!
+     * @brief This function returns the implementation
+     * @return Constant pointer to implementation
+     */
+    const HWResourceImpl* get_impl() const;
+
     /*!
      * @brief Resets the structure to default values
      */
@@ -1028,6 +1056,8 @@ class MLModel
 {
 public:
 
+    using impl_type = MLModelImpl;
+
     /*!
      * @brief Default constructor.
      */
@@ -1318,6 +1348,12 @@ public:
      */
     MLModelImpl* get_impl();
 
+    /*!
+     * @brief This function returns the implementation
+     * @return Constant pointer to implementation
+     */
+    const MLModelImpl* get_impl() const;
+
     /*!
      * @brief Resets the structure to default values
      */
@@ -1508,6 +1544,12 @@ public:
      */
     MLModelMetadataImpl* get_impl();
 
+    /*!
+     * @brief This function returns the implementation
+     * @return Constant pointer to implementation
+     */
+    const MLModelMetadataImpl* get_impl() const;
+
     /*!
      * @brief Resets the structure to default values
      */
@@ -1931,6 +1973,12 @@ public:
      */
     NodeStatusImpl* get_impl();
 
+    /*!
+     * @brief This function returns the implementation
+     * @return Constant pointer to implementation
+     */
+    const NodeStatusImpl* get_impl() const;
+
     /*!
      * @brief Resets the structure to default values
      */
@@ -2369,6 +2417,12 @@ public:
      */
     UserInputImpl* get_impl();
 
+    /*!
+     * @brief This function returns the implementation
+     * @return Constant pointer to implementation
+     */
+    const UserInputImpl* get_impl() const;
+
     /*!
      * @brief Resets the structure to default values
      */
@@ -24,10 +24,19 @@
 
 #include <fastdds/dds/log/Log.hpp>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace sustainml {
 namespace common {
@@ -42,8 +51,24 @@ constexpr const char* HW_RESOURCES_NODE = "HW_RESOURCES_NODE";
 constexpr const char* ML_MODEL_METADATA_NODE = "ML_MODEL_METADATA_NODE";
 constexpr const char* ML_MODEL_NODE = "ML_MODEL_NODE";
 
+//! Name of the participant shared by the nodes of a process, see Options::shared_participant.
+//! The names of the nodes it hosts are listed in its user data
+constexpr const char* SHARED_PARTICIPANT_NAME = "SUSTAINML_SHARED_NODES";
+constexpr char NODE_NAMES_SEPARATOR = ';';
+
 //!Env variables
 static constexpr const char* SUSTAINML_DOMAIN_URI = "SUSTAINML_DOMAIN_ID";
+static constexpr const char* SUSTAINML_TASK_DB_MAX_PROBLEMS = "SUSTAINML_TASK_DB_MAX_PROBLEMS";
+static constexpr const char* SUSTAINML_TASK_DB_MAX_BYTES = "SUSTAINML_TASK_DB_MAX_BYTES";
+static constexpr const char* SUSTAINML_TASK_DB_TTL = "SUSTAINML_TASK_DB_TTL";
+static constexpr const char* SUSTAINML_TASK_DB_SPILL_DIR = "SUSTAINML_TASK_DB_SPILL_DIR";
+static constexpr const char* SUSTAINML_TASK_DB_LOG_DIR = "SUSTAINML_TASK_DB_LOG_DIR";
+static constexpr const char* SUSTAINML_TASK_DB_LOG_MAX_PROBLEMS = "SUSTAINML_TASK_DB_LOG_MAX_PROBLEMS";
+static constexpr const char* SUSTAINML_MAX_IN_FLIGHT_TASKS = "SUSTAINML_MAX_IN_FLIGHT_TASKS";
+static constexpr const char* SUSTAINML_SHARED_PARTICIPANT = "SUSTAINML_SHARED_PARTICIPANT";
+static constexpr const char* SUSTAINML_INTRA_PROCESS = "SUSTAINML_INTRA_PROCESS";
+static constexpr const char* SUSTAINML_METRICS_PERIOD = "SUSTAINML_METRICS_PERIOD";
+static constexpr const char* SUSTAINML_RPC_SERVER_THREADS = "SUSTAINML_RPC_SERVER_THREADS";
 
 inline NodeID get_node_id_from_name(
         const eprosima::fastcdr::string_255& name)
@@ -77,6 +102,52 @@ inline NodeID get_node_id_from_name(
     return id;
 }
 
+/*!
+ * @brief Returns the ids of the nodes listed in the user data of a shared participant
+ */
+inline std::vector<NodeID> get_node_ids_from_user_data(
+        const std::vector<uint8_t>& user_data)
+{
+    std::vector<NodeID> ids;
+    auto begin = user_data.begin();
+
+    while (begin != user_data.end())
+    {
+        auto end = std::find(begin, user_data.end(), static_cast<uint8_t>(NODE_NAMES_SEPARATOR));
+        std::string name(begin, end);
+
+        if (!name.empty())
+        {
+            ids.push_back(get_node_id_from_name(eprosima::fastcdr::string_255(name)));
+        }
+
+        begin = (end == user_data.end()) ? end : end + 1;
+    }
+
+    return ids;
+}
+
+/*!
+ * @brief Encodes the names of the nodes hosted by a shared participant as its user data
+ */
+inline std::vector<uint8_t> node_names_to_user_data(
+        const std::vector<std::string>& names)
+{
+    std::vector<uint8_t> user_data;
+
+    for (const std::string& name : names)
+    {
+        if (!user_data.empty())
+        {
+            user_data.push_back(static_cast<uint8_t>(NODE_NAMES_SEPARATOR));
+        }
+
+        user_data.insert(user_data.end(), name.begin(), name.end());
+    }
+
+    return user_data;
+}
+
 enum Topics
 {
     NODE_CONTROL,
@@ -91,6 +162,7 @@ enum Topics
     HW_RESOURCES_BASELINE,
     ML_MODEL_BASELINE,
     CARBON_FOOTPRINT_BASELINE,
+    NODE_METRICS,
     MAX
 };
 
@@ -167,38 +239,184 @@ inline uint32_t parse_sustainml_env(
     return domain_to_use;
 }
 
-/*!
- * @brief Map in which to store all the topics, name and typename
- */
-class TopicCollection
+inline std::size_t parse_max_in_flight_env(
+        const std::size_t& option)
 {
-public:
+    std::size_t max_in_flight_to_use = option;
+    if (const char* env = std::getenv(SUSTAINML_MAX_IN_FLIGHT_TASKS))
+    {
+        try
+        {
+            max_in_flight_to_use = static_cast<std::size_t>(std::stoull(env));
+        }
+        catch (...)
+        {
+            EPROSIMA_LOG_ERROR(NODE, "Error parsing SUSTAINML_MAX_IN_FLIGHT_TASKS, using default instead");
+            max_in_flight_to_use = option;
+        }
+    }
+    return max_in_flight_to_use;
+}
 
-    static std::map<Topics, std::pair<std::string, std::string>>& get()
+inline bool parse_shared_participant_env(
+        const bool& option)
+{
+    bool shared_to_use = option;
+    if (const char* env = std::getenv(SUSTAINML_SHARED_PARTICIPANT))
     {
-        static std::map<Topics, std::pair<std::string, std::string>>  topics {
-            {NODE_CONTROL, {"/sustainml/control", "NodeControlImpl"}},
-            {NODE_STATUS, {"/sustainml/status", "NodeStatusImpl"}},
-            {APP_REQUIREMENT, {"/sustainml/app_requirements/output", "AppRequirementsImpl"}},
-            {CARBON_FOOTPRINT, {"/sustainml/carbon_tracker/output", "CO2FootprintImpl"}},
-            {HW_CONSTRAINT, {"/sustainml/hw_constraints/output", "HWConstraintsImpl"}},
-            {HW_RESOURCE, {"/sustainml/hw_resources/output", "HWResourceImpl"}},
-            {ML_MODEL_METADATA, {"/sustainml/ml_model_metadata/output", "MLModelMetadataImpl"}},
-            {ML_MODEL, {"/sustainml/ml_model_provider/output", "MLModelImpl"}},
-            {USER_INPUT, {"/sustainml/user_input", "UserInputImpl"}},
-            {ML_MODEL_BASELINE, {"/sustainml/ml_model_provider/baseline", "MLModelImpl"}},
-            {HW_RESOURCES_BASELINE, {"/sustainml/hw_resources/baseline", "HWResourceImpl"}},
-            {CARBON_FOOTPRINT_BASELINE, {"/sustainml/carbon_tracker/baseline", "CO2FootprintImpl"}}
-        };
-
-        return topics;
+        std::string value(env);
+
+        if (value == "1" || value == "true" || value == "TRUE")
+        {
+            shared_to_use = true;
+        }
+        else if (value == "0" || value == "false" || value == "FALSE")
+        {
+            shared_to_use = false;
+        }
+        else
+        {
+            EPROSIMA_LOG_ERROR(NODE, "Error parsing SUSTAINML_SHARED_PARTICIPANT, using default instead");
+        }
     }
+    return shared_to_use;
+}
 
-protected:
+inline bool parse_intra_process_env(
+        const bool& option)
+{
+    bool intra_process_to_use = option;
+    if (const char* env = std::getenv(SUSTAINML_INTRA_PROCESS))
+    {
+        std::string value(env);
+
+        if (value == "1" || value == "true" || value == "TRUE")
+        {
+            intra_process_to_use = true;
+        }
+        else if (value == "0" || value == "false" || value == "FALSE")
+        {
+            intra_process_to_use = false;
+        }
+        else
+        {
+            EPROSIMA_LOG_ERROR(NODE, "Error parsing SUSTAINML_INTRA_PROCESS, using default instead");
+        }
+    }
+    return intra_process_to_use;
+}
+
+inline std::chrono::milliseconds parse_metrics_period_env(
+        const std::chrono::milliseconds& option)
+{
+    std::chrono::milliseconds period_to_use = option;
+    if (const char* env = std::getenv(SUSTAINML_METRICS_PERIOD))
+    {
+        try
+        {
+            period_to_use = std::chrono::milliseconds(std::stoull(env));
+        }
+        catch (...)
+        {
+            EPROSIMA_LOG_ERROR(NODE, "Error parsing SUSTAINML_METRICS_PERIOD, using default instead");
+            period_to_use = option;
+        }
+    }
+    return period_to_use;
+}
+
+//! Maximum number of threads serving the configuration requests of a node
+constexpr std::size_t MAX_RPC_SERVER_THREADS = 64;
 
-    TopicCollection() = default;
+inline std::size_t parse_rpc_server_threads_env(
+        const std::size_t& option)
+{
+    std::size_t threads_to_use = option;
+    if (const char* env = std::getenv(SUSTAINML_RPC_SERVER_THREADS))
+    {
+        try
+        {
+            std::string value(env);
+            std::size_t parsed = 0;
+
+            // stoull takes negative values, wrapping them around
+            if (value.find('-') != std::string::npos)
+            {
+                throw std::invalid_argument(value);
+            }
+
+            threads_to_use = static_cast<std::size_t>(std::stoull(value, &parsed));
+
+            if (parsed != value.size())
+            {
+                throw std::invalid_argument(value);
+            }
+        }
+        catch (...)
+        {
+            EPROSIMA_LOG_ERROR(NODE, "Error parsing SUSTAINML_RPC_SERVER_THREADS, using default instead");
+            threads_to_use = option;
+        }
+    }
+
+    if (threads_to_use > MAX_RPC_SERVER_THREADS)
+    {
+        EPROSIMA_LOG_WARNING(NODE,
+                "Too many RPC server threads (" << threads_to_use << "), using " << MAX_RPC_SERVER_THREADS <<
+                " instead");
+        threads_to_use = MAX_RPC_SERVER_THREADS;
+    }
+
+    return threads_to_use;
+}
+
+/*!
+ * @brief Name and type name of a topic
+ */
+struct TopicDescriptor
+{
+    const char* name;
+    const char* type_name;
 };
 
+/*!
+ * @brief All the topics, indexed by Topics
+ */
+constexpr TopicDescriptor TOPICS[Topics::MAX] = {
+    {"/sustainml/control", "NodeControlImpl"},                         // NODE_CONTROL
+    {"/sustainml/status", "NodeStatusImpl"},                           // NODE_STATUS
+    {"/sustainml/app_requirements/output", "AppRequirementsImpl"},     // APP_REQUIREMENT
+    {"/sustainml/carbon_tracker/output", "CO2FootprintImpl"},          // CARBON_FOOTPRINT
+    {"/sustainml/hw_constraints/output", "HWConstraintsImpl"},         // HW_CONSTRAINT
+    {"/sustainml/hw_resources/output", "HWResourceImpl"},              // HW_RESOURCE
+    {"/sustainml/ml_model_metadata/output", "MLModelMetadataImpl"},    // ML_MODEL_METADATA
+    {"/sustainml/ml_model_provider/output", "MLModelImpl"},            // ML_MODEL
+    {"/sustainml/user_input", "UserInputImpl"},                        // USER_INPUT
+    {"/sustainml/hw_resources/baseline", "HWResourceImpl"},            // HW_RESOURCES_BASELINE
+    {"/sustainml/ml_model_provider/baseline", "MLModelImpl"},          // ML_MODEL_BASELINE
+    {"/sustainml/carbon_tracker/baseline", "CO2FootprintImpl"},        // CARBON_FOOTPRINT_BASELINE
+    {"/sustainml/metrics", "NodeMetricsImpl"}                          // NODE_METRICS
+};
+
+static_assert(nullptr != TOPICS[Topics::MAX - 1].name, "Every topic must be registered in TOPICS");
+
+/*!
+ * @brief Returns the name of a topic, empty for Topics::MAX
+ */
+constexpr const char* topic_name(
+        Topics topic)
+{
+    return topic < Topics::MAX ? TOPICS[topic].name : "";
+}
+
+/*!
+ * @brief Returns the type name of a topic, empty for Topics::MAX
+ */
+constexpr const char* topic_type_name(
+        Topics topic)
+{
+    return topic < Topics::MAX ? TOPICS[topic].type_name : "";
+}
 
 enum QueueIds
 {
@@ -209,112 +427,93 @@ enum QueueIds
     ML_MODEL_METADATA_QUEUE,
     ML_MODEL_QUEUE,
     USER_INPUT_QUEUE,
+    MAX_QUEUE_ID
 };
 
-inline int queue_name_to_id(
-        const std::string& queue_name)
+//! Packs a TaskId in a single integer key for the task indexes
+inline uint64_t task_id_to_key(
+        const types::TaskId& task_id)
 {
-    auto tp = TopicCollection::get();
-
-    if (queue_name.find(tp[APP_REQUIREMENT].second) != std::string::npos)
-    {
-        return APP_REQUIREMENT_QUEUE;
-    }
-    else if (queue_name.find(tp[CARBON_FOOTPRINT].second) != std::string::npos)
-    {
-        return CARBON_FOOTPRINT_QUEUE;
-    }
-    else if (queue_name.find(tp[HW_CONSTRAINT].second) != std::string::npos)
-    {
-        return HW_CONSTRAINT_QUEUE;
-    }
-    else if (queue_name.find(tp[HW_RESOURCE].second) != std::string::npos)
-    {
-        return HW_RESOURCE_QUEUE;
-    }
-    else if (queue_name.find(tp[ML_MODEL_METADATA].second) != std::string::npos)
-    {
-        return ML_MODEL_METADATA_QUEUE;
-    }
-    else if (queue_name.find(tp[ML_MODEL].second) != std::string::npos)
-    {
-        return ML_MODEL_QUEUE;
-    }
-    else if (queue_name.find(tp[USER_INPUT].second) != std::string::npos)
-    {
-        return USER_INPUT_QUEUE;
-    }
-    else
-    {
-        EPROSIMA_LOG_ERROR(COMMON, "Could not find the requested queue type name " << queue_name);
-    }
-
-    return -1;
+    return (static_cast<uint64_t>(task_id.problem_id()) << 32) | task_id.iteration_id();
 }
 
+/*!
+ * @brief Queue in which the samples of each type are received,
+ * -1 for the types that are not received in any queue.
+ */
 template<typename T>
-inline int sample_type_to_queue_id(
-        T* sample)
+struct QueueIdOf : std::integral_constant<int, -1>
 {
-    if (typeid(sample) == typeid(types::AppRequirements*))
-    {
-        return APP_REQUIREMENT_QUEUE;
-    }
-    else if (typeid(sample) == typeid(types::CO2Footprint*))
-    {
-        return CARBON_FOOTPRINT_QUEUE;
-    }
-    else if (typeid(sample) == typeid(types::HWConstraints*))
-    {
-        return HW_CONSTRAINT_QUEUE;
-    }
-    else if (typeid(sample) == typeid(types::HWResource*))
-    {
-        return HW_RESOURCE_QUEUE;
-    }
-    else if (typeid(sample) == typeid(types::MLModelMetadata*))
-    {
-        return ML_MODEL_METADATA_QUEUE;
-    }
-    else if (typeid(sample) == typeid(types::MLModel*))
-    {
-        return ML_MODEL_QUEUE;
-    }
-    else if (typeid(sample) == typeid(types::UserInput*))
-    {
-        return USER_INPUT_QUEUE;
-    }
+};
+
+template<>
+struct QueueIdOf<types::AppRequirements> : std::integral_constant<int, APP_REQUIREMENT_QUEUE>
+{
+};
+
+template<>
+struct QueueIdOf<types::CO2Footprint> : std::integral_constant<int, CARBON_FOOTPRINT_QUEUE>
+{
+};
+
+template<>
+struct QueueIdOf<types::HWConstraints> : std::integral_constant<int, HW_CONSTRAINT_QUEUE>
+{
+};
+
+template<>
+struct QueueIdOf<types::HWResource> : std::integral_constant<int, HW_RESOURCE_QUEUE>
+{
+};
+
+template<>
+struct QueueIdOf<types::MLModelMetadata> : std::integral_constant<int, ML_MODEL_METADATA_QUEUE>
+{
+};
+
+template<>
+struct QueueIdOf<types::MLModel> : std::integral_constant<int, ML_MODEL_QUEUE>
+{
+};
+
+template<>
+struct QueueIdOf<types::UserInput> : std::integral_constant<int, USER_INPUT_QUEUE>
+{
+};
 
-    return -1;
+template<typename T>
+constexpr int sample_type_to_queue_id(
+        T*)
+{
+    return QueueIdOf<T>::value;
 }
 
+//! Input samples of a task indexed by queue id
+using SamplesByQueue = std::array<void*, MAX_QUEUE_ID>;
+
 template<typename T>
 inline bool pair_queue_id_with_sample_type(
-        std::vector<std::pair<int, void*>> input_samples,
+        const SamplesByQueue& samples_by_queue,
         T*& sample,
-        const size_t& expected_samples,
         size_t& n_samples_retrieved)
 {
-    bool ret = false;
+    constexpr int queue_id = QueueIdOf<T>::value;
 
-    for (std::pair<int, void*>& input : input_samples)
+    if (queue_id < 0 || nullptr == samples_by_queue[queue_id])
     {
-        if (sample_type_to_queue_id(sample) == input.first)
-        {
-            sample = reinterpret_cast<decltype(sample)>(input.second);
-            ++n_samples_retrieved;
-            ret = true;
-        }
+        return false;
     }
 
-    return ret;
+    sample = reinterpret_cast<T*>(samples_by_queue[queue_id]);
+    ++n_samples_retrieved;
+    return true;
 }
 
 template<std::size_t I = 0, typename ... Tp>
 inline typename std::enable_if<I == sizeof...(Tp), void>::type
 pair_queue_id_with_sample_type(
-        const std::vector<std::pair<int, void*>>& input_samples,
-        std::tuple<Tp...>& t,
+        const SamplesByQueue& samples_by_queue,
+        std::tuple<Tp...>& t_args,
         const size_t& expected_samples,
         size_t& n_samples_retrieved)
 {
@@ -323,16 +522,15 @@ pair_queue_id_with_sample_type(
 template<std::size_t I = 0, typename ... Tp>
 inline typename std::enable_if < I < sizeof...(Tp), void>::type
 pair_queue_id_with_sample_type(
-        const std::vector<std::pair<int, void*>>& input_samples,
+        const SamplesByQueue& samples_by_queue,
         std::tuple<Tp...>& t_args,
         const size_t& expected_samples,
         size_t& n_samples_retrieved)
 {
 
     if (!pair_queue_id_with_sample_type(
-                input_samples,
+                samples_by_queue,
                 std::get<I>(t_args),
-                expected_samples,
                 n_samples_retrieved))
     {
         if (n_samples_retrieved != expected_samples)
@@ -343,7 +541,40 @@ pair_queue_id_with_sample_type(
         return;
     }
     pair_queue_id_with_sample_type<I + 1, Tp...>(
-        input_samples,
+        samples_by_queue,
+        t_args,
+        expected_samples,
+        n_samples_retrieved);
+}
+
+/*!
+ * @brief Binds the input samples of a task to the user callback arguments,
+ * in order, until an argument whose type is not received in any queue.
+ *
+ * @param input_samples Pairs of queue id and sample
+ * @param t_args User callback arguments
+ * @param expected_samples Number of input samples
+ * @param n_samples_retrieved Incremented for every argument bound
+ */
+template<typename ... Tp>
+inline void pair_queue_id_with_sample_type(
+        const std::vector<std::pair<int, void*>>& input_samples,
+        std::tuple<Tp...>& t_args,
+        const size_t& expected_samples,
+        size_t& n_samples_retrieved)
+{
+    SamplesByQueue samples_by_queue{};
+
+    for (const std::pair<int, void*>& input : input_samples)
+    {
+        if (input.first >= 0 && input.first < MAX_QUEUE_ID)
+        {
+            samples_by_queue[input.first] = input.second;
+        }
+    }
+
+    pair_queue_id_with_sample_type(
+        samples_by_queue,
         t_args,
         expected_samples,
         n_samples_retrieved);
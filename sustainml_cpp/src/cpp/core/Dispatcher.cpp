@@ -22,16 +22,29 @@
 #include <sustainml_cpp/interfaces/SampleQueryable.hpp>
 
 #include <common/Common.hpp>
+#include <utils/SamplePool.hpp>
 
 namespace sustainml {
 namespace core {
 
 Dispatcher::Dispatcher(
-        Node* node)
-    : thread_pool_(N_THREADS_DEFAULT)
+        Node* node,
+        const Options& opts)
+    : thread_pool_(
+        opts.dispatcher_threads > 0 ? opts.dispatcher_threads : N_THREADS_DEFAULT,
+        std::bind(&Dispatcher::routine, this, std::placeholders::_1))
+    , listener_thread_(1, [](std::function<void()>& job)
+            {
+                job();
+            })
     , node_(node)
+    , taskid_tracker_(opts.sample_pool_max_size)
+    , expected_queues_mask_(0)
     , stop_(false)
     , started_(false)
+    , max_in_flight_(common::parse_max_in_flight_env(opts.max_in_flight_tasks))
+    , in_flight_(0)
+    , metrics_(common::parse_metrics_period_env(opts.metrics_period).count() > 0)
 {
     sample_queryables_.reserve(INITIAL_N_QUEUES);
 }
@@ -50,117 +63,225 @@ void Dispatcher::start()
 {
     if (!started_)
     {
+        listener_thread_.enable();
         thread_pool_.enable();
-
-        // Feed the routine in thread pool
-        thread_pool_.slot(
-            DISPATCHER_ROUTINE_ID,
-            std::bind(&Dispatcher::routine, this));
-
         started_.store(true);
     }
 }
 
 void Dispatcher::stop()
 {
+    started_.store(false);
     thread_pool_.disable();
+    listener_thread_.disable();
 }
 
 void Dispatcher::register_sample_queryable(
         interfaces::SampleQueryable* sr)
 {
+    if (sr->get_id() < 0 || sr->get_id() >= MAX_N_QUEUES)
+    {
+        EPROSIMA_LOG_ERROR(DISPATCHER, node_->name() << " Cannot register queue with id " << sr->get_id());
+        return;
+    }
+
     sample_queryables_.emplace_back(sr);
+    expected_queues_mask_.fetch_or(1u << sr->get_id());
 }
 
 void Dispatcher::notify(
-        const types::TaskId& task_id)
+        const types::TaskId& task_id,
+        int queue_id)
 {
-    if (started_.load(std::memory_order_relaxed))
+    if (!started_.load(std::memory_order_relaxed) ||
+            !thread_pool_.push(SampleNotification{task_id, queue_id, metrics_.now()}))
     {
-        {
-            std::unique_lock<std::mutex> lock(mtx_);
-            taskid_buffer_.push(task_id);
-        }
+        EPROSIMA_LOG_ERROR(DISPATCHER,
+                node_->name() << " Dispatcher discarding sample with task_id " << task_id <<
+                ", not running");
+    }
+}
+
+void Dispatcher::notify(
+        const std::vector<types::TaskId>& task_ids,
+        int queue_id)
+{
+    std::vector<SampleNotification> notifications;
+    notifications.reserve(task_ids.size());
+    auto notified_at = metrics_.now();
 
-        thread_pool_.emit(DISPATCHER_ROUTINE_ID);
+    for (auto& task_id : task_ids)
+    {
+        notifications.push_back(SampleNotification{task_id, queue_id, notified_at});
     }
-    else
+
+    if (!started_.load(std::memory_order_relaxed) || !thread_pool_.push(notifications))
     {
         EPROSIMA_LOG_ERROR(DISPATCHER,
-                node_->name() << " Dispatcher discarding sample with task_id " << task_id <<
-                ", not initialized");
+                node_->name() << " Dispatcher discarding " << task_ids.size() <<
+                " samples, not running");
+    }
+}
+
+bool Dispatcher::post_to_listener_thread(
+        const std::function<void()>& job)
+{
+    return started_.load(std::memory_order_relaxed) && listener_thread_.push(job);
+}
+
+void Dispatcher::queue_occupancy(
+        NodeMetrics::QueueOccupancy& occupancy)
+{
+    occupancy = NodeMetrics::QueueOccupancy();
+
+    for (auto& sq : sample_queryables_)
+    {
+        utils::SamplePoolStats stats;
+        sq->pool_stats(stats);
+
+        occupancy.queued_samples += sq->size();
+        occupancy.pool_in_use += stats.in_use;
+        occupancy.pool_capacity += stats.capacity;
     }
 }
 
 void Dispatcher::process(
-        const types::TaskId& task_id)
+        const SampleNotification& notification)
 {
-    int expected_hits = sample_queryables_.size();
+    const types::TaskId& task_id = notification.task_id;
+    int queue_id = notification.queue_id;
 
-    bool all_received = false;
+    if (queue_id < 0 || queue_id >= MAX_N_QUEUES)
+    {
+        EPROSIMA_LOG_ERROR(DISPATCHER, node_->name() << " Invalid queue id " << queue_id);
+        return;
+    }
+
+    auto result = taskid_tracker_.mark(common::task_id_to_key(task_id), 1u << queue_id, expected_queues_mask_.load());
 
+    if (result == utils::TaskReadinessTracker::PENDING)
+    {
+        EPROSIMA_LOG_INFO(DISPATCHER,
+                node_->name() << " task_id " << task_id << " received in queue " << queue_id);
+    }
+    else if (acquire_slot(task_id, notification.notified_at))
     {
-        std::lock_guard<std::mutex> lock(taskid_mtx_);
-        auto it = taskid_tracker_.find(task_id);
+        run(task_id, notification.notified_at);
+    }
+}
 
-        if (it == taskid_tracker_.end())
-        {
-            EPROSIMA_LOG_INFO(DISPATCHER, node_->name() << " Initializing task_id " << task_id);
-            taskid_tracker_[task_id] = 1;
-        }
-        else
-        {
-            it->second += 1;
-            EPROSIMA_LOG_INFO(DISPATCHER,
-                    node_->name() << " Taskid_tracker_[task_id] " << task_id << " n_times " << it->second);
-        }
+bool Dispatcher::acquire_slot(
+        const types::TaskId& task_id,
+        const std::chrono::steady_clock::time_point& ready_at)
+{
+    std::lock_guard<std::mutex> lock(in_flight_mtx_);
+
+    if (max_in_flight_ > 0 && in_flight_ >= max_in_flight_)
+    {
+        EPROSIMA_LOG_INFO(DISPATCHER,
+                node_->name() << " task_id " << task_id << " waits for one of the tasks in flight");
+        parked_.push_back(std::make_pair(task_id, ready_at));
+        return false;
+    }
+
+    ++in_flight_;
+    return true;
+}
+
+void Dispatcher::run(
+        const types::TaskId& task_id,
+        const std::chrono::steady_clock::time_point& ready_at)
+{
+    std::vector<std::pair<int, void*>> samples;
+    samples.reserve(sample_queryables_.size());
+
+    for (auto& sq : sample_queryables_)
+    {
+        void* sample = sq->retrieve_sample_from_taskid(task_id);
 
-        if (taskid_tracker_[task_id] == expected_hits)
+        if (nullptr == sample)
         {
-            all_received = true;
-            taskid_tracker_.erase(task_id);
+            break;
         }
+
+        samples.push_back(std::make_pair(sq->get_id(), sample));
     }
 
-    if (all_received)
+    if (samples.size() != sample_queryables_.size())
     {
-        std::vector<std::pair<int, void*>> samples;
-        samples.reserve(sample_queryables_.size());
+        discard(task_id);
+        release_slot();
+        return;
+    }
 
-        for (auto& sq : sample_queryables_)
-        {
-            void* sample = sq->retrieve_sample_from_taskid(task_id);
+    metrics_.record_since(NodeMetrics::DISPATCH, ready_at);
 
-            if (nullptr != sample)
-            {
-                samples.push_back(std::make_pair(sq->get_id(), sample));
-            }
-            else
-            {
-                return;
-            }
-        }
-        node_->publish_to_user(task_id, samples);
+    if (!node_->publish_to_user(task_id, samples))
+    {
+        discard(task_id);
+        release_slot();
+    }
+}
+
+void Dispatcher::discard(
+        const types::TaskId& task_id)
+{
+    // Nothing would retrieve its samples any more
+    for (auto& sq : sample_queryables_)
+    {
+        sq->remove_element_by_taskid(task_id);
     }
 }
 
-void Dispatcher::routine()
+void Dispatcher::release_slot()
 {
     types::TaskId task_id;
+    std::chrono::steady_clock::time_point ready_at;
+
+    {
+        std::lock_guard<std::mutex> lock(in_flight_mtx_);
+
+        if (parked_.empty())
+        {
+            --in_flight_;
+            return;
+        }
+
+        task_id = parked_.front().first;
+        ready_at = parked_.front().second;
+        parked_.pop_front();
+    }
 
+    // The slot is handed over to the oldest parked task, which is run by the pool
+    // since the task may be completed from a user thread
+    if (!started_.load(std::memory_order_relaxed) ||
+            !thread_pool_.push(SampleNotification{task_id, PARKED_TASK_QUEUE_ID, ready_at}))
     {
-        std::unique_lock<std::mutex> lock(mtx_);
-        task_id = taskid_buffer_.front();
-        taskid_buffer_.pop();
+        EPROSIMA_LOG_ERROR(DISPATCHER,
+                node_->name() << " Dispatcher discarding parked task_id " << task_id << ", not running");
+
+        // Its tracker entry was released when it became ready, only its samples are left
+        discard(task_id);
+
+        std::lock_guard<std::mutex> lock(in_flight_mtx_);
+        --in_flight_;
     }
+}
 
-    if (task_id != types::TaskId{common::INVALID_ID, common::INVALID_ID})
+void Dispatcher::routine(
+        SampleNotification& notification)
+{
+    if (notification.task_id == types::TaskId{common::INVALID_ID, common::INVALID_ID})
     {
-        process(task_id);
+        EPROSIMA_LOG_ERROR(DISPATCHER, "Invalid Task Id in queue");
+    }
+    else if (notification.queue_id == PARKED_TASK_QUEUE_ID)
+    {
+        run(notification.task_id, notification.notified_at);
     }
     else
     {
-        EPROSIMA_LOG_ERROR(DISPATCHER, "Invalid Task Id in queue");
+        process(notification);
     }
 
 }
@@ -21,37 +21,50 @@
 
 #include <sustainml_cpp/interfaces/SampleQueryable.hpp>
 
+#include <chrono>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <mutex>
 #include <memory>
 #include <thread>
-#include <map>
-#include <condition_variable>
 #include <vector>
-#include <queue>
 #include <atomic>
 
-#include <cpp_utils/thread_pool/pool/SlotThreadPool.hpp>
+#include <core/NodeMetrics.hpp>
+#include <core/Options.hpp>
+#include <utils/TaskReadinessTracker.hpp>
+#include <utils/WorkStealingThreadPool.hpp>
 
 namespace sustainml {
 namespace core {
 
 constexpr int N_THREADS_DEFAULT = 2;
 constexpr int INITIAL_N_QUEUES = 6;
-constexpr eprosima::utils::TaskId DISPATCHER_ROUTINE_ID = 1;
+//! Queue ids are used as bit positions of a 32-bit mask
+constexpr int MAX_N_QUEUES = 32;
+//! Queue id of the notifications that resume a parked task
+constexpr int PARKED_TASK_QUEUE_ID = -1;
 
 class Node;
 class SampleQueryable;
 
 /**
- * @brief This class tracks the number of times a sample of a particular
- * task_id has been received in different queues. When a task_id has
+ * @brief This class tracks in which queues a sample of a particular
+ * task_id has been received. When a task_id has
  * received the expected number of samples, is in charge of retrieving
  * the samples so that the Node can invoke the user callback.
  *
- * It is served by a Thread Pool that simultaneously executes the routine()
- * when a new task_id is received.
+ * It is served by a work-stealing Thread Pool that executes the routine()
+ * for every task_id received. The number of threads is taken from
+ * Options::dispatcher_threads.
+ *
+ * Several tasks are run by the node at the same time, up to
+ * Options::max_in_flight_tasks. A task is in flight from the moment it is
+ * handed to the user until its CompletionHandle is completed, which may
+ * happen after the thread has returned to the pool. Tasks that become ready
+ * beyond that limit are parked, and resumed in arrival order as tasks
+ * complete.
  */
 class Dispatcher
 {
@@ -61,7 +74,8 @@ class Dispatcher
 public:
 
     Dispatcher(
-            Node* node);
+            Node* node,
+            const Options& opts = Options());
 
     ~Dispatcher();
 
@@ -81,8 +95,8 @@ public:
     void stop();
 
     /**
-     * @brief Register a new Queue from which to take samples. The expected
-     * number of samples for a task_id is the number of SampleQueryable registered.
+     * @brief Register a new Queue from which to take samples. A task_id is ready
+     * once a sample has been received in every SampleQueryable registered.
      *
      * @param sr Interface from which to retrieve the samples of a particular task_id.
      */
@@ -94,52 +108,150 @@ public:
      * has been received.
      *
      * @param task_id Task identifier
+     * @param queue_id Identifier of the queue in which the sample was received
      */
     void notify(
-            const types::TaskId& task_id);
+            const types::TaskId& task_id,
+            int queue_id);
+
+    /**
+     * @brief Notifies the Dispatcher that samples for several task_ids
+     * have been received in the same queue, enqueueing all of them at once.
+     *
+     * @param task_ids Task identifiers
+     * @param queue_id Identifier of the queue in which the samples were received
+     */
+    void notify(
+            const std::vector<types::TaskId>& task_ids,
+            int queue_id);
+
+    /**
+     * @brief Runs a job in the listener thread of the node. It resumes the
+     * listeners stalled by an exhausted pool, so that the threads releasing
+     * caches, such as the user's, never take samples themselves.
+     * Jobs are run one at a time, in the order they are posted.
+     *
+     * @param job Job to be run
+     * @return false if the Dispatcher is not active.
+     */
+    bool post_to_listener_thread(
+            const std::function<void()>& job);
+
+    /**
+     * @brief Latencies recorded by the node.
+     */
+    NodeMetrics& metrics()
+    {
+        return metrics_;
+    }
+
+    /**
+     * @brief Adds up the occupancy of all the registered queues.
+     *
+     * @param occupancy Receives the occupancy
+     */
+    void queue_occupancy(
+            NodeMetrics::QueueOccupancy& occupancy);
 
 private:
 
+    //! Sample arrival enqueued in the thread pool
+    struct SampleNotification
+    {
+        types::TaskId task_id;
+        int queue_id;
+        //! When the sample was notified, or the task became ready for parked tasks
+        std::chrono::steady_clock::time_point notified_at;
+    };
+
     /**
      * @brief Implements the main logic of the Dispatcher.
-     * Increments the counter for that task_id and, if all the samples are received, it
+     * Marks the queue as received for that task_id and, if all the samples are received, it
      * retrieves the samples from the queues and invokes the user callback.
      *
-     * @param task_id Task identifier
+     * @param notification Received task_id and queue_id
      */
     void process(
-            const types::TaskId& task_id);
+            const SampleNotification& notification);
+
+    /**
+     * @brief Function that each thread executes for every notification
+     * popped (or stolen) from the worker deques.
+     *
+     * @param notification Received task_id and queue_id
+     */
+    void routine(
+            SampleNotification& notification);
 
     /**
-     * @brief Function that each thread executes. In a thread-safe fashion, pops
-     * a task_id from the taskid_buffer and processes it.
+     * @brief Takes a slot for a ready task, parking the task if all are taken.
+     *
+     * @param task_id Task identifier
+     * @param ready_at When the task became ready
+     * @return false if the task has been parked.
      */
-    void routine();
+    bool acquire_slot(
+            const types::TaskId& task_id,
+            const std::chrono::steady_clock::time_point& ready_at);
 
-    eprosima::utils::SlotThreadPool thread_pool_;
+    /**
+     * @brief Hands a ready task to the node. Its slot is released on
+     * completion, or right away if the task could not be handed over.
+     *
+     * @param task_id Task identifier
+     * @param ready_at When the task became ready
+     */
+    void run(
+            const types::TaskId& task_id,
+            const std::chrono::steady_clock::time_point& ready_at);
 
-    std::condition_variable pool_cv;
+    /**
+     * @brief Releases the slot of a task, handing it over to the
+     * oldest parked task if any.
+     */
+    void release_slot();
 
-    std::mutex mtx_, taskid_mtx_;
+    /**
+     * @brief Drops the samples of a task that will not be run from every queue.
+     *
+     * @param task_id Task identifier
+     */
+    void discard(
+            const types::TaskId& task_id);
 
-    std::function<void()> slot_;
+    utils::WorkStealingThreadPool<SampleNotification> thread_pool_;
 
-    Node* node_;
+    //! Single worker running the jobs posted with post_to_listener_thread
+    utils::WorkStealingThreadPool<std::function<void()>> listener_thread_;
 
-    std::queue<types::TaskId> taskid_buffer_;
+    Node* node_;
 
-    // collection of <taskid, std::vector<queue_id>>
+    // Per task_id bitmask of the queues that already received a sample.
     // Current implementation assumes that no task_id
     // can be received twice in a queue
-    // but it can be easily added by also tracking the
-    // queue_id
-    std::map<types::TaskId, int> taskid_tracker_;
+    utils::TaskReadinessTracker taskid_tracker_;
+
+    // Bitmask with the ids of all the registered queues
+    std::atomic<uint32_t> expected_queues_mask_;
 
     std::vector<interfaces::SampleQueryable*> sample_queryables_;
 
     std::atomic<bool> stop_;
 
     std::atomic<bool> started_;
+
+    //! Maximum number of tasks in flight, 0 if unlimited
+    const std::size_t max_in_flight_;
+
+    std::size_t in_flight_;
+
+    //! Ready tasks waiting for a slot, and when they became ready
+    std::deque<std::pair<types::TaskId, std::chrono::steady_clock::time_point>> parked_;
+
+    //! Guards in_flight_ and parked_
+    std::mutex in_flight_mtx_;
+
+    NodeMetrics metrics_;
 };
 
 } // namespace core
@@ -68,7 +68,7 @@ public:
 
         try
         {
-            node_.request_listener().on_configuration_request(req, res);
+            node_.request_listener().dispatch_configuration_request(req, res);
         }
         catch (const std::exception& e)
         {
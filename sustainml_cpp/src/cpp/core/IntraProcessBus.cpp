@@ -0,0 +1,169 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file IntraProcessBus.cpp
+ */
+
+#include <core/IntraProcessBus.hpp>
+
+#include <vector>
+
+#include <fastdds/dds/core/Time_t.hpp>
+#include <fastdds/dds/publisher/DataWriter.hpp>
+#include <fastdds/dds/subscriber/DataReader.hpp>
+#include <fastdds/dds/subscriber/SampleInfo.hpp>
+#include <fastdds/dds/topic/Topic.hpp>
+
+using namespace eprosima::fastdds::dds;
+
+namespace sustainml {
+namespace core {
+
+IntraProcessBus& IntraProcessBus::get()
+{
+    static IntraProcessBus bus;
+    return bus;
+}
+
+void IntraProcessBus::add_reader(
+        DataReader* reader,
+        interfaces::IntraProcessReader* endpoint)
+{
+    std::unique_lock<std::shared_timed_mutex> lock(readers_mtx_);
+
+    readers_[reader->get_instance_handle()] = ReaderEntry{reader->get_topicdescription()->get_name(), endpoint};
+
+    Time_t now;
+    Time_t::now(now);
+
+    std::lock_guard<std::mutex> handles_lock(handles_mtx_);
+    added_at_ns_[endpoint] = now.to_ns();
+}
+
+void IntraProcessBus::remove_reader(
+        const interfaces::IntraProcessReader* endpoint)
+{
+    std::unique_lock<std::shared_timed_mutex> lock(readers_mtx_);
+
+    for (auto it = readers_.begin(); it != readers_.end(); ++it)
+    {
+        if (it->second.endpoint == endpoint)
+        {
+            readers_.erase(it);
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> handles_lock(handles_mtx_);
+    added_at_ns_.erase(endpoint);
+}
+
+void IntraProcessBus::add_writer(
+        DataWriter* writer)
+{
+    std::lock_guard<std::mutex> lock(handles_mtx_);
+    writers_.insert(writer->get_instance_handle());
+}
+
+void IntraProcessBus::remove_writer(
+        DataWriter* writer)
+{
+    std::lock_guard<std::mutex> lock(handles_mtx_);
+    writers_.erase(writer->get_instance_handle());
+}
+
+bool IntraProcessBus::is_duplicate(
+        const interfaces::IntraProcessReader* endpoint,
+        const SampleInfo& info) const
+{
+    std::lock_guard<std::mutex> lock(handles_mtx_);
+
+    auto it = added_at_ns_.find(endpoint);
+
+    // Samples of other processes, or written before the reader was added, were only written to DDS
+    return it != added_at_ns_.end() &&
+           info.source_timestamp.to_ns() >= it->second &&
+           writers_.count(info.publication_handle) > 0;
+}
+
+bool IntraProcessBus::write(
+        DataWriter* writer,
+        void* sample,
+        const std::function<std::shared_ptr<const void>()>& make_shared,
+        const std::function<void()>& before_dds_write)
+{
+    auto write_to_dds = [&]()
+            {
+                if (before_dds_write)
+                {
+                    before_dds_write();
+                }
+
+                return RETCODE_OK == writer->write(sample);
+            };
+
+    bool added;
+
+    {
+        std::lock_guard<std::mutex> lock(handles_mtx_);
+        added = writers_.count(writer->get_instance_handle()) > 0;
+    }
+
+    if (!added)
+    {
+        return write_to_dds();
+    }
+
+    std::shared_lock<std::shared_timed_mutex> lock(readers_mtx_);
+
+    const std::string& topic_name = writer->get_topic()->get_name();
+    std::shared_ptr<const void> shared_sample;
+
+    for (auto& reader : readers_)
+    {
+        if (reader.second.topic_name == topic_name)
+        {
+            if (!shared_sample)
+            {
+                shared_sample = make_shared();
+            }
+
+            reader.second.endpoint->on_intra_process_sample(shared_sample);
+        }
+    }
+
+    // Late joiners of durable topics take the sample from the writer history
+    if (!shared_sample || VOLATILE_DURABILITY_QOS != writer->get_qos().durability().kind)
+    {
+        return write_to_dds();
+    }
+
+    std::vector<eprosima::fastdds::rtps::InstanceHandle_t> matched;
+    writer->get_matched_subscriptions(matched);
+
+    for (const eprosima::fastdds::rtps::InstanceHandle_t& handle : matched)
+    {
+        if (readers_.find(handle) == readers_.end())
+        {
+            // A subscriber outside the bus needs it too
+            return write_to_dds();
+        }
+    }
+
+    return true;
+}
+
+} // namespace core
+} // namespace sustainml
@@ -0,0 +1,155 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file IntraProcessBus.hpp
+ */
+
+#ifndef SUSTAINMLCPP_CORE_INTRAPROCESSBUS_HPP
+#define SUSTAINMLCPP_CORE_INTRAPROCESSBUS_HPP
+
+#include <sustainml_cpp/interfaces/IntraProcessReader.hpp>
+
+#include <fastdds/rtps/common/InstanceHandle.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+
+namespace eprosima {
+namespace fastdds {
+namespace dds {
+
+class DataReader;
+class DataWriter;
+struct SampleInfo;
+
+} // namespace dds
+} // namespace fastdds
+} // namespace eprosima
+
+namespace sustainml {
+namespace core {
+
+/**
+ * @brief Hands the samples of the DataWriters of the process straight to
+ * the DataReaders of the process in the same topic, without serializing them.
+ *
+ * A sample is only written to DDS as well when a subscriber outside the bus
+ * is matched, when no reader of the bus is, or when the writer is durable, so
+ * that the writer history is kept for late joiners. Readers of the bus
+ * discard the DDS copy of the samples they already received through it.
+ *
+ * Only the writers and readers added to it take part. Thread safe.
+ */
+class IntraProcessBus
+{
+public:
+
+    static IntraProcessBus& get();
+
+    /**
+     * @brief Starts handing the samples of the topic of the reader to it.
+     */
+    void add_reader(
+            eprosima::fastdds::dds::DataReader* reader,
+            interfaces::IntraProcessReader* endpoint);
+
+    /**
+     * @brief Stops handing samples to an endpoint. No sample is being handed
+     * to it once it returns.
+     */
+    void remove_reader(
+            const interfaces::IntraProcessReader* endpoint);
+
+    void add_writer(
+            eprosima::fastdds::dds::DataWriter* writer);
+
+    void remove_writer(
+            eprosima::fastdds::dds::DataWriter* writer);
+
+    /**
+     * @brief Writes a sample, handing it to the readers of the bus if the
+     * writer was added to it.
+     *
+     * @param writer The DataWriter of the topic
+     * @param sample The sample, of the impl type of the topic
+     * @param before_dds_write Called right before writing the sample to DDS, if it is.
+     * It may modify the sample, the readers of the bus already got their copy then.
+     * @return false if it could not be written to DDS.
+     */
+    template <typename Impl>
+    bool write(
+            eprosima::fastdds::dds::DataWriter* writer,
+            Impl* sample,
+            const std::function<void()>& before_dds_write = std::function<void()>())
+    {
+        return write(writer, sample, [sample]()
+                       {
+                           return std::shared_ptr<const void>(std::make_shared<const Impl>(*sample));
+                       }, before_dds_write);
+    }
+
+    /**
+     * @brief Whether a sample taken from the DataReader of an endpoint was
+     * already handed to it through the bus.
+     */
+    bool is_duplicate(
+            const interfaces::IntraProcessReader* endpoint,
+            const eprosima::fastdds::dds::SampleInfo& info) const;
+
+private:
+
+    struct ReaderEntry
+    {
+        std::string topic_name;
+        interfaces::IntraProcessReader* endpoint;
+    };
+
+    IntraProcessBus() = default;
+
+    /**
+     * @brief Writes a sample, copying it with make_shared only if any
+     * reader of the bus is interested in it.
+     */
+    bool write(
+            eprosima::fastdds::dds::DataWriter* writer,
+            void* sample,
+            const std::function<std::shared_ptr<const void>()>& make_shared,
+            const std::function<void()>& before_dds_write);
+
+    //! Shared while writing, so that samples are handed and written to DDS atomically
+    //! with respect to the addition of readers
+    std::shared_timed_mutex readers_mtx_;
+
+    std::map<eprosima::fastdds::rtps::InstanceHandle_t, ReaderEntry> readers_;
+
+    //! Never held while writing to DDS, which may call the listeners of the readers
+    mutable std::mutex handles_mtx_;
+
+    std::set<eprosima::fastdds::rtps::InstanceHandle_t> writers_;
+
+    //! Time each reader was added in ns. Samples written before were not handed to it
+    std::map<const interfaces::IntraProcessReader*, int64_t> added_at_ns_;
+};
+
+} // namespace core
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_CORE_INTRAPROCESSBUS_HPP
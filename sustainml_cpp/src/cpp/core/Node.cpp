@@ -18,6 +18,7 @@
 
 #include <sustainml_cpp/core/Node.hpp>
 
+#include <core/Dispatcher.hpp>
 #include <core/NodeImpl.hpp>
 #include <core/Options.hpp>
 
@@ -101,10 +102,45 @@ const Status& Node::status()
     return impl_->node_status_.node_status();
 }
 
+TaskStatus Node::task_status(
+        const types::TaskId& task_id)
+{
+    return impl_->task_status(task_id);
+}
+
 void Node::status(
         const Status& status)
 {
-    impl_->node_status_.node_status(status);
+    impl_->node_status(status);
+}
+
+void Node::task_started(
+        const types::TaskId& task_id)
+{
+    impl_->task_started(task_id);
+}
+
+void Node::task_finished(
+        const types::TaskId& task_id,
+        bool error)
+{
+    impl_->task_finished(task_id, error);
+}
+
+CompletionHandle Node::make_completion_handle(
+        std::function<void(bool)> on_complete)
+{
+    std::weak_ptr<Dispatcher> dispatcher = get_dispatcher();
+
+    return CompletionHandle([dispatcher, on_complete](bool abandoned)
+            {
+                on_complete(abandoned);
+
+                if (auto locked_dispatcher = dispatcher.lock())
+                {
+                    locked_dispatcher->release_slot();
+                }
+            });
 }
 
 std::weak_ptr<Dispatcher> Node::get_dispatcher()
@@ -117,5 +153,16 @@ const std::vector<eprosima::fastdds::dds::DataWriter*>& Node::writers()
     return impl_->writers_;
 }
 
+std::chrono::steady_clock::time_point Node::output_write_start()
+{
+    return impl_->dispatcher_->metrics().now();
+}
+
+void Node::record_output_write(
+        const std::chrono::steady_clock::time_point& start)
+{
+    impl_->dispatcher_->metrics().record_since(NodeMetrics::OUTPUT_WRITE, start);
+}
+
 } // namespace core
 } // namespace sustainml
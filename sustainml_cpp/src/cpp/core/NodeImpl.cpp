@@ -24,8 +24,11 @@
 
 #include <common/Common.hpp>
 #include <core/Dispatcher.hpp>
+#include <core/IntraProcessBus.hpp>
 #include <core/NodeImpl.hpp>
+#include <core/NodeMetrics.hpp>
 #include <core/Options.hpp>
+#include <core/SharedParticipant.hpp>
 #include <types/typesImplPubSubTypes.hpp>
 #include <types/typesImplTypeObjectSupport.hpp>
 
@@ -41,6 +44,64 @@ using namespace eprosima::fastdds::dds;
 namespace sustainml {
 namespace core {
 
+namespace {
+
+/**
+ * @brief Creates the TypeSupport of one of the SustainML types by name.
+ * Empty if the name is unknown.
+ */
+TypeSupport create_type_support(
+        const std::string& type_name)
+{
+    using common::Topics;
+    using common::topic_type_name;
+
+    if (type_name == topic_type_name(Topics::NODE_STATUS))
+    {
+        return TypeSupport(new NodeStatusImplPubSubType());
+    }
+    else if (type_name == topic_type_name(Topics::NODE_CONTROL))
+    {
+        return TypeSupport(new NodeControlImplPubSubType());
+    }
+    else if (type_name == topic_type_name(Topics::APP_REQUIREMENT))
+    {
+        return TypeSupport(new AppRequirementsImplPubSubType());
+    }
+    else if (type_name == topic_type_name(Topics::CARBON_FOOTPRINT))
+    {
+        return TypeSupport(new CO2FootprintImplPubSubType());
+    }
+    else if (type_name == topic_type_name(Topics::HW_CONSTRAINT))
+    {
+        return TypeSupport(new HWConstraintsImplPubSubType());
+    }
+    else if (type_name == topic_type_name(Topics::HW_RESOURCE))
+    {
+        return TypeSupport(new HWResourceImplPubSubType());
+    }
+    else if (type_name == topic_type_name(Topics::ML_MODEL_METADATA))
+    {
+        return TypeSupport(new MLModelMetadataImplPubSubType());
+    }
+    else if (type_name == topic_type_name(Topics::ML_MODEL))
+    {
+        return TypeSupport(new MLModelImplPubSubType());
+    }
+    else if (type_name == topic_type_name(Topics::USER_INPUT))
+    {
+        return TypeSupport(new UserInputImplPubSubType());
+    }
+    else if (type_name == topic_type_name(Topics::NODE_METRICS))
+    {
+        return NodeMetrics::create_type_support();
+    }
+
+    return TypeSupport();
+}
+
+} // namespace
+
 std::atomic<bool> NodeImpl::terminate_(false);
 std::condition_variable NodeImpl::spin_cv_;
 
@@ -66,7 +127,7 @@ NodeImpl::NodeImpl(
         const std::string& name,
         const Options& opts)
     : node_(node)
-    , dispatcher_(new Dispatcher(node_))
+    , dispatcher_(new Dispatcher(node_, opts))
     , participant_(nullptr)
     , publisher_(nullptr)
     , subscriber_(nullptr)
@@ -103,7 +164,7 @@ NodeImpl::NodeImpl(
         const Options& opts,
         RequestReplyListener& req_res_listener)
     : node_(node)
-    , dispatcher_(new Dispatcher(node_))
+    , dispatcher_(new Dispatcher(node_, opts))
     , participant_(nullptr)
     , publisher_(nullptr)
     , subscriber_(nullptr)
@@ -122,6 +183,15 @@ NodeImpl::~NodeImpl()
 
     EPROSIMA_LOG_INFO(NODE, "Destroying Node");
 
+    if (metrics_thread_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(metrics_mtx_);
+        }
+        metrics_cv_.notify_all();
+        metrics_thread_.join();
+    }
+
     if (rpc_server_)
     {
         rpc_server_->stop();
@@ -133,7 +203,39 @@ NodeImpl::~NodeImpl()
         rpc_server_.reset();
     }
 
-    if (participant_)
+    // Readers leave the bus when their listeners are stopped
+    if (intra_process_)
+    {
+        for (DataWriter* writer : writers_)
+        {
+            IntraProcessBus::get().remove_writer(writer);
+        }
+    }
+
+    if (shared_participant_)
+    {
+        // Only the entities of this node are deleted, topics are left to the shared participant
+        shared_participant_->remove_node(node_name());
+
+        for (DataReader* reader : readers_)
+        {
+            subscriber_->delete_datareader(reader);
+        }
+
+        for (DataWriter* writer : writers_)
+        {
+            publisher_->delete_datawriter(writer);
+        }
+
+        if (metrics_writer_)
+        {
+            publisher_->delete_datawriter(metrics_writer_);
+        }
+
+        shared_participant_.reset();
+        participant_ = nullptr;
+    }
+    else if (participant_)
     {
         participant_->delete_contained_entities();
         DomainParticipantFactory::get_instance()->delete_participant(participant_);
@@ -149,39 +251,58 @@ bool NodeImpl::init(
 {
     dispatcher_->start();
 
-    auto dpf = DomainParticipantFactory::get_instance();
-
-    //! Initialize entities
-    DomainParticipantQos pqos = opts.pqos;
-    pqos.name(name);
-
-    //! Set sustainML app ID participant properties
-    pqos.properties().properties().emplace_back("fastdds.application.id", "SUSTAINML", true);
-    pqos.properties().properties().emplace_back("fastdds.application.metadata", "", true);
-
     uint32_t domain = common::parse_sustainml_env(opts.domain);
-    participant_ = dpf->create_participant(domain, pqos);
+    intra_process_ = common::parse_intra_process_env(opts.intra_process);
 
-    if (participant_ == nullptr)
+    if (common::parse_shared_participant_env(opts.shared_participant))
     {
-        return false;
-    }
+        shared_participant_ = SharedParticipant::get(domain, opts);
 
-    subscriber_ = participant_->create_subscriber(opts.subqos);
+        if (!shared_participant_)
+        {
+            return false;
+        }
 
-    if (subscriber_ == nullptr)
-    {
-        return false;
+        participant_ = shared_participant_->participant();
+        subscriber_ = shared_participant_->subscriber();
+        publisher_ = shared_participant_->publisher();
     }
+    else
+    {
+        auto dpf = DomainParticipantFactory::get_instance();
 
-    publisher_ = participant_->create_publisher(opts.pubqos);
+        //! Initialize entities
+        DomainParticipantQos pqos = opts.pqos;
+        pqos.name(name);
 
-    if (publisher_ == nullptr)
-    {
-        return false;
+        //! Set sustainML app ID participant properties
+        pqos.properties().properties().emplace_back("fastdds.application.id", "SUSTAINML", true);
+        pqos.properties().properties().emplace_back("fastdds.application.metadata", "", true);
+
+        participant_ = dpf->create_participant(domain, pqos);
+
+        if (participant_ == nullptr)
+        {
+            return false;
+        }
+
+        subscriber_ = participant_->create_subscriber(opts.subqos);
+
+        if (subscriber_ == nullptr)
+        {
+            return false;
+        }
+
+        publisher_ = participant_->create_publisher(opts.pubqos);
+
+        if (publisher_ == nullptr)
+        {
+            return false;
+        }
     }
 
     eprosima::fastdds::dds::ReplierQos rqos;
+    std::size_t rpc_threads = common::parse_rpc_server_threads_env(opts.rpc_server_threads);
 
     try
     {
@@ -197,7 +318,7 @@ bool NodeImpl::init(
                 *participant_,
                 rpc_service_name_.c_str(),
                 rqos,
-                1u,
+                rpc_threads,
                 impl);
         }
         else if (name == common::HW_CONSTRAINTS_NODE)
@@ -211,7 +332,7 @@ bool NodeImpl::init(
                 *participant_,
                 rpc_service_name_.c_str(),
                 rqos,
-                1u,
+                rpc_threads,
                 impl);
         }
         else if (name == common::HW_RESOURCES_NODE)
@@ -225,7 +346,7 @@ bool NodeImpl::init(
                 *participant_,
                 rpc_service_name_.c_str(),
                 rqos,
-                1u,
+                rpc_threads,
                 impl);
         }
         else if (name == common::CARBON_FOOTPRINT_NODE)
@@ -240,7 +361,7 @@ bool NodeImpl::init(
                 *participant_,
                 rpc_service_name_.c_str(),
                 rqos,
-                1u,
+                rpc_threads,
                 impl);
         }
         else if (name == common::ML_MODEL_METADATA_NODE)
@@ -255,7 +376,7 @@ bool NodeImpl::init(
                 *participant_,
                 rpc_service_name_.c_str(),
                 rqos,
-                1u,
+                rpc_threads,
                 impl);
         }
         else if (name == common::ML_MODEL_NODE)
@@ -269,7 +390,7 @@ bool NodeImpl::init(
                 *participant_,
                 rpc_service_name_.c_str(),
                 rqos,
-                1u,
+                rpc_threads,
                 impl);
         }
         else
@@ -311,41 +432,58 @@ bool NodeImpl::init(
     //           << name
     //           << "' with service '" << rpc_service_name_ << "'" << std::endl;
 
-    // Register Common Types
-
-    std::vector<eprosima::fastdds::dds::TypeSupport> sustainml_types;
-    sustainml_types.reserve(common::Topics::MAX);
-
-    sustainml_types.push_back(static_cast<TypeSupport>(new NodeStatusImplPubSubType()));
-    sustainml_types.push_back(static_cast<TypeSupport>(new NodeControlImplPubSubType()));
-    sustainml_types.push_back(static_cast<TypeSupport>(new AppRequirementsImplPubSubType()));
-    sustainml_types.push_back(static_cast<TypeSupport>(new CO2FootprintImplPubSubType()));
-    sustainml_types.push_back(static_cast<TypeSupport>(new HWConstraintsImplPubSubType()));
-    sustainml_types.push_back(static_cast<TypeSupport>(new HWResourceImplPubSubType()));
-    sustainml_types.push_back(static_cast<TypeSupport>(new MLModelMetadataImplPubSubType()));
-    sustainml_types.push_back(static_cast<TypeSupport>(new MLModelImplPubSubType()));
-    sustainml_types.push_back(static_cast<TypeSupport>(new UserInputImplPubSubType()));
-
-    for (auto&& type : sustainml_types)
-    {
-        participant_->register_type(type);
-    }
+    // Types are registered as their topics are created
 
     //! Initialize common topics
-    initialize_subscription(common::TopicCollection::get()[common::Topics::NODE_CONTROL].first.c_str(),
-            common::TopicCollection::get()[common::Topics::NODE_CONTROL].second.c_str(),
+    initialize_subscription(common::topic_name(common::Topics::NODE_CONTROL),
+            common::topic_type_name(common::Topics::NODE_CONTROL),
             &control_listener_, opts);
 
-    initialize_publication(common::TopicCollection::get()[common::Topics::NODE_STATUS].first.c_str(),
-            common::TopicCollection::get()[common::Topics::NODE_STATUS].second.c_str(),
+    initialize_publication(common::topic_name(common::Topics::NODE_STATUS),
+            common::topic_type_name(common::Topics::NODE_STATUS),
             opts);
 
     //! Initialize node
-    node_status_.node_name(name);
-    node_status_.node_status(Status::NODE_INITIALIZING);
+    {
+        std::lock_guard<std::mutex> lock(status_mtx_);
+        node_status_.node_name(name);
+    }
+
+    if (shared_participant_)
+    {
+        shared_participant_->add_node(name);
+    }
 
+    node_status(Status::NODE_INITIALIZING);
     publish_node_status();
 
+    std::chrono::milliseconds metrics_period = common::parse_metrics_period_env(opts.metrics_period);
+
+    if (metrics_period.count() > 0)
+    {
+        Topic* metrics_topic = find_or_create_topic(common::topic_name(common::Topics::NODE_METRICS),
+                        common::topic_type_name(common::Topics::NODE_METRICS));
+
+        if (metrics_topic != nullptr)
+        {
+            metrics_writer_ = publisher_->create_datawriter(metrics_topic, DATAWRITER_QOS_DEFAULT);
+        }
+
+        if (metrics_writer_ == nullptr)
+        {
+            EPROSIMA_LOG_ERROR(NODE, "Could not create the metrics writer of node '" << name << "'");
+        }
+        else
+        {
+            topics_.emplace_back(metrics_topic);
+
+            metrics_thread_ = std::thread([this, metrics_period]()
+                            {
+                                metrics_routine(metrics_period);
+                            });
+        }
+    }
+
     return true;
 }
 
@@ -353,7 +491,7 @@ void NodeImpl::spin()
 {
     EPROSIMA_LOG_INFO(NODE, "Spinning Node... ");
 
-    node_status_.node_status(Status::NODE_IDLE);
+    node_status(Status::NODE_IDLE);
     publish_node_status();
 
     std::unique_lock<std::mutex> lock(spin_mtx_);
@@ -369,7 +507,7 @@ bool NodeImpl::initialize_subscription(
         eprosima::fastdds::dds::DataReaderListener* listener,
         const Options& opts)
 {
-    Topic* topic = participant_->create_topic(topic_name, type_name, TOPIC_QOS_DEFAULT);
+    Topic* topic = find_or_create_topic(topic_name, type_name);
 
     if (topic == nullptr)
     {
@@ -383,6 +521,14 @@ bool NodeImpl::initialize_subscription(
         return false;
     }
 
+    if (intra_process_)
+    {
+        if (auto endpoint = dynamic_cast<interfaces::IntraProcessReader*>(listener))
+        {
+            IntraProcessBus::get().add_reader(reader, endpoint);
+        }
+    }
+
     topics_.emplace_back(topic);
     readers_.emplace_back(reader);
 
@@ -394,7 +540,7 @@ bool NodeImpl::initialize_publication(
         const char* type_name,
         const Options& opts)
 {
-    Topic* topic = participant_->create_topic(topic_name, type_name, TOPIC_QOS_DEFAULT);
+    Topic* topic = find_or_create_topic(topic_name, type_name);
 
     if (topic == nullptr)
     {
@@ -408,13 +554,55 @@ bool NodeImpl::initialize_publication(
         return false;
     }
 
+    if (intra_process_)
+    {
+        IntraProcessBus::get().add_writer(writer);
+    }
+
     topics_.emplace_back(topic);
     writers_.emplace_back(writer);
 
     return true;
 }
 
+Topic* NodeImpl::find_or_create_topic(
+        const char* topic_name,
+        const char* type_name)
+{
+    std::unique_lock<std::mutex> lock;
+
+    if (shared_participant_)
+    {
+        lock = std::unique_lock<std::mutex>(shared_participant_->mutex());
+    }
+
+    if (participant_->find_type(type_name).empty())
+    {
+        TypeSupport type = create_type_support(type_name);
+
+        if (type.empty() || RETCODE_OK != participant_->register_type(type))
+        {
+            EPROSIMA_LOG_ERROR(NODE, "Could not register type " << type_name);
+            return nullptr;
+        }
+    }
+
+    // Other nodes in the shared participant may have already created it
+    if (TopicDescription* description = participant_->lookup_topicdescription(topic_name))
+    {
+        return dynamic_cast<Topic*>(description);
+    }
+
+    return participant_->create_topic(topic_name, type_name, TOPIC_QOS_DEFAULT);
+}
+
 void NodeImpl::publish_node_status()
+{
+    std::lock_guard<std::mutex> lock(status_mtx_);
+    publish_node_status_nts();
+}
+
+void NodeImpl::publish_node_status_nts()
 {
     if (!writers_.empty())
     {
@@ -422,6 +610,87 @@ void NodeImpl::publish_node_status()
     }
 }
 
+void NodeImpl::metrics_routine(
+        std::chrono::milliseconds period)
+{
+    std::unique_lock<std::mutex> lock(metrics_mtx_);
+
+    while (!metrics_cv_.wait_for(lock, period, [this]
+            {
+                return shutting_down();
+            }))
+    {
+        publish_metrics();
+    }
+}
+
+void NodeImpl::publish_metrics()
+{
+    NodeMetrics::QueueOccupancy occupancy;
+    dispatcher_->queue_occupancy(occupancy);
+
+    if (!dispatcher_->metrics().publish(metrics_writer_, node_name(), occupancy))
+    {
+        EPROSIMA_LOG_WARNING(NODE, "Could not publish the metrics of node '" << node_name() << "'");
+    }
+}
+
+void NodeImpl::node_status(
+        const Status& status)
+{
+    std::lock_guard<std::mutex> lock(status_mtx_);
+    node_status_.node_status(status);
+}
+
+void NodeImpl::task_started(
+        const types::TaskId& task_id)
+{
+    std::lock_guard<std::mutex> lock(status_mtx_);
+
+    if (dispatcher_->metrics().enabled())
+    {
+        task_start_times_[common::task_id_to_key(task_id)] = std::chrono::steady_clock::now();
+    }
+
+    if (task_statuses_.start_nts(task_id))
+    {
+        node_status_.node_status(Status::NODE_RUNNING);
+        node_status_.task_status(TaskStatus::TASK_RUNNING);
+        publish_node_status_nts();
+    }
+}
+
+void NodeImpl::task_finished(
+        const types::TaskId& task_id,
+        bool error)
+{
+    std::lock_guard<std::mutex> lock(status_mtx_);
+
+    Status status = Status::NODE_IDLE;
+
+    auto start_time = task_start_times_.find(common::task_id_to_key(task_id));
+
+    if (start_time != task_start_times_.end())
+    {
+        dispatcher_->metrics().record_since(NodeMetrics::USER_CALLBACK, start_time->second);
+        task_start_times_.erase(start_time);
+    }
+
+    if (task_statuses_.finish_nts(task_id, error, status))
+    {
+        node_status_.node_status(status);
+        node_status_.task_status(task_statuses_.status_nts(task_id));
+        publish_node_status_nts();
+    }
+}
+
+TaskStatus NodeImpl::task_status(
+        const types::TaskId& task_id)
+{
+    std::lock_guard<std::mutex> lock(status_mtx_);
+    return task_statuses_.status_nts(task_id);
+}
+
 void NodeImpl::terminate()
 {
     terminate_.store(true);
@@ -24,8 +24,11 @@
 #include <core/Options.hpp>
 #include <core/RequestReplyListener.hpp>
 #include <types/typesImplPubSubTypes.hpp>
+#include <utils/TaskStatusTracker.hpp>
 
+#include <chrono>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <memory>
@@ -65,6 +68,7 @@ namespace core {
 
 class Dispatcher;
 class Node;
+class SharedParticipant;
 struct Options;
 
 /**
@@ -162,11 +166,58 @@ protected:
             const char* type_name,
             const Options& opts);
 
+    /**
+     * @brief Returns the topic with the given name, creating it and registering
+     * its type if they do not exist yet in the participant.
+     *
+     * @param topic_name The topic name
+     * @param type_name The type name
+     * @return nullptr on failure.
+     */
+    eprosima::fastdds::dds::Topic* find_or_create_topic(
+            const char* topic_name,
+            const char* type_name);
+
     /**
      * @brief Publishes the internal status of the node to DDS.
      */
     void publish_node_status();
 
+    /**
+     * @brief Sets the status of the node.
+     */
+    void node_status(
+            const Status& status);
+
+    /**
+     * @brief Records that a task has started running. The node status is
+     * only published if the node was not running any other task.
+     */
+    void task_started(
+            const types::TaskId& task_id);
+
+    /**
+     * @brief Records that a task has finished. The node status is only
+     * published if it was the last task in flight.
+     */
+    void task_finished(
+            const types::TaskId& task_id,
+            bool error);
+
+    /**
+     * @brief Returns the status of a task, TASK_WAITING if it is unknown.
+     */
+    TaskStatus task_status(
+            const types::TaskId& task_id);
+
+    void publish_node_status_nts();
+
+    /**
+     * @brief Publishes the latencies recorded by the node and the
+     * occupancy of its queues on the metrics topic.
+     */
+    void publish_metrics();
+
     Node* node_;
 
     std::shared_ptr<Dispatcher> dispatcher_;
@@ -177,6 +228,13 @@ protected:
 
     eprosima::fastdds::dds::Subscriber* subscriber_;
 
+    //! Only set if Options::shared_participant is enabled.
+    //! Owns participant_, publisher_ and subscriber_ in that case
+    std::shared_ptr<SharedParticipant> shared_participant_;
+
+    //! Whether the readers and writers take part in the IntraProcessBus
+    bool intra_process_{false};
+
     std::vector<eprosima::fastdds::dds::Topic*> topics_;
 
     // Status writer is always the first
@@ -192,6 +250,25 @@ protected:
 
     NodeStatusImpl node_status_;
 
+    //! Status of the tasks in flight and of the last finished ones
+    utils::TaskStatusTracker task_statuses_;
+
+    //! Start time of the tasks in flight, only kept if metrics are enabled
+    std::unordered_map<uint64_t, std::chrono::steady_clock::time_point> task_start_times_;
+
+    //! Guards node_status_, task_statuses_ and task_start_times_
+    std::mutex status_mtx_;
+
+    //! Not in writers_, so that the indexes of the node writers are kept
+    eprosima::fastdds::dds::DataWriter* metrics_writer_{nullptr};
+
+    //! Publishes the metrics every Options::metrics_period
+    std::thread metrics_thread_;
+
+    std::mutex metrics_mtx_;
+
+    std::condition_variable metrics_cv_;
+
     std::shared_ptr<eprosima::fastdds::dds::rpc::RpcServer> rpc_server_;
 
     std::shared_ptr<void> rpc_impl_;
@@ -221,7 +298,14 @@ private:
             const std::string& name,
             const Options& opts = Options());
 
-    // RPC over DDS server background thread
+    /**
+     * @brief Publishes the metrics every period until the node is destroyed.
+     */
+    void metrics_routine(
+            std::chrono::milliseconds period);
+
+    // RPC over DDS server background thread, which takes the requests and
+    // hands them to the Options::rpc_server_threads workers of rpc_server_
     std::thread rpc_server_thread_;
 
     class NodeControlListener : public eprosima::fastdds::dds::DataReaderListener
@@ -16,11 +16,20 @@
  * @file NodeListener.cpp
  */
 
+#include <fastdds/dds/core/LoanableSequence.hpp>
+#include <fastdds/dds/core/Time_t.hpp>
 #include <fastdds/dds/subscriber/DataReader.hpp>
 #include <fastdds/dds/subscriber/SampleInfo.hpp>
 
 #include <core/Dispatcher.hpp>
+#include <core/IntraProcessBus.hpp>
 #include <core/NodeListener.hpp>
+#include <types/typesImpl.hpp>
+#include <utils/SharedPayloadStore.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 namespace sustainml {
 namespace core {
@@ -28,11 +37,24 @@ namespace core {
 template <typename T>
 NodeListener<T>::NodeListener(
         Node* node,
-        interfaces::QueueQueryable<T>* qq)
+        interfaces::QueueQueryable<T>* qq,
+        const Options& opts)
     : node_(node)
     , queue_queryable_(qq)
+    , batch_size_(std::max<std::size_t>(opts.listener_batch_size, 1))
+    , shared_payloads_(opts.shared_payloads)
+    , data_(static_cast<eprosima::fastdds::dds::LoanableCollection::size_type>(batch_size_))
+    , infos_(static_cast<eprosima::fastdds::dds::LoanableCollection::size_type>(batch_size_))
     , stop_ (false)
+    , stalled_reader_(nullptr)
+    , max_pending_samples_(history_depth(opts))
+    , inserting_pending_(false)
+    , pending_resumed_(false)
+    , has_pending_(false)
+    , resume_target_(std::make_shared<ResumeTarget>())
+    , resume_posted_(false)
 {
+    resume_target_->listener = this;
 
 }
 
@@ -46,56 +68,354 @@ template <typename T>
 void NodeListener<T>::stop()
 {
     stop_.store(true);
+    IntraProcessBus::get().remove_reader(this);
+
+    //! Waits for a resume job running on the listener
+    std::lock_guard<std::mutex> lock(resume_target_->mtx);
+    resume_target_->listener = nullptr;
 }
 
 template <typename T>
-void NodeListener<T>::on_data_available(
-        eprosima::fastdds::dds::DataReader* reader)
+void NodeListener<T>::resume()
 {
-    eprosima::fastdds::dds::SampleInfo info;
+    eprosima::fastdds::dds::DataReader* reader = stalled_reader_.exchange(nullptr);
 
-    SamplesQueue<T>* queue = queue_queryable_->get_queue();
+    if (nullptr != reader && !stop_.load(std::memory_order_relaxed))
+    {
+        EPROSIMA_LOG_INFO(NODE_LISTENER, node_->name() << " Resuming the reception of samples");
+        on_data_available(reader);
+    }
+
+    insert_pending_samples();
+}
+
+template <typename T>
+void NodeListener<T>::request_resume()
+{
+    //! A listener stalling concurrently retries by itself, see get_new_cache_or_stall and on_intra_process_sample
+    if ((nullptr == stalled_reader_.load() && !has_pending_.load()) || resume_posted_.exchange(true))
+    {
+        return;
+    }
+
+    std::shared_ptr<Dispatcher> dispatcher = node_->get_dispatcher().lock();
+    std::shared_ptr<ResumeTarget> target = resume_target_;
+
+    auto job = [target]()
+            {
+                std::lock_guard<std::mutex> lock(target->mtx);
+
+                if (nullptr != target->listener)
+                {
+                    //! Releases from now on post a new job
+                    target->listener->resume_posted_.store(false);
+                    target->listener->resume();
+                }
+            };
 
+    if (!dispatcher || !dispatcher->post_to_listener_thread(job))
+    {
+        resume_posted_.store(false);
+    }
+}
+
+template <typename T>
+T* NodeListener<T>::get_new_cache_or_stall(
+        eprosima::fastdds::dds::DataReader* reader,
+        SamplesQueue<T>* queue)
+{
     T* data_cache = queue->get_new_cache();
 
-    if (nullptr == data_cache)
+    if (nullptr != data_cache)
+    {
+        return data_cache;
+    }
+
+    EPROSIMA_LOG_WARNING(NODE_LISTENER,
+            node_->name() << " Queue is full. Samples are kept in the DataReader until a cache is released");
+    stalled_reader_.store(reader);
+
+    //! A cache may have been released before the reader was recorded
+    data_cache = queue->get_new_cache();
+
+    if (nullptr != data_cache && nullptr == stalled_reader_.exchange(nullptr))
+    {
+        //! A concurrent release already resumed the reception
+        queue->release_cache(data_cache);
+        data_cache = nullptr;
+    }
+
+    return data_cache;
+}
+
+template <typename T>
+void NodeListener<T>::on_data_available(
+        eprosima::fastdds::dds::DataReader* reader)
+{
+    SamplesQueue<T>* queue = queue_queryable_->get_queue();
+    std::shared_ptr<Dispatcher> dispatcher = node_->get_dispatcher().lock();
+
+    if (!dispatcher)
     {
-        EPROSIMA_LOG_ERROR(NODE_LISTENER, node_->name() << " Could not get a new cache. Queue is full");
         return;
     }
 
+    NodeMetrics& metrics = dispatcher->metrics();
+
+    //! data_ and infos_ own their buffers, so that take() deserializes straight into them
+    std::lock_guard<std::mutex> take_lock(take_mtx_);
+
+    std::vector<T*> free_caches;
+    std::vector<T*> received;
+    std::vector<types::TaskId> new_tasks;
+    free_caches.reserve(batch_size_);
+    received.reserve(batch_size_);
+    new_tasks.reserve(batch_size_);
+
     while (!stop_.load(std::memory_order_relaxed))
     {
-        if (reader->take_next_sample(data_cache->get_impl(),
-                &info) == eprosima::fastdds::dds::RETCODE_OK)
+        //! Every sample taken needs a cache, so never take more samples than caches we hold
+        while (free_caches.size() < batch_size_)
         {
-            if (info.instance_state == eprosima::fastdds::dds::ALIVE_INSTANCE_STATE)
+            T* data_cache = free_caches.empty() ?
+                    get_new_cache_or_stall(reader, queue) : queue->get_new_cache();
+
+            if (nullptr == data_cache)
             {
-                // Print your structure data here.
+                break;
+            }
+
+            free_caches.push_back(data_cache);
+        }
+
+        if (free_caches.empty() ||
+                reader->take(data_, infos_, static_cast<int32_t>(free_caches.size())) !=
+                eprosima::fastdds::dds::RETCODE_OK)
+        {
+            break;
+        }
+
+        eprosima::fastdds::dds::Time_t taken_at;
+
+        if (metrics.enabled())
+        {
+            eprosima::fastdds::dds::Time_t::now(taken_at);
+        }
+
+        for (eprosima::fastdds::dds::LoanableCollection::size_type i = 0; i < infos_.length(); ++i)
+        {
+            if (infos_[i].valid_data &&
+                    infos_[i].instance_state == eprosima::fastdds::dds::ALIVE_INSTANCE_STATE &&
+                    !IntraProcessBus::get().is_duplicate(this, infos_[i]))
+            {
+                T* data_cache = free_caches.back();
+                free_caches.pop_back();
+
+                if (metrics.enabled())
+                {
+                    metrics.record(NodeMetrics::RECEIVE,
+                            std::chrono::nanoseconds(taken_at.to_ns() - infos_[i].reception_timestamp.to_ns()));
+                }
+
+                *data_cache->get_impl() = std::move(data_[i]);
+
+                if (shared_payloads_)
+                {
+                    utils::import_shared_payloads(*data_cache);
+                }
+
                 EPROSIMA_LOG_INFO(NODE_LISTENER,
                         node_->name() << " Message with task_id: " << data_cache->task_id() << " in " << reader->guid() <<
                         " RECEIVED");
-                queue->insert_element(data_cache);
+                received.push_back(data_cache);
+            }
+        }
 
-                // notify dispatcher
-                if (auto dispatcher = node_->get_dispatcher().lock())
-                {
-                    dispatcher->notify(data_cache->task_id());
-                }
+        //! A loan goes back to the reader, owned buffers are kept for the next take
+        if (!data_.has_ownership())
+        {
+            reader->return_loan(data_, infos_);
+        }
 
-                //! We need to use a new one in case there are more samples
-                data_cache = queue->get_new_cache();
+        data_.length(0);
+        infos_.length(0);
+
+        auto insert_start = metrics.now();
+        queue->insert_elements(received, new_tasks);
+        metrics.record_since(NodeMetrics::QUEUE_INSERT, insert_start);
+        received.clear();
+
+        if (!new_tasks.empty())
+        {
+            // notify dispatcher
+            dispatcher->notify(new_tasks, queue->get_id());
+            new_tasks.clear();
+        }
+    }
 
-                if (nullptr == data_cache)
+    for (T* data_cache : free_caches)
+    {
+        queue->release_cache(data_cache);
+    }
+}
+
+template <typename T>
+void NodeListener<T>::on_intra_process_sample(
+        const std::shared_ptr<const void>& sample)
+{
+    if (stop_.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    impl_ptr typed_sample = std::static_pointer_cast<const typename T::impl_type>(sample);
+
+    {
+        std::lock_guard<std::mutex> lock(pending_mtx_);
+
+        //! Keep the order of the samples waiting for a cache
+        if (!pending_samples_.empty())
+        {
+            push_pending_sample_nts(typed_sample);
+            return;
+        }
+    }
+
+    if (insert_intra_process_sample(queue_queryable_->get_queue(), typed_sample))
+    {
+        return;
+    }
+
+    EPROSIMA_LOG_WARNING(NODE_LISTENER,
+            node_->name() << " Queue is full. Intra-process samples are kept until a cache is released");
+
+    {
+        std::lock_guard<std::mutex> lock(pending_mtx_);
+        push_pending_sample_nts(typed_sample);
+    }
+
+    //! A cache may have been released before the sample was kept
+    insert_pending_samples();
+}
+
+template <typename T>
+bool NodeListener<T>::insert_intra_process_sample(
+        SamplesQueue<T>* queue,
+        const impl_ptr& sample)
+{
+    T* data_cache = queue->get_new_cache();
+
+    if (nullptr == data_cache)
+    {
+        return false;
+    }
+
+    *data_cache->get_impl() = *sample;
+
+    if (shared_payloads_)
+    {
+        utils::import_shared_payloads(*data_cache);
+    }
+
+    EPROSIMA_LOG_INFO(NODE_LISTENER,
+            node_->name() << " Message with task_id: " << data_cache->task_id() << " RECEIVED intra-process");
+
+    std::shared_ptr<Dispatcher> dispatcher = node_->get_dispatcher().lock();
+
+    if (!dispatcher)
+    {
+        queue->release_cache(data_cache);
+        return true;
+    }
+
+    std::vector<types::TaskId> new_tasks;
+    auto insert_start = dispatcher->metrics().now();
+    queue->insert_elements({data_cache}, new_tasks);
+    dispatcher->metrics().record_since(NodeMetrics::QUEUE_INSERT, insert_start);
+
+    if (!new_tasks.empty())
+    {
+        dispatcher->notify(new_tasks, queue->get_id());
+    }
+
+    return true;
+}
+
+template <typename T>
+std::size_t NodeListener<T>::history_depth(
+        const Options& opts)
+{
+    const eprosima::fastdds::dds::DataReaderQos& qos = opts.rqos;
+    bool keep_last = eprosima::fastdds::dds::KEEP_LAST_HISTORY_QOS == qos.history().kind;
+    int32_t depth = keep_last ? qos.history().depth : qos.resource_limits().max_samples;
+
+    //! Unlimited resources do not bound the reader either
+    if (depth <= 0)
+    {
+        return keep_last ? 1 : std::numeric_limits<std::size_t>::max();
+    }
+
+    return static_cast<std::size_t>(depth);
+}
+
+template <typename T>
+void NodeListener<T>::push_pending_sample_nts(
+        const impl_ptr& sample)
+{
+    pending_samples_.push_back(sample);
+    has_pending_.store(true);
+
+    if (pending_samples_.size() > max_pending_samples_)
+    {
+        EPROSIMA_LOG_WARNING(NODE_LISTENER,
+                node_->name() << " Discarding the oldest intra-process sample, the reader history is full");
+        pending_samples_.pop_front();
+    }
+}
+
+template <typename T>
+void NodeListener<T>::insert_pending_samples()
+{
+    pending_resumed_.store(true);
+
+    //! Inserting a sample may release a cache and get back here, only one thread inserts them
+    while (!inserting_pending_.exchange(true))
+    {
+        pending_resumed_.store(false);
+
+        SamplesQueue<T>* queue = queue_queryable_->get_queue();
+
+        while (!stop_.load(std::memory_order_relaxed))
+        {
+            impl_ptr sample;
+
+            {
+                std::lock_guard<std::mutex> lock(pending_mtx_);
+
+                if (pending_samples_.empty())
                 {
-                    EPROSIMA_LOG_ERROR(NODE_LISTENER, node_->name() << " Could not get a new cache. Queue is full");
                     break;
                 }
+
+                sample = pending_samples_.front();
+                pending_samples_.pop_front();
+                has_pending_.store(!pending_samples_.empty());
+            }
+
+            if (!insert_intra_process_sample(queue, sample))
+            {
+                std::lock_guard<std::mutex> lock(pending_mtx_);
+                pending_samples_.push_front(sample);
+                has_pending_.store(true);
+                break;
             }
         }
-        else
+
+        inserting_pending_.store(false);
+
+        //! Retry if a cache was released after the last attempt
+        if (!pending_resumed_.load())
         {
-            queue->release_cache(data_cache);
             break;
         }
     }
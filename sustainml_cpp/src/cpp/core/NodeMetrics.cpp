@@ -0,0 +1,192 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file NodeMetrics.cpp
+ */
+
+#include <core/NodeMetrics.hpp>
+
+#include <fastdds/dds/core/policy/QosPolicies.hpp>
+#include <fastdds/dds/log/Log.hpp>
+#include <fastdds/dds/publisher/DataWriter.hpp>
+#include <fastdds/dds/topic/TypeSupport.hpp>
+#include <fastdds/dds/xtypes/dynamic_types/DynamicData.hpp>
+#include <fastdds/dds/xtypes/dynamic_types/DynamicDataFactory.hpp>
+#include <fastdds/dds/xtypes/dynamic_types/DynamicPubSubType.hpp>
+#include <fastdds/dds/xtypes/dynamic_types/DynamicType.hpp>
+#include <fastdds/dds/xtypes/dynamic_types/DynamicTypeBuilder.hpp>
+#include <fastdds/dds/xtypes/dynamic_types/DynamicTypeBuilderFactory.hpp>
+#include <fastdds/dds/xtypes/dynamic_types/MemberDescriptor.hpp>
+#include <fastdds/dds/xtypes/dynamic_types/TypeDescriptor.hpp>
+#include <fastdds/dds/xtypes/dynamic_types/Types.hpp>
+
+#include <common/Common.hpp>
+
+#include <vector>
+
+using namespace eprosima::fastdds::dds;
+
+namespace sustainml {
+namespace core {
+
+namespace {
+
+/**
+ * @brief Builds the type of the metrics topic:
+ *
+ * struct NodeMetricsImpl
+ * {
+ *     @key string node_name;
+ *     sequence<string> stages;
+ *     sequence<uint64> count;
+ *     sequence<uint64> p50_ns;
+ *     sequence<uint64> p99_ns;
+ *     sequence<uint64> max_ns;
+ *     uint64 queued_samples;
+ *     uint64 pool_in_use;
+ *     uint64 pool_capacity;
+ * };
+ *
+ * The latency sequences are indexed as stages.
+ */
+DynamicType::_ref_type build_metrics_type()
+{
+    DynamicTypeBuilderFactory::_ref_type factory = DynamicTypeBuilderFactory::get_instance();
+
+    TypeDescriptor::_ref_type type_descriptor {traits<TypeDescriptor>::make_shared()};
+    type_descriptor->kind(TK_STRUCTURE);
+    type_descriptor->name(common::topic_type_name(common::Topics::NODE_METRICS));
+    DynamicTypeBuilder::_ref_type builder = factory->create_type(type_descriptor);
+
+    DynamicType::_ref_type string_type =
+            factory->create_string_type(static_cast<uint32_t>(LENGTH_UNLIMITED))->build();
+    DynamicType::_ref_type uint64_type = factory->get_primitive_type(TK_UINT64);
+    DynamicType::_ref_type strings_type =
+            factory->create_sequence_type(string_type, static_cast<uint32_t>(LENGTH_UNLIMITED))->build();
+    DynamicType::_ref_type uint64s_type =
+            factory->create_sequence_type(uint64_type, static_cast<uint32_t>(LENGTH_UNLIMITED))->build();
+
+    auto add_member = [&builder](const char* name, const DynamicType::_ref_type& type, bool is_key)
+            {
+                MemberDescriptor::_ref_type member {traits<MemberDescriptor>::make_shared()};
+                member->name(name);
+                member->type(type);
+                member->is_key(is_key);
+                builder->add_member(member);
+            };
+
+    add_member("node_name", string_type, true);
+    add_member("stages", strings_type, false);
+    add_member("count", uint64s_type, false);
+    add_member("p50_ns", uint64s_type, false);
+    add_member("p99_ns", uint64s_type, false);
+    add_member("max_ns", uint64s_type, false);
+    add_member("queued_samples", uint64_type, false);
+    add_member("pool_in_use", uint64_type, false);
+    add_member("pool_capacity", uint64_type, false);
+
+    return builder->build();
+}
+
+//! Every node of the process shares the same type
+const DynamicType::_ref_type& metrics_type()
+{
+    static const DynamicType::_ref_type type = build_metrics_type();
+    return type;
+}
+
+} // namespace
+
+NodeMetrics::NodeMetrics(
+        bool enabled)
+    : enabled_(enabled)
+{
+}
+
+const char* NodeMetrics::stage_name(
+        Stage stage)
+{
+    switch (stage)
+    {
+        case RECEIVE:
+            return "receive";
+        case QUEUE_INSERT:
+            return "queue_insert";
+        case DISPATCH:
+            return "dispatch";
+        case USER_CALLBACK:
+            return "user_callback";
+        case OUTPUT_WRITE:
+            return "output_write";
+        default:
+            return "";
+    }
+}
+
+TypeSupport NodeMetrics::create_type_support()
+{
+    return TypeSupport(new DynamicPubSubType(metrics_type()));
+}
+
+bool NodeMetrics::publish(
+        DataWriter* writer,
+        const std::string& node_name,
+        const QueueOccupancy& occupancy)
+{
+    StringSeq stages;
+    UInt64Seq count;
+    UInt64Seq p50;
+    UInt64Seq p99;
+    UInt64Seq max;
+
+    {
+        std::lock_guard<std::mutex> lock(publish_mtx_);
+        latencies_.collect(collected_);
+
+        for (std::size_t i = 0; i < MAX_STAGE; ++i)
+        {
+            stages.push_back(stage_name(static_cast<Stage>(i)));
+            count.push_back(collected_[i].count());
+            p50.push_back(collected_[i].percentile(0.5));
+            p99.push_back(collected_[i].percentile(0.99));
+            max.push_back(collected_[i].max());
+        }
+    }
+
+    DynamicData::_ref_type data = DynamicDataFactory::get_instance()->create_data(metrics_type());
+
+    if (!data ||
+            RETCODE_OK != data->set_string_value(data->get_member_id_by_name("node_name"), node_name) ||
+            RETCODE_OK != data->set_string_values(data->get_member_id_by_name("stages"), stages) ||
+            RETCODE_OK != data->set_uint64_values(data->get_member_id_by_name("count"), count) ||
+            RETCODE_OK != data->set_uint64_values(data->get_member_id_by_name("p50_ns"), p50) ||
+            RETCODE_OK != data->set_uint64_values(data->get_member_id_by_name("p99_ns"), p99) ||
+            RETCODE_OK != data->set_uint64_values(data->get_member_id_by_name("max_ns"), max) ||
+            RETCODE_OK != data->set_uint64_value(data->get_member_id_by_name("queued_samples"),
+            occupancy.queued_samples) ||
+            RETCODE_OK != data->set_uint64_value(data->get_member_id_by_name("pool_in_use"),
+            occupancy.pool_in_use) ||
+            RETCODE_OK != data->set_uint64_value(data->get_member_id_by_name("pool_capacity"),
+            occupancy.pool_capacity))
+    {
+        EPROSIMA_LOG_ERROR(NODE_METRICS, node_name << " Could not fill the metrics sample");
+        return false;
+    }
+
+    return RETCODE_OK == writer->write(&data);
+}
+
+} // namespace core
+} // namespace sustainml
@@ -0,0 +1,171 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file NodeMetrics.hpp
+ */
+
+#ifndef SUSTAINMLCPP_CORE_NODEMETRICS_HPP
+#define SUSTAINMLCPP_CORE_NODEMETRICS_HPP
+
+#include <utils/LatencyHistogram.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace eprosima {
+namespace fastdds {
+namespace dds {
+
+class DataWriter;
+class TypeSupport;
+
+} // namespace dds
+} // namespace fastdds
+} // namespace eprosima
+
+namespace sustainml {
+namespace core {
+
+/**
+ * @brief Latencies of the stages a task goes through in a node, from the
+ * reception of its samples to the write of its output.
+ *
+ * Latencies are recorded in per-thread histograms, and periodically published
+ * on the metrics topic together with the occupancy of the queues of the node.
+ * Nothing is recorded unless enabled, see Options::metrics_period.
+ *
+ * Thread safe.
+ */
+class NodeMetrics
+{
+
+public:
+
+    enum Stage
+    {
+        //! From the reception of a sample by the DataReader until it is taken
+        RECEIVE,
+        //! Insertion of the samples taken in their queue
+        QUEUE_INSERT,
+        //! From the sample that completes a task until the task is handed to the node
+        DISPATCH,
+        //! From the start of a task until its completion by the user
+        USER_CALLBACK,
+        //! Write of the output of a task
+        OUTPUT_WRITE,
+        MAX_STAGE
+    };
+
+    //! Samples held by the queues of a node
+    struct QueueOccupancy
+    {
+        //! Samples stored in the queues
+        uint64_t queued_samples{0};
+        //! Caches taken from the pools of the queues
+        uint64_t pool_in_use{0};
+        //! Caches allocated by the pools of the queues
+        uint64_t pool_capacity{0};
+    };
+
+    explicit NodeMetrics(
+            bool enabled);
+
+    inline bool enabled() const
+    {
+        return enabled_;
+    }
+
+    /**
+     * @brief Current time to start measuring a stage with. The clock is
+     * not read if disabled.
+     */
+    inline std::chrono::steady_clock::time_point now() const
+    {
+        return enabled_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    }
+
+    /**
+     * @brief Records the latency of a stage. No-op if disabled.
+     */
+    inline void record(
+            Stage stage,
+            std::chrono::nanoseconds latency)
+    {
+        if (enabled_)
+        {
+            latencies_.record(stage, static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0)));
+        }
+    }
+
+    /**
+     * @brief Records the time elapsed since start as the latency of a stage.
+     * No-op if disabled.
+     */
+    inline void record_since(
+            Stage stage,
+            const std::chrono::steady_clock::time_point& start)
+    {
+        if (enabled_)
+        {
+            record(stage, std::chrono::steady_clock::now() - start);
+        }
+    }
+
+    /**
+     * @brief Writes the latencies recorded since the last publication,
+     * and starts recording them anew.
+     *
+     * @param writer DataWriter of the metrics topic
+     * @param node_name Name of the node, key of the sample
+     * @param occupancy Current occupancy of the queues of the node
+     * @return false if the sample could not be written.
+     */
+    bool publish(
+            eprosima::fastdds::dds::DataWriter* writer,
+            const std::string& node_name,
+            const QueueOccupancy& occupancy);
+
+    /**
+     * @brief Name of a stage in the metrics topic.
+     */
+    static const char* stage_name(
+            Stage stage);
+
+    /**
+     * @brief Creates the TypeSupport of the metrics topic.
+     */
+    static eprosima::fastdds::dds::TypeSupport create_type_support();
+
+private:
+
+    const bool enabled_;
+
+    utils::PerThreadHistograms<MAX_STAGE> latencies_;
+
+    //! Guards collected_, merged from latencies_ on every publication
+    std::mutex publish_mtx_;
+
+    std::array<utils::LatencyHistogram, MAX_STAGE> collected_;
+};
+
+} // namespace core
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_CORE_NODEMETRICS_HPP
@@ -25,9 +25,24 @@
 #include <fastdds/dds/subscriber/qos/DataReaderQos.hpp>
 #include <fastdds/dds/subscriber/qos/SubscriberQos.hpp>
 
+#include <chrono>
+#include <string>
+#include <thread>
+
 namespace sustainml {
 namespace core {
 
+/**
+ * @brief Action taken when a queue receives a sample of a task it already holds.
+ */
+enum class DuplicateTaskPolicy
+{
+    //! Keep the stored sample and discard the new one
+    DISCARD_NEW,
+    //! Replace the stored sample if it has not been retrieved yet, discard the new one otherwise
+    REPLACE_PENDING
+};
+
 /**
  * @brief Options structure to define Node entities QoS (Participant, Subscriber, Publisher, DataWriter
  * and DataReader). Those QoS are set in initialize_publication and initialize_subscription methods.
@@ -40,7 +55,64 @@ struct Options
     eprosima::fastdds::dds::PublisherQos pubqos;
     eprosima::fastdds::dds::DataReaderQos rqos = eprosima::fastdds::dds::DATAREADER_QOS_DEFAULT;
     eprosima::fastdds::dds::DataWriterQos wqos = eprosima::fastdds::dds::DATAWRITER_QOS_DEFAULT;
+    //! Initial number of samples of each pool, also used as the growth step
     std::size_t sample_pool_size{50};
+    //! Hard cap of each pool. Once reached, new samples are kept in the DataReader history
+    std::size_t sample_pool_max_size{500};
+    //! Maximum number of samples taken from a DataReader at once
+    std::size_t listener_batch_size{32};
+    //! What to do with a sample whose task is already stored in its queue
+    DuplicateTaskPolicy duplicate_task_policy{DuplicateTaskPolicy::DISCARD_NEW};
+    //! Send large MLModel::raw_model payloads out of band through shared memory,
+    //! and read back the ones received that way. Only for nodes running on the
+    //! same host as all their subscribers, which must enable it as well
+    bool shared_payloads{false};
+    //! Minimum payload size, in bytes, sent through shared memory
+    std::size_t shared_payload_threshold{1024 * 1024};
+    //! Number of shared memory segments kept alive by each publisher
+    std::size_t shared_payload_retained{16};
+    //! Number of Dispatcher worker threads. 0 falls back to N_THREADS_DEFAULT
+    std::size_t dispatcher_threads{std::thread::hardware_concurrency()};
+    //! Maximum number of tasks a node runs at the same time. Tasks ready beyond it
+    //! wait for a running one to finish. 0 means as many as Dispatcher threads.
+    //! Overridden by the SUSTAINML_MAX_IN_FLIGHT_TASKS environment variable
+    std::size_t max_in_flight_tasks{0};
+    //! Share one DomainParticipant, Publisher and Subscriber among all the nodes of the process
+    //! created with this option in the same domain. Their QoS are taken from the first node.
+    //! Overridden by the SUSTAINML_SHARED_PARTICIPANT environment variable
+    bool shared_participant{false};
+    //! Hand the outputs of the node straight to the nodes of the same process created with this option,
+    //! without serializing them. DDS is only written when other subscribers are matched or none is local.
+    //! Overridden by the SUSTAINML_INTRA_PROCESS environment variable
+    bool intra_process{false};
+    //! Number of threads serving the configuration requests of the node. Requests are only handled
+    //! concurrently if its RequestReplyListener allows it. 0 means 1, at most common::MAX_RPC_SERVER_THREADS.
+    //! Overridden by the SUSTAINML_RPC_SERVER_THREADS environment variable
+    std::size_t rpc_server_threads{4};
+    //! Period with which the node publishes the latencies of its stages and the occupancy of its queues
+    //! on the metrics topic. 0 disables the recording of latencies.
+    //! Overridden by the SUSTAINML_METRICS_PERIOD environment variable, in milliseconds
+    std::chrono::milliseconds metrics_period{0};
+    //! Maximum number of problems kept in the Orchestrator task DB. 0 means unlimited
+    std::size_t task_db_max_problems{0};
+    //! Maximum approximate size in bytes of the Orchestrator task DB. 0 means unlimited
+    std::size_t task_db_max_bytes{0};
+    //! Problems not accessed for this long are evicted from the Orchestrator task DB. 0 means never
+    std::chrono::seconds task_db_ttl{0};
+    //! Directory evicted problems are written to, and read back from when accessed again.
+    //! Evicted problems are discarded if empty
+    std::string task_db_spill_dir;
+    //! Directory of the Orchestrator task DB write-ahead log. Empty disables it.
+    //! The task history of a previous run in the same directory is recovered on startup
+    std::string task_db_log_dir;
+    //! Size in bytes after which a new task DB log segment is started
+    std::size_t task_db_log_segment_size{64 * 1024 * 1024};
+    //! Flush every task DB log record to the storage device, so that it also survives a system crash
+    bool task_db_log_sync{false};
+    //! Maximum number of problems kept in the task DB log, the oldest evicted ones are dropped from it
+    //! beyond that. Problems evicted for not being accessed within the TTL are always dropped. 0 means unlimited.
+    //! Overridden by the SUSTAINML_TASK_DB_LOG_MAX_PROBLEMS environment variable
+    std::size_t task_db_log_max_problems{1000};
 };
 
 } // namespace core
@@ -47,13 +47,17 @@ namespace core {
         QueuedNodeListener(
             Node* node,
             const Options& opts = Options())
-            : NodeListener<T>(node, this)
+            : NodeListener<T>(node, this, opts)
             , SamplesQueue<T>(node, opts)
         {
 
         }
 
-        virtual ~QueuedNodeListener() = default;
+        virtual ~QueuedNodeListener()
+        {
+            //! Stop receiving intra-process samples before the queue is destroyed
+            NodeListener<T>::stop();
+        }
 
         /**
         * @brief Retrieves the queue of the particular type.
@@ -65,6 +69,16 @@ namespace core {
             return SamplesQueue<T>::get_queue();
         }
 
+    protected:
+
+        /**
+        * @brief Resumes the listener in its own thread once the pool has room again.
+        */
+        void on_cache_released() override
+        {
+            NodeListener<T>::request_resume();
+        }
+
     };
 
 } // namespace core
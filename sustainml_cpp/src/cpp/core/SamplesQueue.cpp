@@ -20,7 +20,8 @@
 
 #include <common/Common.hpp>
 #include <core/Dispatcher.hpp>
-#include <utils/SamplePool.hpp>
+#include <utils/LockFreeSamplePool.hpp>
+#include <utils/TaskIndex.hpp>
 
 namespace sustainml {
 namespace core {
@@ -30,9 +31,13 @@ SamplesQueue<T>::SamplesQueue(
         Node* node,
         const Options& opts)
     : node_(node)
-    , pool_(new sustainml::utils::SamplePool<T>(opts))
-    , queue_id(common::queue_name_to_id(std::string(T::impl_typeinfo().name())))
+    , queue_(new sustainml::utils::TaskIndex<std::pair<T*, bool>>(opts.sample_pool_max_size))
+    , pool_(new sustainml::utils::LockFreeSamplePool<T>(opts))
+    , queue_id(common::QueueIdOf<T>::value)
+    , duplicate_task_policy_(opts.duplicate_task_policy)
 {
+    static_assert(common::QueueIdOf<T>::value >= 0, "Type not received in any queue");
+
     auto dispatcher = node_->get_dispatcher();
 
     if (auto disp_p = dispatcher.lock())
@@ -45,42 +50,141 @@ SamplesQueue<T>::SamplesQueue(
     }
 }
 
+//! Defined here, where the index and the pool are complete types
 template <typename T>
-SamplesQueue<T>::~SamplesQueue()
-{
-    //! TODO
-}
+SamplesQueue<T>::~SamplesQueue() = default;
 
 template <typename T>
 T* SamplesQueue<T>::get_new_cache()
 {
-    std::unique_lock<std::mutex> lock(mtx_);
-    return pool_->get_new_cache_nts();
+    return pool_->get_new_cache();
 }
 
 template <typename T>
 void SamplesQueue<T>::release_cache(
         T* cache)
 {
-    std::unique_lock<std::mutex> lock(mtx_);
-    pool_->release_cache_nts(cache);
+    pool_->release_cache(cache);
+    on_cache_released();
 }
 
 template <typename T>
-void SamplesQueue<T>::insert_element(
+bool SamplesQueue<T>::insert_element(
         T*& elem)
 {
-    std::unique_lock<std::mutex> lock(mtx_);
-    queue_.insert(std::make_pair(elem->task_id(), std::make_pair(elem, false)));
+    T* discarded {nullptr};
+    bool is_new {false};
+
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        is_new = insert_element_nts(elem, discarded);
+    }
+
+    if (discarded == elem)
+    {
+        elem = nullptr;
+    }
+
+    if (nullptr != discarded)
+    {
+        release_cache(discarded);
+    }
+
+    return is_new;
+}
+
+template <typename T>
+void SamplesQueue<T>::insert_elements(
+        const std::vector<T*>& elems,
+        std::vector<types::TaskId>& new_tasks)
+{
+    std::vector<T*> discarded;
+
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        for (T* elem : elems)
+        {
+            T* discarded_elem {nullptr};
+
+            if (insert_element_nts(elem, discarded_elem))
+            {
+                new_tasks.push_back(elem->task_id());
+            }
+
+            if (nullptr != discarded_elem)
+            {
+                discarded.push_back(discarded_elem);
+            }
+        }
+    }
+
+    for (T* cache : discarded)
+    {
+        release_cache(cache);
+    }
+}
+
+template <typename T>
+bool SamplesQueue<T>::insert_element_nts(
+        T* elem,
+        T*& discarded)
+{
+    bool is_new {false};
+
+    auto result = queue_->emplace(common::task_id_to_key(elem->task_id()), std::make_pair(elem, false));
+
+    if (nullptr == result.first)
+    {
+        EPROSIMA_LOG_ERROR(SAMPLES_QUEUE, "No room left for task " << elem->task_id() << " in " << queue_id);
+        discarded = elem;
+    }
+    else if (result.second)
+    {
+        is_new = true;
+    }
+    else if (duplicate_task_policy_ == DuplicateTaskPolicy::REPLACE_PENDING && !result.first->second)
+    {
+        EPROSIMA_LOG_WARNING(SAMPLES_QUEUE,
+                "Replacing pending sample of duplicated task " << elem->task_id() << " in " << queue_id);
+        discarded = result.first->first;
+        result.first->first = elem;
+    }
+    else
+    {
+        EPROSIMA_LOG_WARNING(SAMPLES_QUEUE,
+                "Discarding sample of duplicated task " << elem->task_id() << " in " << queue_id);
+        discarded = elem;
+    }
+
+    return is_new;
 }
 
 template <typename T>
 void SamplesQueue<T>::remove_element_by_taskid(
         const types::TaskId& id)
 {
-    std::unique_lock<std::mutex> lock(mtx_);
-    pool_->release_cache_nts(queue_[id].first);
-    queue_.erase(id);
+    T* cache {nullptr};
+
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        std::pair<T*, bool> entry;
+
+        if (queue_->erase(common::task_id_to_key(id), entry))
+        {
+            cache = entry.first;
+        }
+    }
+
+    //! Unknown task, nothing to release
+    if (nullptr == cache)
+    {
+        return;
+    }
+
+    pool_->release_cache(cache);
+    on_cache_released();
 }
 
 template <typename T>
@@ -91,14 +195,14 @@ void* SamplesQueue<T>::retrieve_sample_from_taskid(
 
     T* sample {nullptr};
 
-    auto it = queue_.find(id);
+    auto entry = queue_->find(common::task_id_to_key(id));
 
-    if (it != queue_.end())
+    if (nullptr != entry)
     {
-        if (!it->second.second)
+        if (!entry->second)
         {
-            sample = it->second.first;
-            it->second.second = true;
+            sample = entry->first;
+            entry->second = true;
         }
         else
         {
@@ -125,5 +229,19 @@ const int& SamplesQueue<T>::get_id()
     return queue_id;
 }
 
+template <typename T>
+void SamplesQueue<T>::pool_stats(
+        sustainml::utils::SamplePoolStats& stats)
+{
+    stats = pool_->stats();
+}
+
+template <typename T>
+std::size_t SamplesQueue<T>::size()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return queue_->size();
+}
+
 } // namespace core
 } // namespace sustainml
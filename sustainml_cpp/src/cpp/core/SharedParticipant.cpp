@@ -0,0 +1,132 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file SharedParticipant.cpp
+ */
+
+#include <core/SharedParticipant.hpp>
+
+#include <algorithm>
+#include <map>
+
+#include <fastdds/dds/domain/DomainParticipant.hpp>
+#include <fastdds/dds/domain/DomainParticipantFactory.hpp>
+#include <fastdds/dds/log/Log.hpp>
+
+#include <common/Common.hpp>
+#include <core/Options.hpp>
+
+using namespace eprosima::fastdds::dds;
+
+namespace sustainml {
+namespace core {
+
+std::shared_ptr<SharedParticipant> SharedParticipant::get(
+        uint32_t domain,
+        const Options& opts)
+{
+    static std::mutex registry_mtx;
+    static std::map<uint32_t, std::weak_ptr<SharedParticipant>> registry;
+
+    std::lock_guard<std::mutex> lock(registry_mtx);
+
+    std::shared_ptr<SharedParticipant> shared = registry[domain].lock();
+
+    if (!shared)
+    {
+        shared.reset(new SharedParticipant(domain, opts));
+
+        if (nullptr == shared->participant_ || nullptr == shared->publisher_ || nullptr == shared->subscriber_)
+        {
+            EPROSIMA_LOG_ERROR(SHARED_PARTICIPANT, "Could not create the shared entities in domain " << domain);
+            return nullptr;
+        }
+
+        registry[domain] = shared;
+    }
+
+    return shared;
+}
+
+SharedParticipant::SharedParticipant(
+        uint32_t domain,
+        const Options& opts)
+    : participant_(nullptr)
+    , publisher_(nullptr)
+    , subscriber_(nullptr)
+{
+    DomainParticipantQos pqos = opts.pqos;
+    pqos.name(common::SHARED_PARTICIPANT_NAME);
+
+    //! Set sustainML app ID participant properties
+    pqos.properties().properties().emplace_back("fastdds.application.id", "SUSTAINML", true);
+    pqos.properties().properties().emplace_back("fastdds.application.metadata", "", true);
+
+    participant_ = DomainParticipantFactory::get_instance()->create_participant(domain, pqos);
+
+    if (participant_ == nullptr)
+    {
+        return;
+    }
+
+    subscriber_ = participant_->create_subscriber(opts.subqos);
+    publisher_ = participant_->create_publisher(opts.pubqos);
+}
+
+SharedParticipant::~SharedParticipant()
+{
+    if (participant_)
+    {
+        participant_->delete_contained_entities();
+        DomainParticipantFactory::get_instance()->delete_participant(participant_);
+    }
+}
+
+void SharedParticipant::add_node(
+        const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    node_names_.push_back(name);
+    update_user_data_nts();
+}
+
+void SharedParticipant::remove_node(
+        const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    auto it = std::find(node_names_.begin(), node_names_.end(), name);
+
+    if (it != node_names_.end())
+    {
+        node_names_.erase(it);
+        update_user_data_nts();
+    }
+}
+
+void SharedParticipant::update_user_data_nts()
+{
+    DomainParticipantQos pqos;
+    participant_->get_qos(pqos);
+    pqos.user_data().data_vec(common::node_names_to_user_data(node_names_));
+
+    if (RETCODE_OK != participant_->set_qos(pqos))
+    {
+        EPROSIMA_LOG_ERROR(SHARED_PARTICIPANT, "Could not announce the nodes of the shared participant");
+    }
+}
+
+} // namespace core
+} // namespace sustainml
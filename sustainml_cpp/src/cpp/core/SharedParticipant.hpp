@@ -0,0 +1,129 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file SharedParticipant.hpp
+ */
+
+#ifndef SUSTAINMLCPP_CORE_SHAREDPARTICIPANT_HPP
+#define SUSTAINMLCPP_CORE_SHAREDPARTICIPANT_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace eprosima {
+namespace fastdds {
+namespace dds {
+
+class DomainParticipant;
+class Publisher;
+class Subscriber;
+
+} // namespace dds
+} // namespace fastdds
+} // namespace eprosima
+
+namespace sustainml {
+namespace core {
+
+struct Options;
+
+/**
+ * @brief DomainParticipant, Publisher and Subscriber shared by the nodes of
+ * a process created with Options::shared_participant.
+ *
+ * There is one per domain, created by the first node and destroyed with the
+ * last one. The names of the nodes using it are announced in its user data,
+ * since the Orchestrator identifies nodes by participant name.
+ */
+class SharedParticipant
+{
+public:
+
+    /**
+     * @brief Returns the entities shared in a domain, creating them if needed.
+     *
+     * @param domain Domain identifier
+     * @param opts QoS of the entities, only used when they are created
+     * @return nullptr if the entities could not be created.
+     */
+    static std::shared_ptr<SharedParticipant> get(
+            uint32_t domain,
+            const Options& opts);
+
+    ~SharedParticipant();
+
+    eprosima::fastdds::dds::DomainParticipant* participant() const
+    {
+        return participant_;
+    }
+
+    eprosima::fastdds::dds::Publisher* publisher() const
+    {
+        return publisher_;
+    }
+
+    eprosima::fastdds::dds::Subscriber* subscriber() const
+    {
+        return subscriber_;
+    }
+
+    /**
+     * @brief Serializes the registration of types and the creation of topics
+     * by the nodes sharing the participant.
+     */
+    std::mutex& mutex()
+    {
+        return mtx_;
+    }
+
+    /**
+     * @brief Announces a node hosted by the participant.
+     */
+    void add_node(
+            const std::string& name);
+
+    /**
+     * @brief Stops announcing a node hosted by the participant.
+     */
+    void remove_node(
+            const std::string& name);
+
+private:
+
+    SharedParticipant(
+            uint32_t domain,
+            const Options& opts);
+
+    //! Publishes the node names in the user data
+    void update_user_data_nts();
+
+    eprosima::fastdds::dds::DomainParticipant* participant_;
+
+    eprosima::fastdds::dds::Publisher* publisher_;
+
+    eprosima::fastdds::dds::Subscriber* subscriber_;
+
+    std::vector<std::string> node_names_;
+
+    std::mutex mtx_;
+};
+
+} // namespace core
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_CORE_SHAREDPARTICIPANT_HPP
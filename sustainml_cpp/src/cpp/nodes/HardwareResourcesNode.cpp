@@ -21,6 +21,7 @@
 #include <fastdds/dds/publisher/DataWriter.hpp>
 
 #include <common/Common.hpp>
+#include <core/IntraProcessBus.hpp>
 #include <core/Options.hpp>
 #include <core/QueuedNodeListener.hpp>
 #include <types/typesImpl.hpp>
@@ -97,30 +98,30 @@ HardwareResourcesNode::~HardwareResourcesNode()
 void HardwareResourcesNode::init (
         const sustainml::core::Options& opts)
 {
-    listener_ml_model_queue_.reset(new core::QueuedNodeListener<MLModel>(this));
-    listener_app_requirements_queue_.reset(new core::QueuedNodeListener<AppRequirements>(this));
-    listener_hw_constraints_queue_.reset(new core::QueuedNodeListener<HWConstraints>(this));
+    listener_ml_model_queue_.reset(new core::QueuedNodeListener<MLModel>(this, opts));
+    listener_app_requirements_queue_.reset(new core::QueuedNodeListener<AppRequirements>(this, opts));
+    listener_hw_constraints_queue_.reset(new core::QueuedNodeListener<HWConstraints>(this, opts));
 
     task_data_pool_.reset(new utils::SamplePool<types::NodeTaskOutputData<HWResource>>(opts));
 
-    initialize_subscription(sustainml::common::TopicCollection::get()[common::ML_MODEL].first.c_str(),
-            sustainml::common::TopicCollection::get()[common::ML_MODEL].second.c_str(),
+    initialize_subscription(sustainml::common::topic_name(common::ML_MODEL),
+            sustainml::common::topic_type_name(common::ML_MODEL),
             &(*listener_ml_model_queue_), opts);
 
-    initialize_subscription(sustainml::common::TopicCollection::get()[common::APP_REQUIREMENT].first.c_str(),
-            sustainml::common::TopicCollection::get()[common::APP_REQUIREMENT].second.c_str(),
+    initialize_subscription(sustainml::common::topic_name(common::APP_REQUIREMENT),
+            sustainml::common::topic_type_name(common::APP_REQUIREMENT),
             &(*listener_app_requirements_queue_), opts);
 
-    initialize_subscription(sustainml::common::TopicCollection::get()[common::HW_CONSTRAINT].first.c_str(),
-            sustainml::common::TopicCollection::get()[common::HW_CONSTRAINT].second.c_str(),
+    initialize_subscription(sustainml::common::topic_name(common::HW_CONSTRAINT),
+            sustainml::common::topic_type_name(common::HW_CONSTRAINT),
             &(*listener_hw_constraints_queue_), opts);
 
-    initialize_publication(sustainml::common::TopicCollection::get()[common::HW_RESOURCE].first.c_str(),
-            sustainml::common::TopicCollection::get()[common::HW_RESOURCE].second.c_str(),
+    initialize_publication(sustainml::common::topic_name(common::HW_RESOURCE),
+            sustainml::common::topic_type_name(common::HW_RESOURCE),
             opts);
 }
 
-void HardwareResourcesNode::publish_to_user(
+bool HardwareResourcesNode::publish_to_user(
         const types::TaskId& task_id,
         const std::vector<std::pair<int, void*>> input_samples)
 {
@@ -146,48 +147,64 @@ void HardwareResourcesNode::publish_to_user(
 
             task_data_cache = task_data_pool_->get_new_cache_nts();
 
+            if (nullptr == task_data_cache)
+            {
+                EPROSIMA_LOG_ERROR(HW_NODE, "No output cache left for task " << task_id << ", discarding it");
+                user_listener_.remove_task_args(task_id);
+                return false;
+            }
+
             status = &task_data_cache->node_status;
             output = &task_data_cache->output_data;
         }
 
-        //! TODO: Manage task statuses individually
+        task_started(task_id);
 
-        if (status() != Status::NODE_RUNNING)
-        {
-            status(Status::NODE_RUNNING);
-            publish_node_status();
-        }
+        auto completion = make_completion_handle([this, task_id, task_data_cache](bool abandoned)
+                {
+                    complete_task(task_id, task_data_cache, abandoned);
+                });
 
-        user_listener_.invoke_user_cb(task_id, core::helper::gen_seq<HardwareResourcesCallable::size>{});
+        user_listener_.invoke_user_cb(task_id, completion, core::helper::gen_seq<HardwareResourcesCallable::size>{});
 
-        //! Ensure task_id is forwarded to the output
-        task_data_cache->output_data.task_id(task_id);
+        return true;
+    }
+    else
+    {
+        EPROSIMA_LOG_ERROR(HW_NODE, "Input size mismatch");
+    }
 
-        if (task_data_cache->node_status.node_status() != Status::NODE_ERROR)
-        {
-            status(Status::NODE_IDLE);
-        }
-        else
-        {
-            status(Status::NODE_ERROR);
-        }
+    return false;
+}
 
-        publish_node_status();
-        writers()[OUTPUT_WRITER_IDX]->write(task_data_cache->output_data.get_impl());
+void HardwareResourcesNode::complete_task(
+        const types::TaskId& task_id,
+        types::NodeTaskOutputData<types::HWResource>* task_data_cache,
+        bool abandoned)
+{
+    if (abandoned)
+    {
+        EPROSIMA_LOG_WARNING(HW_NODE, "Task " << task_id <<
+                " dropped by the user without being completed");
+        task_data_cache->node_status.node_status(Status::NODE_ERROR);
+    }
 
-        listener_ml_model_queue_->remove_element_by_taskid(task_id);
-        listener_app_requirements_queue_->remove_element_by_taskid(task_id);
-        listener_hw_constraints_queue_->remove_element_by_taskid(task_id);
+    //! Ensure task_id is forwarded to the output
+    task_data_cache->output_data.task_id(task_id);
+
+    task_finished(task_id, task_data_cache->node_status.node_status() == Status::NODE_ERROR);
+    auto write_start = output_write_start();
+    core::IntraProcessBus::get().write(writers()[OUTPUT_WRITER_IDX], task_data_cache->output_data.get_impl());
+    record_output_write(write_start);
+
+    listener_ml_model_queue_->remove_element_by_taskid(task_id);
+    listener_app_requirements_queue_->remove_element_by_taskid(task_id);
+    listener_hw_constraints_queue_->remove_element_by_taskid(task_id);
 
-        {
-            std::lock_guard<std::mutex> lock (mtx_);
-            task_data_pool_->release_cache_nts(task_data_cache);
-            user_listener_.remove_task_args(task_id);
-        }
-    }
-    else
     {
-        EPROSIMA_LOG_ERROR(HW_NODE, "Input size mismatch");
+        std::lock_guard<std::mutex> lock (mtx_);
+        task_data_pool_->release_cache_nts(task_data_cache);
+        user_listener_.remove_task_args(task_id);
     }
 }
 
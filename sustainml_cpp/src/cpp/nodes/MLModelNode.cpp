@@ -21,9 +21,12 @@
 #include <fastdds/dds/publisher/DataWriter.hpp>
 
 #include <common/Common.hpp>
+#include <core/IntraProcessBus.hpp>
 #include <core/Options.hpp>
 #include <core/QueuedNodeListener.hpp>
 #include <types/typesImpl.hpp>
+#include <utils/BlobStore.hpp>
+#include <utils/SharedPayloadStore.hpp>
 
 using namespace types;
 
@@ -98,48 +101,53 @@ MLModelNode::~MLModelNode()
 void MLModelNode::init (
         const sustainml::core::Options& opts)
 {
-    listener_model_metadata_queue_.reset(new core::QueuedNodeListener<MLModelMetadata>(this));
-    listener_app_requirements_queue_.reset(new core::QueuedNodeListener<AppRequirements>(this));
-    listener_hw_constraints_queue_.reset(new core::QueuedNodeListener<HWConstraints>(this));
+    listener_model_metadata_queue_.reset(new core::QueuedNodeListener<MLModelMetadata>(this, opts));
+    listener_app_requirements_queue_.reset(new core::QueuedNodeListener<AppRequirements>(this, opts));
+    listener_hw_constraints_queue_.reset(new core::QueuedNodeListener<HWConstraints>(this, opts));
 
     // Baselines
-    listener_mlmodel_queue_.reset(new core::QueuedNodeListener<MLModel>(this));
-    listener_hw_queue_.reset(new core::QueuedNodeListener<HWResource>(this));
-    listener_carbon_footprint_queue_.reset(new core::QueuedNodeListener<CO2Footprint>(this));
+    listener_mlmodel_queue_.reset(new core::QueuedNodeListener<MLModel>(this, opts));
+    listener_hw_queue_.reset(new core::QueuedNodeListener<HWResource>(this, opts));
+    listener_carbon_footprint_queue_.reset(new core::QueuedNodeListener<CO2Footprint>(this, opts));
 
     task_data_pool_.reset(new utils::SamplePool<types::NodeTaskOutputData<MLModel>>(opts));
 
-    initialize_subscription(sustainml::common::TopicCollection::get()[common::ML_MODEL_METADATA].first.c_str(),
-            sustainml::common::TopicCollection::get()[common::ML_MODEL_METADATA].second.c_str(),
+    if (opts.shared_payloads)
+    {
+        shared_payload_store_.reset(new utils::SharedPayloadStore(opts));
+    }
+
+    initialize_subscription(sustainml::common::topic_name(common::ML_MODEL_METADATA),
+            sustainml::common::topic_type_name(common::ML_MODEL_METADATA),
             &(*listener_model_metadata_queue_), opts);
 
-    initialize_subscription(sustainml::common::TopicCollection::get()[common::APP_REQUIREMENT].first.c_str(),
-            sustainml::common::TopicCollection::get()[common::APP_REQUIREMENT].second.c_str(),
+    initialize_subscription(sustainml::common::topic_name(common::APP_REQUIREMENT),
+            sustainml::common::topic_type_name(common::APP_REQUIREMENT),
             &(*listener_app_requirements_queue_), opts);
 
-    initialize_subscription(sustainml::common::TopicCollection::get()[common::HW_CONSTRAINT].first.c_str(),
-            sustainml::common::TopicCollection::get()[common::HW_CONSTRAINT].second.c_str(),
+    initialize_subscription(sustainml::common::topic_name(common::HW_CONSTRAINT),
+            sustainml::common::topic_type_name(common::HW_CONSTRAINT),
             &(*listener_hw_constraints_queue_), opts);
 
-    initialize_publication(sustainml::common::TopicCollection::get()[common::ML_MODEL].first.c_str(),
-            sustainml::common::TopicCollection::get()[common::ML_MODEL].second.c_str(),
+    initialize_publication(sustainml::common::topic_name(common::ML_MODEL),
+            sustainml::common::topic_type_name(common::ML_MODEL),
             opts);
 
     // Baselines topics
-    initialize_subscription(sustainml::common::TopicCollection::get()[common::ML_MODEL_BASELINE].first.c_str(),
-            sustainml::common::TopicCollection::get()[common::ML_MODEL].second.c_str(),
+    initialize_subscription(sustainml::common::topic_name(common::ML_MODEL_BASELINE),
+            sustainml::common::topic_type_name(common::ML_MODEL),
             &(*listener_mlmodel_queue_), opts);
 
-    initialize_subscription(sustainml::common::TopicCollection::get()[common::HW_RESOURCES_BASELINE].first.c_str(),
-            sustainml::common::TopicCollection::get()[common::HW_RESOURCE].second.c_str(),
+    initialize_subscription(sustainml::common::topic_name(common::HW_RESOURCES_BASELINE),
+            sustainml::common::topic_type_name(common::HW_RESOURCE),
             &(*listener_hw_queue_), opts);
 
-    initialize_subscription(sustainml::common::TopicCollection::get()[common::CARBON_FOOTPRINT_BASELINE].first.c_str(),
-            sustainml::common::TopicCollection::get()[common::CARBON_FOOTPRINT].second.c_str(),
+    initialize_subscription(sustainml::common::topic_name(common::CARBON_FOOTPRINT_BASELINE),
+            sustainml::common::topic_type_name(common::CARBON_FOOTPRINT),
             &(*listener_carbon_footprint_queue_), opts);
 }
 
-void MLModelNode::publish_to_user(
+bool MLModelNode::publish_to_user(
         const types::TaskId& task_id,
         const std::vector<std::pair<int, void*>> input_samples)
 {
@@ -155,6 +163,26 @@ void MLModelNode::publish_to_user(
             ExpectedInputSamples::MAX,
             samples_retrieved);
 
+        // The orchestrator announces the baseline models it is going to replace by a blob reference,
+        // and only sends the reference once this node has run a task with the announced model
+        std::vector<uint8_t>& baseline_raw_model =
+                std::get<ML_MODEL_BASELINE_SAMPLE>(user_listener_args)->raw_model();
+        std::vector<uint8_t> missed_reference;
+
+        if (utils::BlobStore::is_reference(baseline_raw_model))
+        {
+            std::vector<uint8_t> reference = baseline_raw_model;
+
+            if (!utils::BlobStore::get().resolve(baseline_raw_model))
+            {
+                missed_reference.swap(reference);
+            }
+        }
+        else if (utils::BlobStore::is_announced(baseline_raw_model))
+        {
+            utils::BlobStore::get().put_announced(baseline_raw_model);
+        }
+
         types::NodeTaskOutputData<MLModel>* task_data_cache;
 
         {
@@ -165,49 +193,84 @@ void MLModelNode::publish_to_user(
 
             task_data_cache = task_data_pool_->get_new_cache_nts();
 
+            if (nullptr == task_data_cache)
+            {
+                EPROSIMA_LOG_ERROR(MLMODEL_NODE, "No output cache left for task " << task_id << ", discarding it");
+                user_listener_.remove_task_args(task_id);
+                return false;
+            }
+
             status = &task_data_cache->node_status;
             output = &task_data_cache->output_data;
         }
 
-        //! TODO: Manage task statuses individually
-
-        if (status() != Status::NODE_RUNNING)
-        {
-            status(Status::NODE_RUNNING);
-            publish_node_status();
-        }
+        task_started(task_id);
 
-        user_listener_.invoke_user_cb(task_id, core::helper::gen_seq<MLModelCallable::size>{});
+        auto completion = make_completion_handle([this, task_id, task_data_cache](bool abandoned)
+                {
+                    complete_task(task_id, task_data_cache, abandoned);
+                });
 
-        //! Ensure task_id is forwarded to the output
-        task_data_cache->output_data.task_id(task_id);
-
-        if (task_data_cache->node_status.node_status() != Status::NODE_ERROR)
-        {
-            status(Status::NODE_IDLE);
-        }
-        else
+        if (!missed_reference.empty())
         {
-            status(Status::NODE_ERROR);
+            // The task fails, and the reference sent back asks the orchestrator for the full baseline model
+            EPROSIMA_LOG_ERROR(MLMODEL_NODE, "Baseline model of task " << task_id << " not found, failing the task");
+            task_data_cache->node_status.node_status(Status::NODE_ERROR);
+            task_data_cache->output_data.raw_model(std::move(missed_reference));
+            completion.complete();
+            return true;
         }
 
-        publish_node_status();
-        writers()[OUTPUT_WRITER_IDX]->write(task_data_cache->output_data.get_impl());
-
-        listener_model_metadata_queue_->remove_element_by_taskid(task_id);
-        listener_app_requirements_queue_->remove_element_by_taskid(task_id);
-        listener_hw_constraints_queue_->remove_element_by_taskid(task_id);
+        user_listener_.invoke_user_cb(task_id, completion, core::helper::gen_seq<MLModelCallable::size>{});
 
-        {
-            std::lock_guard<std::mutex> lock (mtx_);
-            task_data_pool_->release_cache_nts(task_data_cache);
-            user_listener_.remove_task_args(task_id);
-        }
+        return true;
     }
     else
     {
         EPROSIMA_LOG_ERROR(MLMODEL_NODE, "Input size mismatch");
     }
+
+    return false;
+}
+
+void MLModelNode::complete_task(
+        const types::TaskId& task_id,
+        types::NodeTaskOutputData<types::MLModel>* task_data_cache,
+        bool abandoned)
+{
+    if (abandoned)
+    {
+        EPROSIMA_LOG_WARNING(MLMODEL_NODE, "Task " << task_id <<
+                " dropped by the user without being completed");
+        task_data_cache->node_status.node_status(Status::NODE_ERROR);
+    }
+
+    //! Ensure task_id is forwarded to the output
+    task_data_cache->output_data.task_id(task_id);
+
+    task_finished(task_id, task_data_cache->node_status.node_status() == Status::NODE_ERROR);
+
+    auto write_start = output_write_start();
+    //! Readers of the bus get the original model, only the sample written to DDS may reference shared memory
+    core::IntraProcessBus::get().write(writers()[OUTPUT_WRITER_IDX], task_data_cache->output_data.get_impl(),
+            [this, task_data_cache]()
+            {
+                if (shared_payload_store_)
+                {
+                    shared_payload_store_->export_payload(task_data_cache->output_data.raw_model());
+                }
+            });
+    record_output_write(write_start);
+
+    listener_model_metadata_queue_->remove_element_by_taskid(task_id);
+    listener_app_requirements_queue_->remove_element_by_taskid(task_id);
+    listener_hw_constraints_queue_->remove_element_by_taskid(task_id);
+
+    {
+        std::lock_guard<std::mutex> lock (mtx_);
+        task_data_pool_->release_cache_nts(task_data_cache);
+        user_listener_.remove_task_args(task_id);
+    }
 }
 
 } // ml_model_module
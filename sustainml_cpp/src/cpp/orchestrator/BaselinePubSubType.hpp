@@ -0,0 +1,195 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file BaselinePubSubType.hpp
+ */
+
+#ifndef SUSTAINMLCPP_ORCHESTRATOR_BASELINEPUBSUBTYPE_HPP
+#define SUSTAINMLCPP_ORCHESTRATOR_BASELINEPUBSUBTYPE_HPP
+
+#include <cstdint>
+
+#include <sustainml_cpp/types/types.hpp>
+#include <types/typesImpl.hpp>
+#include <types/typesImplPubSubTypes.hpp>
+
+#include <fastdds/rtps/common/InstanceHandle.hpp>
+#include <fastdds/rtps/common/SerializedPayload.hpp>
+
+namespace sustainml {
+namespace orchestrator {
+
+/**
+ * @brief Sets the task id written by every BaselinePubSubType of the calling
+ * thread while it is alive, whatever the task id of the written sample is.
+ */
+class BaselineTaskIdScope
+{
+public:
+
+    explicit BaselineTaskIdScope(
+            const types::TaskId& task_id)
+        : task_id_(task_id)
+    {
+        current() = &task_id_;
+    }
+
+    ~BaselineTaskIdScope()
+    {
+        current() = nullptr;
+    }
+
+    static const types::TaskId*& current()
+    {
+        static thread_local const types::TaskId* task_id = nullptr;
+        return task_id;
+    }
+
+private:
+
+    const types::TaskId task_id_;
+};
+
+/**
+ * @brief TopicDataType of the types published as baselines.
+ *
+ * Baselines are the node outputs of the previous iteration published again
+ * with the task id of the new one. This type lets them be written straight
+ * from the payload shared in the TaskDB: inside a BaselineTaskIdScope the
+ * task id is replaced in the serialized sample and in the instance key,
+ * leaving the written sample untouched. Otherwise it behaves as PubSubType.
+ *
+ * The task id is patched in place only if the serialized sample ends with the
+ * task id of the written one, otherwise a copy holding the new task id is
+ * serialized.
+ */
+template <typename PubSubType>
+class BaselinePubSubType : public PubSubType
+{
+public:
+
+    using PubSubType::compute_key;
+
+    bool serialize(
+            const void* const data,
+            eprosima::fastdds::rtps::SerializedPayload_t& payload,
+            eprosima::fastdds::dds::DataRepresentationId_t data_representation) override
+    {
+        const types::TaskId* task_id = BaselineTaskIdScope::current();
+
+        if (nullptr == task_id)
+        {
+            return PubSubType::serialize(data, payload, data_representation);
+        }
+
+        const typename PubSubType::type* sample = static_cast<const typename PubSubType::type*>(data);
+
+        if (PubSubType::serialize(data, payload, data_representation) &&
+                patch_task_id(payload, sample->task_id(), *task_id))
+        {
+            return true;
+        }
+
+        typename PubSubType::type copy(*sample);
+        copy.task_id(*types::to_task_id_impl(const_cast<types::TaskId*>(task_id)));
+        return PubSubType::serialize(&copy, payload, data_representation);
+    }
+
+    bool compute_key(
+            const void* const data,
+            eprosima::fastdds::rtps::InstanceHandle_t& ihandle,
+            bool force_md5 = false) override
+    {
+        const types::TaskId* task_id = BaselineTaskIdScope::current();
+
+        if (nullptr == task_id)
+        {
+            return PubSubType::compute_key(data, ihandle, force_md5);
+        }
+
+        // The key only holds the task id
+        typename PubSubType::type key_holder;
+        key_holder.task_id(*types::to_task_id_impl(const_cast<types::TaskId*>(task_id)));
+        return PubSubType::compute_key(&key_holder, ihandle, force_md5);
+    }
+
+private:
+
+    /**
+     * @brief Overwrites the task id of a serialized sample.
+     *
+     * task_id is the last member of every stored type, so its two unsigned
+     * longs should be the last bytes of the payload in both XCDR versions.
+     * They are checked against the task id of the sample before being replaced.
+     *
+     * @return false if the payload does not end with the task id of the sample.
+     */
+    static bool patch_task_id(
+            eprosima::fastdds::rtps::SerializedPayload_t& payload,
+            const types::TaskIdImpl& sample_task_id,
+            const types::TaskId& task_id)
+    {
+        constexpr uint32_t encapsulation_size = 4;
+        constexpr uint32_t task_id_size = 2 * sizeof(uint32_t);
+
+        if (payload.length < encapsulation_size + task_id_size)
+        {
+            return false;
+        }
+
+        // The lowest bit of every encapsulation id flags little endian
+        bool little_endian = (payload.data[1] & 0x01) != 0;
+        uint8_t* tail = payload.data + payload.length - task_id_size;
+
+        auto shift = [little_endian](uint32_t i)
+                {
+                    return 8 * (little_endian ? i : sizeof(uint32_t) - 1 - i);
+                };
+
+        auto read = [&shift](const uint8_t* bytes)
+                {
+                    uint32_t value = 0;
+                    for (uint32_t i = 0; i < sizeof(value); ++i)
+                    {
+                        value |= static_cast<uint32_t>(bytes[i]) << shift(i);
+                    }
+                    return value;
+                };
+
+        auto write = [&shift](uint8_t* bytes, uint32_t value)
+                {
+                    for (uint32_t i = 0; i < sizeof(value); ++i)
+                    {
+                        bytes[i] = static_cast<uint8_t>(value >> shift(i));
+                    }
+                };
+
+        if (read(tail) != sample_task_id.problem_id() ||
+                read(tail + sizeof(uint32_t)) != sample_task_id.iteration_id())
+        {
+            return false;
+        }
+
+        write(tail, task_id.problem_id());
+        write(tail + sizeof(uint32_t), task_id.iteration_id());
+        return true;
+    }
+
+};
+
+} // namespace orchestrator
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_ORCHESTRATOR_BASELINEPUBSUBTYPE_HPP
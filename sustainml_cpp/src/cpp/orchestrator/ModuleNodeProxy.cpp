@@ -18,15 +18,27 @@
 
 
 #include <orchestrator/ModuleNodeProxy.hpp>
+#include <orchestrator/TaskDataWaiters.hpp>
 #include <orchestrator/TaskManager.hpp>
+#include <orchestrator/TaskTracer.hpp>
 
 #include "TaskDB.ipp"
 
 #include <common/Common.hpp>
+#include <utils/BlobStore.hpp>
+#include <utils/SharedPayloadStore.hpp>
 
 namespace sustainml {
 namespace orchestrator {
 
+namespace {
+
+//! Maximum number of tasks whose baseline announces a blob while waiting for the node to confirm it.
+//! Announcing copies the model, so it stops once these many are in flight.
+constexpr std::size_t MAX_UNCONFIRMED_BASELINE_TASKS = 16;
+
+} // namespace
+
 ModuleNodeProxy::ModuleNodeProxyListener::ModuleNodeProxyListener(
         ModuleNodeProxy* proxy)
     : proxy_parent_(proxy)
@@ -45,7 +57,7 @@ void ModuleNodeProxy::ModuleNodeProxyListener::on_data_available(
         if (info.instance_state == eprosima::fastdds::dds::ALIVE_INSTANCE_STATE)
         {
             EPROSIMA_LOG_INFO(MODULE_PROXY, "notify_new_node_ouput " << proxy_parent_->name_);
-            proxy_parent_->notify_new_node_ouput();
+            proxy_parent_->notify_new_node_ouput(info);
         }
     }
 }
@@ -90,6 +102,24 @@ void ModuleNodeProxy::ModuleNodeProxyStatusListener::on_subscription_matched(
 
 }
 
+ModuleNodeProxy::ModuleNodeProxyBaselineListener::ModuleNodeProxyBaselineListener(
+        ModuleNodeProxy* proxy)
+    : proxy_parent_(proxy)
+{
+
+}
+
+void ModuleNodeProxy::ModuleNodeProxyBaselineListener::on_publication_matched(
+        eprosima::fastdds::dds::DataWriter*,
+        const eprosima::fastdds::dds::PublicationMatchedStatus& status)
+{
+    std::lock_guard<std::mutex> lock(proxy_parent_->baseline_mtx_);
+
+    proxy_parent_->baseline_readers_ = status.current_count;
+    proxy_parent_->baseline_blob_confirmed_ = false;
+    proxy_parent_->baseline_blob_tasks_.clear();
+}
+
 ModuleNodeProxy::ModuleNodeProxy(
         OrchestratorNode* orchestrator,
         std::shared_ptr<TaskDB_t> task_db,
@@ -99,11 +129,13 @@ ModuleNodeProxy::ModuleNodeProxy(
     , node_id_(common::get_node_id_from_name(name_))
     , publish_baseline_(need_to_publish_baseline)
     , orchestrator_(orchestrator)
+    , shared_payloads_(orchestrator->shared_payloads_)
     , task_db_(task_db)
     , baseline_topic_(nullptr)
     , baseline_writer_(nullptr)
     , listener_(this)
     , status_listener_(this)
+    , baseline_listener_(this)
 {
     if (orchestrator_->participant_ == nullptr ||
             orchestrator_->sub_ == nullptr ||
@@ -116,8 +148,8 @@ ModuleNodeProxy::ModuleNodeProxy(
     status_.node_name(name);
 
     node_output_topic_ = orchestrator_->participant_->create_topic(
-        common::TopicCollection::get()[common::get_topic_from_name(name, false)].first.c_str(),
-        common::TopicCollection::get()[common::get_topic_from_name(name, false)].second.c_str(), TOPIC_QOS_DEFAULT);
+        common::topic_name(common::get_topic_from_name(name, false)),
+        common::topic_type_name(common::get_topic_from_name(name, false)), TOPIC_QOS_DEFAULT);
 
     if (node_output_topic_ == nullptr)
     {
@@ -140,7 +172,7 @@ ModuleNodeProxy::ModuleNodeProxy(
     parameters.push_back(std::string("'") + name + "'");
 
     filtered_status_topic_ = orchestrator_->participant_->create_contentfilteredtopic(
-        (common::TopicCollection::get()[common::Topics::NODE_STATUS].first + "_" + name).c_str(),
+        (std::string(common::topic_name(common::Topics::NODE_STATUS)) + "_" + name).c_str(),
         orchestrator_->status_topic_,
         expression,
         parameters);
@@ -156,10 +188,10 @@ ModuleNodeProxy::ModuleNodeProxy(
     std::string baseline_topic_name;
     if (publish_baseline_)
     {
-        baseline_topic_name = (common::TopicCollection::get()[common::get_topic_from_name(name_, true)].first);
+        baseline_topic_name = common::topic_name(common::get_topic_from_name(name_, true));
         baseline_topic_ = orchestrator_->participant_->create_topic(
             baseline_topic_name,
-            common::TopicCollection::get()[common::get_topic_from_name(name_, true)].second.c_str(), TOPIC_QOS_DEFAULT);
+            common::topic_type_name(common::get_topic_from_name(name_, true)), TOPIC_QOS_DEFAULT);
 
         if (baseline_topic_ == nullptr)
         {
@@ -175,7 +207,7 @@ ModuleNodeProxy::ModuleNodeProxy(
         baseline_writer_ = orchestrator_->pub_->create_datawriter(
             baseline_topic_,
             dwqos,
-            nullptr);
+            &baseline_listener_);
 
         if (baseline_writer_ == nullptr)
         {
@@ -192,6 +224,11 @@ ModuleNodeProxy::~ModuleNodeProxy()
         status_datareader_->set_listener(nullptr);
     }
 
+    if (baseline_writer_)
+    {
+        baseline_writer_->set_listener(nullptr);
+    }
+
     if (node_output_datareader_)
     {
         node_output_datareader_->set_listener(nullptr);
@@ -208,9 +245,13 @@ void ModuleNodeProxy::notify_status_change()
     }
 }
 
-void ModuleNodeProxy::notify_new_node_ouput()
+void ModuleNodeProxy::notify_new_node_ouput(
+        const SampleInfo& info)
 {
+    orchestrator_->task_tracer_->record_output(node_id_, get_tmp_task_id(), info.source_timestamp.to_ns());
     store_data_in_db();
+    // Waiters do not depend on the handler, which may be busy
+    orchestrator_->task_waiters_->notify(get_tmp_task_id(), node_id_);
     void* untyped_data = get_tmp_untyped_data();
     std::lock_guard<std::mutex> lock(orchestrator_->get_mutex());
     OrchestratorNodeHandle* handler_ptr = orchestrator_->get_handler();
@@ -220,10 +261,90 @@ void ModuleNodeProxy::notify_new_node_ouput()
     }
 }
 
-void ModuleNodeProxy::reset_and_prepare_task_id_nts(
+void ModuleNodeProxy::write_baseline_(
+        const types::MLModel& data,
+        const types::TaskId& task_id)
+{
+    const std::vector<uint8_t>& raw_model = data.raw_model();
+
+    // Also serializes the writes, so that no reader matches between a decision and its write
+    std::lock_guard<std::mutex> lock(baseline_mtx_);
+
+    if (raw_model.size() < utils::BlobStore::MIN_BLOB_SIZE)
+    {
+        last_baseline_blob_.reset();
+        baseline_blob_confirmed_ = false;
+        baseline_blob_tasks_.clear();
+        write_baseline_<types::MLModel>(data, task_id);
+        return;
+    }
+
+    utils::Sha256Digest digest = utils::BlobStore::get().put(raw_model);
+
+    if (!last_baseline_blob_ || *last_baseline_blob_ != digest)
+    {
+        last_baseline_blob_.reset(new utils::Sha256Digest(digest));
+        baseline_blob_confirmed_ = false;
+        baseline_blob_tasks_.clear();
+    }
+
+    if (baseline_blob_confirmed_ && 1 == baseline_readers_)
+    {
+        // The receiver already holds these bytes from a previous baseline.
+        // The stored model may be shared, so every other member is copied instead
+        types::MLModel sample;
+        sample.model_path(data.model_path());
+        sample.model(data.model());
+        sample.raw_model(utils::BlobStore::make_reference(digest, raw_model.size()));
+        sample.model_properties_path(data.model_properties_path());
+        sample.model_properties(data.model_properties());
+        sample.input_batch(data.input_batch());
+        sample.target_latency(data.target_latency());
+        sample.extra_data(data.extra_data());
+        sample.task_id(task_id);
+        baseline_writer_->write(sample.get_impl());
+    }
+    else if (baseline_blob_tasks_.size() < MAX_UNCONFIRMED_BASELINE_TASKS)
+    {
+        // Sent in full until the node confirms it holds the blob, announcing it so that the node stores it
+        baseline_blob_tasks_.insert(common::task_id_to_key(task_id));
+
+        types::MLModel sample = data;
+        utils::BlobStore::announce(sample.raw_model(), digest);
+        write_baseline_<types::MLModel>(sample, task_id);
+    }
+    else
+    {
+        write_baseline_<types::MLModel>(data, task_id);
+    }
+}
+
+void ModuleNodeProxy::confirm_baseline_blob(
+        const types::TaskId& task_id)
+{
+    std::lock_guard<std::mutex> lock(baseline_mtx_);
+
+    if (baseline_blob_tasks_.count(common::task_id_to_key(task_id)) > 0 && 1 == baseline_readers_)
+    {
+        baseline_blob_confirmed_ = true;
+        baseline_blob_tasks_.clear();
+    }
+}
+
+void ModuleNodeProxy::reject_baseline_blob(
+        const types::TaskId& task_id)
+{
+    std::lock_guard<std::mutex> lock(baseline_mtx_);
+
+    EPROSIMA_LOG_WARNING(MODULE_PROXY, name_ << " missed the baseline blob of task " << task_id <<
+            ", sending it in full again");
+    baseline_blob_confirmed_ = false;
+    baseline_blob_tasks_.clear();
+}
+
+void ModuleNodeProxy::reset_task_id(
         const types::TaskId& task_id)
 {
-    task_db_->prepare_new_entry_nts(task_id, false);
     orchestrator_->task_man_->update_task_id(task_id);
 }
 
@@ -250,18 +371,15 @@ AppRequirementsNodeProxy::AppRequirementsNodeProxy(
 void AppRequirementsNodeProxy::publish_data_for_iteration(
         const types::TaskId& task_id)
 {
-    types::AppRequirements* iter_data = nullptr;
-    ModuleNodeProxy::publish_data_for_iteration_(task_id, iter_data);
+    ModuleNodeProxy::publish_data_for_iteration_<types::AppRequirements>(task_id);
 }
 
 void AppRequirementsNodeProxy::store_data_in_db()
 {
-    std::lock_guard<std::mutex> lock(task_db_->get_mutex());
-    if (!task_db_->entry_exists_nts(tmp_data_.task_id()))
+    if (task_db_->insert_task_data_creating_entry(tmp_data_.task_id(), tmp_data_))
     {
-        reset_and_prepare_task_id_nts(tmp_data_.task_id());
+        reset_task_id(tmp_data_.task_id());
     }
-    task_db_->insert_task_data_nts(tmp_data_.task_id(), tmp_data_);
 }
 
 CarbonFootprintNodeProxy::CarbonFootprintNodeProxy(
@@ -276,18 +394,15 @@ CarbonFootprintNodeProxy::CarbonFootprintNodeProxy(
 void CarbonFootprintNodeProxy::publish_data_for_iteration(
         const types::TaskId& task_id)
 {
-    types::CO2Footprint* iter_data = nullptr;
-    ModuleNodeProxy::publish_data_for_iteration_(task_id, iter_data);
+    ModuleNodeProxy::publish_data_for_iteration_<types::CO2Footprint>(task_id);
 }
 
 void CarbonFootprintNodeProxy::store_data_in_db()
 {
-    std::lock_guard<std::mutex> lock(task_db_->get_mutex());
-    if (!task_db_->entry_exists_nts(tmp_data_.task_id()))
+    if (task_db_->insert_task_data_creating_entry(tmp_data_.task_id(), tmp_data_))
     {
-        reset_and_prepare_task_id_nts(tmp_data_.task_id());
+        reset_task_id(tmp_data_.task_id());
     }
-    task_db_->insert_task_data_nts(tmp_data_.task_id(), tmp_data_);
 }
 
 HardwareConstraintsNodeProxy::HardwareConstraintsNodeProxy(
@@ -302,18 +417,15 @@ HardwareConstraintsNodeProxy::HardwareConstraintsNodeProxy(
 void HardwareConstraintsNodeProxy::publish_data_for_iteration(
         const types::TaskId& task_id)
 {
-    types::HWConstraints* iter_data = nullptr;
-    ModuleNodeProxy::publish_data_for_iteration_(task_id, iter_data);
+    ModuleNodeProxy::publish_data_for_iteration_<types::HWConstraints>(task_id);
 }
 
 void HardwareConstraintsNodeProxy::store_data_in_db()
 {
-    std::lock_guard<std::mutex> lock(task_db_->get_mutex());
-    if (!task_db_->entry_exists_nts(tmp_data_.task_id()))
+    if (task_db_->insert_task_data_creating_entry(tmp_data_.task_id(), tmp_data_))
     {
-        reset_and_prepare_task_id_nts(tmp_data_.task_id());
+        reset_task_id(tmp_data_.task_id());
     }
-    task_db_->insert_task_data_nts(tmp_data_.task_id(), tmp_data_);
 }
 
 HardwareResourcesNodeProxy::HardwareResourcesNodeProxy(
@@ -328,18 +440,15 @@ HardwareResourcesNodeProxy::HardwareResourcesNodeProxy(
 void HardwareResourcesNodeProxy::publish_data_for_iteration(
         const types::TaskId& task_id)
 {
-    types::HWResource* iter_data = nullptr;
-    ModuleNodeProxy::publish_data_for_iteration_(task_id, iter_data);
+    ModuleNodeProxy::publish_data_for_iteration_<types::HWResource>(task_id);
 }
 
 void HardwareResourcesNodeProxy::store_data_in_db()
 {
-    std::lock_guard<std::mutex> lock(task_db_->get_mutex());
-    if (!task_db_->entry_exists_nts(tmp_data_.task_id()))
+    if (task_db_->insert_task_data_creating_entry(tmp_data_.task_id(), tmp_data_))
     {
-        reset_and_prepare_task_id_nts(tmp_data_.task_id());
+        reset_task_id(tmp_data_.task_id());
     }
-    task_db_->insert_task_data_nts(tmp_data_.task_id(), tmp_data_);
 }
 
 MLModelMetadataNodeProxy::MLModelMetadataNodeProxy(
@@ -354,18 +463,15 @@ MLModelMetadataNodeProxy::MLModelMetadataNodeProxy(
 void MLModelMetadataNodeProxy::publish_data_for_iteration(
         const types::TaskId& task_id)
 {
-    types::MLModelMetadata* iter_data = nullptr;
-    ModuleNodeProxy::publish_data_for_iteration_(task_id, iter_data);
+    ModuleNodeProxy::publish_data_for_iteration_<types::MLModelMetadata>(task_id);
 }
 
 void MLModelMetadataNodeProxy::store_data_in_db()
 {
-    std::lock_guard<std::mutex> lock(task_db_->get_mutex());
-    if (!task_db_->entry_exists_nts(tmp_data_.task_id()))
+    if (task_db_->insert_task_data_creating_entry(tmp_data_.task_id(), tmp_data_))
     {
-        reset_and_prepare_task_id_nts(tmp_data_.task_id());
+        reset_task_id(tmp_data_.task_id());
     }
-    task_db_->insert_task_data_nts(tmp_data_.task_id(), tmp_data_);
 }
 
 MLModelProviderNodeProxy::MLModelProviderNodeProxy(
@@ -380,18 +486,32 @@ MLModelProviderNodeProxy::MLModelProviderNodeProxy(
 void MLModelProviderNodeProxy::publish_data_for_iteration(
         const types::TaskId& task_id)
 {
-    types::MLModel* iter_data = nullptr;
-    ModuleNodeProxy::publish_data_for_iteration_(task_id, iter_data);
+    ModuleNodeProxy::publish_data_for_iteration_<types::MLModel>(task_id);
 }
 
 void MLModelProviderNodeProxy::store_data_in_db()
 {
-    std::lock_guard<std::mutex> lock(task_db_->get_mutex());
-    if (!task_db_->entry_exists_nts(tmp_data_.task_id()))
+    if (shared_payloads_)
+    {
+        utils::import_shared_payloads(tmp_data_);
+    }
+
+    // A failed task carrying a blob reference reports that the node did not hold its baseline blob
+    if (utils::BlobStore::is_reference(tmp_data_.raw_model()))
+    {
+        reject_baseline_blob(tmp_data_.task_id());
+        tmp_data_.raw_model().clear();
+    }
+    else
+    {
+        // The node has run this task, so it holds the baseline blob it was announced with
+        confirm_baseline_blob(tmp_data_.task_id());
+    }
+
+    if (task_db_->insert_task_data_creating_entry(tmp_data_.task_id(), tmp_data_))
     {
-        reset_and_prepare_task_id_nts(tmp_data_.task_id());
+        reset_task_id(tmp_data_.task_id());
     }
-    task_db_->insert_task_data_nts(tmp_data_.task_id(), tmp_data_);
 }
 
 } // namespace orchestrator
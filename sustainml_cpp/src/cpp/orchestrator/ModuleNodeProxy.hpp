@@ -21,19 +21,25 @@
 #define SUSTAINMLCPP_NODES_ORCHESTRATOR_MODULENODEPROXY_HPP
 
 #include <memory>
+#include <mutex>
+#include <unordered_set>
 
 #include "Helper.hpp"
 
+#include <utils/Sha256.hpp>
+
 #include <sustainml_cpp/orchestrator/OrchestratorNode.hpp>
 
 #include <fastdds/dds/domain/DomainParticipant.hpp>
 #include <fastdds/dds/domain/DomainParticipantFactory.hpp>
 #include <fastdds/dds/domain/qos/DomainParticipantQos.hpp>
 #include <fastdds/dds/publisher/DataWriter.hpp>
+#include <fastdds/dds/publisher/DataWriterListener.hpp>
 #include <fastdds/dds/publisher/Publisher.hpp>
 #include <fastdds/dds/publisher/qos/DataWriterQos.hpp>
 #include <fastdds/dds/publisher/qos/PublisherQos.hpp>
 #include <fastdds/dds/subscriber/DataReader.hpp>
+#include <fastdds/dds/subscriber/SampleInfo.hpp>
 #include <fastdds/dds/subscriber/qos/DataReaderQos.hpp>
 #include <fastdds/dds/subscriber/qos/SubscriberQos.hpp>
 #include <fastdds/dds/subscriber/Subscriber.hpp>
@@ -94,6 +100,26 @@ class ModuleNodeProxy
         ModuleNodeProxy* proxy_parent_;
     };
 
+    /**
+     * @brief Listener for the baseline writer. A reader matching the writer
+     * may not hold the last baseline blob, so it has to be sent in full again.
+     */
+    struct ModuleNodeProxyBaselineListener : public DataWriterListener
+    {
+        ModuleNodeProxyBaselineListener(
+                ModuleNodeProxy* parent);
+
+        virtual ~ModuleNodeProxyBaselineListener()
+        {
+        }
+
+        void on_publication_matched(
+                eprosima::fastdds::dds::DataWriter* writer,
+                const eprosima::fastdds::dds::PublicationMatchedStatus& status) override;
+
+        ModuleNodeProxy* proxy_parent_;
+    };
+
 public:
 
     using TaskDB_t = orchestrator::OrchestratorNode::TaskDB_t;
@@ -138,8 +164,40 @@ protected:
      */
     template<typename T>
     void publish_data_for_iteration_(
-            const types::TaskId& task_id,
-            T* data);
+            const types::TaskId& task_id);
+
+    /**
+     * @brief Writes iteration data in the baseline writer with the given task id
+     */
+    template<typename T>
+    void write_baseline_(
+            const T& data,
+            const types::TaskId& task_id);
+
+    /**
+     * @brief Writes an ML model in the baseline writer with the given task id.
+     * Its raw_model is replaced by a blob reference only if it is the same one
+     * published last time and the node confirmed it holds it, see confirm_baseline_blob.
+     * Until then, the raw_model of a few tasks is announced so that the node stores it.
+     */
+    void write_baseline_(
+            const types::MLModel& data,
+            const types::TaskId& task_id);
+
+    /**
+     * @brief Records that the node has produced the output of a task. If the
+     * baseline of that task announced the last blob, the node holds it.
+     * The blob is only confirmed while a single reader is matched.
+     */
+    void confirm_baseline_blob(
+            const types::TaskId& task_id);
+
+    /**
+     * @brief Records that the node could not resolve the baseline blob of a task,
+     * so that the next baselines are sent in full and announced again.
+     */
+    void reject_baseline_blob(
+            const types::TaskId& task_id);
 
     /**
      * @brief Notifies the Orchestrator about
@@ -151,16 +209,19 @@ protected:
      * @brief Notifies the Orchestrator about
      * a new output available in this node to store
      * it into the db
+     *
+     * @param info SampleInfo of the output, whose source timestamp is
+     * recorded in the task trace
      */
-    void notify_new_node_ouput();
+    void notify_new_node_ouput(
+            const SampleInfo& info);
 
     /**
-     * @brief Prepare a new entry and resets task manager counter
-     * to a certain task_id. This is useful in case the Orchestrator
-     * is a late joiner.
-     * @warning This method is not thread safe
+     * @brief Resets task manager counter to a certain task_id when its
+     * entry has been created on the reception of a node output.
+     * This is useful in case the Orchestrator is a late joiner.
      */
-    void reset_and_prepare_task_id_nts(
+    void reset_task_id(
             const types::TaskId& task_id);
 
     /**
@@ -180,12 +241,20 @@ protected:
      */
     virtual void* get_tmp_untyped_data() = 0;
 
+    /**
+     * @brief Get the task id of the temporary data
+     */
+    virtual const types::TaskId& get_tmp_task_id() = 0;
+
     const char* name_;
     const NodeID node_id_;
     bool publish_baseline_;
 
     OrchestratorNode* orchestrator_;
 
+    //! Copied from the orchestrator, as the derived proxies are not its friends
+    const bool shared_payloads_;
+
     types::NodeStatus status_;
     std::shared_ptr<TaskDB_t> task_db_;
 
@@ -197,8 +266,20 @@ protected:
     DataReader* status_datareader_;
     DataWriter* baseline_writer_;
 
+    //! Digest of the last raw_model written in the baseline writer, if any
+    std::unique_ptr<utils::Sha256Digest> last_baseline_blob_;
+    //! Tasks whose baseline announced last_baseline_blob_ since it was last unconfirmed
+    std::unordered_set<uint64_t> baseline_blob_tasks_;
+    //! Whether the matched reader is known to hold last_baseline_blob_
+    bool baseline_blob_confirmed_{false};
+    //! Number of readers matched with the baseline writer
+    int32_t baseline_readers_{0};
+    //! Guards the state of the baseline blob
+    std::mutex baseline_mtx_;
+
     ModuleNodeProxyListener listener_;
     ModuleNodeProxyStatusListener status_listener_;
+    ModuleNodeProxyBaselineListener baseline_listener_;
 };
 
 /**
@@ -236,6 +317,11 @@ protected:
         return &tmp_data_;
     }
 
+    inline const types::TaskId& get_tmp_task_id() override
+    {
+        return tmp_data_.task_id();
+    }
+
 private:
 
     decltype(node_id_to_type_id_)::type tmp_data_;
@@ -276,6 +362,11 @@ protected:
         return &tmp_data_;
     }
 
+    inline const types::TaskId& get_tmp_task_id() override
+    {
+        return tmp_data_.task_id();
+    }
+
 private:
 
     decltype(node_id_to_type_id_)::type tmp_data_;
@@ -316,6 +407,11 @@ protected:
         return &tmp_data_;
     }
 
+    inline const types::TaskId& get_tmp_task_id() override
+    {
+        return tmp_data_.task_id();
+    }
+
 private:
 
     decltype(node_id_to_type_id_)::type tmp_data_;
@@ -356,6 +452,11 @@ protected:
         return &tmp_data_;
     }
 
+    inline const types::TaskId& get_tmp_task_id() override
+    {
+        return tmp_data_.task_id();
+    }
+
 private:
 
     decltype(node_id_to_type_id_)::type tmp_data_;
@@ -396,6 +497,11 @@ protected:
         return &tmp_data_;
     }
 
+    inline const types::TaskId& get_tmp_task_id() override
+    {
+        return tmp_data_.task_id();
+    }
+
 private:
 
     decltype(node_id_to_type_id_)::type tmp_data_;
@@ -436,6 +542,11 @@ protected:
         return &tmp_data_;
     }
 
+    inline const types::TaskId& get_tmp_task_id() override
+    {
+        return tmp_data_.task_id();
+    }
+
 private:
 
     decltype(node_id_to_type_id_)::type tmp_data_;
@@ -17,6 +17,7 @@
  */
 
 
+#include <orchestrator/BaselinePubSubType.hpp>
 #include <orchestrator/ModuleNodeProxy.hpp>
 #include <orchestrator/TaskManager.hpp>
 
@@ -29,8 +30,7 @@ namespace orchestrator {
 
 template<typename T>
 void ModuleNodeProxy::publish_data_for_iteration_(
-        const types::TaskId& task_id,
-        T* iter_data)
+        const types::TaskId& task_id)
 {
     types::TaskId task_id_to_take_from_db(task_id);
 
@@ -41,28 +41,25 @@ void ModuleNodeProxy::publish_data_for_iteration_(
         task_id_to_take_from_db.iteration_id(task_id_to_take_from_db.iteration_id() - 1);
     }
 
-    std::unique_lock<std::mutex> lock(task_db_->get_mutex());
-    if (task_db_->get_task_data_nts(task_id_to_take_from_db, iter_data))
-    {
-        lock.unlock();
-        if (nullptr != iter_data)
-        {
-            // Publish the baseline with the new iteration id
-            // If it not a baseline, the iteration id it is already the correct one
-            iter_data->task_id(task_id);
-
-            baseline_writer_->write(iter_data->get_impl());
-
-            // Restore the original iteration id
-            iter_data->task_id(task_id_to_take_from_db);
-        }
-        else
-        {
-            EPROSIMA_LOG_ERROR(MODULE_PROXY, "Error publishing data for iteration");
-        }
+    std::shared_ptr<const T> iter_data;
 
+    if (task_db_->get_task_data(task_id_to_take_from_db, iter_data))
+    {
+        // Publish the baseline with the new iteration id
+        // If it not a baseline, the iteration id it is already the correct one
+        write_baseline_(*iter_data, task_id);
     }
 }
 
+template<typename T>
+void ModuleNodeProxy::write_baseline_(
+        const T& data,
+        const types::TaskId& task_id)
+{
+    // The task id is only replaced in the serialized sample, the data may be shared
+    BaselineTaskIdScope task_id_scope(task_id);
+    baseline_writer_->write(data.get_impl());
+}
+
 } // namespace orchestrator
 } // namespace sustainml
@@ -17,6 +17,8 @@
  */
 
 #include <chrono>
+#include <fstream>
+#include <future>
 
 #include <sustainml_cpp/orchestrator/OrchestratorNode.hpp>
 
@@ -24,10 +26,16 @@
 #include "TaskDB.ipp"
 
 #include <common/Common.hpp>
+#include <core/Options.hpp>
+#include <orchestrator/BaselinePubSubType.hpp>
+#include <orchestrator/PendingRpcRequests.hpp>
+#include <orchestrator/TaskDataWaiters.hpp>
 #include <orchestrator/TaskManager.hpp>
+#include <orchestrator/TaskTracer.hpp>
 #include <types/typesImplPubSubTypes.hpp>
 #include <types/typesImplTypeObjectSupport.hpp>
 
+#include <fastdds/dds/core/Time_t.hpp>
 #include <fastdds/dds/domain/DomainParticipant.hpp>
 #include <fastdds/dds/domain/DomainParticipantFactory.hpp>
 #include <fastdds/dds/log/Log.hpp>
@@ -46,6 +54,9 @@ using namespace eprosima::fastdds::dds;
 
 namespace {
 
+//! Deadline of the synchronous configuration requests
+constexpr uint32_t CONFIGURATION_REQUEST_TIMEOUT_MS = 5 * 60 * 1000;
+
 // One holder with a client per service/interface type
 struct RpcClientHolder
 {
@@ -55,72 +66,47 @@ struct RpcClientHolder
     std::shared_ptr<::CarbonFootprintService>    carbon_footprint_client;
     std::shared_ptr<::MLModelMetadataService>    ml_model_metadata_client;
     std::shared_ptr<::MLModelService>            ml_model_client;
+
+    //! Requests in flight to any of the clients. Shared, so that they can be cancelled
+    //! without holding the holder, and given up before the clients are destroyed
+    std::shared_ptr<sustainml::orchestrator::PendingRpcRequests> pending_requests =
+            std::make_shared<sustainml::orchestrator::PendingRpcRequests>();
 };
 
-// Helper to do the generic "update_configuration / wait / get" logic
-template<typename ClientT>
-bool rpc_update_configuration(
-        ClientT& client,
+/**
+ * @brief Sends an update_configuration request to the service of a node.
+ * @return false if the node has no configuration service.
+ */
+bool send_update_configuration(
+        RpcClientHolder& holder,
+        const sustainml::NodeID& node_id,
         const std::string& configuration,
-        std::string& out_cfg,
-        const std::atomic<bool>& terminate_flag)
+        std::future<std::string>& future)
 {
-    auto future = client.update_configuration(configuration);
+    using sustainml::NodeID;
 
-    constexpr auto total_timeout = std::chrono::minutes(5);
-    constexpr auto step = std::chrono::seconds(1);
-
-    const auto start = std::chrono::steady_clock::now();
-
-    while (true)
+    switch (node_id)
     {
-        if (terminate_flag.load(std::memory_order_acquire))
-        {
-            std::cerr << "[INFO] RPC aborted due to shutdown\n";
-            return false;
-        }
-
-        // Wait a bit, but don’t block forever
-        auto status = future.wait_for(step);
-
-        if (status == std::future_status::ready)
-        {
-            // Completed (success path OR remote exception thrown here)
-            try
-            {
-                out_cfg = future.get();
-                return true;
-            }
-            catch (const ::InternalError& e)
-            {
-                std::cerr << "[ERROR] RPC InternalError: " << e.what() << "\n";
-                return false;
-            }
-            catch (const eprosima::fastdds::dds::rpc::RpcException& e)
-            {
-                std::cerr << "[ERROR] RPC exception: " << e.what() << "\n";
-                return false;
-            }
-            catch (const std::exception& e)
-            {
-                std::cerr << "[ERROR] std::exception: " << e.what() << "\n";
-                return false;
-            }
-        }
-
-        if (status == std::future_status::deferred)
-        {
-            // Unusual for your RPC futures, but treat as “not running” / failure
-            std::cerr << "[ERROR] RPC future is deferred\n";
-            return false;
-        }
-
-        // status == timeout: check total time budget
-        if (std::chrono::steady_clock::now() - start >= total_timeout)
-        {
-            std::cerr << "[ERROR] RPC timeout after 5 minutes\n";
+        case NodeID::ID_APP_REQUIREMENTS:
+            future = holder.app_requirements_client->update_configuration(configuration);
+            return true;
+        case NodeID::ID_HW_CONSTRAINTS:
+            future = holder.hw_constraints_client->update_configuration(configuration);
+            return true;
+        case NodeID::ID_HW_RESOURCES:
+            future = holder.hw_resources_client->update_configuration(configuration);
+            return true;
+        case NodeID::ID_CARBON_FOOTPRINT:
+            future = holder.carbon_footprint_client->update_configuration(configuration);
+            return true;
+        case NodeID::ID_ML_MODEL_METADATA:
+            future = holder.ml_model_metadata_client->update_configuration(configuration);
+            return true;
+        case NodeID::ID_ML_MODEL:
+            future = holder.ml_model_client->update_configuration(configuration);
+            return true;
+        default:
             return false;
-        }
     }
 }
 
@@ -155,22 +141,38 @@ void OrchestratorNode::OrchestratorParticipantListener::on_participant_discovery
                 });
     }
 
-    // Create the proxy for this node
-    NodeID node_id = common::get_node_id_from_name(participant_name);
+    // Nodes sharing a participant are listed in its user data
+    std::vector<NodeID> node_ids;
 
-    std::cout << "[DEBUG Orchestrator] Participant discovered: name='"
-              << participant_name.to_string()
-              << "' -> node_id=" << static_cast<int>(node_id)
-              << " reason=" << static_cast<int>(reason)
-              << std::endl;
+    if (participant_name == common::SHARED_PARTICIPANT_NAME)
+    {
+        node_ids = common::get_node_ids_from_user_data(info.user_data.data_vec());
+    }
+    else
+    {
+        node_ids.push_back(common::get_node_id_from_name(participant_name));
+    }
 
     std::lock_guard<std::mutex> lock(orchestrator_->proxies_mtx_);
 
-    // Check if the node has been terminated
-    if (!orchestrator_->terminate_.load(std::memory_order_acquire) &&
-            !orchestrator_->terminated_.load(std::memory_order_acquire))
+    for (NodeID node_id : node_ids)
     {
-        if (reason == eprosima::fastdds::rtps::ParticipantDiscoveryStatus::DISCOVERED_PARTICIPANT &&
+        std::cout << "[DEBUG Orchestrator] Participant discovered: name='"
+                  << participant_name.to_string()
+                  << "' -> node_id=" << static_cast<int>(node_id)
+                  << " reason=" << static_cast<int>(reason)
+                  << std::endl;
+
+        // Check if the node has been terminated
+        if (orchestrator_->terminate_.load(std::memory_order_acquire) ||
+                orchestrator_->terminated_.load(std::memory_order_acquire))
+        {
+            break;
+        }
+
+        // A shared participant announces the nodes created after it by changing its user data
+        if ((reason == eprosima::fastdds::rtps::ParticipantDiscoveryStatus::DISCOVERED_PARTICIPANT ||
+                reason == eprosima::fastdds::rtps::ParticipantDiscoveryStatus::CHANGED_QOS_PARTICIPANT) &&
                 orchestrator_->node_proxies_[static_cast<uint32_t>(node_id)] == nullptr)
         {
             EPROSIMA_LOG_INFO(ORCHESTRATOR, "Creating node proxy for " << participant_name << " node");
@@ -193,10 +195,73 @@ void OrchestratorNode::OrchestratorParticipantListener::on_participant_discovery
     }
 }
 
+namespace {
+
+/**
+ * @brief Overrides the task DB retention limits with the ones set in the environment,
+ * so that they can be configured when the Orchestrator is created from Python.
+ */
+core::Options parse_task_db_env(
+        core::Options opts)
+{
+    auto parse = [](const char* name, std::size_t& value)
+            {
+                if (const char* env = std::getenv(name))
+                {
+                    try
+                    {
+                        value = static_cast<std::size_t>(std::stoull(env));
+                    }
+                    catch (...)
+                    {
+                        EPROSIMA_LOG_ERROR(ORCHESTRATOR, "Error parsing " << name << ", using default instead");
+                    }
+                }
+            };
+
+    parse(common::SUSTAINML_TASK_DB_MAX_PROBLEMS, opts.task_db_max_problems);
+    parse(common::SUSTAINML_TASK_DB_MAX_BYTES, opts.task_db_max_bytes);
+    parse(common::SUSTAINML_TASK_DB_LOG_MAX_PROBLEMS, opts.task_db_log_max_problems);
+
+    std::size_t ttl = static_cast<std::size_t>(opts.task_db_ttl.count());
+    parse(common::SUSTAINML_TASK_DB_TTL, ttl);
+    opts.task_db_ttl = std::chrono::seconds(ttl);
+
+    if (const char* env = std::getenv(common::SUSTAINML_TASK_DB_SPILL_DIR))
+    {
+        opts.task_db_spill_dir = env;
+    }
+
+    if (const char* env = std::getenv(common::SUSTAINML_TASK_DB_LOG_DIR))
+    {
+        opts.task_db_log_dir = env;
+    }
+
+    return opts;
+}
+
+core::Options options_for_domain(
+        uint32_t domain)
+{
+    core::Options opts;
+    opts.domain = domain;
+    return opts;
+}
+
+} // namespace
+
 OrchestratorNode::OrchestratorNode(
         OrchestratorNodeHandle& handle,
         uint32_t domain)
-    : domain_(domain)
+    : OrchestratorNode(handle, options_for_domain(domain))
+{
+}
+
+OrchestratorNode::OrchestratorNode(
+        OrchestratorNodeHandle& handle,
+        const core::Options& opts)
+    : domain_(opts.domain)
+    , shared_payloads_(opts.shared_payloads)
     , handler_(&handle)
     , participant_(nullptr)
     , control_topic_(nullptr)
@@ -214,10 +279,19 @@ OrchestratorNode::OrchestratorNode(
                 nullptr,
                 nullptr
             }),
-    task_db_(new TaskDB_t()),
+    task_db_(new TaskDB_t(parse_task_db_env(opts))),
     task_man_(new TaskManager()),
+    task_tracer_(new TaskTracer()),
+    task_waiters_(new TaskDataWaiters()),
     participant_listener_(new OrchestratorParticipantListener(this))
 {
+    // Keep numbering problems after the ones recovered from the task log
+    uint32_t last_problem_id = task_db_->max_logged_problem_id();
+    if (last_problem_id > 0)
+    {
+        task_man_->update_task_id(types::TaskId(last_problem_id, 1));
+    }
+
     if (!init())
     {
         EPROSIMA_LOG_ERROR(ORCHESTRATOR, "Orchestrator initialization Failed");
@@ -232,6 +306,7 @@ OrchestratorNode::~OrchestratorNode()
 void OrchestratorNode::destroy()
 {
     terminate_.store(true, std::memory_order_release);
+    task_waiters_->stop();
 
     if (!terminated_.load())
     {
@@ -248,13 +323,20 @@ void OrchestratorNode::destroy()
             }
         }
 
-        if (rpc_client_holder_)
+        RpcClientHolder* holder = nullptr;
+
         {
-            auto* holder = static_cast<RpcClientHolder*>(rpc_client_holder_);
-            delete holder;
+            std::lock_guard<std::mutex> lock(rpc_client_mtx_);
+            holder = static_cast<RpcClientHolder*>(rpc_client_holder_);
             rpc_client_holder_ = nullptr;
         }
 
+        if (holder)
+        {
+            holder->pending_requests->stop();
+            delete holder;
+        }
+
         if (sub_ != nullptr)
         {
             sub_->delete_contained_entities();
@@ -285,6 +367,41 @@ void OrchestratorNode::print_db()
     std::cout << *task_db_ << std::endl;
 }
 
+TaskDBStats OrchestratorNode::get_task_db_stats() const
+{
+    return task_db_->stats();
+}
+
+std::vector<TaskSpan> OrchestratorNode::get_task_trace(
+        const types::TaskId& task_id) const
+{
+    return task_tracer_->spans(task_id);
+}
+
+bool OrchestratorNode::export_task_trace(
+        const types::TaskId& task_id,
+        const std::string& path) const
+{
+    std::vector<TaskSpan> spans = task_tracer_->spans(task_id);
+
+    if (spans.empty())
+    {
+        EPROSIMA_LOG_WARNING(ORCHESTRATOR, "No trace of task " << task_id << " to export");
+        return false;
+    }
+
+    std::ofstream file(path, std::ios::trunc);
+    file << TaskTracer::to_chrome_trace(task_id, spans);
+
+    if (!file)
+    {
+        EPROSIMA_LOG_ERROR(ORCHESTRATOR, "Could not write the trace of task " << task_id << " to " << path);
+        return false;
+    }
+
+    return true;
+}
+
 bool OrchestratorNode::init()
 {
     auto dpf = DomainParticipantFactory::get_instance();
@@ -312,11 +429,12 @@ bool OrchestratorNode::init()
     std::vector<eprosima::fastdds::dds::TypeSupport> sustainml_types;
     sustainml_types.reserve(common::Topics::MAX);
 
+    //! Types published as baselines are written with the task id of the new iteration
     sustainml_types.push_back(static_cast<TypeSupport>(new AppRequirementsImplPubSubType()));
-    sustainml_types.push_back(static_cast<TypeSupport>(new CO2FootprintImplPubSubType()));
+    sustainml_types.push_back(static_cast<TypeSupport>(new BaselinePubSubType<CO2FootprintImplPubSubType>()));
     sustainml_types.push_back(static_cast<TypeSupport>(new HWConstraintsImplPubSubType()));
-    sustainml_types.push_back(static_cast<TypeSupport>(new HWResourceImplPubSubType()));
-    sustainml_types.push_back(static_cast<TypeSupport>(new MLModelImplPubSubType()));
+    sustainml_types.push_back(static_cast<TypeSupport>(new BaselinePubSubType<HWResourceImplPubSubType>()));
+    sustainml_types.push_back(static_cast<TypeSupport>(new BaselinePubSubType<MLModelImplPubSubType>()));
     sustainml_types.push_back(static_cast<TypeSupport>(new MLModelMetadataImplPubSubType()));
     sustainml_types.push_back(static_cast<TypeSupport>(new NodeControlImplPubSubType()));
     sustainml_types.push_back(static_cast<TypeSupport>(new NodeStatusImplPubSubType()));
@@ -328,16 +446,16 @@ bool OrchestratorNode::init()
     }
 
     status_topic_ = participant_->create_topic(
-        common::TopicCollection::get()[common::Topics::NODE_STATUS].first.c_str(),
-        common::TopicCollection::get()[common::Topics::NODE_STATUS].second.c_str(), TOPIC_QOS_DEFAULT);
+        common::topic_name(common::Topics::NODE_STATUS),
+        common::topic_type_name(common::Topics::NODE_STATUS), TOPIC_QOS_DEFAULT);
 
     control_topic_ = participant_->create_topic(
-        common::TopicCollection::get()[common::Topics::NODE_CONTROL].first.c_str(),
-        common::TopicCollection::get()[common::Topics::NODE_CONTROL].second.c_str(), TOPIC_QOS_DEFAULT);
+        common::topic_name(common::Topics::NODE_CONTROL),
+        common::topic_type_name(common::Topics::NODE_CONTROL), TOPIC_QOS_DEFAULT);
 
     user_input_topic_ = participant_->create_topic(
-        common::TopicCollection::get()[common::Topics::USER_INPUT].first.c_str(),
-        common::TopicCollection::get()[common::Topics::USER_INPUT].second.c_str(), TOPIC_QOS_DEFAULT);
+        common::topic_name(common::Topics::USER_INPUT),
+        common::topic_type_name(common::Topics::USER_INPUT), TOPIC_QOS_DEFAULT);
 
     if (status_topic_ == nullptr)
     {
@@ -430,7 +548,10 @@ bool OrchestratorNode::init()
         return false;
     }
 
-    rpc_client_holder_ = holder;
+    {
+        std::lock_guard<std::mutex> lock(rpc_client_mtx_);
+        rpc_client_holder_ = holder;
+    }
 
     initialized_.store(true);
     initialization_cv_.notify_one();
@@ -441,12 +562,16 @@ std::pair<types::TaskId, types::UserInput*> OrchestratorNode::prepare_new_task()
 {
     std::pair<types::TaskId, types::UserInput*> output;
     auto task_id = task_man_->create_new_task_id();
+    task_db_->prepare_new_entry(task_id, false);
+
+    std::lock_guard<std::mutex> lock(prepared_inputs_mtx_);
+    std::unique_ptr<types::UserInput>& ui = prepared_inputs_[task_id];
+    if (!ui)
     {
-        std::lock_guard<std::mutex> lock(task_db_->get_mutex());
-        task_db_->prepare_new_entry_nts(task_id, false);
-        task_db_->get_task_data_nts(task_id, output.second);
+        ui.reset(new types::UserInput());
     }
     output.first = task_id;
+    output.second = ui.get();
     return output;
 }
 
@@ -457,22 +582,48 @@ std::pair<types::TaskId, types::UserInput*> OrchestratorNode::prepare_new_iterat
     std::pair<types::TaskId, types::UserInput*> output;
     types::TaskId new_task_id(old_task_id);
     new_task_id.iteration_id(last_task_id.iteration_id() + 1);
+    task_db_->prepare_new_entry(new_task_id, true);
+    // Copy the UserInput from the previous iteration
+    // It also updates the iteration_id in the data
+    task_db_->copy_data(old_task_id, new_task_id, {NodeID::ID_ORCHESTRATOR});
+
+    std::shared_ptr<const types::UserInput> previous;
+    task_db_->get_task_data(new_task_id, previous);
+
+    std::lock_guard<std::mutex> lock(prepared_inputs_mtx_);
+    std::unique_ptr<types::UserInput>& ui = prepared_inputs_[new_task_id];
+    if (!ui)
     {
-        std::lock_guard<std::mutex> lock(task_db_->get_mutex());
-        task_db_->prepare_new_entry_nts(new_task_id, true);
-        // Copy the UserInput from the previous iteration
-        // It also updates the iteration_id in the data
-        task_db_->copy_data_nts(old_task_id, new_task_id, {NodeID::ID_ORCHESTRATOR});
-        task_db_->get_task_data_nts(new_task_id, output.second);
+        ui.reset(previous ? new types::UserInput(*previous) : new types::UserInput());
     }
     output.first = new_task_id;
+    output.second = ui.get();
     return output;
 }
 
+std::unique_ptr<types::UserInput> OrchestratorNode::take_prepared_input(
+        const types::TaskId& task_id)
+{
+    std::unique_ptr<types::UserInput> ui;
+
+    std::lock_guard<std::mutex> lock(prepared_inputs_mtx_);
+    auto it = prepared_inputs_.find(task_id);
+    if (it != prepared_inputs_.end())
+    {
+        ui = std::move(it->second);
+        prepared_inputs_.erase(it);
+    }
+    return ui;
+}
+
 bool OrchestratorNode::start_task(
         const types::TaskId& task_id,
         types::UserInput* ui)
 {
+    // Released on return, ui may point to it
+    std::unique_ptr<types::UserInput> prepared = take_prepared_input(task_id);
+    task_db_->insert_task_data(task_id, *ui);
+    record_task_input(task_id);
     user_input_writer_->write(ui->get_impl());
     publish_baselines(task_id);
     return true;
@@ -482,11 +633,23 @@ bool OrchestratorNode::start_iteration(
         const types::TaskId& task_id,
         types::UserInput* ui)
 {
+    // Released on return, ui may point to it
+    std::unique_ptr<types::UserInput> prepared = take_prepared_input(task_id);
+    task_db_->insert_task_data(task_id, *ui);
+    record_task_input(task_id);
     user_input_writer_->write(ui->get_impl());
     publish_baselines(task_id);
     return true;
 }
 
+void OrchestratorNode::record_task_input(
+        const types::TaskId& task_id)
+{
+    Time_t now;
+    Time_t::now(now);
+    task_tracer_->record_input(task_id, now.to_ns());
+}
+
 void OrchestratorNode::publish_baselines(
         const types::TaskId& task_id)
 {
@@ -502,120 +665,99 @@ void OrchestratorNode::publish_baselines(
     }
 }
 
-RetCode_t OrchestratorNode::get_task_data(
+namespace {
+
+/**
+ * @brief Retrieves the output of a node for a task.
+ *
+ * @param snapshot Receives a snapshot of the output, if not nullptr
+ * @param copy Object of the output type into which the output is copied, if not nullptr
+ */
+template<typename T>
+RetCode_t get_received_task_data(
+        OrchestratorNode::TaskDB_t& task_db,
         const types::TaskId& task_id,
-        const NodeID& node_id,
-        void*& data)
+        std::shared_ptr<const void>* snapshot,
+        void* copy)
 {
     RetCode_t ret = RetCode_t::RETCODE_NO_DATA;
+    std::shared_ptr<const T> typed_data;
+
+    // Read through a snapshot, so that shared payloads are not copied
+    if (task_db.get_task_data(task_id, typed_data))
+    {
+        //! Check if the task_id is the same as the one requested
+        //! meaning that the data has already been received
+        if (typed_data->task_id() == task_id)
+        {
+            ret = RetCode_t::RETCODE_OK;
 
-    std::lock_guard<std::mutex> lock(task_db_->get_mutex());
+            if (nullptr != copy)
+            {
+                *static_cast<T*>(copy) = *typed_data;
+            }
+        }
+
+        if (nullptr != snapshot)
+        {
+            *snapshot = std::move(typed_data);
+        }
+    }
+
+    return ret;
+}
+
+RetCode_t get_node_task_data(
+        OrchestratorNode::TaskDB_t& task_db,
+        const types::TaskId& task_id,
+        const NodeID& node_id,
+        std::shared_ptr<const void>* snapshot,
+        void* copy)
+{
+    RetCode_t ret = RetCode_t::RETCODE_NO_DATA;
 
     switch (node_id)
     {
         case NodeID::ID_ML_MODEL_METADATA:
         {
-            MapFromNodeIDToType_t<NodeID::ID_ML_MODEL_METADATA>::type* typed_data = nullptr;
-            if (task_db_->get_task_data_nts(task_id, typed_data))
-            {
-                data = typed_data;
-                //! Check if the task_id is the same as the one requested
-                //! meaning that the data has already been received
-                if (typed_data->task_id() == task_id)
-                {
-                    ret = RetCode_t::RETCODE_OK;
-                }
-            }
+            ret = get_received_task_data<MapFromNodeIDToType_t<NodeID::ID_ML_MODEL_METADATA>::type>(
+                task_db, task_id, snapshot, copy);
             break;
         }
         case NodeID::ID_ML_MODEL:
         {
-            MapFromNodeIDToType_t<NodeID::ID_ML_MODEL>::type* typed_data = nullptr;
-            if (task_db_->get_task_data_nts(task_id, typed_data))
-            {
-                data = typed_data;
-                //! Check if the task_id is the same as the one requested
-                //! meaning that the data has already been received
-                if (typed_data->task_id() == task_id)
-                {
-                    ret = RetCode_t::RETCODE_OK;
-                }
-            }
+            ret = get_received_task_data<MapFromNodeIDToType_t<NodeID::ID_ML_MODEL>::type>(
+                task_db, task_id, snapshot, copy);
             break;
         }
         case NodeID::ID_HW_RESOURCES:
         {
-            MapFromNodeIDToType_t<NodeID::ID_HW_RESOURCES>::type* typed_data = nullptr;
-            if (task_db_->get_task_data_nts(task_id, typed_data))
-            {
-                data = typed_data;
-                //! Check if the task_id is the same as the one requested
-                //! meaning that the data has already been received
-                if (typed_data->task_id() == task_id)
-                {
-                    ret = RetCode_t::RETCODE_OK;
-                }
-            }
+            ret = get_received_task_data<MapFromNodeIDToType_t<NodeID::ID_HW_RESOURCES>::type>(
+                task_db, task_id, snapshot, copy);
             break;
         }
         case NodeID::ID_CARBON_FOOTPRINT:
         {
-            MapFromNodeIDToType_t<NodeID::ID_CARBON_FOOTPRINT>::type* typed_data = nullptr;
-            if (task_db_->get_task_data_nts(task_id, typed_data))
-            {
-                data = typed_data;
-                //! Check if the task_id is the same as the one requested
-                //! meaning that the data has already been received
-                if (typed_data->task_id() == task_id)
-                {
-                    ret = RetCode_t::RETCODE_OK;
-                }
-            }
+            ret = get_received_task_data<MapFromNodeIDToType_t<NodeID::ID_CARBON_FOOTPRINT>::type>(
+                task_db, task_id, snapshot, copy);
             break;
         }
         case NodeID::ID_HW_CONSTRAINTS:
         {
-            MapFromNodeIDToType_t<NodeID::ID_HW_CONSTRAINTS>::type* typed_data = nullptr;
-            if (task_db_->get_task_data_nts(task_id, typed_data))
-            {
-                data = typed_data;
-                //! Check if the task_id is the same as the one requested
-                //! meaning that the data has already been received
-                if (typed_data->task_id() == task_id)
-                {
-                    ret = RetCode_t::RETCODE_OK;
-                }
-            }
+            ret = get_received_task_data<MapFromNodeIDToType_t<NodeID::ID_HW_CONSTRAINTS>::type>(
+                task_db, task_id, snapshot, copy);
             break;
         }
         case NodeID::ID_APP_REQUIREMENTS:
         {
-            MapFromNodeIDToType_t<NodeID::ID_APP_REQUIREMENTS>::type* typed_data = nullptr;
-            if (task_db_->get_task_data_nts(task_id, typed_data))
-            {
-                data = typed_data;
-                //! Check if the task_id is the same as the one requested
-                //! meaning that the data has already been received
-                if (typed_data->task_id() == task_id)
-                {
-                    ret = RetCode_t::RETCODE_OK;
-                }
-            }
+            ret = get_received_task_data<MapFromNodeIDToType_t<NodeID::ID_APP_REQUIREMENTS>::type>(
+                task_db, task_id, snapshot, copy);
             break;
         }
         case NodeID::ID_ORCHESTRATOR:
         {
-            MapFromNodeIDToType_t<NodeID::ID_ORCHESTRATOR>::type* typed_data = nullptr;
-            if (task_db_->get_task_data_nts(task_id, typed_data))
-            {
-                data = typed_data;
-                //! Check if the task_id is the same as the one requested
-                //! meaning that the data has already been received
-                if (typed_data->task_id() == task_id)
-                {
-                    ret = RetCode_t::RETCODE_OK;
-                }
-            }
+            ret = get_received_task_data<MapFromNodeIDToType_t<NodeID::ID_ORCHESTRATOR>::type>(
+                task_db, task_id, snapshot, copy);
             break;
         }
         default:
@@ -628,6 +770,48 @@ RetCode_t OrchestratorNode::get_task_data(
     return ret;
 }
 
+} // namespace
+
+RetCode_t OrchestratorNode::get_task_data(
+        const types::TaskId& task_id,
+        const NodeID& node_id,
+        void* data)
+{
+    if (nullptr == data)
+    {
+        EPROSIMA_LOG_ERROR(ORCHESTRATOR, "Task data requested without storage to copy it to");
+        return RetCode_t::RETCODE_ERROR;
+    }
+
+    return get_node_task_data(*task_db_, task_id, node_id, nullptr, data);
+}
+
+RetCode_t OrchestratorNode::get_task_data(
+        const types::TaskId& task_id,
+        const NodeID& node_id,
+        std::shared_ptr<const void>& data)
+{
+    return get_node_task_data(*task_db_, task_id, node_id, &data, nullptr);
+}
+
+RetCode_t OrchestratorNode::wait_for_task_data(
+        const types::TaskId& task_id,
+        const NodeID& node_id,
+        uint32_t timeout_ms)
+{
+    if (node_id >= NodeID::MAX && node_id != NodeID::ID_ORCHESTRATOR)
+    {
+        EPROSIMA_LOG_ERROR(ORCHESTRATOR, "Waiting for data from non-existing node ID");
+        return RetCode_t::RETCODE_ERROR;
+    }
+
+    return task_waiters_->wait(task_id, node_id, std::chrono::milliseconds(timeout_ms), [&]()
+                   {
+                       std::shared_ptr<const void> data;
+                       return RetCode_t::RETCODE_OK == get_task_data(task_id, node_id, data);
+                   });
+}
+
 RetCode_t OrchestratorNode::get_node_status (
         const NodeID& node_id,
         const types::NodeStatus*& status)
@@ -653,116 +837,109 @@ void OrchestratorNode::send_control_command(
 types::ResponseType OrchestratorNode::configuration_request (
         const types::RequestType& req)
 {
-    types::ResponseType res;
+    auto promise = std::make_shared<std::promise<types::ResponseType>>();
+    std::future<types::ResponseType> response = promise->get_future();
+
+    configuration_request_async(req, CONFIGURATION_REQUEST_TIMEOUT_MS, [promise](const types::ResponseType& res)
+            {
+                promise->set_value(res);
+            });
+
+    return response.get();
+}
 
+uint64_t OrchestratorNode::configuration_request_async(
+        const types::RequestType& req,
+        uint32_t timeout_ms,
+        std::function<void(const types::ResponseType&)> callback)
+{
     // Default: failure
-    res.node_id(req.node_id());
-    res.transaction_id(req.transaction_id());
-    res.success(false);
-    res.configuration("");
+    types::ResponseType failed;
+    failed.node_id(req.node_id());
+    failed.transaction_id(req.transaction_id());
+    failed.success(false);
+    failed.configuration("");
 
     if (terminate_.load())
     {
         EPROSIMA_LOG_WARNING(ORCHESTRATOR,
                 "Orchestrator is terminating, no RPC request will be sent");
-        return res;
-    }
-
-    auto* holder = static_cast<RpcClientHolder*>(rpc_client_holder_);
-    if (!holder)
-    {
-        EPROSIMA_LOG_ERROR(ORCHESTRATOR, "RPC client holder not initialized");
-        return res;
+        callback(failed);
+        return 0;
     }
 
     NodeID node_id = static_cast<NodeID>(req.node_id());
-    std::string cfg;
+    std::future<std::string> future;
+    std::shared_ptr<PendingRpcRequests> pending_requests;
 
-    try
     {
-        switch (node_id)
-        {
-            case NodeID::ID_APP_REQUIREMENTS:
-            {
-                std::cout << "[RPC CLIENT] calling AppRequirementsService.update_configuration tx="
-                          << req.transaction_id() << std::endl;
-                if (!rpc_update_configuration(*holder->app_requirements_client, req.configuration(), cfg, terminate_))
-                {
-                    return res; // Timeout or not ready
-                }
-                break;
-            }
-            case NodeID::ID_HW_CONSTRAINTS:
-            {
-                std::cout << "[RPC CLIENT] calling HWConstraintsService.update_configuration tx="
-                          << req.transaction_id() << std::endl;
-                if (!rpc_update_configuration(*holder->hw_constraints_client, req.configuration(), cfg, terminate_))
-                {
-                    return res;
-                }
-                break;
-            }
-            case NodeID::ID_HW_RESOURCES:
-            {
-                std::cout << "[RPC CLIENT] calling HWResourcesService.update_configuration tx="
-                          << req.transaction_id() << std::endl;
+        // destroy() does not delete the clients while a request is being sent
+        std::lock_guard<std::mutex> lock(rpc_client_mtx_);
+        auto* holder = static_cast<RpcClientHolder*>(rpc_client_holder_);
 
-                if (!rpc_update_configuration(*holder->hw_resources_client, req.configuration(), cfg, terminate_))
-                {
-                    return res;
-                }
-                break;
-            }
-            case NodeID::ID_CARBON_FOOTPRINT:
-            {
-                std::cout << "[RPC CLIENT] calling CarbonFootprintService.update_configuration tx="
-                          << req.transaction_id() << std::endl;
-                if (!rpc_update_configuration(*holder->carbon_footprint_client, req.configuration(), cfg, terminate_))
-                {
-                    return res;
-                }
-                break;
-            }
-            case NodeID::ID_ML_MODEL_METADATA:
+        if (!holder)
+        {
+            EPROSIMA_LOG_ERROR(ORCHESTRATOR, "RPC client holder not initialized");
+        }
+        else
+        {
+            try
             {
-                std::cout << "[RPC CLIENT] calling MLModelMetadataService.update_configuration tx="
-                          << req.transaction_id() << std::endl;
-                if (!rpc_update_configuration(*holder->ml_model_metadata_client, req.configuration(), cfg, terminate_))
+                if (send_update_configuration(*holder, node_id, req.configuration(), future))
                 {
-                    return res;
+                    pending_requests = holder->pending_requests;
                 }
-                break;
-            }
-            case NodeID::ID_ML_MODEL:
-            {
-                std::cout << "[RPC CLIENT] calling MLModelService.update_configuration tx="
-                          << req.transaction_id() << std::endl;
-                if (!rpc_update_configuration(*holder->ml_model_client, req.configuration(), cfg, terminate_))
+                else
                 {
-                    return res;
+                    EPROSIMA_LOG_ERROR(ORCHESTRATOR,
+                            "configuration_request: unsupported node_id=" << static_cast<int>(node_id));
                 }
-                break;
             }
-            default:
+            catch (const std::exception& e)
             {
                 EPROSIMA_LOG_ERROR(ORCHESTRATOR,
-                        "configuration_request: unsupported node_id=" << static_cast<int>(node_id));
-                return res;
+                        "RPC call failed with exception: " << e.what());
             }
         }
+    }
 
-        res.success(true);
-        res.configuration(cfg);
-
+    // Callbacks are never called with the holder locked, they may send or cancel other requests
+    if (!pending_requests)
+    {
+        callback(failed);
+        return 0;
     }
-    catch (const std::exception& e)
+
+    EPROSIMA_LOG_INFO(ORCHESTRATOR,
+            "Configuration request tx=" << req.transaction_id() << " sent to node " << static_cast<int>(node_id));
+
+    return pending_requests->add(std::move(future),
+                   std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms),
+                   [failed, callback](bool success, const std::string& configuration)
+                   {
+                       types::ResponseType res(failed);
+                       res.success(success);
+                       res.configuration(configuration);
+                       callback(res);
+                   });
+}
+
+bool OrchestratorNode::cancel_configuration_request(
+        uint64_t request_id)
+{
+    std::shared_ptr<PendingRpcRequests> pending_requests;
+
     {
-        EPROSIMA_LOG_ERROR(ORCHESTRATOR,
-                "RPC call failed with exception: " << e.what());
-        // Leave success=false, configuration=""
+        std::lock_guard<std::mutex> lock(rpc_client_mtx_);
+        auto* holder = static_cast<RpcClientHolder*>(rpc_client_holder_);
+
+        if (holder)
+        {
+            pending_requests = holder->pending_requests;
+        }
     }
 
-    return res;
+    return pending_requests && pending_requests->cancel(request_id);
 }
 
 void OrchestratorNode::spin()
@@ -0,0 +1,298 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file PendingRpcRequests.hpp
+ */
+
+#ifndef SUSTAINMLCPP_NODES_ORCHESTRATOR_PENDINGRPCREQUESTS_HPP
+#define SUSTAINMLCPP_NODES_ORCHESTRATOR_PENDINGRPCREQUESTS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fastdds/dds/log/Log.hpp>
+
+namespace sustainml {
+namespace orchestrator {
+
+//! Shortest period in which the futures of the pending RPC requests are checked
+constexpr std::chrono::milliseconds RPC_POLL_MIN_PERIOD{1};
+//! Longest period in which the futures of the pending RPC requests are checked
+constexpr std::chrono::milliseconds RPC_POLL_MAX_PERIOD{100};
+
+/**
+ * @brief RPC requests in flight, whose replies are handed to a callback.
+ *
+ * The futures returned by the RPC clients cannot notify their completion, so
+ * a single thread checks those of every pending request, and completes them
+ * once replied, expired or cancelled. Any number of requests may be in flight
+ * at once.
+ *
+ * The futures are checked right after a request is added, and then with a
+ * period that doubles every time no request completes, from
+ * RPC_POLL_MIN_PERIOD up to RPC_POLL_MAX_PERIOD. Requests are given up on
+ * their deadline whatever the period.
+ *
+ * Thread safe.
+ */
+class PendingRpcRequests
+{
+public:
+
+    /**
+     * @brief Called once per request, with success false if it failed, expired or
+     * was cancelled. Called from the internal thread, so it must not block.
+     */
+    using Callback = std::function<void (bool success, const std::string& reply)>;
+
+    PendingRpcRequests()
+        : thread_(&PendingRpcRequests::run, this)
+    {
+    }
+
+    ~PendingRpcRequests()
+    {
+        stop();
+    }
+
+    /**
+     * @brief Tracks a request until it is replied or its deadline expires.
+     *
+     * @param future Future of the reply
+     * @param deadline Time after which the request is given up
+     * @param callback Receives the reply
+     * @return Identifier of the request, 0 if stopped, in which case the callback is
+     * called before returning.
+     */
+    uint64_t add(
+            std::future<std::string>&& future,
+            const std::chrono::steady_clock::time_point& deadline,
+            Callback callback)
+    {
+        uint64_t request_id = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+
+            if (!stop_)
+            {
+                request_id = next_id_++;
+                requests_.emplace(request_id, Request{std::move(future), deadline, callback});
+                added_ = true;
+            }
+        }
+
+        if (0 == request_id)
+        {
+            callback(false, std::string());
+            return 0;
+        }
+
+        cv_.notify_one();
+        return request_id;
+    }
+
+    /**
+     * @brief Gives up a request, whose callback is called before returning.
+     *
+     * @return false if the request is not pending.
+     */
+    bool cancel(
+            uint64_t request_id)
+    {
+        Callback callback;
+
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            auto it = requests_.find(request_id);
+
+            if (it == requests_.end())
+            {
+                return false;
+            }
+
+            callback = std::move(it->second.callback);
+            requests_.erase(it);
+        }
+
+        EPROSIMA_LOG_INFO(ORCHESTRATOR, "RPC request " << request_id << " cancelled");
+        callback(false, std::string());
+        return true;
+    }
+
+    /**
+     * @brief Stops tracking requests, and gives up the pending ones.
+     */
+    void stop()
+    {
+        std::map<uint64_t, Request> pending;
+
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stop_ = true;
+        }
+
+        cv_.notify_one();
+
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            pending.swap(requests_);
+        }
+
+        for (auto& request : pending)
+        {
+            EPROSIMA_LOG_INFO(ORCHESTRATOR, "RPC request " << request.first << " aborted due to shutdown");
+            request.second.callback(false, std::string());
+        }
+    }
+
+private:
+
+    struct Request
+    {
+        std::future<std::string> future;
+        std::chrono::steady_clock::time_point deadline;
+        Callback callback;
+    };
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        std::chrono::milliseconds period = RPC_POLL_MIN_PERIOD;
+
+        while (!stop_)
+        {
+            if (requests_.empty())
+            {
+                cv_.wait(lock, [this]()
+                        {
+                            return stop_ || !requests_.empty();
+                        });
+                continue;
+            }
+
+            if (added_)
+            {
+                added_ = false;
+                period = RPC_POLL_MIN_PERIOD;
+            }
+
+            std::vector<std::pair<uint64_t, Request>> replied;
+            std::vector<std::pair<uint64_t, Request>> expired;
+            auto now = std::chrono::steady_clock::now();
+            auto next_deadline = std::chrono::steady_clock::time_point::max();
+
+            for (auto it = requests_.begin(); it != requests_.end();)
+            {
+                if (std::future_status::ready == it->second.future.wait_for(std::chrono::seconds(0)))
+                {
+                    replied.emplace_back(it->first, std::move(it->second));
+                    it = requests_.erase(it);
+                }
+                else if (now >= it->second.deadline)
+                {
+                    expired.emplace_back(it->first, std::move(it->second));
+                    it = requests_.erase(it);
+                }
+                else
+                {
+                    next_deadline = std::min(next_deadline, it->second.deadline);
+                    ++it;
+                }
+            }
+
+            lock.unlock();
+
+            for (auto& request : replied)
+            {
+                complete(request.first, request.second);
+            }
+
+            for (auto& request : expired)
+            {
+                EPROSIMA_LOG_WARNING(ORCHESTRATOR, "RPC request " << request.first << " expired");
+                request.second.callback(false, std::string());
+            }
+
+            // Replies tend to come in bursts, back off while none arrives
+            period = (replied.empty() && expired.empty()) ?
+                    std::min(2 * period, RPC_POLL_MAX_PERIOD) : RPC_POLL_MIN_PERIOD;
+
+            lock.lock();
+            cv_.wait_until(lock, std::min(std::chrono::steady_clock::now() + period, next_deadline), [this]()
+                    {
+                        return stop_ || added_;
+                    });
+        }
+    }
+
+    static void complete(
+            uint64_t request_id,
+            Request& request)
+    {
+        std::string reply;
+
+        try
+        {
+            // Remote exceptions are thrown here
+            reply = request.future.get();
+        }
+        catch (const std::exception& e)
+        {
+            EPROSIMA_LOG_ERROR(ORCHESTRATOR, "RPC request " << request_id << " failed: " << e.what());
+            request.callback(false, std::string());
+            return;
+        }
+
+        request.callback(true, reply);
+    }
+
+    std::mutex mtx_;
+
+    std::condition_variable cv_;
+
+    std::map<uint64_t, Request> requests_;
+
+    uint64_t next_id_{1};
+
+    //! Whether a request was added since the futures were last checked
+    bool added_{false};
+
+    bool stop_{false};
+
+    //! Declared last, so that it starts once the rest is constructed
+    std::thread thread_;
+};
+
+} // namespace orchestrator
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_NODES_ORCHESTRATOR_PENDINGRPCREQUESTS_HPP
@@ -20,128 +20,598 @@
 #ifndef SUSTAINMLCPP_NODES_ORCHESTRATOR_TASKDB_HPP
 #define SUSTAINMLCPP_NODES_ORCHESTRATOR_TASKDB_HPP
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <shared_mutex>
+#include <string>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <core/Constants.hpp>
+#include <core/Options.hpp>
+#include <orchestrator/TaskDataCodec.hpp>
+#include <orchestrator/TaskLog.hpp>
+#include <sustainml_cpp/orchestrator/OrchestratorNode.hpp>
 #include <types/types.hpp>
 
 #include <fastdds/dds/log/Log.hpp>
 
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif // ifdef _WIN32
+
 namespace sustainml {
 namespace orchestrator {
 
+/**
+ * @brief Position of a type in a parameter pack.
+ */
+template <typename T, typename ... Ts>
+struct IndexOf;
+
+template <typename T, typename ... Ts>
+struct IndexOf<T, T, Ts...> : std::integral_constant<uint32_t, 0>
+{
+};
+
+template <typename T, typename U, typename ... Ts>
+struct IndexOf<T, U, Ts...> : std::integral_constant<uint32_t, 1 + IndexOf<T, Ts...>::value>
+{
+};
+
+/**
+ * @brief Sets the value of a payload. It is always replaced, never assigned in
+ * place, since readers may hold the previous one outside of any lock.
+ */
+template<typename T>
+void assign_payload(
+        std::shared_ptr<T>& payload,
+        const T& data)
+{
+    payload = std::make_shared<T>(data);
+}
+
 /**
  * @brief Class that represents the DataBase
+ *
+ * Problems are spread over SHARDS shards by problem id, each one guarded by
+ * its own reader/writer lock, so that tasks of different problems never
+ * contend. Each (problem, iteration) entry has its own reader/writer lock
+ * that guards its data, so different node outputs of the same task are
+ * stored in parallel while readers of other entries are not blocked.
+ *
+ * Retention is configured through the task_db_* fields of Options. When the
+ * number of problems or the approximate size of the stored data exceeds its
+ * limit, whole problems are evicted in least recently used order. Problems
+ * not accessed for longer than the TTL are evicted as well. If a spill
+ * directory is configured, evicted problems are written there and read back
+ * transparently the next time they are accessed. Files are serialized,
+ * written and read back without holding any lock, and their names are unique
+ * to each DB instance.
+ *
+ * If a log directory is configured, every change is also appended to a
+ * TaskLog. Elements are serialized for it without holding the entry lock, and
+ * elements shared by copy_data() are logged as references to their source
+ * rather than in full. Problems of a previous run are not loaded at startup,
+ * they are read back from the log the first time they are accessed, as
+ * evicted problems are. The log then replaces the spill directory. Expired problems
+ * are finished and dropped from the log, as are the oldest evicted ones once
+ * the log holds more problems than its limit.
+ *
+ * Elements are stored as reference counted payloads. copy_data() shares the
+ * payload of the source entry instead of copying it, and readers can take a
+ * shared snapshot of an element that is never modified afterwards: a payload
+ * referenced from more than one place is replaced rather than modified in
+ * place (copy on write).
+ *
+ * The DB never hands out pointers to its own storage, only shared snapshots.
+ * The least recently used problem is always evicted first, and the last one
+ * is never evicted.
+ *
+ * Thread safe.
  */
 template <typename ... Args>
 class TaskDB
 {
 public:
 
-    TaskDB() = default;
+    //! Number of shards problems are spread over
+    static constexpr std::size_t SHARDS = 16;
+
+    explicit TaskDB(
+            const core::Options& opts = core::Options());
     virtual ~TaskDB();
 
     /**
      * @brief Inserts new data in the DB.
+     * @return false if the entry does not exist.
      */
     template <typename T>
-    bool insert_task_data_nts(
+    bool insert_task_data(
             const types::TaskId& task_id,
             const T& data);
 
     /**
-     * @brief Retrieves data from the DB given the task name
-     * @warning Non thread safe
+     * @brief Inserts new data in the DB, allocating its entry first if needed.
+     * @return true if the entry has been allocated by this call.
      */
     template <typename T>
-    bool get_task_data_nts(
+    bool insert_task_data_creating_entry(
             const types::TaskId& task_id,
-            T*&);
+            const T& data);
 
     /**
-     * @brief Allocates a new entry in the DB
-     * @warning Non thread safe
+     * @brief Retrieves a shared snapshot of data from the DB given the task name.
+     * The snapshot is never modified, later changes of the element replace it,
+     * and it stays valid while it is held even if its problem is evicted.
+     * Elements are modified through insert_task_data().
      */
-    bool prepare_new_entry_nts(
+    template <typename T>
+    bool get_task_data(
             const types::TaskId& task_id,
-            bool is_new_iteration);
+            std::shared_ptr<const T>&);
 
     /**
-     * @brief Checks whether a given entry exists in the DB
-     * @warning Non thread safe
+     * @brief Calls a functor with the data of a given task
+     * while holding the read lock of its entry.
+     *
+     * @param task_id Task to read.
+     * @param functor Callable taking a const T&.
+     * @return false if the entry does not exist.
      */
-    bool entry_exists_nts(
-            const types::TaskId& task_id);
+    template <typename T, typename Functor>
+    bool read_task_data(
+            const types::TaskId& task_id,
+            Functor&& functor);
 
+    /**
+     * @brief Allocates a new entry in the DB
+     */
+    bool prepare_new_entry(
+            const types::TaskId& task_id,
+            bool is_new_iteration);
 
     /**
      * @brief Checks whether a given entry exists in the DB
-     * Non thread safe
      */
-    inline std::mutex& get_mutex()
-    {
-        return mtx_;
-    }
+    bool entry_exists(
+            const types::TaskId& task_id);
 
     /**
-     * @brief Copies the data indicated in data_to_copy from one TaskId to another
+     * @brief Copies the data indicated in data_to_copy from one TaskId to another.
+     * Payloads are shared, not copied.
      */
-    bool copy_data_nts(
+    bool copy_data(
             const types::TaskId& source,
             const types::TaskId& dest,
             const std::vector<NodeID>& data_to_copy);
 
+    /**
+     * @brief Returns the occupancy and eviction counters of the DB.
+     */
+    TaskDBStats stats() const;
+
+    /**
+     * @brief Returns the highest problem id recorded in the log, 0 if there is none.
+     */
+    uint32_t max_logged_problem_id()
+    {
+        return log_ ? log_->max_problem_id() : 0;
+    }
+
     friend std::ostream& operator <<(
             std::ostream& os,
             const TaskDB<Args...>& db)
     {
-        for (auto& db_problem : db.db_)
+        // Gather every entry first, so that they are printed in order
+        std::map<std::pair<uint32_t, uint32_t>, std::shared_ptr<Entry>> entries;
+
+        for (const Shard& shard : db.shards_)
         {
-            for (auto& db_iteration : db_problem.second)
+            std::shared_lock<std::shared_timed_mutex> lock(shard.mtx);
+            for (auto& db_problem : shard.problems)
             {
-                os << types::TaskId{db_problem.first, db_iteration.first} << " : [ ";
-                os << std::get<types::AppRequirements>(db_iteration.second).task_id() << " ";
-                os << std::get<types::CO2Footprint>(db_iteration.second).task_id() << " ";
-                os << std::get<types::HWConstraints>(db_iteration.second).task_id() << " ";
-                os << std::get<types::HWResource>(db_iteration.second).task_id() << " ";
-                os << std::get<types::MLModelMetadata>(db_iteration.second).task_id() << " ";
-                os << std::get<types::MLModel>(db_iteration.second).task_id() << " ";
-                os << std::get<types::UserInput>(db_iteration.second).task_id() << " ";
-                os << "]" << std::endl;
+                for (auto& db_iteration : db_problem.second.iterations)
+                {
+                    entries.emplace(std::make_pair(db_problem.first, db_iteration.first), db_iteration.second);
+                }
             }
         }
+
+        for (auto& entry : entries)
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(entry.second->mtx);
+            const Entry& data = *entry.second;
+            os << types::TaskId{entry.first.first, entry.first.second} << " : [ ";
+            os << data.template element<types::AppRequirements>().task_id() << " ";
+            os << data.template element<types::CO2Footprint>().task_id() << " ";
+            os << data.template element<types::HWConstraints>().task_id() << " ";
+            os << data.template element<types::HWResource>().task_id() << " ";
+            os << data.template element<types::MLModelMetadata>().task_id() << " ";
+            os << data.template element<types::MLModel>().task_id() << " ";
+            os << data.template element<types::UserInput>().task_id() << " ";
+            os << "]" << std::endl;
+        }
         return os;
     }
 
 protected:
 
-    std::mutex mtx_;
-    std::map<uint32_t, std::map<uint32_t, std::tuple<Args...>>> db_;
+    //! Data of a single (problem, iteration)
+    struct Entry
+    {
+        Entry()
+            : data(std::make_shared<Args>()...)
+        {
+        }
+
+        //! Shares the payloads of an evicted entry
+        explicit Entry(
+                const std::tuple<std::shared_ptr<Args>...>& evicted_data)
+            : data(evicted_data)
+        {
+        }
+
+        template <typename T>
+        std::shared_ptr<T>& payload()
+        {
+            return std::get<std::shared_ptr<T>>(data);
+        }
+
+        template <typename T>
+        const T& element() const
+        {
+            return *std::get<std::shared_ptr<T>>(data);
+        }
+
+        mutable std::shared_timed_mutex mtx;
+        //! Never null. Payloads may be shared with other entries and snapshots
+        std::tuple<std::shared_ptr<Args>...> data;
+        //! Set once the entry has left the DB, writers must look it up again. It is never modified afterwards
+        bool evicted{false};
+        //! Bits of the elements whose current payload is not in the log yet, their modifier appends it
+        uint32_t unlogged{0};
+        //! Records of each element in the log, to tell whether a referenced one has been logged again
+        std::array<uint64_t, sizeof...(Args)> logged{};
+    };
+
+    //! Payload shared with another iteration of the problem, logged as a reference to it
+    struct LogReference
+    {
+        const Entry* source;
+        uint32_t iteration_id;
+        //! Records of the element of the source when its payload was taken
+        uint64_t logged;
+    };
+
+    using Iterations = std::map<uint32_t, std::shared_ptr<Entry>>;
+
+    struct Problem
+    {
+        Iterations iterations;
+        //! steady_clock ticks of the last access
+        std::atomic<int64_t> last_access{0};
+    };
+
+    //! Problem evicted to the spill directory
+    struct Spill
+    {
+        //! Distinguishes the files of successive spills of the same problem
+        uint64_t generation{0};
+        //! Evicted entries while the file is being written, read back from here meanwhile
+        std::shared_ptr<const Iterations> pending;
+    };
+
+    struct Shard
+    {
+        mutable std::shared_timed_mutex mtx;
+        std::map<uint32_t, Problem> problems;
+        std::map<uint32_t, Spill> spilled;
+        //! Number of problems evicted from the shard, for restores to detect they raced with one
+        uint64_t evictions{0};
+    };
+
+    using Indices = std::make_index_sequence<sizeof...(Args)>;
+
+    static constexpr std::size_t SPILL_MAGIC_SIZE = 8;
+
+    //! Leading bytes of a spilled problem file
+    static const uint8_t* spill_magic()
+    {
+        static const uint8_t value[SPILL_MAGIC_SIZE] = {'S', 'M', 'L', 'T', 'D', 'B', '0', '1'};
+        return value;
+    }
+
+    Shard& shard_of(
+            uint32_t problem_id)
+    {
+        return shards_[problem_id % SHARDS];
+    }
+
+    static int64_t now()
+    {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    /**
+     * @brief Looks up an entry, reading its problem back from the spill
+     * directory if it has been evicted.
+     * @return The entry, nullptr if it does not exist.
+     */
+    std::shared_ptr<Entry> find_entry(
+            const types::TaskId& task_id);
+
+    /**
+     * @brief Looks up an entry, allocating it if it does not exist.
+     * @param created Receives whether the entry has been allocated by this call.
+     */
+    std::shared_ptr<Entry> find_or_create_entry(
+            const types::TaskId& task_id,
+            bool& created);
+
+    /**
+     * @brief Modifies the payload of an element of an entry under its write lock,
+     * keeping the byte count up to date.
+     *
+     * @param task_id Entry to modify.
+     * @param create Whether to allocate the entry if it does not exist.
+     * @param created Receives whether the entry has been allocated by this call.
+     * @param modifier Callable taking a std::shared_ptr<T>&. A shared payload
+     * must be replaced, not modified.
+     * @param reference Source of the new payload, if it is logged as a reference to it.
+     * @return false if the entry does not exist and create is false.
+     */
+    template <typename T, typename Modifier>
+    bool modify_element(
+            const types::TaskId& task_id,
+            bool create,
+            bool& created,
+            Modifier&& modifier,
+            const LogReference* reference = nullptr);
+
+    /**
+     * @brief Shares a single element of the tuple from one entry with another.
+     */
+    template <typename T>
+    void copy_element(
+            const types::TaskId& source_id,
+            const Entry& source,
+            const types::TaskId& dest);
+
+    /**
+     * @brief Evicts problems until the DB is within its limits.
+     * Only one thread enforces the limits at a time, the rest return right away.
+     */
+    void enforce_retention();
+
+    bool over_limits() const
+    {
+        return (max_problems_ > 0 && live_problems_.load(std::memory_order_relaxed) > max_problems_) ||
+               (max_bytes_ > 0 && live_bytes_.load(std::memory_order_relaxed) > static_cast<int64_t>(max_bytes_));
+    }
+
+    /**
+     * @brief Finds the least recently used problem.
+     * @return false if the DB is empty.
+     */
+    bool find_lru_problem(
+            uint32_t& problem_id,
+            int64_t& last_access);
+
+    /**
+     * @brief Removes a problem from the DB, spilling it to disk if enabled.
+     * @param older_than Only evict it if it has not been accessed since then.
+     * @param expired Whether it is evicted for exceeding the TTL, which drops it from the log.
+     */
+    void evict_problem(
+            uint32_t problem_id,
+            int64_t older_than,
+            bool expired);
+
+    /**
+     * @brief Reads back a problem from the spill directory or the log.
+     * Files and the log are read without holding the shard lock.
+     * @return true if the problem is in the DB on return.
+     */
+    bool restore_problem(
+            uint32_t problem_id);
+
+    /**
+     * @brief Inserts a problem read back into its shard, whose lock must be held.
+     */
+    void insert_restored_problem_nts(
+            Shard& shard,
+            uint32_t problem_id,
+            Iterations& iterations);
+
+    bool write_spilled_problem(
+            uint32_t problem_id,
+            uint64_t generation,
+            const Iterations& iterations);
+
+    bool read_spilled_problem(
+            uint32_t problem_id,
+            uint64_t generation,
+            Iterations& iterations);
+
+    static bool parse_spilled_problem(
+            const std::vector<uint8_t>& file_bytes,
+            Iterations& iterations);
+
+    bool read_logged_problem(
+            uint32_t problem_id,
+            Iterations& iterations);
+
+    /**
+     * @brief Appends a modified element to the log, serializing it without the entry lock.
+     * Skipped if it has been modified again meanwhile, the last modifier logs its own payload,
+     * so that records follow the DB order.
+     *
+     * @param entry Modified entry.
+     * @param payload Payload set by the modification.
+     * @param reference Source the payload has already been logged as a reference to, if any.
+     * The payload is logged in full if the source has been logged again since.
+     */
+    template <typename T>
+    void log_element(
+            const types::TaskId& task_id,
+            Entry& entry,
+            const std::shared_ptr<T>& payload,
+            const LogReference* reference);
+
+    template <typename T>
+    void append_element(
+            const types::TaskId& task_id,
+            T& data);
+
+    /**
+     * @brief Appends the elements of an entry whose modifier has not logged them yet,
+     * with its write lock held. Called when evicting, since the problem is read back from the log.
+     */
+    template <std::size_t ... I>
+    void log_unlogged_elements_nts(
+            const types::TaskId& task_id,
+            Entry& entry,
+            std::index_sequence<I...>);
+
+    std::string spill_path(
+            uint32_t problem_id,
+            uint64_t generation) const
+    {
+        return spill_dir_ + "/" + spill_prefix_ + std::to_string(problem_id) + "_" + std::to_string(generation) +
+               ".tdb";
+    }
+
+    //! Prefix of the spill files, so that DBs sharing the spill directory never collide
+    static std::string make_spill_prefix()
+    {
+        static std::atomic<uint32_t> next_instance{0};
+#ifdef _WIN32
+        int pid = ::_getpid();
+#else
+        int pid = ::getpid();
+#endif // ifdef _WIN32
+        return "tdb_" + std::to_string(pid) + "_" + std::to_string(next_instance.fetch_add(1)) + "_problem_";
+    }
+
+    template <std::size_t ... I>
+    static std::size_t entry_size(
+            const Entry& entry,
+            std::index_sequence<I...>);
+
+    template <std::size_t ... I>
+    static bool serialize_entry(
+            const Entry& entry,
+            std::vector<uint8_t>& bytes,
+            std::index_sequence<I...>);
+
+    template <std::size_t ... I>
+    static bool deserialize_entry(
+            const uint8_t*& bytes,
+            const uint8_t* end,
+            Entry& entry,
+            std::index_sequence<I...>);
+
+    template <std::size_t ... I>
+    static bool deserialize_element(
+            Entry& entry,
+            uint32_t element,
+            const uint8_t* bytes,
+            std::size_t size,
+            std::index_sequence<I...>);
+
+    std::array<Shard, SHARDS> shards_;
+
+    const std::size_t max_problems_;
+    const std::size_t max_bytes_;
+    const int64_t ttl_;
+    const std::size_t log_max_problems_;
+    const std::string spill_dir_;
+    const std::string spill_prefix_;
+    std::atomic<uint64_t> next_spill_generation_{0};
+
+    //! Only set if Options::task_db_log_dir is set
+    std::unique_ptr<TaskLog> log_;
+
+    //! Guards the enforcement of the limits
+    std::mutex retention_mtx_;
+    int64_t next_ttl_sweep_{0};
+
+    std::atomic<std::size_t> live_problems_{0};
+    std::atomic<std::size_t> live_entries_{0};
+    std::atomic<int64_t> live_bytes_{0};
+    std::atomic<std::size_t> evicted_problems_{0};
+    std::atomic<std::size_t> spilled_problems_{0};
+    std::atomic<std::size_t> restored_problems_{0};
 };
 
+template <typename ... Args>
+TaskDB<Args...>::TaskDB(
+        const core::Options& opts)
+    : max_problems_(opts.task_db_max_problems)
+    , max_bytes_(opts.task_db_max_bytes)
+    , ttl_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(opts.task_db_ttl).count())
+    , log_max_problems_(opts.task_db_log_max_problems)
+    , spill_dir_(opts.task_db_spill_dir)
+    , spill_prefix_(make_spill_prefix())
+{
+    if (!opts.task_db_log_dir.empty())
+    {
+        log_.reset(new TaskLog(opts.task_db_log_dir, opts.task_db_log_segment_size, opts.task_db_log_sync));
+
+        if (!log_->is_open())
+        {
+            EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB, "Task log disabled, the task history will not survive a restart");
+            log_.reset();
+        }
+        else if (log_max_problems_ > 0)
+        {
+            // Nothing of the previous run is in memory yet
+            log_->drop_oldest_problems(log_max_problems_);
+        }
+    }
+}
+
 template <typename ... Args>
 TaskDB<Args...>::~TaskDB()
 {
-    std::lock_guard<std::mutex> lock(mtx_);
+    // Spilled problems do not outlive the DB
+    for (Shard& shard : shards_)
+    {
+        std::lock_guard<std::shared_timed_mutex> lock(shard.mtx);
+        for (auto& spilled : shard.spilled)
+        {
+            std::remove(spill_path(spilled.first, spilled.second.generation).c_str());
+        }
+    }
 }
 
 template <typename ... Args>
 template <typename T>
-bool TaskDB<Args...>::insert_task_data_nts(
+bool TaskDB<Args...>::insert_task_data(
         const types::TaskId& task_id,
         const T& data)
 {
-    bool ret_code = false;
+    bool created = false;
 
-    if (entry_exists_nts(task_id))
-    {
-        T& db_data = std::get<T>(db_[task_id.problem_id()][task_id.iteration_id()]);
-        db_data = data;
-        ret_code = true;
-    }
-    else
+    bool ret_code = modify_element<T>(task_id, false, created, [&data](std::shared_ptr<T>& payload)
+                    {
+                        assign_payload(payload, data);
+                    });
+
+    if (!ret_code)
     {
         EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB, "Trying to insert a data element with an unknown task id" << task_id);
     }
@@ -151,16 +621,34 @@ bool TaskDB<Args...>::insert_task_data_nts(
 
 template <typename ... Args>
 template <typename T>
-bool TaskDB<Args...>::get_task_data_nts(
+bool TaskDB<Args...>::insert_task_data_creating_entry(
+        const types::TaskId& task_id,
+        const T& data)
+{
+    bool created = false;
+
+    modify_element<T>(task_id, true, created, [&data](std::shared_ptr<T>& payload)
+            {
+                assign_payload(payload, data);
+            });
+
+    return created;
+}
+
+template <typename ... Args>
+template <typename T>
+bool TaskDB<Args...>::get_task_data(
         const types::TaskId& task_id,
-        T*& data)
+        std::shared_ptr<const T>& data)
 {
     bool ret_code = false;
 
-    if (entry_exists_nts(task_id))
+    std::shared_ptr<Entry> entry = find_entry(task_id);
+
+    if (entry)
     {
-        T& db_data = std::get<T>(db_[task_id.problem_id()][task_id.iteration_id()]);
-        data = &db_data;
+        std::shared_lock<std::shared_timed_mutex> lock(entry->mtx);
+        data = entry->template payload<T>();
         ret_code = true;
     }
     else
@@ -172,181 +660,913 @@ bool TaskDB<Args...>::get_task_data_nts(
 }
 
 template <typename ... Args>
-bool TaskDB<Args...>::prepare_new_entry_nts(
+template <typename T, typename Functor>
+bool TaskDB<Args...>::read_task_data(
         const types::TaskId& task_id,
-        bool is_new_iteration)
+        Functor&& functor)
 {
     bool ret_code = false;
 
-    if (!entry_exists_nts(task_id))
+    std::shared_ptr<Entry> entry = find_entry(task_id);
+
+    if (entry)
     {
-        db_[task_id.problem_id()][task_id.iteration_id()];
+        std::shared_lock<std::shared_timed_mutex> lock(entry->mtx);
+        functor(entry->template element<T>());
         ret_code = true;
     }
     else
     {
-        EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB, "Trying to prepare an already existing entry " << task_id);
+        EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB, "Trying to read a data element with an unknown task id" << task_id);
     }
 
     return ret_code;
 }
 
 template <typename ... Args>
-bool TaskDB<Args...>::entry_exists_nts(
-        const types::TaskId& task_id)
+bool TaskDB<Args...>::prepare_new_entry(
+        const types::TaskId& task_id,
+        bool is_new_iteration)
 {
-    bool ret_code = false;
+    static_cast<void>(is_new_iteration);
+
+    bool created = false;
 
-    auto it_problem_id = db_.find(task_id.problem_id());
+    find_or_create_entry(task_id, created);
 
-    if (it_problem_id != db_.end())
+    if (!created)
     {
-        auto it_id = db_[task_id.problem_id()].find(task_id.iteration_id());
-        if (it_id != db_[task_id.problem_id()].end())
-        {
-            ret_code = true;
-        }
+        EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB, "Trying to prepare an already existing entry " << task_id);
+    }
+    else
+    {
+        enforce_retention();
     }
 
-    return ret_code;
+    return created;
 }
 
-template<typename T>
-void substitute_data(
-        const T& old_data,
-        T& new_data)
+template <typename ... Args>
+bool TaskDB<Args...>::entry_exists(
+        const types::TaskId& task_id)
 {
-    new_data = old_data;
-    new_data.task_id(old_data.task_id());
+    return nullptr != find_entry(task_id);
 }
 
 template <typename ... Args>
-bool TaskDB<Args...>::copy_data_nts(
-        const types::TaskId& source,
-        const types::TaskId& dest,
-        const std::vector<NodeID>& data_to_copy)
+TaskDBStats TaskDB<Args...>::stats() const
 {
-    bool ret_code = false;
+    TaskDBStats stats;
+    stats.live_problems = live_problems_.load(std::memory_order_relaxed);
+    stats.live_entries = live_entries_.load(std::memory_order_relaxed);
+    int64_t live_bytes = live_bytes_.load(std::memory_order_relaxed);
+    stats.live_bytes = live_bytes > 0 ? static_cast<std::size_t>(live_bytes) : 0;
+    stats.evicted_problems = evicted_problems_.load(std::memory_order_relaxed);
+    stats.spilled_problems = spilled_problems_.load(std::memory_order_relaxed);
+    stats.restored_problems = restored_problems_.load(std::memory_order_relaxed);
+    return stats;
+}
 
-    auto it_source_problem_id = db_.find(source.problem_id());
+template <typename ... Args>
+std::shared_ptr<typename TaskDB<Args...>::Entry> TaskDB<Args...>::find_entry(
+        const types::TaskId& task_id)
+{
+    Shard& shard = shard_of(task_id.problem_id());
 
-    if (it_source_problem_id != db_.end())
     {
-        auto it_source_iteration_id = db_[source.problem_id()].find(source.iteration_id());
-        if (it_source_iteration_id != db_[source.problem_id()].end())
+        std::shared_lock<std::shared_timed_mutex> lock(shard.mtx);
+
+        auto it_problem_id = shard.problems.find(task_id.problem_id());
+
+        if (it_problem_id != shard.problems.end())
         {
-            // check that the destination exists
-            auto it_dest_problem_id = db_.find(dest.problem_id());
-            if (it_dest_problem_id != db_.end())
-            {
-                auto it_dest_iteration_id = db_[dest.problem_id()].find(dest.iteration_id());
-                if (it_dest_iteration_id != db_[dest.problem_id()].end())
-                {
-                    // copy the data
-                    for (size_t i = 0; i < data_to_copy.size(); i++)
-                    {
-                        switch (data_to_copy[i])
-                        {
-                            case NodeID::ID_APP_REQUIREMENTS:
-                            {
-                                types::AppRequirements& source_db_data = std::get<types::AppRequirements>(
-                                    it_source_iteration_id->second);
-                                types::AppRequirements& dest_db_data = std::get<types::AppRequirements>(
-                                    it_dest_iteration_id->second);
-                                substitute_data(source_db_data, dest_db_data);
-                                ret_code = true;
-                                break;
-                            }
-                            case NodeID::ID_CARBON_FOOTPRINT:
-                            {
-                                types::CO2Footprint& source_db_data = std::get<types::CO2Footprint>(
-                                    it_source_iteration_id->second);
-                                types::CO2Footprint& dest_db_data = std::get<types::CO2Footprint>(
-                                    it_dest_iteration_id->second);
-                                substitute_data(source_db_data, dest_db_data);
-                                ret_code = true;
-                                break;
-                            }
-                            case NodeID::ID_HW_CONSTRAINTS:
-                            {
-                                types::HWConstraints& source_db_data = std::get<types::HWConstraints>(
-                                    it_source_iteration_id->second);
-                                types::HWConstraints& dest_db_data = std::get<types::HWConstraints>(
-                                    it_dest_iteration_id->second);
-                                substitute_data(source_db_data, dest_db_data);
-                                ret_code = true;
-                                break;
-                            }
-                            case NodeID::ID_HW_RESOURCES:
-                            {
-                                types::HWResource& source_db_data = std::get<types::HWResource>(
-                                    it_source_iteration_id->second);
-                                types::HWResource& dest_db_data = std::get<types::HWResource>(
-                                    it_dest_iteration_id->second);
-                                substitute_data(source_db_data, dest_db_data);
-                                ret_code = true;
-                                break;
-                            }
-                            case NodeID::ID_ML_MODEL_METADATA:
-                            {
-                                types::MLModelMetadata& source_db_data = std::get<types::MLModelMetadata>(
-                                    it_source_iteration_id->second);
-                                types::MLModelMetadata& dest_db_data = std::get<types::MLModelMetadata>(
-                                    it_dest_iteration_id->second);
-                                substitute_data(source_db_data, dest_db_data);
-                                ret_code = true;
-                                break;
-                            }
-                            case NodeID::ID_ML_MODEL:
-                            {
-                                types::MLModel& source_db_data =
-                                        std::get<types::MLModel>(it_source_iteration_id->second);
-                                types::MLModel& dest_db_data = std::get<types::MLModel>(it_dest_iteration_id->second);
-                                substitute_data(source_db_data, dest_db_data);
-                                ret_code = true;
-                                break;
-                            }
-                            case NodeID::ID_ORCHESTRATOR:
-                            {
-                                types::UserInput& source_db_data = std::get<types::UserInput>(
-                                    it_source_iteration_id->second);
-                                types::UserInput& dest_db_data =
-                                        std::get<types::UserInput>(it_dest_iteration_id->second);
-                                substitute_data(source_db_data, dest_db_data);
-                                ret_code = true;
-                                break;
-                            }
-                            case NodeID::MAX:
-                            case NodeID::UNKNOWN:
-                            {
-                                break;
-                            }
-                        }
-                    }
-                }
-                else
-                {
-                    EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB,
-                            "Trying to copy data to an unknown destination iteration id " << dest);
-                }
-            }
-            else
+            it_problem_id->second.last_access.store(now(), std::memory_order_relaxed);
+
+            auto it_id = it_problem_id->second.iterations.find(task_id.iteration_id());
+            if (it_id != it_problem_id->second.iterations.end())
             {
-                EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB,
-                        "Trying to copy data to an unknown destination problem id " << dest);
+                return it_id->second;
             }
 
+            return nullptr;
         }
-        else
+        else if (shard.spilled.find(task_id.problem_id()) == shard.spilled.end() &&
+                !(log_ && log_->contains(task_id.problem_id())))
         {
-            EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB, "Trying to copy data from an unknown source iteration id " << source);
+            return nullptr;
         }
     }
-    else
+
+    if (!restore_problem(task_id.problem_id()))
+    {
+        return nullptr;
+    }
+
+    enforce_retention();
+
+    // Look it up again, unless it has already been evicted by someone else
+    std::shared_lock<std::shared_timed_mutex> lock(shard.mtx);
+
+    auto it_problem_id = shard.problems.find(task_id.problem_id());
+
+    if (it_problem_id != shard.problems.end())
+    {
+        auto it_id = it_problem_id->second.iterations.find(task_id.iteration_id());
+        if (it_id != it_problem_id->second.iterations.end())
+        {
+            return it_id->second;
+        }
+    }
+
+    return nullptr;
+}
+
+template <typename ... Args>
+std::shared_ptr<typename TaskDB<Args...>::Entry> TaskDB<Args...>::find_or_create_entry(
+        const types::TaskId& task_id,
+        bool& created)
+{
+    created = false;
+
+    std::shared_ptr<Entry> entry = find_entry(task_id);
+
+    if (entry)
     {
-        EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB, "Trying to copy data from an invalid source " << source);
+        return entry;
     }
 
+    Shard& shard = shard_of(task_id.problem_id());
+    std::lock_guard<std::shared_timed_mutex> lock(shard.mtx);
+
+    // Another thread may have created it in between
+    auto it_problem_id = shard.problems.find(task_id.problem_id());
+
+    if (it_problem_id == shard.problems.end())
+    {
+        it_problem_id = shard.problems.emplace(std::piecewise_construct,
+                        std::forward_as_tuple(task_id.problem_id()), std::forward_as_tuple()).first;
+        live_problems_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    it_problem_id->second.last_access.store(now(), std::memory_order_relaxed);
+
+    std::shared_ptr<Entry>& slot = it_problem_id->second.iterations[task_id.iteration_id()];
+
+    if (!slot)
+    {
+        slot = std::make_shared<Entry>();
+        created = true;
+
+        if (log_)
+        {
+            log_->append(task_id.problem_id(), task_id.iteration_id(), TaskLog::ENTRY_RECORD, nullptr, 0);
+        }
+
+        live_entries_.fetch_add(1, std::memory_order_relaxed);
+        live_bytes_.fetch_add(static_cast<int64_t>(entry_size(*slot, Indices{})), std::memory_order_relaxed);
+    }
+
+    return slot;
+}
+
+template <typename ... Args>
+template <typename T, typename Modifier>
+bool TaskDB<Args...>::modify_element(
+        const types::TaskId& task_id,
+        bool create,
+        bool& created,
+        Modifier&& modifier,
+        const LogReference* reference)
+{
+    constexpr uint32_t element = IndexOf<T, Args...>::value;
+    std::shared_ptr<Entry> entry;
+    std::shared_ptr<T> unlogged;
+    created = false;
+
+    // An entry evicted between the lookup and the lock is looked up again,
+    // which reads it back from the spill directory if enabled
+    for (;;)
+    {
+        bool entry_created = false;
+        entry = create ? find_or_create_entry(task_id, entry_created) : find_entry(task_id);
+        created = created || entry_created;
+
+        if (!entry)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::shared_timed_mutex> lock(entry->mtx);
+
+        if (entry->evicted)
+        {
+            continue;
+        }
+
+        std::shared_ptr<T>& payload = entry->template payload<T>();
+        int64_t old_size = static_cast<int64_t>(approximate_size(*payload));
+        modifier(payload);
+        live_bytes_.fetch_add(static_cast<int64_t>(approximate_size(*payload)) - old_size, std::memory_order_relaxed);
+
+        if (log_)
+        {
+            entry->unlogged |= 1u << element;
+            unlogged = payload;
+
+            if (nullptr != reference)
+            {
+                log_->append_reference(task_id.problem_id(), task_id.iteration_id(), element,
+                        reference->iteration_id);
+                ++entry->logged[element];
+            }
+        }
+        break;
+    }
+
+    if (unlogged)
+    {
+        log_element(task_id, *entry, unlogged, reference);
+    }
+
+    enforce_retention();
+    return true;
+}
+
+template <typename ... Args>
+template <typename T>
+void TaskDB<Args...>::log_element(
+        const types::TaskId& task_id,
+        Entry& entry,
+        const std::shared_ptr<T>& payload,
+        const LogReference* reference)
+{
+    constexpr uint32_t element = IndexOf<T, Args...>::value;
+    bool referenced = false;
+
+    if (nullptr != reference)
+    {
+        // The reference resolves to the latest record of the source, which must still hold the payload
+        std::shared_lock<std::shared_timed_mutex> lock(reference->source->mtx);
+        referenced = !reference->source->evicted && reference->source->logged[element] == reference->logged;
+    }
+
+    std::vector<uint8_t> bytes;
+    bool serialized = referenced || serialize_task_data(*payload, bytes);
+
+    std::lock_guard<std::shared_timed_mutex> lock(entry.mtx);
+
+    // Modified again or already logged on eviction
+    if (0 == (entry.unlogged & (1u << element)) || entry.template payload<T>() != payload)
+    {
+        return;
+    }
+
+    entry.unlogged &= ~(1u << element);
+
+    if (referenced)
+    {
+        return;
+    }
+    else if (serialized)
+    {
+        log_->append(task_id.problem_id(), task_id.iteration_id(), element, bytes.data(),
+                static_cast<uint32_t>(bytes.size()));
+        ++entry.logged[element];
+    }
+    else
+    {
+        EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB, "Could not serialize a data element of " << task_id << " to the log");
+    }
+}
+
+template <typename ... Args>
+template <typename T>
+void TaskDB<Args...>::append_element(
+        const types::TaskId& task_id,
+        T& data)
+{
+    std::vector<uint8_t> bytes;
+
+    if (serialize_task_data(data, bytes))
+    {
+        log_->append(task_id.problem_id(), task_id.iteration_id(), IndexOf<T, Args...>::value,
+                bytes.data(), static_cast<uint32_t>(bytes.size()));
+    }
+    else
+    {
+        EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB, "Could not serialize a data element of " << task_id << " to the log");
+    }
+}
+
+template <typename ... Args>
+template <std::size_t ... I>
+void TaskDB<Args...>::log_unlogged_elements_nts(
+        const types::TaskId& task_id,
+        Entry& entry,
+        std::index_sequence<I...>)
+{
+    int expand[] = {0, (0 != (entry.unlogged & (1u << I)) ?
+                        (append_element(task_id, *std::get<I>(entry.data)), ++entry.logged[I], 0) : 0)...};
+    static_cast<void>(expand);
+    entry.unlogged = 0;
+}
+
+template <typename ... Args>
+template <typename T>
+void TaskDB<Args...>::copy_element(
+        const types::TaskId& source_id,
+        const Entry& source,
+        const types::TaskId& dest)
+{
+    constexpr uint32_t element = IndexOf<T, Args...>::value;
+    LogReference reference{&source, source_id.iteration_id(), 0};
+    bool by_reference = false;
+
+    // Never hold both entry locks at once, copies in opposite directions would deadlock
+    std::shared_ptr<T> shared;
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(source.mtx);
+        shared = std::get<std::shared_ptr<T>>(source.data);
+
+        // Only a payload already in the log can be referenced, and from the same problem
+        reference.logged = source.logged[element];
+        by_reference = log_ && !source.evicted && 0 == (source.unlogged & (1u << element)) &&
+                reference.logged > 0 && source_id.problem_id() == dest.problem_id();
+    }
+
+    bool created = false;
+    modify_element<T>(dest, false, created, [&shared](std::shared_ptr<T>& payload)
+            {
+                payload = shared;
+            }, by_reference ? &reference : nullptr);
+}
+
+template <typename ... Args>
+bool TaskDB<Args...>::copy_data(
+        const types::TaskId& source,
+        const types::TaskId& dest,
+        const std::vector<NodeID>& data_to_copy)
+{
+    bool ret_code = false;
+
+    std::shared_ptr<Entry> source_entry = find_entry(source);
+
+    if (!source_entry)
+    {
+        EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB, "Trying to copy data from an unknown source " << source);
+    }
+    else if (!entry_exists(dest))
+    {
+        EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB, "Trying to copy data to an unknown destination " << dest);
+    }
+    else
+    {
+        for (size_t i = 0; i < data_to_copy.size(); i++)
+        {
+            switch (data_to_copy[i])
+            {
+                case NodeID::ID_APP_REQUIREMENTS:
+                {
+                    copy_element<types::AppRequirements>(source, *source_entry, dest);
+                    ret_code = true;
+                    break;
+                }
+                case NodeID::ID_CARBON_FOOTPRINT:
+                {
+                    copy_element<types::CO2Footprint>(source, *source_entry, dest);
+                    ret_code = true;
+                    break;
+                }
+                case NodeID::ID_HW_CONSTRAINTS:
+                {
+                    copy_element<types::HWConstraints>(source, *source_entry, dest);
+                    ret_code = true;
+                    break;
+                }
+                case NodeID::ID_HW_RESOURCES:
+                {
+                    copy_element<types::HWResource>(source, *source_entry, dest);
+                    ret_code = true;
+                    break;
+                }
+                case NodeID::ID_ML_MODEL_METADATA:
+                {
+                    copy_element<types::MLModelMetadata>(source, *source_entry, dest);
+                    ret_code = true;
+                    break;
+                }
+                case NodeID::ID_ML_MODEL:
+                {
+                    copy_element<types::MLModel>(source, *source_entry, dest);
+                    ret_code = true;
+                    break;
+                }
+                case NodeID::ID_ORCHESTRATOR:
+                {
+                    copy_element<types::UserInput>(source, *source_entry, dest);
+                    ret_code = true;
+                    break;
+                }
+                case NodeID::MAX:
+                case NodeID::UNKNOWN:
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    return ret_code;
+}
+
+template <typename ... Args>
+void TaskDB<Args...>::enforce_retention()
+{
+    if (0 == max_problems_ && 0 == max_bytes_ && 0 == ttl_)
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(retention_mtx_, std::try_to_lock);
+
+    if (!lock.owns_lock())
+    {
+        return;
+    }
+
+    int64_t current = now();
+
+    // Sweep expired problems at most ten times per TTL
+    if (ttl_ > 0 && current >= next_ttl_sweep_)
+    {
+        next_ttl_sweep_ = current + ttl_ / 10;
+
+        uint32_t problem_id = 0;
+        int64_t last_access = 0;
+
+        while (live_problems_.load(std::memory_order_relaxed) > 1 &&
+                find_lru_problem(problem_id, last_access) &&
+                current - last_access > ttl_)
+        {
+            evict_problem(problem_id, last_access, true);
+        }
+    }
+
+    while (over_limits() && live_problems_.load(std::memory_order_relaxed) > 1)
+    {
+        uint32_t problem_id = 0;
+        int64_t last_access = 0;
+
+        if (!find_lru_problem(problem_id, last_access))
+        {
+            break;
+        }
+
+        // Skipped if accessed in the meantime, the next one is tried then
+        evict_problem(problem_id, last_access, false);
+    }
+}
+
+template <typename ... Args>
+bool TaskDB<Args...>::find_lru_problem(
+        uint32_t& problem_id,
+        int64_t& last_access)
+{
+    bool found = false;
+
+    for (Shard& shard : shards_)
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(shard.mtx);
+
+        for (auto& problem : shard.problems)
+        {
+            int64_t access = problem.second.last_access.load(std::memory_order_relaxed);
+
+            if (!found || access < last_access)
+            {
+                problem_id = problem.first;
+                last_access = access;
+                found = true;
+            }
+        }
+    }
+
+    return found;
+}
+
+template <typename ... Args>
+void TaskDB<Args...>::evict_problem(
+        uint32_t problem_id,
+        int64_t older_than,
+        bool expired)
+{
+    Shard& shard = shard_of(problem_id);
+    // Logged problems are read back from the log instead
+    bool spill = !spill_dir_.empty() && !log_;
+    std::shared_ptr<const Iterations> evicted;
+    uint64_t generation = 0;
+
+    {
+        std::lock_guard<std::shared_timed_mutex> shard_lock(shard.mtx);
+
+        auto it_problem_id = shard.problems.find(problem_id);
+
+        if (it_problem_id == shard.problems.end() ||
+                it_problem_id->second.last_access.load(std::memory_order_relaxed) > older_than)
+        {
+            return;
+        }
+
+        Problem& problem = it_problem_id->second;
+        std::size_t n_entries = problem.iterations.size();
+        int64_t bytes = 0;
+
+        for (auto& iteration : problem.iterations)
+        {
+            Entry& entry = *iteration.second;
+            std::lock_guard<std::shared_timed_mutex> entry_lock(entry.mtx);
+
+            // Read back from the log, which must not miss the modifications still being logged
+            if (log_ && 0 != entry.unlogged)
+            {
+                log_unlogged_elements_nts(types::TaskId(problem_id, iteration.first), entry, Indices{});
+            }
+
+            bytes += static_cast<int64_t>(entry_size(entry, Indices{}));
+            entry.evicted = true;
+        }
+
+        if (spill)
+        {
+            // Read back from memory until the file is written
+            generation = next_spill_generation_.fetch_add(1, std::memory_order_relaxed);
+            evicted = std::make_shared<const Iterations>(std::move(problem.iterations));
+            Spill& record = shard.spilled[problem_id];
+            record.generation = generation;
+            record.pending = evicted;
+        }
+
+        live_entries_.fetch_sub(n_entries, std::memory_order_relaxed);
+        live_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+        live_problems_.fetch_sub(1, std::memory_order_relaxed);
+        evicted_problems_.fetch_add(1, std::memory_order_relaxed);
+
+        shard.problems.erase(it_problem_id);
+        ++shard.evictions;
+
+        // Dropped under the shard lock, so that it is not read back from the log in between
+        if (log_ && (expired || (log_max_problems_ > 0 && log_->problem_count() > log_max_problems_)))
+        {
+            log_->drop_problem(problem_id);
+        }
+    }
+
+    if (!spill)
+    {
+        return;
+    }
+
+    // Evicted entries are never modified, so they are serialized without any lock
+    bool written = write_spilled_problem(problem_id, generation, *evicted);
+    std::string path = spill_path(problem_id, generation);
+
+    std::lock_guard<std::shared_timed_mutex> shard_lock(shard.mtx);
+
+    auto it_spilled = shard.spilled.find(problem_id);
+
+    if (it_spilled == shard.spilled.end() || it_spilled->second.generation != generation)
+    {
+        // Read back, or even evicted again, while it was being written
+        std::remove(path.c_str());
+    }
+    else if (written)
+    {
+        it_spilled->second.pending.reset();
+        spilled_problems_.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        EPROSIMA_LOG_WARNING(ORCHESTRATOR_DB, "Could not spill problem " << problem_id << ", discarding it");
+        shard.spilled.erase(it_spilled);
+        std::remove(path.c_str());
+    }
+}
+
+template <typename ... Args>
+bool TaskDB<Args...>::restore_problem(
+        uint32_t problem_id)
+{
+    Shard& shard = shard_of(problem_id);
+
+    // Retried if the shard evicted a problem while reading, since the problem may have been
+    // restored, modified and evicted again meanwhile
+    for (;;)
+    {
+        Iterations iterations;
+        uint64_t evictions = 0;
+        uint64_t generation = 0;
+        bool from_log = false;
+
+        {
+            std::lock_guard<std::shared_timed_mutex> lock(shard.mtx);
+
+            if (shard.problems.find(problem_id) != shard.problems.end())
+            {
+                return true;
+            }
+
+            auto it_spilled = shard.spilled.find(problem_id);
+
+            if (it_spilled != shard.spilled.end() && it_spilled->second.pending)
+            {
+                // Still being written, its entries are shared instead of read back
+                for (auto& iteration : *it_spilled->second.pending)
+                {
+                    iterations[iteration.first] = std::make_shared<Entry>(iteration.second->data);
+                }
+
+                shard.spilled.erase(it_spilled);
+                insert_restored_problem_nts(shard, problem_id, iterations);
+                return true;
+            }
+            else if (it_spilled != shard.spilled.end())
+            {
+                generation = it_spilled->second.generation;
+            }
+            else if (log_ && log_->contains(problem_id))
+            {
+                from_log = true;
+            }
+            else
+            {
+                return false;
+            }
+
+            evictions = shard.evictions;
+        }
+
+        bool valid = from_log ?
+                read_logged_problem(problem_id, iterations) :
+                read_spilled_problem(problem_id, generation, iterations);
+
+        {
+            std::lock_guard<std::shared_timed_mutex> lock(shard.mtx);
+
+            // Restored by another thread in the meantime
+            if (shard.problems.find(problem_id) != shard.problems.end())
+            {
+                return true;
+            }
+
+            if (shard.evictions != evictions)
+            {
+                continue;
+            }
+
+            if (!from_log)
+            {
+                auto it_spilled = shard.spilled.find(problem_id);
+
+                if (it_spilled == shard.spilled.end() || it_spilled->second.generation != generation)
+                {
+                    continue;
+                }
+
+                shard.spilled.erase(it_spilled);
+            }
+
+            if (valid)
+            {
+                insert_restored_problem_nts(shard, problem_id, iterations);
+            }
+        }
+
+        if (!from_log)
+        {
+            std::remove(spill_path(problem_id, generation).c_str());
+        }
+
+        if (!valid)
+        {
+            EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB, "Could not read back problem " << problem_id);
+        }
+
+        return valid;
+    }
+}
+
+template <typename ... Args>
+void TaskDB<Args...>::insert_restored_problem_nts(
+        Shard& shard,
+        uint32_t problem_id,
+        Iterations& iterations)
+{
+    int64_t restored_bytes = 0;
+    for (auto& iteration : iterations)
+    {
+        restored_bytes += static_cast<int64_t>(entry_size(*iteration.second, Indices{}));
+    }
+
+    Problem& problem = shard.problems[problem_id];
+    problem.iterations.swap(iterations);
+    problem.last_access.store(now(), std::memory_order_relaxed);
+
+    live_problems_.fetch_add(1, std::memory_order_relaxed);
+    live_entries_.fetch_add(problem.iterations.size(), std::memory_order_relaxed);
+    live_bytes_.fetch_add(restored_bytes, std::memory_order_relaxed);
+    restored_problems_.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename ... Args>
+bool TaskDB<Args...>::write_spilled_problem(
+        uint32_t problem_id,
+        uint64_t generation,
+        const Iterations& iterations)
+{
+    // Header, number of iterations and then each iteration id followed by its serialized elements
+    std::vector<uint8_t> file_bytes(spill_magic(), spill_magic() + SPILL_MAGIC_SIZE);
+    uint32_t n_iterations = static_cast<uint32_t>(iterations.size());
+    file_bytes.insert(file_bytes.end(), reinterpret_cast<const uint8_t*>(&n_iterations),
+            reinterpret_cast<const uint8_t*>(&n_iterations) + sizeof(n_iterations));
+
+    for (auto& iteration : iterations)
+    {
+        file_bytes.insert(file_bytes.end(), reinterpret_cast<const uint8_t*>(&iteration.first),
+                reinterpret_cast<const uint8_t*>(&iteration.first) + sizeof(iteration.first));
+
+        if (!serialize_entry(*iteration.second, file_bytes, Indices{}))
+        {
+            return false;
+        }
+    }
+
+    std::ofstream file(spill_path(problem_id, generation), std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(file_bytes.data()), static_cast<std::streamsize>(file_bytes.size()));
+    file.close();
+    return !file.fail();
+}
+
+template <typename ... Args>
+bool TaskDB<Args...>::read_spilled_problem(
+        uint32_t problem_id,
+        uint64_t generation,
+        Iterations& iterations)
+{
+    std::ifstream file(spill_path(problem_id, generation), std::ios::binary);
+    std::vector<uint8_t> file_bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    return parse_spilled_problem(file_bytes, iterations);
+}
+
+template <typename ... Args>
+bool TaskDB<Args...>::parse_spilled_problem(
+        const std::vector<uint8_t>& file_bytes,
+        Iterations& iterations)
+{
+    const uint8_t* bytes = file_bytes.data();
+    const uint8_t* end = bytes + file_bytes.size();
+    uint32_t n_iterations = 0;
+
+    bool valid = file_bytes.size() >= SPILL_MAGIC_SIZE + sizeof(n_iterations) &&
+            std::memcmp(bytes, spill_magic(), SPILL_MAGIC_SIZE) == 0;
+
+    if (valid)
+    {
+        bytes += SPILL_MAGIC_SIZE;
+        std::memcpy(&n_iterations, bytes, sizeof(n_iterations));
+        bytes += sizeof(n_iterations);
+    }
+
+    for (uint32_t i = 0; valid && i < n_iterations; ++i)
+    {
+        uint32_t iteration_id = 0;
+        valid = static_cast<std::size_t>(end - bytes) >= sizeof(iteration_id);
+
+        if (valid)
+        {
+            std::memcpy(&iteration_id, bytes, sizeof(iteration_id));
+            bytes += sizeof(iteration_id);
+
+            std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+            valid = deserialize_entry(bytes, end, *entry, Indices{});
+            iterations[iteration_id] = entry;
+        }
+    }
+
+    return valid;
+}
+
+template <typename ... Args>
+bool TaskDB<Args...>::read_logged_problem(
+        uint32_t problem_id,
+        Iterations& iterations)
+{
+    bool valid = true;
+
+    bool found = log_->load_problem(problem_id,
+                    [&](uint32_t iteration_id, uint32_t element, const uint8_t* data, uint32_t size)
+                    {
+                        std::shared_ptr<Entry>& entry = iterations[iteration_id];
+                        if (!entry)
+                        {
+                            entry = std::make_shared<Entry>();
+                        }
+
+                        if (TaskLog::ENTRY_RECORD != element)
+                        {
+                            valid = valid && deserialize_element(*entry, element, data, size, Indices{});
+
+                            // Already in the log, so it can be referenced
+                            if (valid && element < sizeof...(Args))
+                            {
+                                entry->logged[element] = 1;
+                            }
+                        }
+                    });
+
+    return found && valid;
+}
+
+template <typename ... Args>
+template <std::size_t ... I>
+std::size_t TaskDB<Args...>::entry_size(
+        const Entry& entry,
+        std::index_sequence<I...>)
+{
+    std::size_t size = 0;
+    int expand[] = {0, (size += approximate_size(*std::get<I>(entry.data)), 0)...};
+    static_cast<void>(expand);
+    return size;
+}
+
+template <typename ... Args>
+template <std::size_t ... I>
+bool TaskDB<Args...>::serialize_entry(
+        const Entry& entry,
+        std::vector<uint8_t>& bytes,
+        std::index_sequence<I...>)
+{
+    bool ret_code = true;
+    std::vector<uint8_t> element;
+
+    // Each element is stored as its size followed by its CDR representation
+    auto append = [&](bool serialized)
+            {
+                uint32_t size = static_cast<uint32_t>(element.size());
+                ret_code = ret_code && serialized;
+                bytes.insert(bytes.end(), reinterpret_cast<const uint8_t*>(&size),
+                        reinterpret_cast<const uint8_t*>(&size) + sizeof(size));
+                bytes.insert(bytes.end(), element.begin(), element.end());
+            };
+
+    int expand[] = {0, (append(serialize_task_data(*std::get<I>(entry.data), element)), 0)...};
+    static_cast<void>(expand);
+    return ret_code;
+}
+
+template <typename ... Args>
+template <std::size_t ... I>
+bool TaskDB<Args...>::deserialize_entry(
+        const uint8_t*& bytes,
+        const uint8_t* end,
+        Entry& entry,
+        std::index_sequence<I...>)
+{
+    bool ret_code = true;
+
+    auto extract = [&](auto& data)
+            {
+                uint32_t size = 0;
+                ret_code = ret_code && static_cast<std::size_t>(end - bytes) >= sizeof(size);
+                if (ret_code)
+                {
+                    std::memcpy(&size, bytes, sizeof(size));
+                    bytes += sizeof(size);
+                    ret_code = static_cast<std::size_t>(end - bytes) >= size &&
+                            deserialize_task_data(bytes, size, data);
+                    bytes += ret_code ? size : 0;
+                }
+            };
+
+    int expand[] = {0, (extract(*std::get<I>(entry.data)), 0)...};
+    static_cast<void>(expand);
+    return ret_code;
+}
+
+template <typename ... Args>
+template <std::size_t ... I>
+bool TaskDB<Args...>::deserialize_element(
+        Entry& entry,
+        uint32_t element,
+        const uint8_t* bytes,
+        std::size_t size,
+        std::index_sequence<I...>)
+{
+    bool ret_code = false;
+    int expand[] = {0, (I == element ? (ret_code = deserialize_task_data(bytes, size, *std::get<I>(entry.data))) : false,
+                        0)...};
+    static_cast<void>(expand);
     return ret_code;
 }
 
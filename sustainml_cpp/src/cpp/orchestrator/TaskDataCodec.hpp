@@ -0,0 +1,224 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file TaskDataCodec.hpp
+ */
+
+#ifndef SUSTAINMLCPP_ORCHESTRATOR_TASKDATACODEC_HPP
+#define SUSTAINMLCPP_ORCHESTRATOR_TASKDATACODEC_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <types/types.hpp>
+#include <types/typesImplPubSubTypes.hpp>
+
+#include <fastdds/dds/core/policy/QosPolicies.hpp>
+#include <fastdds/rtps/common/SerializedPayload.hpp>
+
+namespace sustainml {
+namespace orchestrator {
+
+/**
+ * @brief Maps each stored type to the TopicDataType that serializes its impl.
+ */
+template <typename T>
+struct PubSubTypeOf;
+
+template <>
+struct PubSubTypeOf<types::AppRequirements>
+{
+    using type = AppRequirementsImplPubSubType;
+};
+
+template <>
+struct PubSubTypeOf<types::CO2Footprint>
+{
+    using type = CO2FootprintImplPubSubType;
+};
+
+template <>
+struct PubSubTypeOf<types::HWConstraints>
+{
+    using type = HWConstraintsImplPubSubType;
+};
+
+template <>
+struct PubSubTypeOf<types::HWResource>
+{
+    using type = HWResourceImplPubSubType;
+};
+
+template <>
+struct PubSubTypeOf<types::MLModelMetadata>
+{
+    using type = MLModelMetadataImplPubSubType;
+};
+
+template <>
+struct PubSubTypeOf<types::MLModel>
+{
+    using type = MLModelImplPubSubType;
+};
+
+template <>
+struct PubSubTypeOf<types::UserInput>
+{
+    using type = UserInputImplPubSubType;
+};
+
+/**
+ * @brief Serializes a stored element into CDR, encapsulation included.
+ *
+ * @param data Element to serialize.
+ * @param bytes Receives the serialized element.
+ * @return false if the serialization failed.
+ */
+template <typename T>
+bool serialize_task_data(
+        T& data,
+        std::vector<uint8_t>& bytes)
+{
+    using eprosima::fastdds::dds::XCDR2_DATA_REPRESENTATION;
+
+    typename PubSubTypeOf<T>::type type;
+    eprosima::fastdds::rtps::SerializedPayload_t payload(
+        type.calculate_serialized_size(data.get_impl(), XCDR2_DATA_REPRESENTATION));
+
+    if (!type.serialize(data.get_impl(), payload, XCDR2_DATA_REPRESENTATION))
+    {
+        return false;
+    }
+
+    bytes.assign(payload.data, payload.data + payload.length);
+    return true;
+}
+
+/**
+ * @brief Deserializes an element previously serialized with serialize_task_data.
+ *
+ * @param bytes Serialized element.
+ * @param size Size of the serialized element.
+ * @param data Receives the element.
+ * @return false if the deserialization failed.
+ */
+template <typename T>
+bool deserialize_task_data(
+        const uint8_t* bytes,
+        std::size_t size,
+        T& data)
+{
+    typename PubSubTypeOf<T>::type type;
+    eprosima::fastdds::rtps::SerializedPayload_t payload(static_cast<uint32_t>(size));
+    std::memcpy(payload.data, bytes, size);
+    payload.length = static_cast<uint32_t>(size);
+
+    return type.deserialize(payload, data.get_impl());
+}
+
+/**
+ * @brief Heap bytes held by the members of a stored element.
+ */
+inline std::size_t heap_size(
+        const std::string& value)
+{
+    return value.size();
+}
+
+inline std::size_t heap_size(
+        const std::vector<uint8_t>& value)
+{
+    return value.size();
+}
+
+inline std::size_t heap_size(
+        const std::vector<std::string>& value)
+{
+    std::size_t size = value.size() * sizeof(std::string);
+    for (const std::string& item : value)
+    {
+        size += item.size();
+    }
+    return size;
+}
+
+/**
+ * @brief Size of a stored element and its implementation, without their members.
+ */
+template <typename T>
+constexpr std::size_t object_size()
+{
+    return sizeof(T) + sizeof(typename T::impl_type);
+}
+
+/**
+ * @brief Approximate memory footprint of a stored element, every member accounted.
+ */
+inline std::size_t approximate_size(
+        const types::AppRequirements& data)
+{
+    return object_size<types::AppRequirements>() + heap_size(data.app_requirements()) +
+           heap_size(data.extra_data());
+}
+
+inline std::size_t approximate_size(
+        const types::CO2Footprint& data)
+{
+    return object_size<types::CO2Footprint>() + heap_size(data.extra_data());
+}
+
+inline std::size_t approximate_size(
+        const types::HWConstraints& data)
+{
+    return object_size<types::HWConstraints>() + heap_size(data.hardware_required()) +
+           heap_size(data.extra_data());
+}
+
+inline std::size_t approximate_size(
+        const types::HWResource& data)
+{
+    return object_size<types::HWResource>() + heap_size(data.hw_description()) + heap_size(data.extra_data());
+}
+
+inline std::size_t approximate_size(
+        const types::MLModelMetadata& data)
+{
+    return object_size<types::MLModelMetadata>() + heap_size(data.keywords()) +
+           heap_size(data.ml_model_metadata()) + heap_size(data.extra_data());
+}
+
+inline std::size_t approximate_size(
+        const types::MLModel& data)
+{
+    return object_size<types::MLModel>() + heap_size(data.model_path()) + heap_size(data.model()) +
+           heap_size(data.raw_model()) + heap_size(data.model_properties_path()) +
+           heap_size(data.model_properties()) + heap_size(data.input_batch()) + heap_size(data.extra_data());
+}
+
+inline std::size_t approximate_size(
+        const types::UserInput& data)
+{
+    return object_size<types::UserInput>() + heap_size(data.modality()) +
+           heap_size(data.problem_short_description()) + heap_size(data.problem_definition()) +
+           heap_size(data.inputs()) + heap_size(data.outputs()) + heap_size(data.geo_location_continent()) +
+           heap_size(data.geo_location_region()) + heap_size(data.extra_data());
+}
+
+} // namespace orchestrator
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_ORCHESTRATOR_TASKDATACODEC_HPP
@@ -0,0 +1,186 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file TaskDataWaiters.hpp
+ */
+
+#ifndef SUSTAINMLCPP_NODES_ORCHESTRATOR_TASKDATAWAITERS_HPP
+#define SUSTAINMLCPP_NODES_ORCHESTRATOR_TASKDATAWAITERS_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include <sustainml_cpp/core/Constants.hpp>
+#include <sustainml_cpp/types/types.hpp>
+
+#include <common/Common.hpp>
+
+namespace sustainml {
+namespace orchestrator {
+
+/**
+ * @brief Threads waiting for the output of a node for a task.
+ *
+ * Every (task, node) pair being waited for has its own condition variable,
+ * so that an output only wakes the threads waiting for it. Availability is
+ * checked without the internal mutex, waiters only sleep under it until the
+ * pair is notified again.
+ *
+ * Thread safe.
+ */
+class TaskDataWaiters
+{
+public:
+
+    /**
+     * @brief Waits until the output of a node for a task is available.
+     *
+     * @param task_id Task to wait for
+     * @param node_id Node whose output to wait for
+     * @param timeout Maximum time to wait
+     * @param is_available Checks whether the output is available. It is called
+     * without the internal mutex, so it may be slow or block.
+     * @return RETCODE_OK if available, RETCODE_TIMEOUT if the timeout expired,
+     * RETCODE_ERROR if stopped.
+     */
+    template<typename Predicate>
+    RetCode_t wait(
+            const types::TaskId& task_id,
+            const NodeID& node_id,
+            const std::chrono::milliseconds& timeout,
+            Predicate is_available)
+    {
+        if (is_available())
+        {
+            return RetCode_t::RETCODE_OK;
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        const Key key{common::task_id_to_key(task_id), node_id};
+
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        if (stopped_)
+        {
+            return RetCode_t::RETCODE_ERROR;
+        }
+
+        std::unique_ptr<Waiter>& entry = waiters_[key];
+
+        if (!entry)
+        {
+            entry.reset(new Waiter());
+        }
+
+        Waiter* waiter = entry.get();
+        ++waiter->count;
+
+        bool available = false;
+
+        while (!stopped_)
+        {
+            // Any notification after this point wakes the thread up, even if
+            // it arrives while the output is being checked
+            const uint64_t seen = waiter->notifications;
+
+            lock.unlock();
+            available = is_available();
+            lock.lock();
+
+            if (available || !waiter->cv.wait_until(lock, deadline, [&]()
+                    {
+                        return waiter->notifications != seen || stopped_;
+                    }))
+            {
+                break;
+            }
+        }
+
+        if (0 == --waiter->count)
+        {
+            waiters_.erase(key);
+        }
+
+        if (available)
+        {
+            return RetCode_t::RETCODE_OK;
+        }
+
+        return stopped_ ? RetCode_t::RETCODE_ERROR : RetCode_t::RETCODE_TIMEOUT;
+    }
+
+    /**
+     * @brief Wakes the threads waiting for the output of a node for a task.
+     * The output must have been made available before.
+     */
+    void notify(
+            const types::TaskId& task_id,
+            const NodeID& node_id)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto it = waiters_.find(Key{common::task_id_to_key(task_id), node_id});
+
+        if (it != waiters_.end())
+        {
+            ++it->second->notifications;
+            it->second->cv.notify_all();
+        }
+    }
+
+    /**
+     * @brief Wakes every waiting thread, and makes the next waits return
+     * as soon as the output is not available.
+     */
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stopped_ = true;
+
+        for (auto& waiter : waiters_)
+        {
+            waiter.second->cv.notify_all();
+        }
+    }
+
+private:
+
+    using Key = std::pair<uint64_t, NodeID>;
+
+    struct Waiter
+    {
+        std::condition_variable cv;
+        //! Threads waiting on cv
+        std::size_t count{0};
+        //! Number of times the pair has been notified
+        uint64_t notifications{0};
+    };
+
+    std::mutex mtx_;
+
+    std::map<Key, std::unique_ptr<Waiter>> waiters_;
+
+    bool stopped_{false};
+};
+
+} // namespace orchestrator
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_NODES_ORCHESTRATOR_TASKDATAWAITERS_HPP
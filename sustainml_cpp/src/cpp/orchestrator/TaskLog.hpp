@@ -0,0 +1,1095 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file TaskLog.hpp
+ */
+
+#ifndef SUSTAINMLCPP_ORCHESTRATOR_TASKLOG_HPP
+#define SUSTAINMLCPP_ORCHESTRATOR_TASKLOG_HPP
+
+#include <cinttypes>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <utils/Crc32.hpp>
+
+#include <fastdds/dds/log/Log.hpp>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // ifndef _WIN32
+
+namespace sustainml {
+namespace orchestrator {
+
+/**
+ * @brief Append-only log of the TaskDB contents.
+ *
+ * Every change of a DB element is appended as a record holding its
+ * (problem, iteration, element) key and its CDR representation. An element
+ * that shares the value of another iteration of its problem is appended as a
+ * reference record instead, holding only that iteration: it resolves to the
+ * latest record of the same element of that iteration that precedes it.
+ * Records are written to segment files of a bounded size. Once the active
+ * segment is full it is sealed and mapped in memory, and a new one is started.
+ *
+ * On startup the existing segments are mapped and only their record headers
+ * are scanned to index the records by problem. Payloads are checked and
+ * decoded later, when their problem is first accessed, so restarting with a
+ * long history is fast.
+ *
+ * Superseded records are dropped by compacting the sealed segments every
+ * COMPACTION_INTERVAL seals, if at least half of their bytes are dead.
+ * Problems that are no longer needed are dropped with a record that discards
+ * their previous ones, and vanish from the log at the next compaction.
+ *
+ * Appending a record only writes it. Flushing the records to the storage
+ * device and compacting the log are done by a background thread, which only
+ * takes the lock of the log to pick up its work and to install the result.
+ * Files are only accessible to their owner.
+ *
+ * Only available on POSIX systems.
+ *
+ * Thread safe.
+ */
+class TaskLog
+{
+public:
+
+    //! Element of the records that only announce a new entry
+    static constexpr uint32_t ENTRY_RECORD = 0xffffffff;
+    //! Element of the records that discard every previous record of their problem
+    static constexpr uint32_t DROP_RECORD = 0xfffffffe;
+    //! Flag of the element of reference records
+    static constexpr uint32_t REFERENCE_FLAG = 0x80000000;
+    //! Number of sealed segments between compaction attempts
+    static constexpr std::size_t COMPACTION_INTERVAL = 4;
+
+    /**
+     * @param dir Directory holding the segments.
+     * @param segment_size Size after which the active segment is sealed.
+     * @param sync Whether to flush each record to the storage device, as soon as possible.
+     */
+    TaskLog(
+            const std::string& dir,
+            std::size_t segment_size,
+            bool sync)
+        : dir_(dir)
+        , segment_size_(segment_size)
+        , sync_(sync)
+    {
+#ifndef _WIN32
+        ::mkdir(dir_.c_str(), 0700);
+
+        if (DIR* d = ::opendir(dir_.c_str()))
+        {
+            while (struct dirent* file = ::readdir(d))
+            {
+                unsigned long long seq = 0;
+                char suffix[8] = {0};
+                if (std::sscanf(file->d_name, "segment_%llu.%7s", &seq, suffix) == 2 &&
+                        std::strcmp(suffix, "log") == 0)
+                {
+                    segments_[seq].path = dir_ + "/" + file->d_name;
+                }
+            }
+            ::closedir(d);
+        }
+
+        for (auto it = segments_.begin(); it != segments_.end();)
+        {
+            map_segment(it->second);
+
+            // Active segments of runs that did not write anything
+            struct stat st;
+            if (nullptr == it->second.map && ::stat(it->second.path.c_str(), &st) == 0 && st.st_size == 0)
+            {
+                std::remove(it->second.path.c_str());
+                it = segments_.erase(it);
+                continue;
+            }
+
+            scan_segment(it->first, it->second);
+            ++it;
+        }
+
+        open_active_segment(segments_.empty() ? 1 : segments_.rbegin()->first + 1);
+
+        if (active_fd_ >= 0)
+        {
+            worker_ = std::thread(&TaskLog::run, this);
+        }
+#else
+        EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB, "The task log is not supported on this platform");
+#endif // ifndef _WIN32
+    }
+
+    ~TaskLog()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stop_ = true;
+        }
+        work_cv_.notify_all();
+
+        // Sealed segments are flushed and closed by the worker before it exits
+        if (worker_.joinable())
+        {
+            worker_.join();
+        }
+
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        for (auto& segment : segments_)
+        {
+            unmap_segment(segment.second);
+        }
+
+#ifndef _WIN32
+        if (active_fd_ >= 0)
+        {
+            if (sync_)
+            {
+                ::fdatasync(active_fd_);
+            }
+            ::close(active_fd_);
+        }
+#endif // ifndef _WIN32
+    }
+
+    bool is_open() const
+    {
+        return active_fd_ >= 0;
+    }
+
+    /**
+     * @brief Appends a record.
+     *
+     * @param problem_id Problem of the record.
+     * @param iteration_id Iteration of the record.
+     * @param element Index of the element in the DB entry, or ENTRY_RECORD.
+     * @param data Serialized element.
+     * @param size Size of the serialized element.
+     * @return false if the record could not be written.
+     */
+    bool append(
+            uint32_t problem_id,
+            uint32_t iteration_id,
+            uint32_t element,
+            const uint8_t* data,
+            uint32_t size)
+    {
+#ifndef _WIN32
+        std::vector<uint8_t> record = make_record(problem_id, iteration_id, element, data, size);
+
+        std::lock_guard<std::mutex> lock(mtx_);
+        return append_nts(record, problem_id, iteration_id, element, size);
+#else
+        static_cast<void>(problem_id);
+        static_cast<void>(iteration_id);
+        static_cast<void>(element);
+        static_cast<void>(data);
+        static_cast<void>(size);
+        return false;
+#endif // ifndef _WIN32
+    }
+
+    /**
+     * @brief Appends a reference record, holding the value of the same element of another
+     * iteration of the problem, as of its latest record.
+     *
+     * @param problem_id Problem of the record.
+     * @param iteration_id Iteration of the record.
+     * @param element Index of the element in the DB entry.
+     * @param source_iteration_id Iteration whose element is referenced.
+     * @return false if the record could not be written.
+     */
+    bool append_reference(
+            uint32_t problem_id,
+            uint32_t iteration_id,
+            uint32_t element,
+            uint32_t source_iteration_id)
+    {
+        return append(problem_id, iteration_id, element | REFERENCE_FLAG,
+                       reinterpret_cast<const uint8_t*>(&source_iteration_id), sizeof(source_iteration_id));
+    }
+
+    /**
+     * @brief Drops every record of a problem, which is not read back anymore, not even after a restart.
+     * @return false if the problem is not in the log or the drop could not be written.
+     */
+    bool drop_problem(
+            uint32_t problem_id)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return drop_problem_nts(problem_id);
+    }
+
+    /**
+     * @brief Drops the problems with the lowest ids until at most max_problems remain.
+     */
+    void drop_oldest_problems(
+            std::size_t max_problems)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        while (index_.size() > max_problems && drop_problem_nts(index_.begin()->first))
+        {
+        }
+    }
+
+    /**
+     * @brief Returns the number of problems in the log.
+     */
+    std::size_t problem_count()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return index_.size();
+    }
+
+    /**
+     * @brief Waits until the background thread is idle: the records appended so far are
+     * on the storage device, if sync is enabled, and pending compactions are done.
+     */
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        if (!worker_.joinable())
+        {
+            return;
+        }
+
+        sync_pending_ = sync_pending_ || sync_;
+        work_cv_.notify_one();
+        idle_cv_.wait(lock, [this]()
+                {
+                    return stop_ || (!busy_ && !has_work_nts());
+                });
+    }
+
+    /**
+     * @brief Returns whether the log holds records of a problem.
+     */
+    bool contains(
+            uint32_t problem_id)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return index_.find(problem_id) != index_.end();
+    }
+
+    /**
+     * @brief Returns the highest problem id in the log, 0 if it is empty.
+     */
+    uint32_t max_problem_id()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return max_problem_id_;
+    }
+
+    /**
+     * @brief Reads back the latest record of every element of a problem.
+     *
+     * @param problem_id Problem to read.
+     * @param functor Callable taking the iteration id, the element, and a
+     * pointer and size of the serialized element. It is called in log order,
+     * with references already resolved.
+     * @return false if the problem is not in the log or a record is corrupted.
+     */
+    template <typename Functor>
+    bool load_problem(
+            uint32_t problem_id,
+            Functor&& functor)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        auto it = index_.find(problem_id);
+
+        if (it == index_.end())
+        {
+            return false;
+        }
+
+        std::vector<uint8_t> buffer;
+
+        for (std::size_t index : latest_records(it->second))
+        {
+            const Location& location = it->second[index];
+            std::size_t resolved = index;
+            const uint8_t* record = resolve_record_nts(it->second, resolved, buffer);
+
+            if (nullptr == record)
+            {
+                EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB, "Corrupted record of problem " << problem_id << " in the task log");
+                return false;
+            }
+
+            functor(location.iteration_id, element_of(location.element), record + HEADER_SIZE,
+                    it->second[resolved].size);
+        }
+
+        return true;
+    }
+
+private:
+
+    //! Magic, problem, iteration, element, size and CRC
+    static constexpr std::size_t HEADER_SIZE = 6 * sizeof(uint32_t);
+    static constexpr uint32_t MAGIC = 0x524c4d53;
+
+    struct Location
+    {
+        uint64_t segment;
+        //! Offset of the record header in the segment
+        uint64_t offset;
+        //! Size of the payload
+        uint32_t size;
+        uint32_t iteration_id;
+        //! As written, with REFERENCE_FLAG for reference records
+        uint32_t element;
+    };
+
+    struct Segment
+    {
+        std::string path;
+        const uint8_t* map{nullptr};
+        std::size_t mapped_size{0};
+        //! Bytes of valid records
+        std::size_t size{0};
+    };
+
+    static bool is_reference(
+            uint32_t element)
+    {
+        return element < DROP_RECORD && 0 != (element & REFERENCE_FLAG);
+    }
+
+    static uint32_t element_of(
+            uint32_t element)
+    {
+        return is_reference(element) ? element & ~REFERENCE_FLAG : element;
+    }
+
+    /**
+     * @brief Finds the record a reference record resolves to.
+     *
+     * @param locations Records of a problem, in log order.
+     * @param index Position of the reference, receives the position of the referenced record.
+     * @param source_iteration_id Iteration held by the reference.
+     * @return false if there is no such record.
+     */
+    static bool find_referenced(
+            const std::vector<Location>& locations,
+            std::size_t& index,
+            uint32_t source_iteration_id)
+    {
+        uint32_t element = element_of(locations[index].element);
+
+        for (std::size_t source = index; source > 0; --source)
+        {
+            const Location& location = locations[source - 1];
+
+            if (location.iteration_id == source_iteration_id && element_of(location.element) == element)
+            {
+                index = source - 1;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //! CRC of the header fields after the magic and of the payload
+    static uint32_t record_crc(
+            const uint8_t* record,
+            const uint8_t* payload,
+            uint32_t size)
+    {
+        uint32_t crc = utils::crc32(record + sizeof(uint32_t), 4 * sizeof(uint32_t));
+        return utils::crc32(payload, size, crc);
+    }
+
+    static uint32_t stored_crc(
+            const uint8_t* record)
+    {
+        uint32_t crc = 0;
+        std::memcpy(&crc, record + HEADER_SIZE - sizeof(crc), sizeof(crc));
+        return crc;
+    }
+
+    static std::vector<uint8_t> make_record(
+            uint32_t problem_id,
+            uint32_t iteration_id,
+            uint32_t element,
+            const uint8_t* data,
+            uint32_t size)
+    {
+        std::vector<uint8_t> record(HEADER_SIZE + size);
+        uint32_t fields[] = {problem_id, iteration_id, element, size};
+        std::memcpy(record.data() + sizeof(uint32_t), fields, sizeof(fields));
+        if (size > 0)
+        {
+            std::memcpy(record.data() + HEADER_SIZE, data, size);
+        }
+        uint32_t magic = MAGIC;
+        uint32_t crc = record_crc(record.data(), record.data() + HEADER_SIZE, size);
+        std::memcpy(record.data(), &magic, sizeof(magic));
+        std::memcpy(record.data() + HEADER_SIZE - sizeof(crc), &crc, sizeof(crc));
+        return record;
+    }
+
+    bool append_nts(
+            const std::vector<uint8_t>& record,
+            uint32_t problem_id,
+            uint32_t iteration_id,
+            uint32_t element,
+            uint32_t size)
+    {
+#ifndef _WIN32
+        if (active_fd_ < 0)
+        {
+            return false;
+        }
+
+        Segment& active = segments_[active_seq_];
+
+        if (active.size > 0 && active.size + record.size() > segment_size_)
+        {
+            seal_active_segment_nts();
+            if (active_fd_ < 0)
+            {
+                return false;
+            }
+        }
+
+        Segment& segment = segments_[active_seq_];
+
+        if (::write(active_fd_, record.data(), record.size()) != static_cast<ssize_t>(record.size()))
+        {
+            EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB, "Could not append to the task log " << segment.path);
+            return false;
+        }
+
+        if (sync_ && !sync_pending_)
+        {
+            sync_pending_ = true;
+            work_cv_.notify_one();
+        }
+
+        if (DROP_RECORD == element)
+        {
+            index_.erase(problem_id);
+        }
+        else
+        {
+            index_[problem_id].push_back(Location{active_seq_, segment.size, size, iteration_id, element});
+        }
+        segment.size += record.size();
+
+        if (problem_id > max_problem_id_)
+        {
+            max_problem_id_ = problem_id;
+        }
+
+        return true;
+#else
+        static_cast<void>(record);
+        static_cast<void>(problem_id);
+        static_cast<void>(iteration_id);
+        static_cast<void>(element);
+        static_cast<void>(size);
+        return false;
+#endif // ifndef _WIN32
+    }
+
+    bool drop_problem_nts(
+            uint32_t problem_id)
+    {
+        if (index_.find(problem_id) == index_.end())
+        {
+            return false;
+        }
+
+        std::vector<uint8_t> record = make_record(problem_id, 0, DROP_RECORD, nullptr, 0);
+        return append_nts(record, problem_id, 0, DROP_RECORD, 0);
+    }
+
+    bool has_work_nts() const
+    {
+        return sync_pending_ || compaction_pending_ || !sealed_fds_.empty();
+    }
+
+    //! Background thread flushing the segments and compacting the log
+    void run()
+    {
+#ifndef _WIN32
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        for (;;)
+        {
+            work_cv_.wait(lock, [this]()
+                    {
+                        return stop_ || has_work_nts();
+                    });
+
+            if (stop_ && !has_work_nts())
+            {
+                break;
+            }
+
+            std::vector<int> sealed_fds;
+            sealed_fds.swap(sealed_fds_);
+
+            // Duplicated, the active segment may be sealed and closed meanwhile
+            int active_fd = sync_pending_ ? ::dup(active_fd_) : -1;
+            sync_pending_ = false;
+
+            bool compaction = compaction_pending_ && !stop_;
+            compaction_pending_ = false;
+
+            busy_ = true;
+            lock.unlock();
+
+            for (int fd : sealed_fds)
+            {
+                ::fdatasync(fd);
+                ::close(fd);
+            }
+
+            if (active_fd >= 0)
+            {
+                ::fdatasync(active_fd);
+                ::close(active_fd);
+            }
+
+            if (compaction)
+            {
+                compact();
+            }
+
+            lock.lock();
+            busy_ = false;
+            idle_cv_.notify_all();
+        }
+#endif // ifndef _WIN32
+    }
+
+    //! Positions of the last record of each (iteration, element), in log order
+    static std::vector<std::size_t> latest_records(
+            const std::vector<Location>& locations)
+    {
+        std::map<std::pair<uint32_t, uint32_t>, std::size_t> latest;
+
+        for (std::size_t i = 0; i < locations.size(); ++i)
+        {
+            latest[std::make_pair(locations[i].iteration_id, element_of(locations[i].element))] = i;
+        }
+
+        std::vector<bool> keep(locations.size(), false);
+        for (auto& entry : latest)
+        {
+            keep[entry.second] = true;
+        }
+
+        std::vector<std::size_t> output;
+        output.reserve(latest.size());
+        for (std::size_t i = 0; i < locations.size(); ++i)
+        {
+            if (keep[i])
+            {
+                output.push_back(i);
+            }
+        }
+        return output;
+    }
+
+    /**
+     * @brief Returns a pointer to a whole checked record, following references.
+     *
+     * @param locations Records of a problem, in log order.
+     * @param index Position of the record, receives the position of the record it resolves to.
+     * @param buffer Storage for records that are not mapped.
+     * @return nullptr if a record is corrupted or a reference cannot be resolved.
+     */
+    const uint8_t* resolve_record_nts(
+            const std::vector<Location>& locations,
+            std::size_t& index,
+            std::vector<uint8_t>& buffer)
+    {
+        for (;;)
+        {
+            const Location& location = locations[index];
+            const uint8_t* record = read_record_nts(location, buffer);
+            uint32_t source_iteration_id = 0;
+
+            if (nullptr == record ||
+                    record_crc(record, record + HEADER_SIZE, location.size) != stored_crc(record))
+            {
+                return nullptr;
+            }
+            else if (!is_reference(location.element))
+            {
+                return record;
+            }
+            else if (location.size != sizeof(source_iteration_id))
+            {
+                return nullptr;
+            }
+
+            std::memcpy(&source_iteration_id, record + HEADER_SIZE, sizeof(source_iteration_id));
+
+            if (!find_referenced(locations, index, source_iteration_id))
+            {
+                return nullptr;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns a pointer to a whole record, reading it into buffer
+     * if its segment is not mapped.
+     */
+    const uint8_t* read_record_nts(
+            const Location& location,
+            std::vector<uint8_t>& buffer)
+    {
+        Segment& segment = segments_[location.segment];
+
+        if (nullptr != segment.map)
+        {
+            return segment.map + location.offset;
+        }
+
+#ifndef _WIN32
+        // Only the active segment is not mapped
+        buffer.resize(HEADER_SIZE + location.size);
+        ssize_t read = ::pread(active_fd_, buffer.data(), buffer.size(), static_cast<off_t>(location.offset));
+        return (read == static_cast<ssize_t>(buffer.size())) ? buffer.data() : nullptr;
+#else
+        return nullptr;
+#endif // ifndef _WIN32
+    }
+
+    void map_segment(
+            Segment& segment)
+    {
+#ifndef _WIN32
+        int fd = ::open(segment.path.c_str(), O_RDONLY);
+
+        if (fd < 0)
+        {
+            return;
+        }
+
+        struct stat st;
+
+        if (::fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void* addr = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            if (MAP_FAILED != addr)
+            {
+                segment.map = static_cast<const uint8_t*>(addr);
+                segment.mapped_size = static_cast<std::size_t>(st.st_size);
+            }
+        }
+
+        ::close(fd);
+#else
+        static_cast<void>(segment);
+#endif // ifndef _WIN32
+    }
+
+    void unmap_segment(
+            Segment& segment)
+    {
+#ifndef _WIN32
+        if (nullptr != segment.map)
+        {
+            ::munmap(const_cast<uint8_t*>(segment.map), segment.mapped_size);
+        }
+#endif // ifndef _WIN32
+        segment.map = nullptr;
+        segment.mapped_size = 0;
+    }
+
+    //! Indexes the records of a mapped segment, stopping at the first invalid one
+    void scan_segment(
+            uint64_t seq,
+            Segment& segment)
+    {
+        std::size_t offset = 0;
+        std::vector<std::pair<uint32_t, Location>> records;
+
+        while (nullptr != segment.map && offset + HEADER_SIZE <= segment.mapped_size)
+        {
+            const uint8_t* record = segment.map + offset;
+            uint32_t fields[5];
+            std::memcpy(fields, record, sizeof(fields));
+
+            if (fields[0] != MAGIC || offset + HEADER_SIZE + fields[4] > segment.mapped_size)
+            {
+                break;
+            }
+
+            records.emplace_back(fields[1], Location{seq, offset, fields[4], fields[2], fields[3]});
+            offset += HEADER_SIZE + fields[4];
+        }
+
+        // A crash may have torn the last record
+        if (!records.empty())
+        {
+            const Location& last = records.back().second;
+            const uint8_t* record = segment.map + last.offset;
+
+            if (record_crc(record, record + HEADER_SIZE, last.size) != stored_crc(record))
+            {
+                offset = last.offset;
+                records.pop_back();
+            }
+        }
+
+        if (offset != segment.mapped_size)
+        {
+            EPROSIMA_LOG_WARNING(ORCHESTRATOR_DB, "Ignoring " << segment.mapped_size - offset
+                                                              << " trailing bytes of " << segment.path);
+        }
+
+        segment.size = offset;
+
+        for (auto& record : records)
+        {
+            if (DROP_RECORD == record.second.element)
+            {
+                index_.erase(record.first);
+            }
+            else
+            {
+                index_[record.first].push_back(record.second);
+            }
+
+            if (record.first > max_problem_id_)
+            {
+                max_problem_id_ = record.first;
+            }
+        }
+    }
+
+    void open_active_segment(
+            uint64_t seq)
+    {
+#ifndef _WIN32
+        char name[64];
+        std::snprintf(name, sizeof(name), "/segment_%016" PRIu64 ".log", seq);
+
+        Segment& segment = segments_[seq];
+        segment.path = dir_ + name;
+
+        active_fd_ = ::open(segment.path.c_str(), O_CREAT | O_EXCL | O_RDWR | O_APPEND, 0600);
+        active_seq_ = seq;
+
+        if (active_fd_ < 0)
+        {
+            EPROSIMA_LOG_ERROR(ORCHESTRATOR_DB, "Could not create the task log segment " << segment.path);
+            segments_.erase(seq);
+        }
+#else
+        static_cast<void>(seq);
+#endif // ifndef _WIN32
+    }
+
+    //! The sealed segment is flushed and closed by the background thread
+    void seal_active_segment_nts()
+    {
+#ifndef _WIN32
+        sealed_fds_.push_back(active_fd_);
+        active_fd_ = -1;
+
+        map_segment(segments_[active_seq_]);
+        open_active_segment(active_seq_ + 1);
+
+        if (++seals_since_compaction_ >= COMPACTION_INTERVAL)
+        {
+            seals_since_compaction_ = 0;
+            compaction_pending_ = true;
+        }
+
+        work_cv_.notify_one();
+#endif // ifndef _WIN32
+    }
+
+    /**
+     * @brief Rewrites the live records of the sealed segments into the last
+     * sealed one and removes the rest.
+     *
+     * References whose record is superseded are rewritten as full records.
+     * The compacted segment replaces the last sealed one atomically, and the
+     * older ones are removed afterwards, so a crash at any point leaves a log
+     * that replays to the same contents.
+     *
+     * Sealed segments are never modified and only unmapped here, so they are
+     * read without the lock. Records appended meanwhile go to later segments.
+     */
+    void compact()
+    {
+#ifndef _WIN32
+        uint64_t last_sealed = 0;
+        uint32_t max_problem_id = 0;
+        std::string target_path;
+        //! Sealed records of each problem, and the positions of the live ones among them
+        std::map<uint32_t, std::pair<std::vector<Location>, std::vector<std::size_t>>> live;
+        std::map<uint64_t, const uint8_t*> maps;
+
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+
+            if (segments_.size() < 3)
+            {
+                return;
+            }
+
+            last_sealed = std::prev(segments_.end(), 2)->first;
+            std::size_t sealed_bytes = 0;
+            std::size_t live_bytes = 0;
+
+            for (auto& segment : segments_)
+            {
+                if (segment.first <= last_sealed)
+                {
+                    sealed_bytes += segment.second.size;
+                    maps[segment.first] = segment.second.map;
+                }
+            }
+
+            for (auto& problem : index_)
+            {
+                std::vector<Location> sealed;
+                for (const Location& location : problem.second)
+                {
+                    if (location.segment <= last_sealed)
+                    {
+                        sealed.push_back(location);
+                    }
+                }
+
+                auto& kept = live[problem.first];
+                kept.second = latest_records(sealed);
+                for (std::size_t index : kept.second)
+                {
+                    live_bytes += HEADER_SIZE + sealed[index].size;
+                }
+                kept.first.swap(sealed);
+            }
+
+            if (2 * live_bytes > sealed_bytes)
+            {
+                return;
+            }
+
+            target_path = segments_[last_sealed].path;
+            max_problem_id = max_problem_id_;
+        }
+
+        std::string tmp_path = target_path + ".compact";
+        int fd = ::open(tmp_path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0600);
+
+        if (fd < 0)
+        {
+            EPROSIMA_LOG_WARNING(ORCHESTRATOR_DB, "Could not compact the task log");
+            return;
+        }
+
+        bool ok = true;
+        std::size_t offset = 0;
+        std::map<uint32_t, std::vector<Location>> compacted;
+
+        for (auto& problem : live)
+        {
+            const std::vector<Location>& sealed = problem.second.first;
+            std::vector<bool> kept(sealed.size(), false);
+
+            for (std::size_t index : problem.second.second)
+            {
+                kept[index] = true;
+            }
+
+            for (std::size_t index : problem.second.second)
+            {
+                const Location& location = sealed[index];
+                const uint8_t* map = maps[location.segment];
+                std::size_t record_size = HEADER_SIZE + location.size;
+                std::size_t referenced = index;
+
+                // References to superseded records are rewritten with the payload they resolve to
+                bool rewrite = is_reference(location.element) && follow_sealed(sealed, maps, referenced) &&
+                        !kept[referenced];
+
+                while (rewrite && is_reference(sealed[referenced].element))
+                {
+                    rewrite = follow_sealed(sealed, maps, referenced);
+                }
+
+                if (rewrite && nullptr != maps[sealed[referenced].segment])
+                {
+                    const Location& source = sealed[referenced];
+                    std::vector<uint8_t> record = make_record(problem.first, location.iteration_id,
+                                    element_of(location.element), maps[source.segment] + source.offset + HEADER_SIZE,
+                                    source.size);
+
+                    ok = ok && ::write(fd, record.data(), record.size()) == static_cast<ssize_t>(record.size());
+
+                    compacted[problem.first].push_back(Location{last_sealed, offset, source.size,
+                                                                    location.iteration_id,
+                                                                    element_of(location.element)});
+                    offset += record.size();
+                    continue;
+                }
+
+                ok = ok && nullptr != map &&
+                        ::write(fd, map + location.offset, record_size) == static_cast<ssize_t>(record_size);
+
+                compacted[problem.first].push_back(
+                    Location{last_sealed, offset, location.size, location.iteration_id, location.element});
+                offset += record_size;
+            }
+        }
+
+        // Keeps the highest problem id across restarts, even if its records are gone
+        if (live[max_problem_id].second.empty())
+        {
+            std::vector<uint8_t> record = make_record(max_problem_id, 0, DROP_RECORD, nullptr, 0);
+            ok = ok && ::write(fd, record.data(), record.size()) == static_cast<ssize_t>(record.size());
+            offset += record.size();
+        }
+
+        ok = ok && ::fdatasync(fd) == 0;
+        ::close(fd);
+
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        if (!ok || std::rename(tmp_path.c_str(), target_path.c_str()) != 0)
+        {
+            EPROSIMA_LOG_WARNING(ORCHESTRATOR_DB, "Could not compact the task log");
+            std::remove(tmp_path.c_str());
+            return;
+        }
+
+        // The records of the older segments are now in the compacted one
+        for (auto it = segments_.begin(); it != segments_.end() && it->first <= last_sealed;)
+        {
+            unmap_segment(it->second);
+            if (it->first < last_sealed)
+            {
+                std::remove(it->second.path.c_str());
+                it = segments_.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        Segment& target = segments_[last_sealed];
+        target.size = offset;
+        map_segment(target);
+
+        for (auto& problem : index_)
+        {
+            // Problems dropped meanwhile have no sealed records left, their compacted
+            // ones are discarded by the drop record that follows them in the log
+            bool sealed = false;
+            for (const Location& location : problem.second)
+            {
+                sealed = sealed || location.segment <= last_sealed;
+            }
+
+            if (!sealed)
+            {
+                continue;
+            }
+
+            std::vector<Location> locations = std::move(compacted[problem.first]);
+            for (const Location& location : problem.second)
+            {
+                if (location.segment > last_sealed)
+                {
+                    locations.push_back(location);
+                }
+            }
+            problem.second.swap(locations);
+        }
+#endif // ifndef _WIN32
+    }
+
+    //! Moves from a sealed reference record to the record it references, read without the lock
+    static bool follow_sealed(
+            const std::vector<Location>& sealed,
+            std::map<uint64_t, const uint8_t*>& maps,
+            std::size_t& index)
+    {
+        const uint8_t* map = maps[sealed[index].segment];
+        uint32_t source_iteration_id = 0;
+
+        if (nullptr == map || sealed[index].size != sizeof(source_iteration_id))
+        {
+            return false;
+        }
+
+        std::memcpy(&source_iteration_id, map + sealed[index].offset + HEADER_SIZE, sizeof(source_iteration_id));
+        return find_referenced(sealed, index, source_iteration_id);
+    }
+
+    const std::string dir_;
+    const std::size_t segment_size_;
+    const bool sync_;
+
+    std::map<uint64_t, Segment> segments_;
+    uint64_t active_seq_{0};
+    int active_fd_{-1};
+    std::size_t seals_since_compaction_{0};
+
+    //! Records of each problem, in log order. Ordered, so that the oldest problem comes first
+    std::map<uint32_t, std::vector<Location>> index_;
+    uint32_t max_problem_id_{0};
+
+    //! Sealed segments not flushed and closed yet
+    std::vector<int> sealed_fds_;
+    bool sync_pending_{false};
+    bool compaction_pending_{false};
+    bool busy_{false};
+    bool stop_{false};
+
+    std::mutex mtx_;
+    std::condition_variable work_cv_;
+    std::condition_variable idle_cv_;
+    std::thread worker_;
+};
+
+} // namespace orchestrator
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_ORCHESTRATOR_TASKLOG_HPP
@@ -0,0 +1,330 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file TaskTracer.hpp
+ */
+
+#ifndef SUSTAINMLCPP_NODES_ORCHESTRATOR_TASKTRACER_HPP
+#define SUSTAINMLCPP_NODES_ORCHESTRATOR_TASKTRACER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sustainml_cpp/orchestrator/OrchestratorNode.hpp>
+
+#include <common/Common.hpp>
+
+namespace sustainml {
+namespace orchestrator {
+
+//! Number of tasks whose timestamps are kept, the oldest ones are forgotten first
+constexpr std::size_t MAX_TRACED_TASKS = 1000;
+
+/**
+ * @brief Keeps the time at which the user input and the output of every
+ * node were written for the last tasks, and assembles them in a span tree.
+ *
+ * Times are the source timestamps of the samples, so the span of a node runs
+ * from the write of its last input to the write of its output. It covers
+ * the transport and the wait in the queues of the node, as well as the user
+ * callback. Nodes on different hosts are only comparable if their clocks are
+ * synchronized.
+ *
+ * Thread safe.
+ */
+class TaskTracer
+{
+public:
+
+    explicit TaskTracer(
+            std::size_t max_tasks = MAX_TRACED_TASKS)
+        : max_tasks_(max_tasks)
+    {
+    }
+
+    /**
+     * @brief Records the write of the user input of a task by the orchestrator.
+     */
+    void record_input(
+            const types::TaskId& task_id,
+            int64_t written_at_ns)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        times_nts(task_id).input_ns = written_at_ns;
+    }
+
+    /**
+     * @brief Records the write of the output of a node for a task.
+     */
+    void record_output(
+            const NodeID& node_id,
+            const types::TaskId& task_id,
+            int64_t written_at_ns)
+    {
+        if (node_id >= NodeID::MAX)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mtx_);
+        times_nts(task_id).output_ns[static_cast<std::size_t>(node_id)] = written_at_ns;
+    }
+
+    /**
+     * @brief Assembles the span tree of a task.
+     *
+     * @return The span of the whole task, as NodeID::ID_ORCHESTRATOR, followed
+     * by the span of every node whose output has been received. Empty if the
+     * task is unknown.
+     */
+    std::vector<TaskSpan> spans(
+            const types::TaskId& task_id) const
+    {
+        TaskTimes times;
+
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            auto it = tasks_.find(common::task_id_to_key(task_id));
+
+            if (it == tasks_.end())
+            {
+                return {};
+            }
+
+            times = it->second;
+        }
+
+        std::vector<TaskSpan> spans;
+        spans.push_back(TaskSpan{NodeID::ID_ORCHESTRATOR, NodeID::UNKNOWN, times.input_ns, times.input_ns, true});
+
+        for (std::size_t i = 0; i < static_cast<std::size_t>(NodeID::MAX); ++i)
+        {
+            if (times.output_ns[i] < 0)
+            {
+                continue;
+            }
+
+            TaskSpan span{static_cast<NodeID>(i), NodeID::ID_ORCHESTRATOR, -1, times.output_ns[i], false};
+
+            // The last input written is the one the node waited for
+            for (const NodeID& input : inputs_of(span.node_id))
+            {
+                int64_t input_ns = (input == NodeID::ID_ORCHESTRATOR) ?
+                        times.input_ns : times.output_ns[static_cast<std::size_t>(input)];
+
+                if (input_ns > span.start_ns)
+                {
+                    span.start_ns = input_ns;
+                    span.parent_id = input;
+                }
+            }
+
+            // Unknown inputs, or clocks out of sync
+            if (span.start_ns < 0 || span.start_ns > span.end_ns)
+            {
+                span.start_ns = span.end_ns;
+            }
+
+            spans.push_back(span);
+        }
+
+        mark_critical_path(spans);
+
+        return spans;
+    }
+
+    /**
+     * @brief Formats the spans of a task in the Chrome trace event format,
+     * one row per node.
+     */
+    static std::string to_chrome_trace(
+            const types::TaskId& task_id,
+            const std::vector<TaskSpan>& spans)
+    {
+        std::ostringstream json;
+        json << std::fixed << std::setprecision(3);
+        json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        for (std::size_t i = 0; i < spans.size(); ++i)
+        {
+            const TaskSpan& span = spans[i];
+            // The whole task is shown in the first row
+            int row = (span.node_id == NodeID::ID_ORCHESTRATOR) ? 0 : static_cast<int>(span.node_id) + 1;
+            const char* parent = (span.parent_id == NodeID::UNKNOWN) ? "" : span_name(span.parent_id);
+
+            json << (i > 0 ? "," : "") << "\n{\"name\":\"" << span_name(span.node_id) << "\""
+                 << ",\"cat\":\"sustainml\",\"ph\":\"X\""
+                 << ",\"pid\":" << task_id.problem_id()
+                 << ",\"tid\":" << row
+                 << ",\"ts\":" << static_cast<double>(span.start_ns) / 1000.0
+                 << ",\"dur\":" << static_cast<double>(span.end_ns - span.start_ns) / 1000.0
+                 << ",\"args\":{\"task_id\":\"" << task_id.problem_id() << "." << task_id.iteration_id() << "\""
+                 << ",\"parent\":\"" << parent << "\""
+                 << ",\"critical_path\":" << (span.critical ? "true" : "false") << "}}";
+        }
+
+        json << "\n]}\n";
+        return json.str();
+    }
+
+private:
+
+    struct TaskTimes
+    {
+        TaskTimes()
+        {
+            output_ns.fill(-1);
+        }
+
+        //! Negative while unknown
+        int64_t input_ns{-1};
+        std::array<int64_t, static_cast<std::size_t>(NodeID::MAX)> output_ns;
+    };
+
+    /**
+     * @brief Nodes whose outputs a node takes as inputs. NodeID::ID_ORCHESTRATOR
+     * stands for the user input and the baselines.
+     */
+    static std::vector<NodeID> inputs_of(
+            const NodeID& node_id)
+    {
+        switch (node_id)
+        {
+            case NodeID::ID_ML_MODEL:
+                return {NodeID::ID_ORCHESTRATOR, NodeID::ID_ML_MODEL_METADATA, NodeID::ID_APP_REQUIREMENTS,
+                        NodeID::ID_HW_CONSTRAINTS};
+            case NodeID::ID_HW_RESOURCES:
+                return {NodeID::ID_ML_MODEL, NodeID::ID_APP_REQUIREMENTS, NodeID::ID_HW_CONSTRAINTS};
+            case NodeID::ID_CARBON_FOOTPRINT:
+                return {NodeID::ID_ORCHESTRATOR, NodeID::ID_ML_MODEL, NodeID::ID_HW_RESOURCES};
+            default:
+                return {NodeID::ID_ORCHESTRATOR};
+        }
+    }
+
+    static const char* span_name(
+            const NodeID& node_id)
+    {
+        switch (node_id)
+        {
+            case NodeID::ID_APP_REQUIREMENTS:
+                return common::APP_REQUIREMENTS_NODE;
+            case NodeID::ID_CARBON_FOOTPRINT:
+                return common::CARBON_FOOTPRINT_NODE;
+            case NodeID::ID_HW_CONSTRAINTS:
+                return common::HW_CONSTRAINTS_NODE;
+            case NodeID::ID_HW_RESOURCES:
+                return common::HW_RESOURCES_NODE;
+            case NodeID::ID_ML_MODEL_METADATA:
+                return common::ML_MODEL_METADATA_NODE;
+            case NodeID::ID_ML_MODEL:
+                return common::ML_MODEL_NODE;
+            default:
+                return "TASK";
+        }
+    }
+
+    /**
+     * @brief Completes the span of the whole task, and marks the chain of
+     * spans that ends last, walking back through their parents.
+     *
+     * @param spans Spans of a task, the whole task first
+     */
+    static void mark_critical_path(
+            std::vector<TaskSpan>& spans)
+    {
+        TaskSpan& task = spans.front();
+        TaskSpan* last = nullptr;
+
+        for (std::size_t i = 1; i < spans.size(); ++i)
+        {
+            if (task.start_ns < 0 || spans[i].start_ns < task.start_ns)
+            {
+                task.start_ns = spans[i].start_ns;
+            }
+
+            if (nullptr == last || spans[i].end_ns > last->end_ns)
+            {
+                last = &spans[i];
+            }
+        }
+
+        if (nullptr == last)
+        {
+            return;
+        }
+
+        task.end_ns = std::max(task.end_ns, last->end_ns);
+
+        while (nullptr != last && !last->critical)
+        {
+            last->critical = true;
+            TaskSpan* parent = nullptr;
+
+            for (std::size_t i = 1; i < spans.size(); ++i)
+            {
+                if (spans[i].node_id == last->parent_id)
+                {
+                    parent = &spans[i];
+                }
+            }
+
+            last = parent;
+        }
+    }
+
+    TaskTimes& times_nts(
+            const types::TaskId& task_id)
+    {
+        uint64_t key = common::task_id_to_key(task_id);
+        auto it = tasks_.find(key);
+
+        if (it != tasks_.end())
+        {
+            return it->second;
+        }
+
+        if (max_tasks_ > 0 && tasks_.size() >= max_tasks_)
+        {
+            tasks_.erase(order_.front());
+            order_.pop_front();
+        }
+
+        order_.push_back(key);
+        return tasks_[key];
+    }
+
+    const std::size_t max_tasks_;
+
+    mutable std::mutex mtx_;
+
+    std::unordered_map<uint64_t, TaskTimes> tasks_;
+
+    //! Keys of tasks_ in insertion order
+    std::deque<uint64_t> order_;
+};
+
+} // namespace orchestrator
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_NODES_ORCHESTRATOR_TASKTRACER_HPP
@@ -327,6 +327,11 @@ NodeStatusImpl* NodeStatus::get_impl()
     return impl_;
 }
 
+const NodeStatusImpl* NodeStatus::get_impl() const
+{
+    return impl_;
+}
+
 void NodeStatus::reset()
 {
     impl_->node_status(Status::NODE_IDLE);
@@ -907,6 +912,11 @@ UserInputImpl* UserInput::get_impl()
     return impl_;
 }
 
+const UserInputImpl* UserInput::get_impl() const
+{
+    return impl_;
+}
+
 void UserInput::reset()
 {
     impl_->modality("");
@@ -1092,6 +1102,11 @@ MLModelMetadataImpl* MLModelMetadata::get_impl()
     return impl_;
 }
 
+const MLModelMetadataImpl* MLModelMetadata::get_impl() const
+{
+    return impl_;
+}
+
 void MLModelMetadata::reset()
 {
     impl_->keywords().clear();
@@ -1241,6 +1256,11 @@ AppRequirementsImpl* AppRequirements::get_impl()
     return impl_;
 }
 
+const AppRequirementsImpl* AppRequirements::get_impl() const
+{
+    return impl_;
+}
+
 void AppRequirements::reset()
 {
     impl_->app_requirements().clear();
@@ -1407,6 +1427,11 @@ HWConstraintsImpl* HWConstraints::get_impl()
     return impl_;
 }
 
+const HWConstraintsImpl* HWConstraints::get_impl() const
+{
+    return impl_;
+}
+
 void HWConstraints::reset()
 {
     impl_->max_memory_footprint(0);
@@ -1693,6 +1718,11 @@ MLModelImpl* MLModel::get_impl()
     return impl_;
 }
 
+const MLModelImpl* MLModel::get_impl() const
+{
+    return impl_;
+}
+
 void MLModel::reset()
 {
     impl_->model("");
@@ -1919,6 +1949,11 @@ HWResourceImpl* HWResource::get_impl()
     return impl_;
 }
 
+const HWResourceImpl* HWResource::get_impl() const
+{
+    return impl_;
+}
+
 void HWResource::reset()
 {
     impl_->hw_description("");
@@ -2103,6 +2138,11 @@ CO2FootprintImpl* CO2Footprint::get_impl()
     return impl_;
 }
 
+const CO2FootprintImpl* CO2Footprint::get_impl() const
+{
+    return impl_;
+}
+
 void CO2Footprint::reset()
 {
     impl_->carbon_intensity(0.0);
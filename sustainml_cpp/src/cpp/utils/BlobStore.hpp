@@ -0,0 +1,410 @@
+// Copyright 2023 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file BlobStore.hpp
+ */
+
+#ifndef SUSTAINMLCPP_UTILS_BLOBSTORE_HPP
+#define SUSTAINMLCPP_UTILS_BLOBSTORE_HPP
+
+#include <fastdds/dds/log/Log.hpp>
+#include <utils/Sha256.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // ifndef _WIN32
+
+namespace sustainml {
+namespace utils {
+
+/*!
+ *  @brief Process-wide content-addressed store of byte blobs.
+ *
+ *  Blobs are indexed by their SHA-256 digest and kept in memory in LRU order
+ *  up to a byte budget. If the SUSTAINML_BLOB_STORE_DIR environment variable
+ *  names a directory, every blob is also written there under its hex digest,
+ *  so that processes of the same host sharing the directory find blobs put by
+ *  any of them. Files are read back through mmap. The disk layer is only
+ *  available on POSIX systems.
+ *
+ *  A blob can be replaced in a sample by a reference, a small byte sequence
+ *  holding its digest and size, and resolved back on the receiving side.
+ *  Before that, the sender announces the blob by appending its reference to
+ *  the full contents, so that the receiver stores it under the sender's
+ *  digest without hashing it again.
+ *
+ *  Thread safe.
+ */
+class BlobStore
+{
+
+public:
+
+    //! Blobs smaller than this are never replaced by a reference
+    static constexpr std::size_t MIN_BLOB_SIZE = 64 * 1024;
+    //! Default byte budget of the in-memory cache
+    static constexpr std::size_t DEFAULT_MEMORY_CAPACITY = 256 * 1024 * 1024;
+
+    static BlobStore& get()
+    {
+        static BlobStore store;
+        return store;
+    }
+
+    /**
+     * @brief Stores a blob.
+     *
+     * @param bytes Blob contents.
+     * @return Digest of the blob.
+     */
+    Sha256Digest put(
+            const std::vector<uint8_t>& bytes)
+    {
+        Sha256Digest digest = sha256(bytes.data(), bytes.size());
+        put(digest, bytes);
+        return digest;
+    }
+
+    /**
+     * @brief Stores a blob whose digest is already known. Nothing is copied
+     * if the blob is already held.
+     *
+     * @param digest Digest of the blob, trusted.
+     * @param bytes Blob contents.
+     */
+    void put(
+            const Sha256Digest& digest,
+            const std::vector<uint8_t>& bytes)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        if (!touch_nts(digest))
+        {
+            insert_nts(digest, std::make_shared<const std::vector<uint8_t>>(bytes));
+            write_to_disk_nts(digest, bytes);
+        }
+    }
+
+    /**
+     * @brief Retrieves a blob by digest, from memory or from disk.
+     *
+     * @param digest Digest of the blob.
+     * @param bytes Receives the blob contents.
+     * @return false on a miss.
+     */
+    bool fetch(
+            const Sha256Digest& digest,
+            std::vector<uint8_t>& bytes)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        if (touch_nts(digest))
+        {
+            const auto& blob = *lru_.front().second;
+            bytes.assign(blob.begin(), blob.end());
+            return true;
+        }
+
+        if (read_from_disk_nts(digest, bytes))
+        {
+            insert_nts(digest, std::make_shared<const std::vector<uint8_t>>(bytes));
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Returns whether a byte sequence is a blob reference.
+     */
+    static bool is_reference(
+            const std::vector<uint8_t>& bytes)
+    {
+        return bytes.size() == REFERENCE_SIZE && std::memcmp(bytes.data(), magic(), MAGIC_SIZE) == 0;
+    }
+
+    /**
+     * @brief Builds the reference of a blob.
+     */
+    static std::vector<uint8_t> make_reference(
+            const Sha256Digest& digest,
+            uint64_t size)
+    {
+        std::vector<uint8_t> reference(REFERENCE_SIZE);
+        std::memcpy(reference.data(), magic(), MAGIC_SIZE);
+        std::memcpy(reference.data() + MAGIC_SIZE, &size, sizeof(size));
+        std::memcpy(reference.data() + MAGIC_SIZE + sizeof(size), digest.data(), digest.size());
+        return reference;
+    }
+
+    /**
+     * @brief Appends the reference of a blob to its contents, announcing it.
+     */
+    static void announce(
+            std::vector<uint8_t>& bytes,
+            const Sha256Digest& digest)
+    {
+        std::vector<uint8_t> reference = make_reference(digest, bytes.size());
+        bytes.insert(bytes.end(), reference.begin(), reference.end());
+    }
+
+    /**
+     * @brief Returns whether a byte sequence is an announced blob, that is,
+     * a blob followed by its own reference.
+     */
+    static bool is_announced(
+            const std::vector<uint8_t>& bytes)
+    {
+        if (bytes.size() < MIN_BLOB_SIZE + REFERENCE_SIZE)
+        {
+            return false;
+        }
+
+        const uint8_t* trailer = bytes.data() + bytes.size() - REFERENCE_SIZE;
+        uint64_t size = 0;
+        std::memcpy(&size, trailer + MAGIC_SIZE, sizeof(size));
+
+        return std::memcmp(trailer, magic(), MAGIC_SIZE) == 0 && size == bytes.size() - REFERENCE_SIZE;
+    }
+
+    /**
+     * @brief Strips the reference of an announced blob and stores the blob under
+     * the digest it carries.
+     *
+     * @param bytes Announced blob. Only its contents are left.
+     */
+    void put_announced(
+            std::vector<uint8_t>& bytes)
+    {
+        Sha256Digest digest;
+        std::memcpy(digest.data(), bytes.data() + bytes.size() - digest.size(), digest.size());
+        bytes.resize(bytes.size() - REFERENCE_SIZE);
+
+        put(digest, bytes);
+    }
+
+    /**
+     * @brief Replaces a reference with the blob it points to.
+     *
+     * @param bytes Reference to resolve. Cleared on a miss.
+     * @return false on a miss.
+     */
+    bool resolve(
+            std::vector<uint8_t>& bytes)
+    {
+        Sha256Digest digest;
+        uint64_t size = 0;
+        std::memcpy(&size, bytes.data() + MAGIC_SIZE, sizeof(size));
+        std::memcpy(digest.data(), bytes.data() + MAGIC_SIZE + sizeof(size), digest.size());
+
+        if (fetch(digest, bytes) && bytes.size() == size)
+        {
+            return true;
+        }
+
+        EPROSIMA_LOG_ERROR(BLOB_STORE, "Blob " << to_hex(digest) << " not found");
+        bytes.clear();
+        return false;
+    }
+
+private:
+
+    static constexpr std::size_t MAGIC_SIZE = 8;
+    static constexpr std::size_t REFERENCE_SIZE = MAGIC_SIZE + sizeof(uint64_t) + 32;
+
+    //! Leading bytes identifying a reference
+    static const char* magic()
+    {
+        static const char value[MAGIC_SIZE] = {'S', 'M', 'L', 'B', 'L', 'O', 'B', '1'};
+        return value;
+    }
+
+    using Entry = std::pair<Sha256Digest, std::shared_ptr<const std::vector<uint8_t>>>;
+
+    BlobStore()
+        : memory_capacity_(DEFAULT_MEMORY_CAPACITY)
+        , memory_size_(0)
+    {
+        if (const char* dir = std::getenv("SUSTAINML_BLOB_STORE_DIR"))
+        {
+            disk_dir_ = dir;
+        }
+    }
+
+    static std::string to_hex(
+            const Sha256Digest& digest)
+    {
+        static const char hex[] = "0123456789abcdef";
+        std::string str;
+        str.reserve(2 * digest.size());
+        for (uint8_t byte : digest)
+        {
+            str.push_back(hex[byte >> 4]);
+            str.push_back(hex[byte & 0x0f]);
+        }
+        return str;
+    }
+
+    //! Moves the entry to the front of the LRU list if present
+    bool touch_nts(
+            const Sha256Digest& digest)
+    {
+        auto it = index_.find(digest);
+
+        if (it == index_.end())
+        {
+            return false;
+        }
+
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return true;
+    }
+
+    void insert_nts(
+            const Sha256Digest& digest,
+            std::shared_ptr<const std::vector<uint8_t>> blob)
+    {
+        memory_size_ += blob->size();
+        lru_.emplace_front(digest, std::move(blob));
+        index_[digest] = lru_.begin();
+
+        // Always keep the most recent blob, even if it exceeds the budget alone
+        while (memory_size_ > memory_capacity_ && lru_.size() > 1)
+        {
+            memory_size_ -= lru_.back().second->size();
+            index_.erase(lru_.back().first);
+            lru_.pop_back();
+        }
+    }
+
+    void write_to_disk_nts(
+            const Sha256Digest& digest,
+            const std::vector<uint8_t>& bytes)
+    {
+#ifndef _WIN32
+        if (disk_dir_.empty())
+        {
+            return;
+        }
+
+        std::string path = disk_dir_ + "/" + to_hex(digest);
+
+        if (::access(path.c_str(), F_OK) == 0)
+        {
+            return;
+        }
+
+        std::string tmp_path = path + "." + std::to_string(::getpid()) + ".tmp";
+
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        file.close();
+
+        // Readers must never see a partially written blob
+        if (!file.good() || std::rename(tmp_path.c_str(), path.c_str()) != 0)
+        {
+            EPROSIMA_LOG_WARNING(BLOB_STORE, "Could not write blob " << path);
+            std::remove(tmp_path.c_str());
+        }
+#else
+        static_cast<void>(digest);
+        static_cast<void>(bytes);
+#endif // ifndef _WIN32
+    }
+
+    bool read_from_disk_nts(
+            const Sha256Digest& digest,
+            std::vector<uint8_t>& bytes)
+    {
+#ifndef _WIN32
+        if (disk_dir_.empty())
+        {
+            return false;
+        }
+
+        std::string path = disk_dir_ + "/" + to_hex(digest);
+        int fd = ::open(path.c_str(), O_RDONLY);
+
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat st;
+        void* addr = MAP_FAILED;
+
+        if (::fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            addr = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        }
+
+        ::close(fd);
+
+        if (MAP_FAILED == addr)
+        {
+            return false;
+        }
+
+        const uint8_t* data = static_cast<const uint8_t*>(addr);
+        bool valid = sha256(data, static_cast<std::size_t>(st.st_size)) == digest;
+
+        if (valid)
+        {
+            bytes.assign(data, data + st.st_size);
+        }
+        else
+        {
+            EPROSIMA_LOG_WARNING(BLOB_STORE, "Discarding corrupted blob " << path);
+        }
+
+        ::munmap(addr, static_cast<std::size_t>(st.st_size));
+        return valid;
+#else
+        static_cast<void>(digest);
+        static_cast<void>(bytes);
+        return false;
+#endif // ifndef _WIN32
+    }
+
+    const std::size_t memory_capacity_;
+    std::size_t memory_size_;
+    std::string disk_dir_;
+
+    std::list<Entry> lru_;
+    std::map<Sha256Digest, std::list<Entry>::iterator> index_;
+
+    std::mutex mtx_;
+
+};
+
+} // namespace utils
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_UTILS_BLOBSTORE_HPP
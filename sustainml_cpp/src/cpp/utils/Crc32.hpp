@@ -0,0 +1,67 @@
+// Copyright 2023 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file Crc32.hpp
+ */
+
+#ifndef SUSTAINMLCPP_UTILS_CRC32_HPP
+#define SUSTAINMLCPP_UTILS_CRC32_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace sustainml {
+namespace utils {
+
+/*!
+ *  @brief Computes the CRC-32 (IEEE 802.3) of a byte buffer.
+ *
+ *  @param data Buffer to checksum.
+ *  @param size Size of the buffer.
+ *  @param crc CRC of the preceding bytes, to checksum a sequence of buffers.
+ */
+inline uint32_t crc32(
+        const uint8_t* data,
+        std::size_t size,
+        uint32_t crc = 0)
+{
+    static const std::array<uint32_t, 256> table = []()
+            {
+                std::array<uint32_t, 256> values;
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    uint32_t value = i;
+                    for (int bit = 0; bit < 8; ++bit)
+                    {
+                        value = (value & 1) ? (0xedb88320u ^ (value >> 1)) : (value >> 1);
+                    }
+                    values[i] = value;
+                }
+                return values;
+            }();
+
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+} // namespace utils
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_UTILS_CRC32_HPP
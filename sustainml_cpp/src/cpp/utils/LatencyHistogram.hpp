@@ -0,0 +1,280 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file LatencyHistogram.hpp
+ */
+
+#ifndef SUSTAINMLCPP_UTILS_LATENCYHISTOGRAM_HPP
+#define SUSTAINMLCPP_UTILS_LATENCYHISTOGRAM_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace sustainml {
+namespace utils {
+
+/*!
+ *  @brief Histogram of latencies with logarithmic buckets, each power of two
+ *  split in SUB_BUCKETS linear ones, as HDR histograms do.
+ *
+ *  Values below SUB_BUCKETS are exact, larger ones are kept with a relative
+ *  error below 1 / SUB_BUCKETS. Recording is constant time and never allocates.
+ *
+ *  Not thread safe.
+ */
+class LatencyHistogram
+{
+
+public:
+
+    static constexpr uint32_t SUB_BUCKET_BITS = 4;
+    static constexpr uint32_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    //! Enough buckets for any uint64_t value
+    static constexpr std::size_t N_BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    void record(
+            uint64_t value)
+    {
+        ++counts_[bucket_of(value)];
+        ++count_;
+        max_ = std::max(max_, value);
+    }
+
+    /**
+     * @brief Adds the values recorded in another histogram.
+     */
+    void merge(
+            const LatencyHistogram& other)
+    {
+        for (std::size_t i = 0; i < N_BUCKETS; ++i)
+        {
+            counts_[i] += other.counts_[i];
+        }
+
+        count_ += other.count_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    /**
+     * @brief Returns the value below which the given fraction of the values
+     * fall, rounded up to the upper bound of its bucket. 0 if empty.
+     *
+     * @param fraction Between 0 and 1
+     */
+    uint64_t percentile(
+            double fraction) const
+    {
+        if (0 == count_)
+        {
+            return 0;
+        }
+
+        uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count_)));
+        rank = std::min(std::max<uint64_t>(rank, 1), count_);
+
+        uint64_t seen = 0;
+
+        for (std::size_t i = 0; i < N_BUCKETS; ++i)
+        {
+            seen += counts_[i];
+
+            if (seen >= rank)
+            {
+                return std::min(upper_bound_of(i), max_);
+            }
+        }
+
+        return max_;
+    }
+
+    uint64_t max() const
+    {
+        return max_;
+    }
+
+    uint64_t count() const
+    {
+        return count_;
+    }
+
+    void reset()
+    {
+        counts_.fill(0);
+        count_ = 0;
+        max_ = 0;
+    }
+
+private:
+
+    static std::size_t bucket_of(
+            uint64_t value)
+    {
+        if (value < SUB_BUCKETS)
+        {
+            return static_cast<std::size_t>(value);
+        }
+
+        uint32_t shift = most_significant_bit(value) - SUB_BUCKET_BITS;
+        uint64_t sub_bucket = (value >> shift) & (SUB_BUCKETS - 1);
+        return static_cast<std::size_t>((shift + 1) * SUB_BUCKETS + sub_bucket);
+    }
+
+    static uint64_t upper_bound_of(
+            std::size_t bucket)
+    {
+        if (bucket < SUB_BUCKETS)
+        {
+            return bucket;
+        }
+
+        uint32_t shift = static_cast<uint32_t>(bucket / SUB_BUCKETS) - 1;
+        uint64_t lower = (static_cast<uint64_t>(SUB_BUCKETS) + bucket % SUB_BUCKETS) << shift;
+        return lower + ((uint64_t(1) << shift) - 1);
+    }
+
+    static uint32_t most_significant_bit(
+            uint64_t value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - static_cast<uint32_t>(__builtin_clzll(value));
+#else
+        uint32_t bit = 0;
+        while (value >>= 1)
+        {
+            ++bit;
+        }
+        return bit;
+#endif // if defined(__GNUC__) || defined(__clang__)
+    }
+
+    std::array<uint64_t, N_BUCKETS> counts_{};
+    uint64_t count_{0};
+    uint64_t max_{0};
+};
+
+/*!
+ *  @brief Set of N LatencyHistogram recorded by several threads.
+ *
+ *  Every thread records in its own buffer, so that recording threads never
+ *  contend among themselves. collect() merges the buffers of all threads.
+ *
+ *  Thread safe.
+ */
+template <std::size_t N>
+class PerThreadHistograms
+{
+
+public:
+
+    PerThreadHistograms()
+        : id_(next_id().fetch_add(1, std::memory_order_relaxed))
+    {
+    }
+
+    /**
+     * @brief Records a value in the histogram of the calling thread.
+     *
+     * @param index Histogram in which to record it, below N
+     * @param value Value to record
+     */
+    void record(
+            std::size_t index,
+            uint64_t value)
+    {
+        Buffer& buffer = local_buffer();
+        std::lock_guard<std::mutex> lock(buffer.mtx);
+        buffer.histograms[index].record(value);
+    }
+
+    /**
+     * @brief Merges the histograms of every thread and resets them.
+     *
+     * @param histograms Receives the merged histograms
+     */
+    void collect(
+            std::array<LatencyHistogram, N>& histograms)
+    {
+        for (auto& histogram : histograms)
+        {
+            histogram.reset();
+        }
+
+        std::lock_guard<std::mutex> lock(buffers_mtx_);
+
+        for (auto& buffer : buffers_)
+        {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mtx);
+
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                histograms[i].merge(buffer->histograms[i]);
+                buffer->histograms[i].reset();
+            }
+        }
+    }
+
+private:
+
+    struct Buffer
+    {
+        //! Only contended while collecting
+        std::mutex mtx;
+        std::array<LatencyHistogram, N> histograms;
+    };
+
+    //! Identifies the instance in the thread local maps, since addresses may be reused
+    static std::atomic<uint64_t>& next_id()
+    {
+        static std::atomic<uint64_t> id{0};
+        return id;
+    }
+
+    Buffer& local_buffer()
+    {
+        static thread_local std::unordered_map<uint64_t, Buffer*> thread_buffers;
+
+        auto it = thread_buffers.find(id_);
+
+        if (it != thread_buffers.end())
+        {
+            return *it->second;
+        }
+
+        std::lock_guard<std::mutex> lock(buffers_mtx_);
+        buffers_.emplace_back(new Buffer());
+        thread_buffers[id_] = buffers_.back().get();
+        return *buffers_.back();
+    }
+
+    const uint64_t id_;
+
+    std::mutex buffers_mtx_;
+
+    //! Buffers of every thread that has recorded, owned by the instance
+    std::vector<std::unique_ptr<Buffer>> buffers_;
+};
+
+} // namespace utils
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_UTILS_LATENCYHISTOGRAM_HPP
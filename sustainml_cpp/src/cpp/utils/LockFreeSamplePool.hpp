@@ -0,0 +1,395 @@
+// Copyright 2023 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file LockFreeSamplePool.hpp
+ */
+
+#ifndef SUSTAINMLCPP_UTILS_LOCKFREESAMPLEPOOL_HPP
+#define SUSTAINMLCPP_UTILS_LOCKFREESAMPLEPOOL_HPP
+
+#include <fastdds/dds/log/Log.hpp>
+#include <core/Options.hpp>
+#include <utils/SamplePool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sustainml {
+namespace utils {
+
+/*!
+ *  @brief Thread safe variant of SamplePool.
+ *
+ *  Free caches are kept in a Treiber stack of cache indices whose head is
+ *  tagged with a counter to avoid the ABA problem, so acquiring and
+ *  releasing a cache never takes a lock. Only the allocation of a new slab,
+ *  which happens when the stack is empty and the hard cap has not been
+ *  reached, and the release of the extra slabs are serialized.
+ *
+ *  As in SamplePool, the extra slabs are freed following a ShrinkPolicy.
+ *  The index links live outside the slabs, so a concurrent acquire never
+ *  reads freed memory, and a slab is only freed if all of its caches could
+ *  be taken out of the stack.
+ */
+template <typename T>
+class LockFreeSamplePool
+{
+
+public:
+
+    explicit LockFreeSamplePool(
+            const core::Options& opts = core::Options())
+        : slab_size_(std::max<std::size_t>(opts.sample_pool_size, 1))
+        , max_size_(std::min<std::size_t>(std::max(opts.sample_pool_max_size, slab_size_), NIL))
+        , max_slabs_((max_size_ + slab_size_ - 1) / slab_size_)
+        , slabs_(new std::atomic<T*>[max_slabs_])
+        , next_(new std::atomic<uint32_t>[max_size_])
+        , head_(pack(0, NIL))
+        , n_slabs_(0)
+        , shrink_policy_(slab_size_)
+    {
+        for (std::size_t i = 0; i < max_slabs_; ++i)
+        {
+            slabs_[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        allocate_slab();
+    }
+
+    ~LockFreeSamplePool()
+    {
+        for (std::size_t i = 0; i < max_slabs_; ++i)
+        {
+            delete [] slabs_[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    LockFreeSamplePool(
+            const LockFreeSamplePool&) = delete;
+    LockFreeSamplePool& operator =(
+            const LockFreeSamplePool&) = delete;
+
+    T* get_new_cache()
+    {
+        uint32_t index = NIL;
+
+        while (!pop(index))
+        {
+            if (!allocate_slab())
+            {
+                exhausted_count_.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+
+        std::size_t in_use = in_use_.fetch_add(1, std::memory_order_relaxed) + 1;
+        update_max(high_water_mark_, in_use);
+        shrink_policy_.on_acquire(in_use);
+
+        return cache_at(index);
+    }
+
+    void release_cache(
+            T* cache)
+    {
+        if (nullptr == cache)
+        {
+            EPROSIMA_LOG_ERROR(SAMPLE_POOL, "Trying to release a null cache");
+            return;
+        }
+
+        uint32_t index = index_of(cache);
+
+        if (NIL == index)
+        {
+            EPROSIMA_LOG_ERROR(SAMPLE_POOL, "Trying to release a cache that does not belong to the pool");
+            return;
+        }
+
+        cache->reset();
+        std::size_t in_use = in_use_.fetch_sub(1, std::memory_order_relaxed) - 1;
+        push(index, index);
+
+        if (shrink_policy_.on_release(in_use) && n_slabs_.load(std::memory_order_relaxed) > 1)
+        {
+            shrink();
+        }
+    }
+
+    SamplePoolStats stats() const
+    {
+        SamplePoolStats stats;
+        stats.capacity = capacity_.load(std::memory_order_relaxed);
+        stats.in_use = in_use_.load(std::memory_order_relaxed);
+        stats.high_water_mark = high_water_mark_.load(std::memory_order_relaxed);
+        stats.max_capacity_reached = max_capacity_reached_.load(std::memory_order_relaxed);
+        stats.exhausted_count = exhausted_count_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    static uint64_t pack(
+            uint32_t tag,
+            uint32_t index)
+    {
+        return (static_cast<uint64_t>(tag) << 32) | index;
+    }
+
+    static uint32_t tag_of(
+            uint64_t head)
+    {
+        return static_cast<uint32_t>(head >> 32);
+    }
+
+    static uint32_t index_of_head(
+            uint64_t head)
+    {
+        return static_cast<uint32_t>(head);
+    }
+
+    static void update_max(
+            std::atomic<std::size_t>& max,
+            std::size_t value)
+    {
+        std::size_t current = max.load(std::memory_order_relaxed);
+        while (current < value &&
+                !max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    bool pop(
+            uint32_t& index)
+    {
+        uint64_t head = head_.load(std::memory_order_acquire);
+
+        while (NIL != index_of_head(head))
+        {
+            uint32_t next = next_[index_of_head(head)].load(std::memory_order_relaxed);
+
+            if (head_.compare_exchange_weak(head, pack(tag_of(head) + 1, next),
+                    std::memory_order_acquire, std::memory_order_acquire))
+            {
+                index = index_of_head(head);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //! Pushes the already linked chain [first, ..., last]
+    void push(
+            uint32_t first,
+            uint32_t last)
+    {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+
+        do
+        {
+            next_[last].store(index_of_head(head), std::memory_order_relaxed);
+        }
+        while (!head_.compare_exchange_weak(head, pack(tag_of(head) + 1, first),
+                std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    //! Returns true if there may be free caches, false if the hard cap has been reached
+    bool allocate_slab()
+    {
+        std::lock_guard<std::mutex> lock(grow_mtx_);
+
+        if (NIL != index_of_head(head_.load(std::memory_order_acquire)))
+        {
+            return true;
+        }
+
+        std::size_t slab = n_slabs_.load(std::memory_order_relaxed);
+
+        if (slab == max_slabs_)
+        {
+            return false;
+        }
+
+        std::size_t first = slab * slab_size_;
+        std::size_t n_caches = slab_caches(slab);
+
+        slabs_[slab].store(new T[n_caches], std::memory_order_release);
+
+        for (std::size_t i = first; i + 1 < first + n_caches; ++i)
+        {
+            next_[i].store(static_cast<uint32_t>(i + 1), std::memory_order_relaxed);
+        }
+
+        n_slabs_.store(slab + 1, std::memory_order_release);
+        update_max(max_capacity_reached_, capacity_.fetch_add(n_caches, std::memory_order_relaxed) + n_caches);
+
+        push(static_cast<uint32_t>(first), static_cast<uint32_t>(first + n_caches - 1));
+
+        return true;
+    }
+
+    /**
+     * @brief Frees the extra slabs whose caches are all free. Every free cache
+     * is taken out of the stack, so that no acquire can hand them out, and
+     * the ones that are kept are pushed back. Skipped if another thread is
+     * growing or shrinking the pool.
+     */
+    void shrink()
+    {
+        std::unique_lock<std::mutex> lock(grow_mtx_, std::try_to_lock);
+
+        if (!lock.owns_lock())
+        {
+            return;
+        }
+
+        std::vector<uint32_t> free_indexes;
+        uint32_t index = NIL;
+
+        while (pop(index))
+        {
+            free_indexes.push_back(index);
+        }
+
+        std::size_t n_slabs = n_slabs_.load(std::memory_order_relaxed);
+        std::vector<std::size_t> free_per_slab(n_slabs, 0);
+
+        for (uint32_t free_index : free_indexes)
+        {
+            ++free_per_slab[free_index / slab_size_];
+        }
+
+        // Slabs are only freed from the last one, as n_slabs_ bounds the valid indexes
+        std::size_t kept_slabs = n_slabs;
+
+        while (kept_slabs > 1 &&
+                free_per_slab[kept_slabs - 1] == slab_caches(kept_slabs - 1))
+        {
+            --kept_slabs;
+        }
+
+        if (kept_slabs < n_slabs)
+        {
+            n_slabs_.store(kept_slabs, std::memory_order_release);
+
+            for (std::size_t slab = kept_slabs; slab < n_slabs; ++slab)
+            {
+                capacity_.fetch_sub(slab_caches(slab), std::memory_order_relaxed);
+                delete [] slabs_[slab].exchange(nullptr, std::memory_order_acq_rel);
+            }
+
+            shrink_policy_.on_shrink();
+        }
+
+        uint32_t first = NIL;
+        uint32_t last = NIL;
+
+        for (uint32_t free_index : free_indexes)
+        {
+            if (free_index < kept_slabs * slab_size_)
+            {
+                if (NIL == first)
+                {
+                    first = free_index;
+                }
+                else
+                {
+                    next_[last].store(free_index, std::memory_order_relaxed);
+                }
+
+                last = free_index;
+            }
+        }
+
+        if (NIL != first)
+        {
+            push(first, last);
+        }
+    }
+
+    std::size_t slab_caches(
+            std::size_t slab) const
+    {
+        return std::min(slab_size_, max_size_ - slab * slab_size_);
+    }
+
+    T* cache_at(
+            uint32_t index) const
+    {
+        return &slabs_[index / slab_size_].load(std::memory_order_acquire)[index % slab_size_];
+    }
+
+    uint32_t index_of(
+            const T* cache) const
+    {
+        std::size_t n_slabs = n_slabs_.load(std::memory_order_acquire);
+        std::less<const T*> less;
+
+        for (std::size_t slab = 0; slab < n_slabs; ++slab)
+        {
+            const T* begin = slabs_[slab].load(std::memory_order_acquire);
+
+            //! Freed by a concurrent shrink, none of its caches is in use
+            if (nullptr == begin)
+            {
+                continue;
+            }
+
+            const T* end = begin + slab_caches(slab);
+
+            if (!less(cache, begin) && less(cache, end))
+            {
+                return static_cast<uint32_t>(slab * slab_size_ + (cache - begin));
+            }
+        }
+
+        return NIL;
+    }
+
+    const std::size_t slab_size_;
+    const std::size_t max_size_;
+    const std::size_t max_slabs_;
+
+    std::unique_ptr<std::atomic<T*>[]> slabs_;
+    std::unique_ptr<std::atomic<uint32_t>[]> next_;
+
+    //! Tag in the upper half, index of the top free cache in the lower half
+    std::atomic<uint64_t> head_;
+    std::atomic<std::size_t> n_slabs_;
+    //! Serializes the allocation and the release of slabs
+    std::mutex grow_mtx_;
+
+    ShrinkPolicy shrink_policy_;
+
+    std::atomic<std::size_t> capacity_{0};
+    std::atomic<std::size_t> max_capacity_reached_{0};
+    std::atomic<std::size_t> in_use_{0};
+    std::atomic<std::size_t> high_water_mark_{0};
+    std::atomic<std::size_t> exhausted_count_{0};
+
+};
+
+} // namespace utils
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_UTILS_LOCKFREESAMPLEPOOL_HPP
@@ -22,6 +22,8 @@
 #include <fastdds/dds/log/Log.hpp>
 #include <core/Options.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -29,9 +31,124 @@
 
 namespace sustainml {
 namespace utils {
+
+/*!
+ *  @brief Occupancy counters of a SamplePool.
+ */
+struct SamplePoolStats
+{
+    //! Number of caches currently allocated
+    std::size_t capacity{0};
+    //! Number of caches currently handed out
+    std::size_t in_use{0};
+    //! Maximum number of caches handed out at the same time
+    std::size_t high_water_mark{0};
+    //! Maximum number of caches allocated at the same time
+    std::size_t max_capacity_reached{0};
+    //! Number of requests that found the pool at its hard cap
+    std::size_t exhausted_count{0};
+};
+
+//! Releases in each window in which a pool observes its usage, in slabs
+constexpr std::size_t SHRINK_WINDOW_SLABS = 4;
+//! Consecutive windows whose peak usage fits in the first slab before a pool shrinks
+constexpr std::size_t SHRINK_LOW_WINDOWS = 2;
+
+/*!
+ *  @brief Decides when a pool gives back its extra slabs.
+ *
+ *  The usage of the pool is observed in windows of SHRINK_WINDOW_SLABS
+ *  slabs worth of releases. The pool only shrinks once it is idle after
+ *  SHRINK_LOW_WINDOWS consecutive windows whose peak usage fitted in the
+ *  first slab, so that a steady load above it does not shrink and regrow it.
+ *
+ *  Thread safe.
+ */
+class ShrinkPolicy
+{
+
+public:
+
+    explicit ShrinkPolicy(
+            std::size_t slab_size)
+        : low_watermark_(slab_size)
+        , window_(SHRINK_WINDOW_SLABS * slab_size)
+        , releases_(0)
+        , window_peak_(0)
+        , low_windows_(0)
+    {
+    }
+
+    /**
+     * @brief Records that a cache has been handed out.
+     *
+     * @param in_use Number of caches in use after handing it out
+     */
+    void on_acquire(
+            std::size_t in_use)
+    {
+        std::size_t peak = window_peak_.load(std::memory_order_relaxed);
+
+        while (in_use > peak &&
+                !window_peak_.compare_exchange_weak(peak, in_use, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /**
+     * @brief Records that a cache has been returned.
+     *
+     * @param in_use Number of caches in use after returning it
+     * @return true if the pool should shrink now.
+     */
+    bool on_release(
+            std::size_t in_use)
+    {
+        if (0 == (releases_.fetch_add(1, std::memory_order_relaxed) + 1) % window_)
+        {
+            if (window_peak_.exchange(in_use, std::memory_order_relaxed) <= low_watermark_)
+            {
+                low_windows_.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                low_windows_.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        return 0 == in_use && low_windows_.load(std::memory_order_relaxed) >= SHRINK_LOW_WINDOWS;
+    }
+
+    /**
+     * @brief Records that the pool has shrunk, so that it waits for a new low watermark.
+     */
+    void on_shrink()
+    {
+        low_windows_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+
+    const std::size_t low_watermark_;
+    const std::size_t window_;
+
+    std::atomic<std::size_t> releases_;
+    //! Maximum number of caches in use in the current window
+    std::atomic<std::size_t> window_peak_;
+    //! Number of consecutive windows whose peak did not exceed low_watermark_
+    std::atomic<std::size_t> low_windows_;
+
+};
+
 /*!
  *  @brief Helper class that stores samples until they are processed.
  *
+ *  Caches are allocated in slabs of Options::sample_pool_size elements.
+ *  When all of them are in use a new slab is allocated, up to
+ *  Options::sample_pool_max_size caches. The extra slabs are freed, and
+ *  only the first one kept, once the usage has stayed within the first
+ *  slab for a while and every cache has been returned, see ShrinkPolicy.
+ *
  *  @warning Non thread safe
  */
 template <typename T>
@@ -42,29 +159,37 @@ public:
 
     explicit SamplePool(
             const core::Options& opts = core::Options())
-        : caches_(new T[opts.sample_pool_size])
+        : slab_size_(std::max<std::size_t>(opts.sample_pool_size, 1))
+        , max_size_(std::max(opts.sample_pool_max_size, slab_size_))
+        , shrink_policy_(slab_size_)
     {
-        free_caches_.reserve(opts.sample_pool_size);
-
-        for ( std::size_t i = 0; i < opts.sample_pool_size; ++i )
-        {
-            free_caches_.push_back( &caches_[i] );
-        }
+        free_caches_.reserve(slab_size_);
+        allocate_slab_nts(slab_size_);
     }
 
-    ~SamplePool()
-    {
-        delete [] caches_;
-    }
+    ~SamplePool() = default;
 
     T* get_new_cache_nts()
     {
         T* cache = nullptr;
 
+        if (free_caches_.empty() && stats_.capacity < max_size_)
+        {
+            allocate_slab_nts(std::min(slab_size_, max_size_ - stats_.capacity));
+        }
+
         if (!free_caches_.empty())
         {
             cache = free_caches_.back();
             free_caches_.pop_back();
+
+            ++stats_.in_use;
+            stats_.high_water_mark = std::max(stats_.high_water_mark, stats_.in_use);
+            shrink_policy_.on_acquire(stats_.in_use);
+        }
+        else
+        {
+            ++stats_.exhausted_count;
         }
 
         return cache;
@@ -77,6 +202,12 @@ public:
         {
             cache->reset();
             free_caches_.push_back(cache);
+            --stats_.in_use;
+
+            if (shrink_policy_.on_release(stats_.in_use) && slabs_.size() > 1)
+            {
+                shrink_nts();
+            }
         }
         else
         {
@@ -84,10 +215,53 @@ public:
         }
     }
 
+    const SamplePoolStats& stats_nts() const
+    {
+        return stats_;
+    }
+
 private:
 
+    void allocate_slab_nts(
+            std::size_t n_caches)
+    {
+        slabs_.emplace_back(new T[n_caches]);
+        T* slab = slabs_.back().get();
+
+        for ( std::size_t i = 0; i < n_caches; ++i )
+        {
+            free_caches_.push_back( &slab[i] );
+        }
+
+        stats_.capacity += n_caches;
+        stats_.max_capacity_reached = std::max(stats_.max_capacity_reached, stats_.capacity);
+    }
+
+    //! Keeps only the first slab. Every cache must have been released.
+    void shrink_nts()
+    {
+        slabs_.resize(1);
+        free_caches_.clear();
+
+        T* slab = slabs_.front().get();
+        for ( std::size_t i = 0; i < slab_size_; ++i )
+        {
+            free_caches_.push_back( &slab[i] );
+        }
+
+        stats_.capacity = slab_size_;
+        shrink_policy_.on_shrink();
+    }
+
+    const std::size_t slab_size_;
+    const std::size_t max_size_;
+
     std::vector<T*> free_caches_;
-    T* caches_;
+    std::vector<std::unique_ptr<T[]>> slabs_;
+
+    SamplePoolStats stats_;
+
+    ShrinkPolicy shrink_policy_;
 
 };
 
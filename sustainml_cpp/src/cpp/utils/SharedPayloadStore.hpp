@@ -0,0 +1,329 @@
+// Copyright 2023 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file SharedPayloadStore.hpp
+ */
+
+#ifndef SUSTAINMLCPP_UTILS_SHAREDPAYLOADSTORE_HPP
+#define SUSTAINMLCPP_UTILS_SHAREDPAYLOADSTORE_HPP
+
+#include <sustainml_cpp/types/types.hpp>
+
+#include <fastdds/dds/log/Log.hpp>
+#include <core/Options.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // ifndef _WIN32
+
+namespace sustainml {
+namespace utils {
+
+//! Minimum time a segment is kept alive, so that subscribers have time to read it
+constexpr std::chrono::seconds SHARED_PAYLOAD_MIN_LIFETIME{10};
+
+/*!
+ *  @brief Moves large byte payloads out of band through shared memory.
+ *
+ *  The publisher copies the payload into a new shared memory segment and
+ *  replaces it with a small descriptor holding the segment name and size, so
+ *  only the descriptor is serialized and sent through DDS. Subscribers on the
+ *  same host recognise the descriptor and read the payload back from the
+ *  segment.
+ *
+ *  Segments are owned by the publisher, which keeps the last
+ *  Options::shared_payload_retained ones and unlinks the older ones. If the
+ *  oldest one is younger than SHARED_PAYLOAD_MIN_LIFETIME, the payload is
+ *  sent in band instead, so that no segment disappears before it is read.
+ *  Segments are only readable by the user running the publisher.
+ *
+ *  Only available on POSIX systems. Elsewhere payloads are always sent in band.
+ */
+class SharedPayloadStore
+{
+
+public:
+
+    explicit SharedPayloadStore(
+            const core::Options& opts = core::Options())
+        : threshold_(opts.shared_payload_threshold)
+        , retained_(opts.shared_payload_retained > 0 ? opts.shared_payload_retained : 1)
+    {
+    }
+
+    ~SharedPayloadStore()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        while (!segments_.empty())
+        {
+            unlink_segment(segments_.front().first);
+            segments_.pop_front();
+        }
+    }
+
+    /**
+     * @brief Moves a payload to shared memory if it is large enough,
+     * replacing it with its descriptor.
+     *
+     * Thread safe operation.
+     *
+     * @param payload Bytes to export. Left untouched if they are not exported.
+     * @return true if the payload has been replaced by a descriptor.
+     */
+    bool export_payload(
+            std::vector<uint8_t>& payload)
+    {
+#ifndef _WIN32
+        if (payload.size() < threshold_ || payload.empty())
+        {
+            return false;
+        }
+
+        std::string name;
+
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+
+            if (segments_.size() + exporting_ >= retained_)
+            {
+                if (segments_.empty() ||
+                        std::chrono::steady_clock::now() - segments_.front().second < SHARED_PAYLOAD_MIN_LIFETIME)
+                {
+                    EPROSIMA_LOG_WARNING(SHARED_PAYLOAD,
+                            "All the " << retained_ <<
+                            " shared memory segments are in use, sending the payload in band");
+                    return false;
+                }
+
+                unlink_segment(segments_.front().first);
+                segments_.pop_front();
+            }
+
+            ++exporting_;
+            name = segment_prefix() + std::to_string(::getpid()) + "_" + std::to_string(next_segment_++);
+        }
+
+        if (!write_segment(name, payload))
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            --exporting_;
+            return false;
+        }
+
+        uint64_t size = payload.size();
+        payload.resize(MAGIC_SIZE + sizeof(size) + name.size());
+        payload.shrink_to_fit();
+        std::memcpy(payload.data(), magic(), MAGIC_SIZE);
+        std::memcpy(payload.data() + MAGIC_SIZE, &size, sizeof(size));
+        std::memcpy(payload.data() + MAGIC_SIZE + sizeof(size), name.data(), name.size());
+
+        std::lock_guard<std::mutex> lock(mtx_);
+        --exporting_;
+        segments_.emplace_back(name, std::chrono::steady_clock::now());
+
+        return true;
+#else
+        static_cast<void>(payload);
+        return false;
+#endif // ifndef _WIN32
+    }
+
+    /**
+     * @brief Replaces a descriptor with the payload it references.
+     * Payloads sent in band are left untouched.
+     *
+     * Thread safe operation.
+     *
+     * @param payload Received bytes.
+     * @return false if the payload is a descriptor that could not be resolved.
+     */
+    static bool import_payload(
+            std::vector<uint8_t>& payload)
+    {
+        uint64_t size = 0;
+
+        if (payload.size() <= MAGIC_SIZE + sizeof(size) ||
+                std::memcmp(payload.data(), magic(), MAGIC_SIZE) != 0)
+        {
+            return true;
+        }
+
+#ifndef _WIN32
+        std::memcpy(&size, payload.data() + MAGIC_SIZE, sizeof(size));
+        std::string name(payload.begin() + MAGIC_SIZE + sizeof(size), payload.end());
+
+        if (name.compare(0, segment_prefix().size(), segment_prefix()) != 0 ||
+                name.find('/', 1) != std::string::npos)
+        {
+            EPROSIMA_LOG_ERROR(SHARED_PAYLOAD, "Invalid shared memory segment name " << name);
+            payload.clear();
+            return false;
+        }
+
+        int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+
+        if (fd < 0)
+        {
+            EPROSIMA_LOG_ERROR(SHARED_PAYLOAD, "Shared memory segment " << name << " is no longer available");
+            payload.clear();
+            return false;
+        }
+
+        //! Mapping beyond the end of the segment would raise SIGBUS on access
+        struct stat segment_stat;
+
+        if (::fstat(fd, &segment_stat) != 0 || segment_stat.st_size < 0 ||
+                static_cast<uint64_t>(segment_stat.st_size) != size || 0 == size)
+        {
+            EPROSIMA_LOG_ERROR(SHARED_PAYLOAD,
+                    "Shared memory segment " << name << " does not hold the " << size << " bytes announced");
+            ::close(fd);
+            payload.clear();
+            return false;
+        }
+
+        void* addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+
+        if (MAP_FAILED == addr)
+        {
+            EPROSIMA_LOG_ERROR(SHARED_PAYLOAD, "Could not map shared memory segment " << name);
+            payload.clear();
+            return false;
+        }
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(addr);
+        payload.assign(bytes, bytes + size);
+        ::munmap(addr, size);
+
+        return true;
+#else
+        EPROSIMA_LOG_ERROR(SHARED_PAYLOAD, "Shared memory payloads are not supported on this platform");
+        payload.clear();
+        return false;
+#endif // ifndef _WIN32
+    }
+
+private:
+
+    static constexpr std::size_t MAGIC_SIZE = 8;
+
+    //! Leading bytes identifying a descriptor
+    static const char* magic()
+    {
+        static const char value[MAGIC_SIZE] = {'S', 'M', 'L', 'S', 'H', 'M', '0', '1'};
+        return value;
+    }
+
+#ifndef _WIN32
+    //! Creates a segment holding a copy of the payload
+    static bool write_segment(
+            const std::string& name,
+            const std::vector<uint8_t>& payload)
+    {
+        int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+
+        if (fd < 0)
+        {
+            EPROSIMA_LOG_ERROR(SHARED_PAYLOAD, "Could not create shared memory segment " << name);
+            return false;
+        }
+
+        void* addr = MAP_FAILED;
+
+        if (::ftruncate(fd, static_cast<off_t>(payload.size())) == 0)
+        {
+            addr = ::mmap(nullptr, payload.size(), PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+
+        ::close(fd);
+
+        if (MAP_FAILED == addr)
+        {
+            EPROSIMA_LOG_ERROR(SHARED_PAYLOAD, "Could not map shared memory segment " << name);
+            ::shm_unlink(name.c_str());
+            return false;
+        }
+
+        std::memcpy(addr, payload.data(), payload.size());
+        ::munmap(addr, payload.size());
+
+        return true;
+    }
+
+#endif // ifndef _WIN32
+
+    static const std::string& segment_prefix()
+    {
+        static const std::string value = "/sustainml_";
+        return value;
+    }
+
+    static void unlink_segment(
+            const std::string& name)
+    {
+#ifndef _WIN32
+        ::shm_unlink(name.c_str());
+#else
+        static_cast<void>(name);
+#endif // ifndef _WIN32
+    }
+
+    const std::size_t threshold_;
+    const std::size_t retained_;
+
+    uint64_t next_segment_{0};
+    //! Number of segments being written
+    std::size_t exporting_{0};
+
+    //! Live segments and when they were created, oldest first
+    std::deque<std::pair<std::string, std::chrono::steady_clock::time_point>> segments_;
+    //! Guards next_segment_, exporting_ and segments_
+    std::mutex mtx_;
+
+};
+
+/**
+ * @brief Resolves the out of band payloads of a received sample.
+ * Only MLModel carries them, every other type is left untouched.
+ */
+template <typename T>
+inline void import_shared_payloads(
+        T&)
+{
+}
+
+inline void import_shared_payloads(
+        types::MLModel& model)
+{
+    SharedPayloadStore::import_payload(model.raw_model());
+}
+
+} // namespace utils
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_UTILS_SHAREDPAYLOADSTORE_HPP
@@ -0,0 +1,211 @@
+// Copyright 2023 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file TaskIndex.hpp
+ */
+
+#ifndef SUSTAINMLCPP_UTILS_TASKINDEX_HPP
+#define SUSTAINMLCPP_UTILS_TASKINDEX_HPP
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace sustainml {
+namespace utils {
+
+/*!
+ *  @brief Flat open-addressing hash index from a task key to a value.
+ *
+ *  All the slots are allocated at construction, values are stored inline and
+ *  collisions are resolved with linear probing. Erasing shifts back the rest
+ *  of the probe sequence, so there are no tombstones and lookups stay short
+ *  no matter how many tasks have gone through the index.
+ *
+ *  @warning Non thread safe
+ */
+template <typename V>
+class TaskIndex
+{
+
+public:
+
+    using Key = uint64_t;
+
+    /**
+     * @param max_entries Maximum number of entries stored at the same time
+     */
+    explicit TaskIndex(
+            std::size_t max_entries)
+    {
+        // Keep the load factor under 0.5 when the index is full
+        capacity_ = 16;
+        while (capacity_ < 2 * max_entries)
+        {
+            capacity_ <<= 1;
+        }
+
+        max_entries_ = max_entries;
+        slots_.reset(new Slot[capacity_]);
+    }
+
+    /**
+     * @brief Looks up the value of a key.
+     *
+     * @return Pointer to the value, nullptr if the key is not in the index.
+     */
+    V* find(
+            Key key)
+    {
+        for (std::size_t i = home(key);; i = next(i))
+        {
+            Slot& slot = slots_[i];
+
+            if (!slot.used)
+            {
+                return nullptr;
+            }
+            else if (slot.key == key)
+            {
+                return &slot.value;
+            }
+        }
+    }
+
+    /**
+     * @brief Inserts a value if the key is not in the index yet.
+     *
+     * @return Pointer to the value stored for the key, and whether it has been
+     * inserted by this call. Pointer is nullptr if the index is full.
+     */
+    std::pair<V*, bool> emplace(
+            Key key,
+            const V& value)
+    {
+        std::size_t i = home(key);
+
+        for (;; i = next(i))
+        {
+            Slot& slot = slots_[i];
+
+            if (!slot.used)
+            {
+                break;
+            }
+            else if (slot.key == key)
+            {
+                return std::make_pair(&slot.value, false);
+            }
+        }
+
+        if (size_ == max_entries_)
+        {
+            return std::make_pair(nullptr, false);
+        }
+
+        Slot& slot = slots_[i];
+        slot.key = key;
+        slot.value = value;
+        slot.used = true;
+        ++size_;
+
+        return std::make_pair(&slot.value, true);
+    }
+
+    /**
+     * @brief Removes a key from the index.
+     *
+     * @param key Key to remove.
+     * @param value Receives the removed value.
+     * @return true if the key was in the index.
+     */
+    bool erase(
+            Key key,
+            V& value)
+    {
+        std::size_t i = home(key);
+
+        for (;; i = next(i))
+        {
+            if (!slots_[i].used)
+            {
+                return false;
+            }
+            else if (slots_[i].key == key)
+            {
+                break;
+            }
+        }
+
+        value = std::move(slots_[i].value);
+
+        // Move back the entries whose probe sequence goes through the hole
+        for (std::size_t j = next(i); slots_[j].used; j = next(j))
+        {
+            std::size_t k = home(slots_[j].key);
+
+            if ((i <= j) ? (k <= i || k > j) : (k <= i && k > j))
+            {
+                slots_[i] = std::move(slots_[j]);
+                i = j;
+            }
+        }
+
+        slots_[i].used = false;
+        --size_;
+
+        return true;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+private:
+
+    struct Slot
+    {
+        Key key{0};
+        bool used{false};
+        V value{};
+    };
+
+    std::size_t home(
+            Key key) const
+    {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        return static_cast<std::size_t>(key) & (capacity_ - 1);
+    }
+
+    std::size_t next(
+            std::size_t i) const
+    {
+        return (i + 1) & (capacity_ - 1);
+    }
+
+    std::size_t capacity_{0};
+    std::size_t max_entries_{0};
+    std::size_t size_{0};
+    std::unique_ptr<Slot[]> slots_;
+
+};
+
+} // namespace utils
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_UTILS_TASKINDEX_HPP
@@ -0,0 +1,401 @@
+// Copyright 2023 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file TaskReadinessTracker.hpp
+ */
+
+#ifndef SUSTAINMLCPP_UTILS_TASKREADINESSTRACKER_HPP
+#define SUSTAINMLCPP_UTILS_TASKREADINESSTRACKER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sustainml {
+namespace utils {
+
+/*!
+ *  @brief Sharded open-addressing table that tracks, for every task key,
+ *  a bitmask of the queues in which a sample has already been received.
+ *
+ *  Looking up an existing entry is lock-free and recording an arrival is a
+ *  single atomic fetch-or on the entry mask. Only the first arrival of a task
+ *  and the removal of a completed one take the lock of their shard.
+ *
+ *  A shard is rebuilt under its lock when its slots run short, doubling it if
+ *  most of them are in use, or in place if most of them are tombstones of
+ *  removed tasks. Lock-free lookups step aside to the locked path meanwhile.
+ *  Tasks arriving once a shard cannot grow any more are tracked in an
+ *  overflow map of the shard, only accessed under its lock.
+ *
+ *  @warning It assumes that a bit is set at most once per task, that is,
+ *  no task is received twice in the same queue.
+ */
+class TaskReadinessTracker
+{
+
+public:
+
+    using Key = uint64_t;
+
+    static constexpr Key EMPTY_KEY = 0;
+    static constexpr Key TOMBSTONE_KEY = std::numeric_limits<Key>::max();
+    static constexpr std::size_t DEFAULT_N_SHARDS = 16;
+    //! Times a shard may double its initial number of slots
+    static constexpr std::size_t MAX_SHARD_GROWTH = 64;
+
+    enum MarkResult
+    {
+        //! The task still waits for samples of other queues
+        PENDING,
+        //! This arrival completed the task, the entry has been released
+        COMPLETED
+    };
+
+    /**
+     * @param expected_tasks Number of tasks expected to be in flight at the same time
+     * @param n_shards Number of independent shards
+     */
+    explicit TaskReadinessTracker(
+            std::size_t expected_tasks,
+            std::size_t n_shards = DEFAULT_N_SHARDS)
+    {
+        n_shards = (n_shards == 0) ? 1 : n_shards;
+
+        // Keep the load factor under 0.5 when all the expected tasks are in flight
+        std::size_t slots = 16;
+        while (slots < (2 * expected_tasks + n_shards - 1) / n_shards)
+        {
+            slots <<= 1;
+        }
+
+        max_slots_ = slots * MAX_SHARD_GROWTH;
+
+        shards_.reserve(n_shards);
+        for (std::size_t i = 0; i < n_shards; ++i)
+        {
+            shards_.emplace_back(new Shard(slots));
+        }
+    }
+
+    /**
+     * @brief Records the arrival of a sample of a task.
+     *
+     * Thread safe operation.
+     *
+     * @param key Task key. Must not be EMPTY_KEY nor TOMBSTONE_KEY.
+     * @param bit Bit identifying the queue that received the sample.
+     * @param complete_mask Mask with the bits of all the queues that must receive a sample.
+     * @return COMPLETED only for the arrival that completes the mask.
+     */
+    MarkResult mark(
+            Key key,
+            uint32_t bit,
+            uint32_t complete_mask)
+    {
+        Shard& shard = *shards_[mix(key) % shards_.size()];
+        uint32_t previous = 0;
+
+        if (!mark_lock_free(shard, key, bit, previous))
+        {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            Slot* slot = find(shard, key);
+
+            // Once in the overflow map, a task stays there until completed
+            if (nullptr == slot &&
+                    (shard.overflow.count(key) > 0 || nullptr == (slot = insert_nts(shard, key))))
+            {
+                return mark_overflow_nts(shard, key, bit, complete_mask);
+            }
+
+            previous = slot->mask.fetch_or(bit, std::memory_order_acq_rel);
+        }
+
+        if (((previous | bit) & complete_mask) == complete_mask &&
+                (previous & complete_mask) != complete_mask)
+        {
+            // The entry may have been moved by a rebuild since it was marked
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            Slot* slot = find(shard, key);
+
+            if (nullptr != slot)
+            {
+                slot->mask.store(0, std::memory_order_relaxed);
+                slot->key.store(TOMBSTONE_KEY, std::memory_order_release);
+                shard.live.fetch_sub(1, std::memory_order_relaxed);
+                ++shard.tombstones;
+            }
+
+            return COMPLETED;
+        }
+
+        return PENDING;
+    }
+
+    /**
+     * @brief Returns the number of tasks partially received.
+     */
+    std::size_t size() const
+    {
+        std::size_t n = 0;
+        for (auto& shard : shards_)
+        {
+            n += shard->live.load(std::memory_order_relaxed) + shard->overflowed.load(std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+private:
+
+    struct Slot
+    {
+        std::atomic<Key> key{EMPTY_KEY};
+        std::atomic<uint32_t> mask{0};
+    };
+
+    struct Shard
+    {
+        explicit Shard(
+                std::size_t n_slots)
+            : slots(new Slot[n_slots])
+            , capacity(n_slots)
+            , live(0)
+        {
+        }
+
+        //! Only replaced under mtx, with rebuilding set and no lock-free reader inside
+        std::unique_ptr<Slot[]> slots;
+        std::size_t capacity;
+        std::atomic<std::size_t> live;
+        //! Guarded by mtx
+        std::size_t tombstones{0};
+        //! Tasks that did not fit in the slots, guarded by mtx
+        std::unordered_map<Key, uint32_t> overflow;
+        //! Size of overflow, readable without the lock
+        std::atomic<std::size_t> overflowed{0};
+        //! Lock-free readers currently looking up the slots
+        std::atomic<uint32_t> readers{0};
+        std::atomic<bool> rebuilding{false};
+        std::mutex mtx;
+    };
+
+    //! Spreads the (problem_id, iteration_id) bits before indexing
+    static inline Key mix(
+            Key key)
+    {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        return key;
+    }
+
+    /**
+     * @brief Sets the bit of an existing entry without taking the lock.
+     *
+     * @param previous Receives the mask before the bit was set.
+     * @return false if the entry was not found, or the shard is being rebuilt.
+     */
+    static bool mark_lock_free(
+            Shard& shard,
+            Key key,
+            uint32_t bit,
+            uint32_t& previous)
+    {
+        bool marked = false;
+
+        // Pairs with rebuild_nts: either the rebuild sees this reader, or this reader sees the rebuild
+        shard.readers.fetch_add(1, std::memory_order_seq_cst);
+
+        if (!shard.rebuilding.load(std::memory_order_seq_cst))
+        {
+            Slot* slot = find(shard, key);
+
+            if (nullptr != slot)
+            {
+                previous = slot->mask.fetch_or(bit, std::memory_order_acq_rel);
+                marked = true;
+            }
+        }
+
+        shard.readers.fetch_sub(1, std::memory_order_release);
+        return marked;
+    }
+
+    /**
+     * @brief Records the arrival of a sample of a task kept in the overflow map of its shard.
+     */
+    static MarkResult mark_overflow_nts(
+            Shard& shard,
+            Key key,
+            uint32_t bit,
+            uint32_t complete_mask)
+    {
+        auto it = shard.overflow.find(key);
+
+        if (it == shard.overflow.end())
+        {
+            it = shard.overflow.emplace(key, 0).first;
+            shard.overflowed.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        uint32_t previous = it->second;
+        it->second |= bit;
+
+        if ((it->second & complete_mask) == complete_mask)
+        {
+            shard.overflow.erase(it);
+            shard.overflowed.fetch_sub(1, std::memory_order_relaxed);
+            return ((previous & complete_mask) != complete_mask) ? COMPLETED : PENDING;
+        }
+
+        return PENDING;
+    }
+
+    static Slot* find(
+            Shard& shard,
+            Key key)
+    {
+        std::size_t idx = (mix(key) >> 8) & (shard.capacity - 1);
+
+        for (std::size_t i = 0; i < shard.capacity; ++i)
+        {
+            Slot& slot = shard.slots[(idx + i) & (shard.capacity - 1)];
+            Key current = slot.key.load(std::memory_order_acquire);
+
+            if (current == key)
+            {
+                return &slot;
+            }
+            else if (current == EMPTY_KEY)
+            {
+                break;
+            }
+        }
+
+        return nullptr;
+    }
+
+    Slot* insert_nts(
+            Shard& shard,
+            Key key)
+    {
+        // Keep some empty slots, so that failed lookups end early
+        if (4 * (shard.live.load(std::memory_order_relaxed) + shard.tombstones + 1) > 3 * shard.capacity)
+        {
+            bool grow = 2 * shard.live.load(std::memory_order_relaxed) >= shard.capacity;
+
+            if (grow && 2 * shard.capacity > max_slots_)
+            {
+                // Only worth compacting if enough tombstones are reclaimed
+                if (8 * shard.tombstones < shard.capacity)
+                {
+                    return insert_slot_nts(shard, key);
+                }
+                grow = false;
+            }
+
+            rebuild_nts(shard, grow ? 2 * shard.capacity : shard.capacity);
+        }
+
+        return insert_slot_nts(shard, key);
+    }
+
+    static Slot* insert_slot_nts(
+            Shard& shard,
+            Key key)
+    {
+        std::size_t idx = (mix(key) >> 8) & (shard.capacity - 1);
+
+        for (std::size_t i = 0; i < shard.capacity; ++i)
+        {
+            Slot& slot = shard.slots[(idx + i) & (shard.capacity - 1)];
+            Key current = slot.key.load(std::memory_order_relaxed);
+
+            if (current == EMPTY_KEY || current == TOMBSTONE_KEY)
+            {
+                if (current == TOMBSTONE_KEY)
+                {
+                    --shard.tombstones;
+                }
+
+                slot.mask.store(0, std::memory_order_relaxed);
+                slot.key.store(key, std::memory_order_release);
+                shard.live.fetch_add(1, std::memory_order_relaxed);
+                return &slot;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @brief Moves the live entries of a shard to a new table, dropping the tombstones.
+     * Lock-free readers are kept out meanwhile.
+     */
+    static void rebuild_nts(
+            Shard& shard,
+            std::size_t capacity)
+    {
+        shard.rebuilding.store(true, std::memory_order_seq_cst);
+
+        while (0 != shard.readers.load(std::memory_order_seq_cst))
+        {
+            std::this_thread::yield();
+        }
+
+        std::unique_ptr<Slot[]> old_slots(new Slot[capacity]);
+        std::size_t old_capacity = shard.capacity;
+        shard.slots.swap(old_slots);
+        shard.capacity = capacity;
+
+        for (std::size_t i = 0; i < old_capacity; ++i)
+        {
+            Key key = old_slots[i].key.load(std::memory_order_relaxed);
+
+            if (key != EMPTY_KEY && key != TOMBSTONE_KEY)
+            {
+                std::size_t idx = (mix(key) >> 8) & (capacity - 1);
+
+                while (shard.slots[idx].key.load(std::memory_order_relaxed) != EMPTY_KEY)
+                {
+                    idx = (idx + 1) & (capacity - 1);
+                }
+
+                shard.slots[idx].mask.store(old_slots[i].mask.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+                shard.slots[idx].key.store(key, std::memory_order_relaxed);
+            }
+        }
+
+        shard.tombstones = 0;
+        shard.rebuilding.store(false, std::memory_order_seq_cst);
+    }
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    //! Maximum number of slots of a shard
+    std::size_t max_slots_;
+
+};
+
+} // namespace utils
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_UTILS_TASKREADINESSTRACKER_HPP
@@ -0,0 +1,181 @@
+// Copyright 2023 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file TaskStatusTracker.hpp
+ */
+
+#ifndef SUSTAINMLCPP_UTILS_TASKSTATUSTRACKER_HPP
+#define SUSTAINMLCPP_UTILS_TASKSTATUSTRACKER_HPP
+
+#include <sustainml_cpp/types/types.hpp>
+
+#include <types/typesImpl.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <map>
+
+namespace sustainml {
+namespace utils {
+
+/*!
+ *  @brief Tracks the status of every task run by a node and derives the
+ *  status of the node from them.
+ *
+ *  The node is running while at least one task is in flight. Once the last
+ *  one finishes it becomes idle, or errored if any task failed since it
+ *  started running. Only these transitions change the node status, so
+ *  pipelined tasks do not flip it back and forth.
+ *
+ *  The status of the last finished tasks is retained for queries, up to a
+ *  fixed number of them.
+ *
+ *  Not thread safe.
+ */
+class TaskStatusTracker
+{
+
+public:
+
+    //! Default number of finished tasks whose status is retained
+    static constexpr std::size_t DEFAULT_RETAINED_TASKS = 500;
+
+    explicit TaskStatusTracker(
+            std::size_t retained_tasks = DEFAULT_RETAINED_TASKS)
+        : retained_tasks_(retained_tasks)
+    {
+    }
+
+    /**
+     * @brief Records that a task has started running. Starting a task
+     * already running has no effect.
+     *
+     * @param task_id Task identifier
+     * @return true if the node was not running any other task.
+     */
+    bool start_nts(
+            const types::TaskId& task_id)
+    {
+        auto it = tasks_.find(task_id);
+
+        if (it == tasks_.end())
+        {
+            tasks_.emplace(task_id, TaskStatus::TASK_RUNNING);
+        }
+        else if (TaskStatus::TASK_RUNNING == it->second)
+        {
+            return false;
+        }
+        else
+        {
+            // Finished before, it is retained again when it finishes
+            it->second = TaskStatus::TASK_RUNNING;
+            auto pos = std::find(finished_.begin(), finished_.end(), task_id);
+            if (pos != finished_.end())
+            {
+                finished_.erase(pos);
+            }
+        }
+
+        if (0 == in_flight_++)
+        {
+            failed_ = false;
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Records that a task has finished.
+     *
+     * @param task_id Task identifier
+     * @param error Whether the task failed
+     * @param node_status Receives the status of the node if it has changed.
+     * @return true if it was the last task in flight.
+     */
+    bool finish_nts(
+            const types::TaskId& task_id,
+            bool error,
+            Status& node_status)
+    {
+        auto it = tasks_.find(task_id);
+
+        if (it == tasks_.end() || it->second != TaskStatus::TASK_RUNNING)
+        {
+            return false;
+        }
+
+        it->second = error ? TaskStatus::TASK_ERROR : TaskStatus::TASK_SUCCEEDED;
+        failed_ = failed_ || error;
+
+        finished_.push_back(task_id);
+        while (finished_.size() > retained_tasks_)
+        {
+            // Never forget a task in flight
+            auto oldest = tasks_.find(finished_.front());
+            if (oldest != tasks_.end() && oldest->second != TaskStatus::TASK_RUNNING)
+            {
+                tasks_.erase(oldest);
+            }
+            finished_.pop_front();
+        }
+
+        if (0 == --in_flight_)
+        {
+            node_status = failed_ ? Status::NODE_ERROR : Status::NODE_IDLE;
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Returns the status of a task, TASK_WAITING if it is unknown.
+     */
+    TaskStatus status_nts(
+            const types::TaskId& task_id) const
+    {
+        auto it = tasks_.find(task_id);
+        return it != tasks_.end() ? it->second : TaskStatus::TASK_WAITING;
+    }
+
+    /**
+     * @brief Returns the number of tasks running.
+     */
+    std::size_t in_flight_nts() const
+    {
+        return in_flight_;
+    }
+
+private:
+
+    const std::size_t retained_tasks_;
+
+    //! Tasks in flight and the last finished ones
+    std::map<types::TaskId, TaskStatus> tasks_;
+    //! Finished tasks, oldest first
+    std::deque<types::TaskId> finished_;
+
+    std::size_t in_flight_{0};
+    //! Whether a task has failed since the node started running
+    bool failed_{false};
+};
+
+} // namespace utils
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_UTILS_TASKSTATUSTRACKER_HPP
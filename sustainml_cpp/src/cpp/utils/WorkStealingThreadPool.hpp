@@ -0,0 +1,391 @@
+// Copyright 2023 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file WorkStealingThreadPool.hpp
+ */
+
+#ifndef SUSTAINMLCPP_UTILS_WORKSTEALINGTHREADPOOL_HPP
+#define SUSTAINMLCPP_UTILS_WORKSTEALINGTHREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sustainml {
+namespace utils {
+
+/*!
+ *  @brief Thread pool in which every worker owns a deque of pending tasks.
+ *
+ *  Tasks pushed from a worker thread go to its own deque, tasks pushed from
+ *  any other thread are spread round-robin among the workers. A worker pops
+ *  from the back of its own deque and, when it runs out of work, steals
+ *  from the front of the others' deques. Every deque has its own lock so
+ *  producers and workers only contend when they hit the same deque.
+ *
+ *  The same routine is executed for every task.
+ */
+template <typename Task>
+class WorkStealingThreadPool
+{
+
+public:
+
+    using Routine = std::function<void (Task&)>;
+
+    WorkStealingThreadPool(
+            std::size_t n_threads,
+            Routine routine)
+        : routine_(routine)
+        , next_worker_(0)
+        , pending_(0)
+        , pushes_(0)
+        , enabled_(false)
+    {
+        n_threads = (n_threads == 0) ? 1 : n_threads;
+
+        workers_.reserve(n_threads);
+        for (std::size_t i = 0; i < n_threads; ++i)
+        {
+            workers_.emplace_back(new Worker());
+        }
+    }
+
+    ~WorkStealingThreadPool()
+    {
+        disable();
+    }
+
+    /**
+     * @brief Spawns the worker threads. Calling it on an enabled pool has no effect.
+     */
+    void enable()
+    {
+        std::lock_guard<std::mutex> lock(state_mtx_);
+
+        if (!enabled_.load())
+        {
+            enabled_.store(true);
+
+            threads_.reserve(workers_.size());
+            for (std::size_t i = 0; i < workers_.size(); ++i)
+            {
+                threads_.emplace_back(&WorkStealingThreadPool::run, this, i);
+            }
+        }
+    }
+
+    /**
+     * @brief Stops and joins the worker threads. Pending tasks are discarded.
+     */
+    void disable()
+    {
+        std::lock_guard<std::mutex> lock(state_mtx_);
+
+        if (enabled_.load())
+        {
+            {
+                std::lock_guard<std::mutex> sleep_lock(sleep_mtx_);
+                enabled_.store(false);
+            }
+            sleep_cv_.notify_all();
+
+            for (auto& th : threads_)
+            {
+                if (th.joinable())
+                {
+                    th.join();
+                }
+            }
+            threads_.clear();
+
+            // A push racing with disable() either is dropped here or sees the pool disabled,
+            // so the counter is kept in step with the deques instead of reset
+            for (auto& worker : workers_)
+            {
+                std::lock_guard<std::mutex> worker_lock(worker->mtx);
+                pending_.fetch_sub(worker->tasks.size());
+                worker->tasks.clear();
+            }
+        }
+    }
+
+    /**
+     * @brief Returns whether the workers are running.
+     */
+    bool is_enabled() const
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the number of workers of the pool.
+     */
+    std::size_t size() const
+    {
+        return workers_.size();
+    }
+
+    /**
+     * @brief Enqueues a new task and wakes up a sleeping worker, if any.
+     *
+     * Thread safe operation.
+     *
+     * @param task Task to be processed by the routine.
+     * @return false if the pool is not enabled.
+     */
+    bool push(
+            const Task& task)
+    {
+        if (!enabled_.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        std::size_t idx;
+        const ThreadContext& ctx = thread_context();
+
+        if (ctx.pool == this)
+        {
+            idx = ctx.index;
+        }
+        else
+        {
+            idx = next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(workers_[idx]->mtx);
+
+            // Checked again under the lock, so that disable() either sees the task or the push fails
+            if (!enabled_.load())
+            {
+                return false;
+            }
+
+            // Counted before it can be taken, so that a worker never sees it below zero
+            pending_.fetch_add(1);
+            workers_[idx]->tasks.push_back(task);
+        }
+
+        {
+            std::lock_guard<std::mutex> sleep_lock(sleep_mtx_);
+            pushes_.fetch_add(1);
+        }
+        sleep_cv_.notify_one();
+
+        return true;
+    }
+
+    /**
+     * @brief Enqueues several tasks in the same deque with a single lock and
+     * wakes up as many sleeping workers as needed. Idle workers steal the rest.
+     *
+     * Thread safe operation.
+     *
+     * @param tasks Tasks to be processed by the routine.
+     * @return false if the pool is not enabled.
+     */
+    bool push(
+            const std::vector<Task>& tasks)
+    {
+        if (!enabled_.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        if (tasks.empty())
+        {
+            return true;
+        }
+
+        std::size_t idx;
+        const ThreadContext& ctx = thread_context();
+
+        if (ctx.pool == this)
+        {
+            idx = ctx.index;
+        }
+        else
+        {
+            idx = next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(workers_[idx]->mtx);
+
+            if (!enabled_.load())
+            {
+                return false;
+            }
+
+            pending_.fetch_add(tasks.size());
+            workers_[idx]->tasks.insert(workers_[idx]->tasks.end(), tasks.begin(), tasks.end());
+        }
+
+        {
+            std::lock_guard<std::mutex> sleep_lock(sleep_mtx_);
+            pushes_.fetch_add(1);
+        }
+
+        if (tasks.size() == 1)
+        {
+            sleep_cv_.notify_one();
+        }
+        else
+        {
+            sleep_cv_.notify_all();
+        }
+
+        return true;
+    }
+
+private:
+
+    struct Worker
+    {
+        std::mutex mtx;
+        std::deque<Task> tasks;
+    };
+
+    struct ThreadContext
+    {
+        const WorkStealingThreadPool* pool;
+        std::size_t index;
+    };
+
+    static ThreadContext& thread_context()
+    {
+        static thread_local ThreadContext ctx{nullptr, 0};
+        return ctx;
+    }
+
+    bool pop_own(
+            std::size_t idx,
+            Task& task)
+    {
+        Worker& worker = *workers_[idx];
+        std::lock_guard<std::mutex> lock(worker.mtx);
+
+        if (worker.tasks.empty())
+        {
+            return false;
+        }
+
+        task = std::move(worker.tasks.back());
+        worker.tasks.pop_back();
+        return true;
+    }
+
+    /**
+     * @brief Takes a task from the front of the deque of another worker.
+     *
+     * @param blocking Whether to wait for the locks of the deques, or skip
+     * those held by someone else.
+     */
+    bool steal(
+            std::size_t idx,
+            bool blocking,
+            Task& task)
+    {
+        for (std::size_t i = 1; i < workers_.size(); ++i)
+        {
+            Worker& victim = *workers_[(idx + i) % workers_.size()];
+            std::unique_lock<std::mutex> lock(victim.mtx, std::defer_lock);
+
+            if (blocking)
+            {
+                lock.lock();
+            }
+            else
+            {
+                lock.try_lock();
+            }
+
+            if (lock.owns_lock() && !victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void run(
+            std::size_t idx)
+    {
+        ThreadContext& ctx = thread_context();
+        ctx.pool = this;
+        ctx.index = idx;
+
+        Task task;
+
+        while (enabled_.load(std::memory_order_relaxed))
+        {
+            // Any push completed after this point wakes the worker up
+            const std::size_t seen_pushes = pushes_.load();
+
+            // Deques skipped for being locked are only visited again if some task is still pending
+            if (pop_own(idx, task) || steal(idx, false, task) ||
+                    (pending_.load() > 0 && steal(idx, true, task)))
+            {
+                pending_.fetch_sub(1);
+                routine_(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> sleep_lock(sleep_mtx_);
+            sleep_cv_.wait(sleep_lock, [this, seen_pushes]()
+                    {
+                        return !enabled_.load() || pushes_.load() != seen_pushes;
+                    });
+        }
+
+        ctx.pool = nullptr;
+    }
+
+    Routine routine_;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    std::vector<std::thread> threads_;
+
+    std::atomic<std::size_t> next_worker_;
+
+    //! Number of tasks enqueued, or about to be, and not yet taken by any worker
+    std::atomic<std::size_t> pending_;
+
+    //! Number of completed pushes, for the workers to sleep until the next one
+    std::atomic<std::size_t> pushes_;
+
+    std::atomic<bool> enabled_;
+
+    std::mutex state_mtx_, sleep_mtx_;
+
+    std::condition_variable sleep_cv_;
+
+};
+
+} // namespace utils
+} // namespace sustainml
+
+#endif // SUSTAINMLCPP_UTILS_WORKSTEALINGTHREADPOOL_HPP
@@ -19,15 +19,12 @@ TEST(BlackboxTestsPairedNodes, MLModelMetadataWithMLNode)
     MLModelMetadataManagedNode ml_md_node;
     MLModelManagedNode ml_node;
 
-    TaskInjector<UserInputImplPubSubType> ui_inj(common::TopicCollection::get()[common::USER_INPUT].first);
-    TaskInjector<HWConstraintsImplPubSubType> hw_cons_inj(common::TopicCollection::get()[common::HW_CONSTRAINT].first);
-    TaskInjector<AppRequirementsImplPubSubType> appreq_inj(common::TopicCollection::get()[common::APP_REQUIREMENT].first);
-    TaskInjector<MLModelImplPubSubType> ml_model_baseline_inj(common::TopicCollection::get()[common::ML_MODEL_BASELINE].
-                    first);
-    TaskInjector<HWResourceImplPubSubType> hw_res_baseline_inj(common::TopicCollection::get()[common::
-                    HW_RESOURCES_BASELINE].first);
-    TaskInjector<CO2FootprintImplPubSubType> co2_baseline_inj(common::TopicCollection::get()[common::
-                    CARBON_FOOTPRINT_BASELINE].first);
+    TaskInjector<UserInputImplPubSubType> ui_inj(common::topic_name(common::USER_INPUT));
+    TaskInjector<HWConstraintsImplPubSubType> hw_cons_inj(common::topic_name(common::HW_CONSTRAINT));
+    TaskInjector<AppRequirementsImplPubSubType> appreq_inj(common::topic_name(common::APP_REQUIREMENT));
+    TaskInjector<MLModelImplPubSubType> ml_model_baseline_inj(common::topic_name(common::ML_MODEL_BASELINE));
+    TaskInjector<HWResourceImplPubSubType> hw_res_baseline_inj(common::topic_name(common::HW_RESOURCES_BASELINE));
+    TaskInjector<CO2FootprintImplPubSubType> co2_baseline_inj(common::topic_name(common::CARBON_FOOTPRINT_BASELINE));
 
 
     ml_md_node.start();
@@ -66,16 +63,11 @@ TEST(BlackboxTestsPairedNodes, MachineLearningWithHardwareResourcesNode)
     HWConstraintsManagedNode hwc_node;
     AppRequirementsManagedNode app_req_node;
 
-    TaskInjector<MLModelMetadataImplPubSubType> enc_task_inj(common::TopicCollection::get()[common::ML_MODEL_METADATA].
-                    first);
-    TaskInjector<UserInputImplPubSubType> user_input_inj(common::TopicCollection::get()[common::USER_INPUT].
-                    first);
-    TaskInjector<MLModelImplPubSubType> ml_model_baseline_inj(common::TopicCollection::get()[common::ML_MODEL_BASELINE].
-                    first);
-    TaskInjector<HWResourceImplPubSubType> hw_res_baseline_inj(common::TopicCollection::get()[common::
-                    HW_RESOURCES_BASELINE].first);
-    TaskInjector<CO2FootprintImplPubSubType> co2_baseline_inj(common::TopicCollection::get()[common::
-                    CARBON_FOOTPRINT_BASELINE].first);
+    TaskInjector<MLModelMetadataImplPubSubType> enc_task_inj(common::topic_name(common::ML_MODEL_METADATA));
+    TaskInjector<UserInputImplPubSubType> user_input_inj(common::topic_name(common::USER_INPUT));
+    TaskInjector<MLModelImplPubSubType> ml_model_baseline_inj(common::topic_name(common::ML_MODEL_BASELINE));
+    TaskInjector<HWResourceImplPubSubType> hw_res_baseline_inj(common::topic_name(common::HW_RESOURCES_BASELINE));
+    TaskInjector<CO2FootprintImplPubSubType> co2_baseline_inj(common::topic_name(common::CARBON_FOOTPRINT_BASELINE));
 
     hw_node.start();
     ml_node.start();
@@ -110,10 +102,10 @@ TEST(BlackboxTestsPairedNodes, HardwareResourcesWithCarbonFootprintNode)
     HWResourcesManagedNode hw_node;
     CarbonFootprintManagedNode co2_node;
 
-    TaskInjector<MLModelImplPubSubType> ml_inj(common::TopicCollection::get()[common::ML_MODEL].first);
-    TaskInjector<UserInputImplPubSubType> ui_inj(common::TopicCollection::get()[common::USER_INPUT].first);
-    TaskInjector<HWConstraintsImplPubSubType> hw_cons_inj(common::TopicCollection::get()[common::HW_CONSTRAINT].first);
-    TaskInjector<AppRequirementsImplPubSubType> appreq_inj(common::TopicCollection::get()[common::APP_REQUIREMENT].first);
+    TaskInjector<MLModelImplPubSubType> ml_inj(common::topic_name(common::ML_MODEL));
+    TaskInjector<UserInputImplPubSubType> ui_inj(common::topic_name(common::USER_INPUT));
+    TaskInjector<HWConstraintsImplPubSubType> hw_cons_inj(common::topic_name(common::HW_CONSTRAINT));
+    TaskInjector<AppRequirementsImplPubSubType> appreq_inj(common::topic_name(common::APP_REQUIREMENT));
 
     co2_node.start();
     hw_node.start();
@@ -147,13 +139,10 @@ TEST(BlackboxTestsPairedNodes, CompleteChain)
     MLModelMetadataManagedNode ml_md_node;
     MLModelManagedNode ml_node;
 
-    TaskInjector<UserInputImplPubSubType> ui_inj(common::TopicCollection::get()[common::USER_INPUT].first);
-    TaskInjector<MLModelImplPubSubType> ml_model_baseline_inj(common::TopicCollection::get()[common::ML_MODEL_BASELINE].
-                    first);
-    TaskInjector<HWResourceImplPubSubType> hw_res_baseline_inj(common::TopicCollection::get()[common::
-                    HW_RESOURCES_BASELINE].first);
-    TaskInjector<CO2FootprintImplPubSubType> co2_baseline_inj(common::TopicCollection::get()[common::
-                    CARBON_FOOTPRINT_BASELINE].first);
+    TaskInjector<UserInputImplPubSubType> ui_inj(common::topic_name(common::USER_INPUT));
+    TaskInjector<MLModelImplPubSubType> ml_model_baseline_inj(common::topic_name(common::ML_MODEL_BASELINE));
+    TaskInjector<HWResourceImplPubSubType> hw_res_baseline_inj(common::topic_name(common::HW_RESOURCES_BASELINE));
+    TaskInjector<CO2FootprintImplPubSubType> co2_baseline_inj(common::topic_name(common::CARBON_FOOTPRINT_BASELINE));
 
     co2_node.start();
     hw_cons_node.start();
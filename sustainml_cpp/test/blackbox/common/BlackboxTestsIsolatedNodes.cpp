@@ -18,7 +18,7 @@ TEST(BlackboxTestsIsolatedNodes, MLModelMetadataNode)
 {
     MLModelMetadataManagedNode node;
 
-    TaskInjector<UserInputImplPubSubType> ui_inj(common::TopicCollection::get()[common::USER_INPUT].first);
+    TaskInjector<UserInputImplPubSubType> ui_inj(common::topic_name(common::USER_INPUT));
 
     node.start();
 
@@ -37,16 +37,12 @@ TEST(BlackboxTestsIsolatedNodes, MachineLearningModelNode)
 {
     MLModelManagedNode node;
 
-    TaskInjector<MLModelMetadataImplPubSubType> ml_model_metadata_inj(common::TopicCollection::get()[common::
-                    ML_MODEL_METADATA].first);
-    TaskInjector<HWConstraintsImplPubSubType> hw_cons_inj(common::TopicCollection::get()[common::HW_CONSTRAINT].first);
-    TaskInjector<AppRequirementsImplPubSubType> appreq_inj(common::TopicCollection::get()[common::APP_REQUIREMENT].first);
-    TaskInjector<MLModelImplPubSubType> ml_model_baseline_inj(common::TopicCollection::get()[common::ML_MODEL_BASELINE].
-                    first);
-    TaskInjector<HWResourceImplPubSubType> hw_res_baseline_inj(common::TopicCollection::get()[common::
-                    HW_RESOURCES_BASELINE].first);
-    TaskInjector<CO2FootprintImplPubSubType> co2_baseline_inj(common::TopicCollection::get()[common::
-                    CARBON_FOOTPRINT_BASELINE].first);
+    TaskInjector<MLModelMetadataImplPubSubType> ml_model_metadata_inj(common::topic_name(common::ML_MODEL_METADATA));
+    TaskInjector<HWConstraintsImplPubSubType> hw_cons_inj(common::topic_name(common::HW_CONSTRAINT));
+    TaskInjector<AppRequirementsImplPubSubType> appreq_inj(common::topic_name(common::APP_REQUIREMENT));
+    TaskInjector<MLModelImplPubSubType> ml_model_baseline_inj(common::topic_name(common::ML_MODEL_BASELINE));
+    TaskInjector<HWResourceImplPubSubType> hw_res_baseline_inj(common::topic_name(common::HW_RESOURCES_BASELINE));
+    TaskInjector<CO2FootprintImplPubSubType> co2_baseline_inj(common::topic_name(common::CARBON_FOOTPRINT_BASELINE));
 
     node.start();
 
@@ -80,9 +76,9 @@ TEST(BlackboxTestsIsolatedNodes, HardwareResourcesNode)
 {
     HWResourcesManagedNode node;
 
-    TaskInjector<MLModelImplPubSubType> ml_inj(common::TopicCollection::get()[common::ML_MODEL].first);
-    TaskInjector<HWConstraintsImplPubSubType> hw_cons_inj(common::TopicCollection::get()[common::HW_CONSTRAINT].first);
-    TaskInjector<AppRequirementsImplPubSubType> appreq_inj(common::TopicCollection::get()[common::APP_REQUIREMENT].first);
+    TaskInjector<MLModelImplPubSubType> ml_inj(common::topic_name(common::ML_MODEL));
+    TaskInjector<HWConstraintsImplPubSubType> hw_cons_inj(common::topic_name(common::HW_CONSTRAINT));
+    TaskInjector<AppRequirementsImplPubSubType> appreq_inj(common::topic_name(common::APP_REQUIREMENT));
 
     node.start();
 
@@ -107,9 +103,9 @@ TEST(BlackboxTestsIsolatedNodes, CarbonFootprintNode)
 {
     CarbonFootprintManagedNode node;
 
-    TaskInjector<UserInputImplPubSubType> ui_inj(common::TopicCollection::get()[common::USER_INPUT].first);
-    TaskInjector<MLModelImplPubSubType> ml_inj(common::TopicCollection::get()[common::ML_MODEL].first);
-    TaskInjector<HWResourceImplPubSubType> hw_inj(common::TopicCollection::get()[common::HW_RESOURCE].first);
+    TaskInjector<UserInputImplPubSubType> ui_inj(common::topic_name(common::USER_INPUT));
+    TaskInjector<MLModelImplPubSubType> ml_inj(common::topic_name(common::ML_MODEL));
+    TaskInjector<HWResourceImplPubSubType> hw_inj(common::topic_name(common::HW_RESOURCE));
 
     node.start();
 
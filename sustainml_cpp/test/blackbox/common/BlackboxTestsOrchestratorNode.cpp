@@ -276,15 +276,15 @@ TEST(OrchestratorNode, OrchestratorGetTaskData)
     orchestrator.start_task(task.first, task.second);
 
     ASSERT_TRUE(tonh->wait_for_data(std::chrono::seconds(10)));
-    void* enc_task = nullptr;
-    void* hw = nullptr;
+    types::MLModelMetadata enc_task;
+    types::HWResource hw;
     orchestrator.print_db();
-    ASSERT_EQ(orchestrator.get_task_data({1, 1}, NodeID::ID_ML_MODEL_METADATA, enc_task), RetCode_t::RETCODE_OK);
-    ASSERT_EQ(((types::MLModelMetadata*)enc_task)->task_id().problem_id(), 1);
-    ASSERT_EQ(orchestrator.get_task_data({2, 1}, NodeID::ID_ML_MODEL_METADATA, enc_task), RetCode_t::RETCODE_OK);
-    ASSERT_EQ(((types::MLModelMetadata*)enc_task)->task_id().problem_id(), 2);
-    ASSERT_EQ(orchestrator.get_task_data({2, 1}, NodeID::ID_HW_RESOURCES, hw), RetCode_t::RETCODE_OK);
-    ASSERT_EQ(((types::HWResource*)hw)->task_id().problem_id(), 2);
+    ASSERT_EQ(orchestrator.get_task_data({1, 1}, NodeID::ID_ML_MODEL_METADATA, &enc_task), RetCode_t::RETCODE_OK);
+    ASSERT_EQ(enc_task.task_id().problem_id(), 1);
+    ASSERT_EQ(orchestrator.get_task_data({2, 1}, NodeID::ID_ML_MODEL_METADATA, &enc_task), RetCode_t::RETCODE_OK);
+    ASSERT_EQ(enc_task.task_id().problem_id(), 2);
+    ASSERT_EQ(orchestrator.get_task_data({2, 1}, NodeID::ID_HW_RESOURCES, &hw), RetCode_t::RETCODE_OK);
+    ASSERT_EQ(hw.task_id().problem_id(), 2);
     orchestrator.destroy();
 }
 
@@ -439,10 +439,10 @@ TEST(OrchestratorNode, OrchestratorTaskIteration)
 
     orchestrator.print_db();
 
-    void* data;
+    std::shared_ptr<const void> data;
     ASSERT_EQ(RetCode_t::RETCODE_OK,
             orchestrator.get_task_data(iteration_data.first, NodeID::ID_CARBON_FOOTPRINT, data));
-    auto carbon_iterated_data = (types::CO2Footprint*)data;
+    auto carbon_iterated_data = static_cast<const types::CO2Footprint*>(data.get());
     ASSERT_EQ(1, carbon_iterated_data->task_id().problem_id());
     ASSERT_EQ(2, carbon_iterated_data->task_id().iteration_id());
     ASSERT_GT(carbon_iterated_data->energy_consumption(), 300);
@@ -0,0 +1,202 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file ConfigurationRequestBenchmark.cpp
+ *
+ * Measures the time a node takes to answer a burst of configuration requests
+ * sent at once, when its handler takes a while, for instance searching a
+ * remote model hub. Requests only overlap if the node has several RPC server
+ * threads and its listener is concurrent.
+ *
+ * Usage: ConfigurationRequestBenchmark [serial|concurrent] [server_threads] [requests] [handler_ms]
+ */
+
+#include <common/Common.hpp>
+#include <core/Options.hpp>
+#include <sustainml_cpp/core/RequestReplyListener.hpp>
+#include <sustainml_cpp/nodes/AppRequirementsNode.hpp>
+#include <types/SustainMLServiceClient.hpp>
+
+#include <fastdds/dds/domain/DomainParticipantFactory.hpp>
+#include <fastdds/dds/domain/qos/RequesterQos.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sustainml;
+using namespace eprosima::fastdds::dds;
+
+namespace {
+
+struct AppRequirementsListener : public app_requirements_module::AppRequirementsTaskListener
+{
+    void on_new_task_available(
+            types::UserInput&,
+            types::NodeStatus&,
+            types::AppRequirements&) override
+    {
+    }
+
+};
+
+//! Echoes the configuration after simulating a slow lookup
+struct SlowConfigurationListener : public core::RequestReplyListener
+{
+    SlowConfigurationListener(
+            bool concurrent,
+            std::chrono::milliseconds handler_time)
+        : core::RequestReplyListener(concurrent)
+        , handler_time_(handler_time)
+    {
+    }
+
+    void on_configuration_request(
+            types::RequestType& req,
+            types::ResponseType& res) override
+    {
+        std::this_thread::sleep_for(handler_time_);
+        res.success(true);
+        res.configuration(req.configuration());
+    }
+
+    std::chrono::milliseconds handler_time_;
+};
+
+/**
+ * @brief Sends requests until one is answered, so that the client and the
+ * server are matched before measuring.
+ */
+bool wait_server(
+        AppRequirementsService& client)
+{
+    for (int attempt = 0; attempt < 10; ++attempt)
+    {
+        auto future = client.update_configuration("warmup");
+
+        if (std::future_status::ready == future.wait_for(std::chrono::seconds(2)))
+        {
+            try
+            {
+                future.get();
+                return true;
+            }
+            catch (const std::exception&)
+            {
+            }
+        }
+    }
+
+    return false;
+}
+
+} // namespace
+
+int main(
+        int argc,
+        char** argv)
+{
+    bool concurrent = (argc > 1) && (0 == std::strcmp(argv[1], "concurrent"));
+    std::size_t server_threads = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 4;
+    std::size_t n_requests = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 16;
+    std::chrono::milliseconds handler_time((argc > 4) ? std::strtoul(argv[4], nullptr, 10) : 100);
+
+    core::Options opts;
+    opts.rpc_server_threads = server_threads;
+
+    AppRequirementsListener task_listener;
+    SlowConfigurationListener configuration_listener(concurrent, handler_time);
+    app_requirements_module::AppRequirementsNode node(task_listener, configuration_listener, opts);
+
+    auto* factory = DomainParticipantFactory::get_instance();
+    DomainParticipant* participant = factory->create_participant(
+        common::parse_sustainml_env(opts.domain), PARTICIPANT_QOS_DEFAULT);
+
+    if (nullptr == participant)
+    {
+        std::cerr << "Error creating the client participant" << std::endl;
+        return 1;
+    }
+
+    int ret = 0;
+
+    {
+        RequesterQos rqos;
+        std::shared_ptr<AppRequirementsService> client =
+                create_AppRequirementsServiceClient(*participant, "AppRequirementsService", rqos);
+
+        if (!client || !wait_server(*client))
+        {
+            std::cerr << "The AppRequirementsService did not answer" << std::endl;
+            ret = 1;
+        }
+        else
+        {
+            std::vector<std::future<std::string>> futures;
+            std::vector<double> latencies;
+            std::size_t errors = 0;
+
+            auto start = std::chrono::steady_clock::now();
+
+            for (std::size_t i = 0; i < n_requests; ++i)
+            {
+                futures.push_back(client->update_configuration("request_" + std::to_string(i)));
+            }
+
+            // Replies are collected in order, so every latency is an upper bound
+            for (auto& future : futures)
+            {
+                try
+                {
+                    future.get();
+                    latencies.push_back(
+                        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << "Request failed: " << e.what() << std::endl;
+                    ++errors;
+                }
+            }
+
+            double total = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            std::sort(latencies.begin(), latencies.end());
+
+            std::cout << "Listener: " << (concurrent ? "concurrent" : "serial") << ", server threads: "
+                      << server_threads << ", requests: " << n_requests << ", handler: " << handler_time.count()
+                      << " ms" << std::endl;
+            std::cout << "Burst completed in: " << total << " ms" << std::endl;
+
+            if (!latencies.empty())
+            {
+                std::cout << "Reply latency p50: " << latencies[latencies.size() / 2] << " ms, max: "
+                          << latencies.back() << " ms" << std::endl;
+            }
+
+            std::cout << "Errors: " << errors << std::endl;
+        }
+    }
+
+    participant->delete_contained_entities();
+    factory->delete_participant(participant);
+
+    return ret;
+}
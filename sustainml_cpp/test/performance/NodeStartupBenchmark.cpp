@@ -0,0 +1,213 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file NodeStartupBenchmark.cpp
+ *
+ * Measures the time to first task of the nodes fed by the user input when
+ * they are started in the same process, each with its own DomainParticipant
+ * or sharing one.
+ *
+ * Usage: NodeStartupBenchmark [separate|shared] [rounds]
+ */
+
+#include <common/Common.hpp>
+#include <core/Options.hpp>
+#include <sustainml_cpp/nodes/AppRequirementsNode.hpp>
+#include <sustainml_cpp/nodes/HardwareConstraintsNode.hpp>
+#include <sustainml_cpp/nodes/MLModelMetadataNode.hpp>
+#include <types/typesImplPubSubTypes.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <mutex>
+
+#include <TaskInjector.hpp>
+
+using namespace sustainml;
+
+namespace {
+
+constexpr std::size_t N_NODES = 3;
+
+//! Counts the nodes that have received their first task
+struct FirstTaskCounter
+{
+    void signal()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        ++count;
+        cv.notify_all();
+    }
+
+    bool wait_all(
+            std::chrono::seconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        return cv.wait_for(lock, timeout, [this]()
+                       {
+                           return count == N_NODES;
+                       });
+    }
+
+    std::size_t count{0};
+    std::mutex mtx;
+    std::condition_variable cv;
+};
+
+struct AppRequirementsListener : public app_requirements_module::AppRequirementsTaskListener
+{
+    AppRequirementsListener(
+            FirstTaskCounter& counter)
+        : counter_(counter)
+    {
+    }
+
+    void on_new_task_available(
+            types::UserInput&,
+            types::NodeStatus&,
+            types::AppRequirements&) override
+    {
+        counter_.signal();
+    }
+
+    FirstTaskCounter& counter_;
+};
+
+struct HardwareConstraintsListener : public hardware_module::HardwareConstraintsTaskListener
+{
+    HardwareConstraintsListener(
+            FirstTaskCounter& counter)
+        : counter_(counter)
+    {
+    }
+
+    void on_new_task_available(
+            types::UserInput&,
+            types::NodeStatus&,
+            types::HWConstraints&) override
+    {
+        counter_.signal();
+    }
+
+    FirstTaskCounter& counter_;
+};
+
+struct MLModelMetadataListener : public ml_model_module::MLModelMetadataTaskListener
+{
+    MLModelMetadataListener(
+            FirstTaskCounter& counter)
+        : counter_(counter)
+    {
+    }
+
+    void on_new_task_available(
+            types::UserInput&,
+            types::NodeStatus&,
+            types::MLModelMetadata&) override
+    {
+        counter_.signal();
+    }
+
+    FirstTaskCounter& counter_;
+};
+
+/**
+ * @brief Starts the nodes and injects a task once they are discovered.
+ *
+ * @param construction Receives the time spent creating the nodes
+ * @return The time from the creation of the first node to the first task
+ * received by the last one, negative if the task was not received.
+ */
+double run_round(
+        bool shared,
+        uint32_t round,
+        double& construction)
+{
+    TaskInjector<UserInputImplPubSubType> injector(common::topic_name(common::USER_INPUT));
+
+    core::Options opts;
+    opts.shared_participant = shared;
+
+    FirstTaskCounter counter;
+    AppRequirementsListener app_req_listener(counter);
+    HardwareConstraintsListener hw_cons_listener(counter);
+    MLModelMetadataListener metadata_listener(counter);
+
+    auto start = std::chrono::steady_clock::now();
+
+    app_requirements_module::AppRequirementsNode app_req_node(app_req_listener, opts);
+    hardware_module::HardwareConstraintsNode hw_cons_node(hw_cons_listener, opts);
+    ml_model_module::MLModelMetadataNode metadata_node(metadata_listener, opts);
+
+    construction = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (!injector.wait_discovery(N_NODES, std::chrono::seconds(10)))
+    {
+        return -1.0;
+    }
+
+    UserInputImpl user_input;
+    user_input.task_id().problem_id(round + 1);
+    user_input.task_id().iteration_id(1);
+
+    std::list<UserInputImpl> tasks{user_input};
+    injector.inject(tasks, 0);
+
+    if (!counter.wait_all(std::chrono::seconds(10)))
+    {
+        return -1.0;
+    }
+
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(
+        int argc,
+        char** argv)
+{
+    bool shared = (argc > 1) && (0 == std::strcmp(argv[1], "shared"));
+    uint32_t rounds = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 5;
+
+    double total_construction = 0.0;
+    double total_first_task = 0.0;
+
+    for (uint32_t round = 0; round < rounds; ++round)
+    {
+        double construction = 0.0;
+        double first_task = run_round(shared, round, construction);
+
+        if (first_task < 0.0)
+        {
+            std::cerr << "Round " << round << " timed out" << std::endl;
+            return 1;
+        }
+
+        total_construction += construction;
+        total_first_task += first_task;
+    }
+
+    std::cout << "Participants: " << (shared ? "shared" : "separate") << ", nodes: " << N_NODES
+              << ", rounds: " << rounds << std::endl;
+    std::cout << "Node construction: " << total_construction / rounds << " ms" << std::endl;
+    std::cout << "Time to first task: " << total_first_task / rounds << " ms" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,150 @@
+// Copyright 2023 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * @file SamplePoolBenchmark.cpp
+ *
+ * Compares the acquire/release throughput of SamplePool protected by a mutex,
+ * as SamplesQueue used it, against LockFreeSamplePool.
+ *
+ * Usage: SamplePoolBenchmark [threads] [iterations per thread]
+ */
+
+#include <utils/LockFreeSamplePool.hpp>
+#include <utils/SamplePool.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Cache
+{
+    void reset()
+    {
+        value = 0;
+    }
+
+    std::size_t value{0};
+};
+
+//! Each iteration acquires a small batch of caches and releases them
+constexpr std::size_t BATCH_SIZE = 4;
+
+class MutexPool
+{
+public:
+
+    MutexPool(
+            const sustainml::core::Options& opts)
+        : pool_(opts)
+    {
+    }
+
+    Cache* get_new_cache()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return pool_.get_new_cache_nts();
+    }
+
+    void release_cache(
+            Cache* cache)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        pool_.release_cache_nts(cache);
+    }
+
+private:
+
+    sustainml::utils::SamplePool<Cache> pool_;
+    std::mutex mtx_;
+};
+
+template <typename Pool>
+double run(
+        Pool& pool,
+        std::size_t n_threads,
+        std::size_t iterations)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t t = 0; t < n_threads; ++t)
+    {
+        threads.emplace_back([&pool, iterations]()
+                {
+                    Cache* caches[BATCH_SIZE];
+
+                    for (std::size_t i = 0; i < iterations; ++i)
+                    {
+                        for (std::size_t j = 0; j < BATCH_SIZE; ++j)
+                        {
+                            caches[j] = pool.get_new_cache();
+                            if (nullptr != caches[j])
+                            {
+                                caches[j]->value = i;
+                            }
+                        }
+
+                        for (std::size_t j = 0; j < BATCH_SIZE; ++j)
+                        {
+                            if (nullptr != caches[j])
+                            {
+                                pool.release_cache(caches[j]);
+                            }
+                        }
+                    }
+                });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(n_threads * iterations * BATCH_SIZE) / elapsed.count();
+}
+
+} // namespace
+
+int main(
+        int argc,
+        char** argv)
+{
+    std::size_t n_threads = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 4;
+    std::size_t iterations = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+
+    sustainml::core::Options opts;
+
+    MutexPool mutex_pool(opts);
+    sustainml::utils::LockFreeSamplePool<Cache> lock_free_pool(opts);
+
+    double mutex_rate = run(mutex_pool, n_threads, iterations);
+    double lock_free_rate = run(lock_free_pool, n_threads, iterations);
+
+    std::cout << "Threads: " << n_threads << ", iterations per thread: " << iterations << std::endl;
+    std::cout << "SamplePool + mutex:  " << mutex_rate << " acquire/release per second" << std::endl;
+    std::cout << "LockFreeSamplePool:  " << lock_free_rate << " acquire/release per second" << std::endl;
+
+    auto stats = lock_free_pool.stats();
+    std::cout << "LockFreeSamplePool high water mark: " << stats.high_water_mark
+              << ", exhausted: " << stats.exhausted_count << std::endl;
+
+    return 0;
+}
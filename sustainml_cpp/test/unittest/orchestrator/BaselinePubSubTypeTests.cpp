@@ -0,0 +1,159 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <orchestrator/BaselinePubSubType.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fastdds/dds/core/policy/QosPolicies.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace sustainml;
+using namespace sustainml::orchestrator;
+using namespace eprosima::fastdds::dds;
+using eprosima::fastdds::rtps::InstanceHandle_t;
+using eprosima::fastdds::rtps::SerializedPayload_t;
+
+namespace {
+
+// Odd sized sequences, so that the task id needs padding before it
+void fill(
+        CO2FootprintImpl& sample)
+{
+    sample.carbon_footprint(1.5);
+    sample.energy_consumption(2.5);
+    sample.carbon_intensity(3.5);
+    sample.extra_data(std::vector<uint8_t>{1, 2, 3});
+}
+
+void fill(
+        HWResourceImpl& sample)
+{
+    sample.hw_description("hardware");
+    sample.power_consumption(1.5);
+    sample.latency(2.5);
+    sample.memory_footprint_of_ml_model(3.5);
+    sample.max_hw_memory_footprint(4.5);
+    sample.extra_data(std::vector<uint8_t>{1, 2, 3, 4, 5});
+}
+
+void fill(
+        MLModelImpl& sample)
+{
+    sample.model_path("model.onnx");
+    sample.model("model");
+    sample.raw_model(std::vector<uint8_t>{1});
+    sample.model_properties_path("properties.json");
+    sample.model_properties("properties");
+    sample.input_batch(std::vector<std::string>{"batch"});
+    sample.target_latency(1.5);
+    sample.extra_data(std::vector<uint8_t>{1, 2});
+}
+
+} // namespace
+
+template <typename PubSubType>
+class BaselinePubSubTypeTests : public ::testing::Test
+{
+protected:
+
+    using Sample = typename PubSubType::type;
+
+    void SetUp() override
+    {
+        fill(sample_);
+        sample_.task_id().problem_id(7);
+        sample_.task_id().iteration_id(1);
+
+        expected_ = sample_;
+        expected_.task_id().iteration_id(2);
+    }
+
+    Sample round_trip(
+            DataRepresentationId_t data_representation)
+    {
+        BaselinePubSubType<PubSubType> baseline_type;
+        PubSubType plain_type;
+
+        SerializedPayload_t payload(baseline_type.calculate_serialized_size(&sample_, data_representation));
+
+        {
+            BaselineTaskIdScope scope(types::TaskId(7, 2));
+            EXPECT_TRUE(baseline_type.serialize(&sample_, payload, data_representation));
+        }
+
+        Sample received;
+        EXPECT_TRUE(plain_type.deserialize(payload, &received));
+        return received;
+    }
+
+    Sample sample_;
+
+    Sample expected_;
+};
+
+using BaselineTypes = ::testing::Types<CO2FootprintImplPubSubType, HWResourceImplPubSubType, MLModelImplPubSubType>;
+TYPED_TEST_SUITE(BaselinePubSubTypeTests, BaselineTypes);
+
+TYPED_TEST(BaselinePubSubTypeTests, replaces_the_task_id_in_xcdr1)
+{
+    typename TestFixture::Sample original = this->sample_;
+
+    EXPECT_EQ(this->round_trip(XCDR_DATA_REPRESENTATION), this->expected_);
+    EXPECT_EQ(this->sample_, original);
+}
+
+TYPED_TEST(BaselinePubSubTypeTests, replaces_the_task_id_in_xcdr2)
+{
+    typename TestFixture::Sample original = this->sample_;
+
+    EXPECT_EQ(this->round_trip(XCDR2_DATA_REPRESENTATION), this->expected_);
+    EXPECT_EQ(this->sample_, original);
+}
+
+TYPED_TEST(BaselinePubSubTypeTests, replaces_the_task_id_in_the_key)
+{
+    BaselinePubSubType<TypeParam> baseline_type;
+    TypeParam plain_type;
+
+    InstanceHandle_t baseline_handle;
+    InstanceHandle_t expected_handle;
+
+    {
+        BaselineTaskIdScope scope(types::TaskId(7, 2));
+        ASSERT_TRUE(baseline_type.compute_key(&this->sample_, baseline_handle));
+    }
+    ASSERT_TRUE(plain_type.compute_key(&this->expected_, expected_handle));
+
+    EXPECT_EQ(baseline_handle, expected_handle);
+}
+
+TYPED_TEST(BaselinePubSubTypeTests, behaves_as_the_type_out_of_a_scope)
+{
+    BaselinePubSubType<TypeParam> baseline_type;
+    TypeParam plain_type;
+
+    uint32_t size = plain_type.calculate_serialized_size(&this->sample_, XCDR2_DATA_REPRESENTATION);
+    SerializedPayload_t baseline_payload(size);
+    SerializedPayload_t plain_payload(size);
+
+    ASSERT_TRUE(baseline_type.serialize(&this->sample_, baseline_payload, XCDR2_DATA_REPRESENTATION));
+    ASSERT_TRUE(plain_type.serialize(&this->sample_, plain_payload, XCDR2_DATA_REPRESENTATION));
+
+    ASSERT_EQ(baseline_payload.length, plain_payload.length);
+    EXPECT_EQ(0, std::memcmp(baseline_payload.data, plain_payload.data, plain_payload.length));
+}
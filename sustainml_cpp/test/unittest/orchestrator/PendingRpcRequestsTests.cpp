@@ -0,0 +1,203 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <orchestrator/PendingRpcRequests.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace sustainml::orchestrator;
+
+namespace {
+
+//! Outcome of a request, filled by its callback
+struct Outcome
+{
+    std::promise<std::pair<bool, std::string>> promise;
+    std::future<std::pair<bool, std::string>> result = promise.get_future();
+
+    PendingRpcRequests::Callback callback()
+    {
+        return [this](bool success, const std::string& reply)
+               {
+                   promise.set_value(std::make_pair(success, reply));
+               };
+    }
+
+    bool completed_within(
+            const std::chrono::milliseconds& timeout)
+    {
+        return std::future_status::ready == result.wait_for(timeout);
+    }
+
+};
+
+std::chrono::steady_clock::time_point in(
+        const std::chrono::milliseconds& time)
+{
+    return std::chrono::steady_clock::now() + time;
+}
+
+} // namespace
+
+TEST(PendingRpcRequestsTests, hands_the_reply_to_the_callback)
+{
+    PendingRpcRequests requests;
+    std::promise<std::string> reply;
+    Outcome outcome;
+
+    EXPECT_NE(0u, requests.add(reply.get_future(), in(std::chrono::seconds(10)), outcome.callback()));
+    EXPECT_FALSE(outcome.completed_within(std::chrono::milliseconds(20)));
+
+    reply.set_value("configuration");
+
+    ASSERT_TRUE(outcome.completed_within(std::chrono::seconds(1)));
+    auto result = outcome.result.get();
+    EXPECT_TRUE(result.first);
+    EXPECT_EQ("configuration", result.second);
+}
+
+TEST(PendingRpcRequestsTests, fails_requests_replied_with_an_exception)
+{
+    PendingRpcRequests requests;
+    std::promise<std::string> reply;
+    Outcome outcome;
+
+    requests.add(reply.get_future(), in(std::chrono::seconds(10)), outcome.callback());
+    reply.set_exception(std::make_exception_ptr(std::runtime_error("remote error")));
+
+    ASSERT_TRUE(outcome.completed_within(std::chrono::seconds(1)));
+    EXPECT_FALSE(outcome.result.get().first);
+}
+
+TEST(PendingRpcRequestsTests, expires_requests_on_their_deadline)
+{
+    PendingRpcRequests requests;
+    std::promise<std::string> reply;
+    Outcome outcome;
+
+    auto start = std::chrono::steady_clock::now();
+    requests.add(reply.get_future(), in(std::chrono::milliseconds(50)), outcome.callback());
+
+    ASSERT_TRUE(outcome.completed_within(std::chrono::seconds(1)));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+    EXPECT_FALSE(outcome.result.get().first);
+}
+
+TEST(PendingRpcRequestsTests, cancelled_requests_are_completed_before_returning)
+{
+    PendingRpcRequests requests;
+    std::promise<std::string> reply;
+    Outcome outcome;
+
+    uint64_t request_id = requests.add(reply.get_future(), in(std::chrono::seconds(10)), outcome.callback());
+
+    EXPECT_TRUE(requests.cancel(request_id));
+    ASSERT_TRUE(outcome.completed_within(std::chrono::milliseconds(0)));
+    EXPECT_FALSE(outcome.result.get().first);
+
+    EXPECT_FALSE(requests.cancel(request_id));
+    EXPECT_FALSE(requests.cancel(request_id + 1));
+}
+
+TEST(PendingRpcRequestsTests, stop_gives_up_the_pending_requests)
+{
+    PendingRpcRequests requests;
+    std::promise<std::string> reply;
+    Outcome pending;
+    Outcome late;
+
+    requests.add(reply.get_future(), in(std::chrono::seconds(10)), pending.callback());
+    requests.stop();
+
+    ASSERT_TRUE(pending.completed_within(std::chrono::milliseconds(0)));
+    EXPECT_FALSE(pending.result.get().first);
+
+    std::promise<std::string> late_reply;
+    EXPECT_EQ(0u, requests.add(late_reply.get_future(), in(std::chrono::seconds(10)), late.callback()));
+    ASSERT_TRUE(late.completed_within(std::chrono::milliseconds(0)));
+    EXPECT_FALSE(late.result.get().first);
+}
+
+TEST(PendingRpcRequestsTests, backed_off_polling_still_replies_in_time)
+{
+    PendingRpcRequests requests;
+    std::promise<std::string> slow_reply;
+    Outcome slow;
+
+    requests.add(slow_reply.get_future(), in(std::chrono::seconds(10)), slow.callback());
+
+    // Long enough for the period to reach its maximum
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    auto start = std::chrono::steady_clock::now();
+    slow_reply.set_value("slow");
+    ASSERT_TRUE(slow.completed_within(std::chrono::seconds(1)));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 2 * RPC_POLL_MAX_PERIOD);
+
+    // A new request resets the period
+    std::promise<std::string> fast_reply;
+    Outcome fast;
+    fast_reply.set_value("fast");
+
+    start = std::chrono::steady_clock::now();
+    requests.add(fast_reply.get_future(), in(std::chrono::seconds(10)), fast.callback());
+    ASSERT_TRUE(fast.completed_within(std::chrono::seconds(1)));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, RPC_POLL_MAX_PERIOD);
+}
+
+TEST(PendingRpcRequestsTests, many_requests_in_flight)
+{
+    constexpr int N_REQUESTS = 100;
+
+    PendingRpcRequests requests;
+    std::vector<std::promise<std::string>> replies(N_REQUESTS);
+    std::atomic<int> succeeded{0};
+
+    for (auto& reply : replies)
+    {
+        requests.add(reply.get_future(), in(std::chrono::seconds(10)), [&succeeded](bool success, const std::string&)
+                {
+                    if (success)
+                    {
+                        ++succeeded;
+                    }
+                });
+    }
+
+    std::thread replier([&replies]()
+            {
+                for (auto& reply : replies)
+                {
+                    reply.set_value("ok");
+                }
+            });
+    replier.join();
+
+    auto deadline = in(std::chrono::seconds(2));
+    while (succeeded.load() < N_REQUESTS && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_EQ(N_REQUESTS, succeeded.load());
+}
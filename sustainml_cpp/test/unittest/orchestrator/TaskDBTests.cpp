@@ -0,0 +1,328 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <orchestrator/TaskDB.ipp>
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace sustainml;
+using namespace sustainml::orchestrator;
+
+namespace {
+
+using TaskDB_t = OrchestratorNode::TaskDB_t;
+
+types::MLModel make_model(
+        const types::TaskId& task_id,
+        std::size_t size)
+{
+    types::MLModel model;
+    model.task_id(task_id);
+    model.raw_model(std::vector<uint8_t>(size, static_cast<uint8_t>(task_id.problem_id())));
+    return model;
+}
+
+class TaskDBTests : public ::testing::Test
+{
+protected:
+
+    void SetUp() override
+    {
+        char path[] = "/tmp/sustainml_task_db_XXXXXX";
+        ASSERT_NE(::mkdtemp(path), nullptr);
+        dir_ = path;
+    }
+
+    void TearDown() override
+    {
+        for (const std::string& file : files())
+        {
+            std::remove((dir_ + "/" + file).c_str());
+        }
+        ::rmdir(dir_.c_str());
+    }
+
+    std::vector<std::string> files() const
+    {
+        std::vector<std::string> names;
+
+        if (DIR* d = ::opendir(dir_.c_str()))
+        {
+            while (struct dirent* file = ::readdir(d))
+            {
+                if ('.' != file->d_name[0])
+                {
+                    names.push_back(file->d_name);
+                }
+            }
+            ::closedir(d);
+        }
+
+        return names;
+    }
+
+    std::string dir_;
+};
+
+} // namespace
+
+TEST_F(TaskDBTests, concurrent_inserts_and_lookups_across_shards)
+{
+    TaskDB_t db;
+    constexpr uint32_t N_THREADS = 8;
+    constexpr uint32_t N_PROBLEMS = 64;
+    constexpr uint32_t N_ITERATIONS = 4;
+    std::atomic<bool> mismatch{false};
+
+    std::vector<std::thread> threads;
+
+    for (uint32_t t = 0; t < N_THREADS; ++t)
+    {
+        threads.emplace_back([&, t]()
+                {
+                    for (uint32_t p = 0; p < N_PROBLEMS; ++p)
+                    {
+                        for (uint32_t i = 1; i <= N_ITERATIONS; ++i)
+                        {
+                            types::TaskId task_id(1 + p * N_THREADS + t, i);
+                            db.insert_task_data_creating_entry(task_id, make_model(task_id, 16));
+
+                            // Problems of the other threads may or may not be there yet
+                            types::TaskId other(1 + p * N_THREADS + (t + 1) % N_THREADS, i);
+                            std::shared_ptr<const types::MLModel> model;
+
+                            if (!db.entry_exists(other) || !db.get_task_data(other, model))
+                            {
+                                continue;
+                            }
+
+                            // Empty until the element is inserted
+                            if (!model->raw_model().empty() && model->task_id() != other)
+                            {
+                                mismatch = true;
+                            }
+                        }
+                    }
+                });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_FALSE(mismatch);
+    EXPECT_EQ(N_THREADS * N_PROBLEMS, db.stats().live_problems);
+    EXPECT_EQ(N_THREADS * N_PROBLEMS * N_ITERATIONS, db.stats().live_entries);
+
+    for (uint32_t problem_id = 1; problem_id <= N_THREADS * N_PROBLEMS; ++problem_id)
+    {
+        types::TaskId task_id(problem_id, N_ITERATIONS);
+        std::shared_ptr<const types::MLModel> model;
+
+        ASSERT_TRUE(db.get_task_data(task_id, model));
+        EXPECT_EQ(task_id, model->task_id());
+        EXPECT_EQ(16u, model->raw_model().size());
+    }
+}
+
+TEST_F(TaskDBTests, evicts_least_recently_used_beyond_max_problems)
+{
+    core::Options opts;
+    opts.task_db_max_problems = 2;
+    TaskDB_t db(opts);
+
+    ASSERT_TRUE(db.prepare_new_entry(types::TaskId(1, 1), false));
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    ASSERT_TRUE(db.prepare_new_entry(types::TaskId(2, 1), false));
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+    // Problem 2 becomes the least recently used one
+    ASSERT_TRUE(db.entry_exists(types::TaskId(1, 1)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    ASSERT_TRUE(db.prepare_new_entry(types::TaskId(3, 1), false));
+
+    EXPECT_TRUE(db.entry_exists(types::TaskId(1, 1)));
+    EXPECT_FALSE(db.entry_exists(types::TaskId(2, 1)));
+    EXPECT_TRUE(db.entry_exists(types::TaskId(3, 1)));
+    EXPECT_EQ(2u, db.stats().live_problems);
+    EXPECT_EQ(1u, db.stats().evicted_problems);
+}
+
+TEST_F(TaskDBTests, evicts_beyond_max_bytes_but_never_the_last_problem)
+{
+    core::Options opts;
+    opts.task_db_max_bytes = 15000;
+    TaskDB_t db(opts);
+
+    db.insert_task_data_creating_entry(types::TaskId(1, 1), make_model(types::TaskId(1, 1), 10000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    db.insert_task_data_creating_entry(types::TaskId(2, 1), make_model(types::TaskId(2, 1), 10000));
+
+    EXPECT_FALSE(db.entry_exists(types::TaskId(1, 1)));
+    EXPECT_TRUE(db.entry_exists(types::TaskId(2, 1)));
+    EXPECT_EQ(1u, db.stats().evicted_problems);
+
+    // Over the limit on its own
+    db.insert_task_data_creating_entry(types::TaskId(2, 2), make_model(types::TaskId(2, 2), 20000));
+
+    EXPECT_TRUE(db.entry_exists(types::TaskId(2, 1)));
+    EXPECT_TRUE(db.entry_exists(types::TaskId(2, 2)));
+    EXPECT_EQ(1u, db.stats().live_problems);
+    EXPECT_LT(15000u, db.stats().live_bytes);
+}
+
+TEST_F(TaskDBTests, evicts_problems_not_accessed_within_the_ttl)
+{
+    core::Options opts;
+    opts.task_db_ttl = std::chrono::seconds(1);
+    TaskDB_t db(opts);
+
+    ASSERT_TRUE(db.prepare_new_entry(types::TaskId(1, 1), false));
+    ASSERT_TRUE(db.prepare_new_entry(types::TaskId(2, 1), false));
+    std::this_thread::sleep_for(std::chrono::milliseconds(600));
+    ASSERT_TRUE(db.entry_exists(types::TaskId(2, 1)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(600));
+    ASSERT_TRUE(db.prepare_new_entry(types::TaskId(3, 1), false));
+
+    EXPECT_FALSE(db.entry_exists(types::TaskId(1, 1)));
+    EXPECT_TRUE(db.entry_exists(types::TaskId(2, 1)));
+    EXPECT_TRUE(db.entry_exists(types::TaskId(3, 1)));
+    EXPECT_EQ(1u, db.stats().evicted_problems);
+}
+
+TEST_F(TaskDBTests, spilled_problems_are_read_back)
+{
+    core::Options opts;
+    opts.task_db_max_problems = 1;
+    opts.task_db_spill_dir = dir_;
+
+    {
+        TaskDB_t db(opts);
+
+        db.insert_task_data_creating_entry(types::TaskId(1, 1), make_model(types::TaskId(1, 1), 1000));
+        db.insert_task_data_creating_entry(types::TaskId(1, 2), make_model(types::TaskId(1, 2), 2000));
+        db.insert_task_data_creating_entry(types::TaskId(2, 1), make_model(types::TaskId(2, 1), 3000));
+
+        EXPECT_EQ(1u, db.stats().live_problems);
+        EXPECT_EQ(1u, db.stats().spilled_problems);
+        EXPECT_EQ(1u, files().size());
+
+        // Reading problem 1 back spills problem 2
+        std::shared_ptr<const types::MLModel> model;
+        ASSERT_TRUE(db.get_task_data(types::TaskId(1, 2), model));
+        EXPECT_EQ(types::TaskId(1, 2), model->task_id());
+        EXPECT_EQ(std::vector<uint8_t>(2000, 1), model->raw_model());
+        ASSERT_TRUE(db.get_task_data(types::TaskId(1, 1), model));
+        EXPECT_EQ(1000u, model->raw_model().size());
+
+        EXPECT_EQ(1u, db.stats().restored_problems);
+        EXPECT_EQ(2u, db.stats().spilled_problems);
+        EXPECT_EQ(1u, files().size());
+
+        ASSERT_TRUE(db.get_task_data(types::TaskId(2, 1), model));
+        EXPECT_EQ(std::vector<uint8_t>(3000, 2), model->raw_model());
+        EXPECT_FALSE(db.entry_exists(types::TaskId(3, 1)));
+    }
+
+    // Spilled problems do not outlive the DB
+    EXPECT_TRUE(files().empty());
+}
+
+TEST_F(TaskDBTests, logged_copies_keep_the_copied_value)
+{
+    core::Options opts;
+    opts.task_db_max_problems = 1;
+    opts.task_db_log_dir = dir_;
+    TaskDB_t db(opts);
+    types::TaskId source(1, 1);
+    types::TaskId dest(1, 2);
+
+    ASSERT_TRUE(db.prepare_new_entry(source, false));
+    ASSERT_TRUE(db.prepare_new_entry(dest, true));
+    ASSERT_TRUE(db.insert_task_data(source, make_model(source, 1000)));
+    ASSERT_TRUE(db.copy_data(source, dest, {NodeID::ID_ML_MODEL}));
+    ASSERT_TRUE(db.insert_task_data(source, make_model(source, 10)));
+
+    // Read back from the log
+    ASSERT_TRUE(db.prepare_new_entry(types::TaskId(2, 1), false));
+    EXPECT_EQ(1u, db.stats().evicted_problems);
+
+    std::shared_ptr<const types::MLModel> model;
+    ASSERT_TRUE(db.get_task_data(dest, model));
+    EXPECT_EQ(source, model->task_id());
+    EXPECT_EQ(1000u, model->raw_model().size());
+    ASSERT_TRUE(db.get_task_data(source, model));
+    EXPECT_EQ(10u, model->raw_model().size());
+    EXPECT_EQ(1u, db.stats().restored_problems);
+}
+
+TEST_F(TaskDBTests, copied_data_shares_the_payload)
+{
+    TaskDB_t db;
+    types::TaskId source(1, 1);
+    types::TaskId dest(1, 2);
+
+    ASSERT_TRUE(db.prepare_new_entry(source, false));
+    ASSERT_TRUE(db.prepare_new_entry(dest, true));
+    ASSERT_TRUE(db.insert_task_data(source, make_model(source, 1000)));
+    ASSERT_TRUE(db.copy_data(source, dest, {NodeID::ID_ML_MODEL}));
+
+    std::shared_ptr<const types::MLModel> source_model;
+    std::shared_ptr<const types::MLModel> dest_model;
+    ASSERT_TRUE(db.get_task_data(source, source_model));
+    ASSERT_TRUE(db.get_task_data(dest, dest_model));
+
+    EXPECT_EQ(source_model.get(), dest_model.get());
+}
+
+TEST_F(TaskDBTests, shared_payloads_are_copied_on_write)
+{
+    TaskDB_t db;
+    types::TaskId source(1, 1);
+    types::TaskId dest(1, 2);
+
+    ASSERT_TRUE(db.prepare_new_entry(source, false));
+    ASSERT_TRUE(db.prepare_new_entry(dest, true));
+    ASSERT_TRUE(db.insert_task_data(source, make_model(source, 1000)));
+    ASSERT_TRUE(db.copy_data(source, dest, {NodeID::ID_ML_MODEL}));
+
+    std::shared_ptr<const types::MLModel> snapshot;
+    ASSERT_TRUE(db.get_task_data(dest, snapshot));
+
+    ASSERT_TRUE(db.insert_task_data(dest, make_model(dest, 10)));
+
+    std::shared_ptr<const types::MLModel> source_model;
+    std::shared_ptr<const types::MLModel> dest_model;
+    ASSERT_TRUE(db.get_task_data(source, source_model));
+    ASSERT_TRUE(db.get_task_data(dest, dest_model));
+
+    // Neither the source nor the snapshot taken before see the new value
+    EXPECT_EQ(snapshot.get(), source_model.get());
+    EXPECT_EQ(1000u, snapshot->raw_model().size());
+    EXPECT_NE(source_model.get(), dest_model.get());
+    EXPECT_EQ(10u, dest_model->raw_model().size());
+    EXPECT_EQ(dest, dest_model->task_id());
+}
@@ -0,0 +1,141 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <orchestrator/TaskDataWaiters.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace sustainml;
+using namespace sustainml::orchestrator;
+
+TEST(TaskDataWaitersTests, times_out_if_the_output_never_arrives)
+{
+    TaskDataWaiters waiters;
+
+    EXPECT_EQ(RetCode_t::RETCODE_TIMEOUT, waiters.wait(types::TaskId(1, 1), NodeID::ID_ML_MODEL,
+            std::chrono::milliseconds(20), []()
+            {
+                return false;
+            }));
+}
+
+TEST(TaskDataWaitersTests, only_wakes_the_waiters_of_the_output)
+{
+    TaskDataWaiters waiters;
+    std::atomic<bool> model_available{false};
+    std::atomic<int> woken{0};
+
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&, i]()
+                {
+                    NodeID node_id = (i % 2) ? NodeID::ID_ML_MODEL : NodeID::ID_HW_RESOURCES;
+                    RetCode_t ret = waiters.wait(types::TaskId(1, 1), node_id, std::chrono::seconds(5), [&, node_id]()
+                    {
+                        return NodeID::ID_ML_MODEL == node_id && model_available.load();
+                    });
+
+                    if (RetCode_t::RETCODE_OK == ret)
+                    {
+                        ++woken;
+                    }
+                });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    model_available.store(true);
+    waiters.notify(types::TaskId(1, 1), NodeID::ID_ML_MODEL);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(2, woken.load());
+
+    waiters.stop();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(2, woken.load());
+}
+
+TEST(TaskDataWaitersTests, no_notification_is_lost_while_checking)
+{
+    for (uint32_t iteration_id = 1; iteration_id <= 100; ++iteration_id)
+    {
+        TaskDataWaiters waiters;
+        std::atomic<bool> available{false};
+        std::atomic<int> woken{0};
+
+        // A slow check, as a task restored from disk, races with the notification
+        auto is_available = [&available]()
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    return available.load();
+                };
+
+        std::vector<std::thread> threads;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            threads.emplace_back([&]()
+                    {
+                        if (RetCode_t::RETCODE_OK ==
+                        waiters.wait(types::TaskId(1, iteration_id), NodeID::ID_ML_MODEL,
+                        std::chrono::seconds(5), is_available))
+                        {
+                            ++woken;
+                        }
+                    });
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(20 * (iteration_id % 7)));
+        available.store(true);
+        waiters.notify(types::TaskId(1, iteration_id), NodeID::ID_ML_MODEL);
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        EXPECT_EQ(4, woken.load());
+        EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    }
+}
+
+TEST(TaskDataWaitersTests, stop_only_fails_unavailable_outputs)
+{
+    TaskDataWaiters waiters;
+    waiters.stop();
+
+    EXPECT_EQ(RetCode_t::RETCODE_OK, waiters.wait(types::TaskId(1, 1), NodeID::ID_ML_MODEL,
+            std::chrono::seconds(1), []()
+            {
+                return true;
+            }));
+    EXPECT_EQ(RetCode_t::RETCODE_ERROR, waiters.wait(types::TaskId(1, 1), NodeID::ID_ML_MODEL,
+            std::chrono::seconds(1), []()
+            {
+                return false;
+            }));
+}
@@ -0,0 +1,346 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <orchestrator/TaskLog.hpp>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace sustainml::orchestrator;
+
+namespace {
+
+//! Latest payload of each (iteration, element) of a problem
+using Contents = std::map<std::pair<uint32_t, uint32_t>, std::string>;
+
+class TaskLogTests : public ::testing::Test
+{
+protected:
+
+    void SetUp() override
+    {
+        char path[] = "/tmp/sustainml_task_log_XXXXXX";
+        ASSERT_NE(::mkdtemp(path), nullptr);
+        dir_ = path;
+    }
+
+    void TearDown() override
+    {
+        for (const std::string& file : files())
+        {
+            std::remove((dir_ + "/" + file).c_str());
+        }
+        ::rmdir(dir_.c_str());
+    }
+
+    std::vector<std::string> files() const
+    {
+        std::vector<std::string> names;
+
+        if (DIR* d = ::opendir(dir_.c_str()))
+        {
+            while (struct dirent* file = ::readdir(d))
+            {
+                if ('.' != file->d_name[0])
+                {
+                    names.push_back(file->d_name);
+                }
+            }
+            ::closedir(d);
+        }
+
+        return names;
+    }
+
+    static bool append(
+            TaskLog& log,
+            uint32_t problem_id,
+            uint32_t iteration_id,
+            uint32_t element,
+            const std::string& payload)
+    {
+        return log.append(problem_id, iteration_id, element,
+                       reinterpret_cast<const uint8_t*>(payload.data()), static_cast<uint32_t>(payload.size()));
+    }
+
+    static bool load(
+            TaskLog& log,
+            uint32_t problem_id,
+            Contents& contents)
+    {
+        contents.clear();
+        return log.load_problem(problem_id,
+                       [&contents](uint32_t iteration_id, uint32_t element, const uint8_t* data, uint32_t size)
+                       {
+                           contents[std::make_pair(iteration_id, element)] =
+                           std::string(reinterpret_cast<const char*>(data), size);
+                       });
+    }
+
+    std::string dir_;
+};
+
+} // namespace
+
+TEST_F(TaskLogTests, loads_the_latest_record_of_each_element)
+{
+    TaskLog log(dir_, 1024 * 1024, false);
+    ASSERT_TRUE(log.is_open());
+
+    EXPECT_TRUE(append(log, 1, 1, TaskLog::ENTRY_RECORD, ""));
+    EXPECT_TRUE(append(log, 1, 1, 0, "first"));
+    EXPECT_TRUE(append(log, 1, 1, 2, "other"));
+    EXPECT_TRUE(append(log, 1, 1, 0, "second"));
+    EXPECT_TRUE(append(log, 2, 1, 0, "problem 2"));
+
+    Contents contents;
+    ASSERT_TRUE(load(log, 1, contents));
+    EXPECT_EQ(contents.size(), 3u);
+    EXPECT_EQ(contents[std::make_pair(1u, 0u)], "second");
+    EXPECT_EQ(contents[std::make_pair(1u, 2u)], "other");
+
+    EXPECT_FALSE(load(log, 3, contents));
+    EXPECT_EQ(log.max_problem_id(), 2u);
+    EXPECT_EQ(log.problem_count(), 2u);
+}
+
+TEST_F(TaskLogTests, references_resolve_to_the_preceding_record)
+{
+    TaskLog log(dir_, 1024 * 1024, false);
+    ASSERT_TRUE(log.is_open());
+
+    EXPECT_TRUE(append(log, 1, 1, 0, "first"));
+    EXPECT_TRUE(log.append_reference(1, 2, 0, 1));
+    EXPECT_TRUE(log.append_reference(1, 3, 0, 2));
+    EXPECT_TRUE(append(log, 1, 1, 0, "second"));
+    EXPECT_TRUE(log.append_reference(1, 4, 0, 1));
+
+    // Not logged for the referenced iteration
+    EXPECT_TRUE(log.append_reference(2, 2, 0, 1));
+
+    Contents contents;
+    ASSERT_TRUE(load(log, 1, contents));
+    EXPECT_EQ(contents.size(), 4u);
+    EXPECT_EQ(contents[std::make_pair(1u, 0u)], "second");
+    EXPECT_EQ(contents[std::make_pair(2u, 0u)], "first");
+    EXPECT_EQ(contents[std::make_pair(3u, 0u)], "first");
+    EXPECT_EQ(contents[std::make_pair(4u, 0u)], "second");
+
+    EXPECT_FALSE(load(log, 2, contents));
+}
+
+TEST_F(TaskLogTests, compaction_keeps_what_references_resolve_to)
+{
+    const std::size_t segment_size = 256;
+    const std::string payload(100, 'x');
+
+    {
+        TaskLog log(dir_, segment_size, false);
+
+        ASSERT_TRUE(append(log, 1, 1, 0, "referenced"));
+        ASSERT_TRUE(log.append_reference(1, 2, 0, 1));
+        ASSERT_TRUE(log.append_reference(1, 3, 0, 2));
+
+        // Supersedes the referenced record, which is compacted away
+        for (uint32_t i = 0; i < 10 * TaskLog::COMPACTION_INTERVAL; ++i)
+        {
+            ASSERT_TRUE(append(log, 1, 1, 0, payload + std::to_string(i)));
+        }
+        log.flush();
+
+        EXPECT_LT(files().size(), 2 * TaskLog::COMPACTION_INTERVAL);
+    }
+
+    TaskLog log(dir_, segment_size, false);
+    Contents contents;
+    ASSERT_TRUE(load(log, 1, contents));
+    EXPECT_EQ(contents.size(), 3u);
+    EXPECT_EQ(contents[std::make_pair(1u, 0u)], payload + std::to_string(10 * TaskLog::COMPACTION_INTERVAL - 1));
+    EXPECT_EQ(contents[std::make_pair(2u, 0u)], "referenced");
+    EXPECT_EQ(contents[std::make_pair(3u, 0u)], "referenced");
+}
+
+TEST_F(TaskLogTests, recovers_after_restart)
+{
+    std::map<uint32_t, Contents> expected;
+
+    {
+        TaskLog log(dir_, 1024, true);
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            std::string payload = "value " + std::to_string(i);
+            ASSERT_TRUE(append(log, i % 5 + 1, i % 3 + 1, i % 7, payload));
+            expected[i % 5 + 1][std::make_pair(i % 3 + 1, i % 7)] = payload;
+        }
+        log.flush();
+    }
+
+    TaskLog log(dir_, 1024, false);
+    ASSERT_TRUE(log.is_open());
+    EXPECT_EQ(log.max_problem_id(), 5u);
+
+    for (auto& problem : expected)
+    {
+        Contents contents;
+        ASSERT_TRUE(load(log, problem.first, contents));
+        EXPECT_EQ(contents, problem.second);
+    }
+}
+
+TEST_F(TaskLogTests, ignores_a_torn_tail)
+{
+    {
+        TaskLog log(dir_, 1024 * 1024, false);
+        ASSERT_TRUE(append(log, 1, 1, 0, "kept"));
+        ASSERT_TRUE(append(log, 1, 1, 0, "torn by a crash"));
+    }
+
+    std::vector<std::string> segments = files();
+    ASSERT_EQ(segments.size(), 1u);
+    std::string path = dir_ + "/" + segments[0];
+
+    struct stat st;
+    ASSERT_EQ(::stat(path.c_str(), &st), 0);
+    ASSERT_EQ(::truncate(path.c_str(), st.st_size - 3), 0);
+
+    {
+        TaskLog log(dir_, 1024 * 1024, false);
+        Contents contents;
+        ASSERT_TRUE(load(log, 1, contents));
+        EXPECT_EQ(contents[std::make_pair(1u, 0u)], "kept");
+
+        // Records appended after the restart go to a new segment
+        ASSERT_TRUE(append(log, 1, 1, 0, "after restart"));
+    }
+
+    TaskLog log(dir_, 1024 * 1024, false);
+    Contents contents;
+    ASSERT_TRUE(load(log, 1, contents));
+    EXPECT_EQ(contents[std::make_pair(1u, 0u)], "after restart");
+}
+
+TEST_F(TaskLogTests, ignores_a_corrupted_last_record)
+{
+    {
+        TaskLog log(dir_, 1024 * 1024, false);
+        ASSERT_TRUE(append(log, 1, 1, 0, "kept"));
+        ASSERT_TRUE(append(log, 2, 1, 0, "corrupted"));
+    }
+
+    std::vector<std::string> segments = files();
+    ASSERT_EQ(segments.size(), 1u);
+    std::string path = dir_ + "/" + segments[0];
+
+    // Flip the last byte of the payload of the last record
+    FILE* file = std::fopen(path.c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(std::fseek(file, -1, SEEK_END), 0);
+    int last = std::fgetc(file);
+    ASSERT_EQ(std::fseek(file, -1, SEEK_END), 0);
+    std::fputc(last ^ 0xff, file);
+    std::fclose(file);
+
+    TaskLog log(dir_, 1024 * 1024, false);
+    EXPECT_TRUE(log.contains(1));
+    EXPECT_FALSE(log.contains(2));
+}
+
+TEST_F(TaskLogTests, compacts_superseded_records)
+{
+    const std::size_t segment_size = 256;
+    const std::string payload(100, 'x');
+
+    {
+        TaskLog log(dir_, segment_size, false);
+
+        // Every record supersedes the previous one, and two records fill a segment
+        for (uint32_t i = 0; i < 10 * TaskLog::COMPACTION_INTERVAL; ++i)
+        {
+            ASSERT_TRUE(append(log, 1, 1, 0, payload + std::to_string(i)));
+        }
+        log.flush();
+
+        EXPECT_LT(files().size(), 2 * TaskLog::COMPACTION_INTERVAL);
+
+        Contents contents;
+        ASSERT_TRUE(load(log, 1, contents));
+        EXPECT_EQ(contents[std::make_pair(1u, 0u)], payload + std::to_string(10 * TaskLog::COMPACTION_INTERVAL - 1));
+    }
+
+    TaskLog log(dir_, segment_size, false);
+    Contents contents;
+    ASSERT_TRUE(load(log, 1, contents));
+    EXPECT_EQ(contents.size(), 1u);
+    EXPECT_EQ(contents[std::make_pair(1u, 0u)], payload + std::to_string(10 * TaskLog::COMPACTION_INTERVAL - 1));
+}
+
+TEST_F(TaskLogTests, dropped_problems_stay_dropped)
+{
+    const std::string payload(100, 'x');
+
+    {
+        TaskLog log(dir_, 256, false);
+
+        for (uint32_t problem_id = 1; problem_id <= 10; ++problem_id)
+        {
+            ASSERT_TRUE(append(log, problem_id, 1, 0, payload));
+        }
+
+        EXPECT_TRUE(log.drop_problem(10));
+        EXPECT_FALSE(log.drop_problem(10));
+        log.drop_oldest_problems(4);
+        EXPECT_EQ(log.problem_count(), 4u);
+
+        // Compacted away, while the highest problem id is kept
+        for (uint32_t i = 0; i < 4 * TaskLog::COMPACTION_INTERVAL; ++i)
+        {
+            ASSERT_TRUE(append(log, 9, 1, 0, payload));
+        }
+        log.flush();
+    }
+
+    TaskLog log(dir_, 256, false);
+    EXPECT_EQ(log.problem_count(), 4u);
+    EXPECT_FALSE(log.contains(5));
+    EXPECT_TRUE(log.contains(6));
+    EXPECT_TRUE(log.contains(9));
+    EXPECT_FALSE(log.contains(10));
+    EXPECT_EQ(log.max_problem_id(), 10u);
+}
+
+TEST_F(TaskLogTests, files_are_private)
+{
+    {
+        TaskLog log(dir_, 1024, false);
+        ASSERT_TRUE(append(log, 1, 1, 0, "private"));
+    }
+
+    struct stat st;
+    ASSERT_EQ(::stat(dir_.c_str(), &st), 0);
+
+    for (const std::string& file : files())
+    {
+        ASSERT_EQ(::stat((dir_ + "/" + file).c_str(), &st), 0);
+        EXPECT_EQ(st.st_mode & 0777, 0600u) << file;
+    }
+}
@@ -0,0 +1,205 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <utils/BlobStore.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace sustainml::utils;
+
+namespace {
+
+std::vector<uint8_t> make_blob(
+        std::size_t size,
+        uint8_t seed)
+{
+    std::vector<uint8_t> blob(size);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        blob[i] = static_cast<uint8_t>(i * 31 + seed);
+    }
+
+    return blob;
+}
+
+std::string to_hex(
+        const Sha256Digest& digest)
+{
+    static const char hex[] = "0123456789abcdef";
+    std::string str;
+
+    for (uint8_t byte : digest)
+    {
+        str.push_back(hex[byte >> 4]);
+        str.push_back(hex[byte & 0x0f]);
+    }
+
+    return str;
+}
+
+//! Directory of the disk layer, set before the store is first used
+const std::string& blob_dir()
+{
+    static const std::string dir = []()
+            {
+                char path[] = "/tmp/sustainml_blob_store_XXXXXX";
+                std::string created = (nullptr != ::mkdtemp(path)) ? path : "";
+                ::setenv("SUSTAINML_BLOB_STORE_DIR", created.c_str(), 1);
+                return created;
+            }();
+    return dir;
+}
+
+BlobStore& store()
+{
+    blob_dir();
+    return BlobStore::get();
+}
+
+void write_file(
+        const std::string& path,
+        const std::vector<uint8_t>& bytes)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+} // namespace
+
+TEST(BlobStoreTests, put_and_fetch)
+{
+    std::vector<uint8_t> blob = make_blob(BlobStore::MIN_BLOB_SIZE, 1);
+    Sha256Digest digest = store().put(blob);
+
+    EXPECT_EQ(sha256(blob.data(), blob.size()), digest);
+
+    std::vector<uint8_t> fetched;
+    ASSERT_TRUE(store().fetch(digest, fetched));
+    EXPECT_EQ(blob, fetched);
+
+    // Putting the same bytes again yields the same digest
+    EXPECT_EQ(digest, store().put(blob));
+}
+
+TEST(BlobStoreTests, references_resolve_to_the_blob)
+{
+    std::vector<uint8_t> blob = make_blob(BlobStore::MIN_BLOB_SIZE, 2);
+    Sha256Digest digest = store().put(blob);
+
+    std::vector<uint8_t> reference = BlobStore::make_reference(digest, blob.size());
+    EXPECT_TRUE(BlobStore::is_reference(reference));
+    EXPECT_FALSE(BlobStore::is_reference(blob));
+
+    ASSERT_TRUE(store().resolve(reference));
+    EXPECT_EQ(blob, reference);
+}
+
+TEST(BlobStoreTests, unknown_reference_is_cleared)
+{
+    std::vector<uint8_t> never_stored = make_blob(BlobStore::MIN_BLOB_SIZE, 3);
+    std::vector<uint8_t> reference = BlobStore::make_reference(
+        sha256(never_stored.data(), never_stored.size()), never_stored.size());
+
+    EXPECT_FALSE(store().resolve(reference));
+    EXPECT_TRUE(reference.empty());
+}
+
+TEST(BlobStoreTests, reference_with_wrong_size_is_cleared)
+{
+    std::vector<uint8_t> blob = make_blob(BlobStore::MIN_BLOB_SIZE, 4);
+    Sha256Digest digest = store().put(blob);
+    std::vector<uint8_t> reference = BlobStore::make_reference(digest, blob.size() + 1);
+
+    EXPECT_FALSE(store().resolve(reference));
+    EXPECT_TRUE(reference.empty());
+}
+
+TEST(BlobStoreTests, announced_blobs_are_stored_under_their_digest)
+{
+    std::vector<uint8_t> blob = make_blob(BlobStore::MIN_BLOB_SIZE, 5);
+    Sha256Digest digest = sha256(blob.data(), blob.size());
+
+    std::vector<uint8_t> announced = blob;
+    BlobStore::announce(announced, digest);
+    EXPECT_TRUE(BlobStore::is_announced(announced));
+    EXPECT_FALSE(BlobStore::is_reference(announced));
+
+    store().put_announced(announced);
+    EXPECT_EQ(blob, announced);
+
+    std::vector<uint8_t> reference = BlobStore::make_reference(digest, blob.size());
+    ASSERT_TRUE(store().resolve(reference));
+    EXPECT_EQ(blob, reference);
+}
+
+TEST(BlobStoreTests, plain_blobs_are_not_announced)
+{
+    std::vector<uint8_t> blob = make_blob(BlobStore::MIN_BLOB_SIZE, 6);
+    EXPECT_FALSE(BlobStore::is_announced(blob));
+
+    // A trailer not matching the size of the contents is part of them
+    std::vector<uint8_t> shifted = blob;
+    BlobStore::announce(shifted, sha256(blob.data(), blob.size()));
+    shifted.insert(shifted.begin(), 0);
+    EXPECT_FALSE(BlobStore::is_announced(shifted));
+
+    std::vector<uint8_t> small = make_blob(16, 7);
+    BlobStore::announce(small, sha256(small.data(), small.size()));
+    EXPECT_FALSE(BlobStore::is_announced(small));
+}
+
+TEST(BlobStoreTests, blobs_are_written_to_disk)
+{
+    ASSERT_FALSE(blob_dir().empty());
+
+    std::vector<uint8_t> blob = make_blob(BlobStore::MIN_BLOB_SIZE, 5);
+    Sha256Digest digest = store().put(blob);
+
+    std::ifstream file(blob_dir() + "/" + to_hex(digest), std::ios::binary);
+    std::vector<uint8_t> on_disk((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(blob, on_disk);
+}
+
+TEST(BlobStoreTests, blobs_put_by_other_processes_are_read_from_disk)
+{
+    ASSERT_FALSE(blob_dir().empty());
+
+    std::vector<uint8_t> blob = make_blob(BlobStore::MIN_BLOB_SIZE, 6);
+    Sha256Digest digest = sha256(blob.data(), blob.size());
+    write_file(blob_dir() + "/" + to_hex(digest), blob);
+
+    std::vector<uint8_t> fetched;
+    ASSERT_TRUE(store().fetch(digest, fetched));
+    EXPECT_EQ(blob, fetched);
+}
+
+TEST(BlobStoreTests, corrupted_blobs_on_disk_are_discarded)
+{
+    ASSERT_FALSE(blob_dir().empty());
+
+    std::vector<uint8_t> blob = make_blob(BlobStore::MIN_BLOB_SIZE, 7);
+    Sha256Digest digest = sha256(blob.data(), blob.size());
+    blob[0] ^= 0xff;
+    write_file(blob_dir() + "/" + to_hex(digest), blob);
+
+    std::vector<uint8_t> fetched;
+    EXPECT_FALSE(store().fetch(digest, fetched));
+}
@@ -0,0 +1,75 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <utils/Crc32.hpp>
+
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace sustainml::utils;
+
+namespace {
+
+uint32_t crc_of(
+        const char* str)
+{
+    return crc32(reinterpret_cast<const uint8_t*>(str), std::strlen(str));
+}
+
+} // namespace
+
+TEST(Crc32Tests, empty_buffer)
+{
+    EXPECT_EQ(crc32(nullptr, 0), 0u);
+}
+
+TEST(Crc32Tests, known_vectors)
+{
+    // Check value of the IEEE 802.3 CRC-32
+    EXPECT_EQ(crc_of("123456789"), 0xcbf43926u);
+    EXPECT_EQ(crc_of("a"), 0xe8b7be43u);
+    EXPECT_EQ(crc_of("The quick brown fox jumps over the lazy dog"), 0x414fa339u);
+}
+
+TEST(Crc32Tests, chained_buffers)
+{
+    const char* str = "The quick brown fox jumps over the lazy dog";
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(str);
+    std::size_t size = std::strlen(str);
+
+    for (std::size_t split = 0; split <= size; ++split)
+    {
+        EXPECT_EQ(crc32(bytes + split, size - split, crc32(bytes, split)), crc_of(str));
+    }
+}
+
+TEST(Crc32Tests, detects_single_bit_flips)
+{
+    std::vector<uint8_t> bytes(64);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    uint32_t crc = crc32(bytes.data(), bytes.size());
+
+    for (std::size_t bit = 0; bit < bytes.size() * 8; ++bit)
+    {
+        bytes[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+        EXPECT_NE(crc32(bytes.data(), bytes.size()), crc);
+        bytes[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+    }
+}
@@ -0,0 +1,245 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <core/Options.hpp>
+#include <utils/LockFreeSamplePool.hpp>
+
+#include <atomic>
+#include <functional>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace sustainml;
+using namespace sustainml::utils;
+
+namespace {
+
+struct Cache
+{
+    void reset()
+    {
+        value = 0;
+    }
+
+    int value{0};
+    //! Set while the cache is handed out, to detect it being handed out twice
+    std::atomic<bool> owned{false};
+};
+
+core::Options pool_options(
+        std::size_t slab_size,
+        std::size_t max_size)
+{
+    core::Options opts;
+    opts.sample_pool_size = slab_size;
+    opts.sample_pool_max_size = max_size;
+    return opts;
+}
+
+/**
+ * @brief Acquires and releases caches from several threads at the same time, failing
+ * if a cache is handed out to two threads at once.
+ */
+void hammer(
+        LockFreeSamplePool<Cache>& pool,
+        std::size_t n_threads,
+        std::size_t iterations,
+        const std::function<std::size_t(std::size_t)>& held_per_thread)
+{
+    std::atomic<bool> double_handout{false};
+    std::vector<std::thread> threads;
+
+    for (std::size_t t = 0; t < n_threads; ++t)
+    {
+        threads.emplace_back([&]()
+                {
+                    std::vector<Cache*> held;
+
+                    auto release_oldest = [&]()
+                            {
+                                held.front()->owned.store(false);
+                                pool.release_cache(held.front());
+                                held.erase(held.begin());
+                            };
+
+                    for (std::size_t i = 0; i < iterations; ++i)
+                    {
+                        Cache* cache = pool.get_new_cache();
+
+                        if (nullptr != cache)
+                        {
+                            if (cache->owned.exchange(true))
+                            {
+                                double_handout.store(true);
+                            }
+                            held.push_back(cache);
+                        }
+                        else if (!held.empty())
+                        {
+                            release_oldest();
+                        }
+
+                        while (held.size() > held_per_thread(i))
+                        {
+                            release_oldest();
+                        }
+                    }
+
+                    for (Cache* cache : held)
+                    {
+                        cache->owned.store(false);
+                        pool.release_cache(cache);
+                    }
+                });
+    }
+
+    for (auto& th : threads)
+    {
+        th.join();
+    }
+
+    EXPECT_FALSE(double_handout.load());
+    EXPECT_EQ(0u, pool.stats().in_use);
+}
+
+} // namespace
+
+TEST(LockFreeSamplePoolTests, hands_out_distinct_caches_up_to_max_size)
+{
+    LockFreeSamplePool<Cache> pool(pool_options(4, 10));
+    std::set<Cache*> caches;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        Cache* cache = pool.get_new_cache();
+        ASSERT_NE(nullptr, cache);
+        EXPECT_TRUE(caches.insert(cache).second);
+    }
+
+    EXPECT_EQ(nullptr, pool.get_new_cache());
+    EXPECT_EQ(10u, pool.stats().capacity);
+    EXPECT_EQ(10u, pool.stats().in_use);
+    EXPECT_EQ(1u, pool.stats().exhausted_count);
+
+    for (Cache* cache : caches)
+    {
+        pool.release_cache(cache);
+    }
+
+    EXPECT_EQ(0u, pool.stats().in_use);
+    EXPECT_EQ(10u, pool.stats().high_water_mark);
+}
+
+TEST(LockFreeSamplePoolTests, rejects_foreign_caches)
+{
+    LockFreeSamplePool<Cache> pool(pool_options(4, 8));
+    Cache foreign;
+
+    pool.release_cache(nullptr);
+    pool.release_cache(&foreign);
+
+    EXPECT_EQ(0u, pool.stats().in_use);
+    EXPECT_EQ(4u, pool.stats().capacity);
+}
+
+TEST(LockFreeSamplePoolTests, released_caches_are_reset)
+{
+    LockFreeSamplePool<Cache> pool(pool_options(1, 1));
+
+    Cache* cache = pool.get_new_cache();
+    ASSERT_NE(nullptr, cache);
+    cache->value = 42;
+    pool.release_cache(cache);
+
+    cache = pool.get_new_cache();
+    ASSERT_NE(nullptr, cache);
+    EXPECT_EQ(0, cache->value);
+    pool.release_cache(cache);
+}
+
+TEST(LockFreeSamplePoolTests, shrinks_after_sustained_low_usage)
+{
+    constexpr std::size_t SLAB_SIZE = 4;
+    LockFreeSamplePool<Cache> pool(pool_options(SLAB_SIZE, 4 * SLAB_SIZE));
+    std::vector<Cache*> caches;
+
+    for (std::size_t i = 0; i < 3 * SLAB_SIZE; ++i)
+    {
+        caches.push_back(pool.get_new_cache());
+        ASSERT_NE(nullptr, caches.back());
+    }
+
+    for (Cache* cache : caches)
+    {
+        pool.release_cache(cache);
+    }
+
+    EXPECT_EQ(3 * SLAB_SIZE, pool.stats().capacity);
+
+    for (std::size_t i = 0; i < (SHRINK_LOW_WINDOWS + 1) * SHRINK_WINDOW_SLABS * SLAB_SIZE; ++i)
+    {
+        Cache* cache = pool.get_new_cache();
+        ASSERT_NE(nullptr, cache);
+        pool.release_cache(cache);
+    }
+
+    EXPECT_EQ(SLAB_SIZE, pool.stats().capacity);
+    EXPECT_EQ(3 * SLAB_SIZE, pool.stats().max_capacity_reached);
+
+    // Grows again on demand
+    caches.clear();
+
+    for (std::size_t i = 0; i < 2 * SLAB_SIZE; ++i)
+    {
+        caches.push_back(pool.get_new_cache());
+        ASSERT_NE(nullptr, caches.back());
+    }
+
+    EXPECT_EQ(2 * SLAB_SIZE, pool.stats().capacity);
+
+    for (Cache* cache : caches)
+    {
+        pool.release_cache(cache);
+    }
+}
+
+TEST(LockFreeSamplePoolTests, aba_under_contention)
+{
+    // A couple of caches shared by many threads make the same index reach the
+    // top of the stack again while other threads are popping it
+    LockFreeSamplePool<Cache> pool(pool_options(2, 2));
+
+    hammer(pool, 8, 50000, [](std::size_t)
+            {
+                return 1;
+            });
+}
+
+TEST(LockFreeSamplePoolTests, concurrent_growth_and_shrink)
+{
+    // Short bursts in which every thread holds several caches make the pool grow,
+    // and it shrinks in the quiet periods in between while other threads use it
+    LockFreeSamplePool<Cache> pool(pool_options(2, 64));
+
+    hammer(pool, 4, 50000, [](std::size_t i)
+            {
+                return (i % 1000 < 20) ? 8 : 0;
+            });
+
+    EXPECT_LE(pool.stats().capacity, 64u);
+    EXPECT_GT(pool.stats().max_capacity_reached, 8u);
+}
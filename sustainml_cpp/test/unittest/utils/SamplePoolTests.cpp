@@ -0,0 +1,150 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <core/Options.hpp>
+#include <utils/SamplePool.hpp>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace sustainml;
+using namespace sustainml::utils;
+
+namespace {
+
+struct Cache
+{
+    void reset()
+    {
+        value = 0;
+    }
+
+    int value{0};
+};
+
+constexpr std::size_t SLAB_SIZE = 4;
+
+core::Options pool_options()
+{
+    core::Options opts;
+    opts.sample_pool_size = SLAB_SIZE;
+    opts.sample_pool_max_size = 4 * SLAB_SIZE;
+    return opts;
+}
+
+/**
+ * @brief Hands out n caches at once and returns all of them.
+ */
+void burst(
+        SamplePool<Cache>& pool,
+        std::size_t n)
+{
+    std::vector<Cache*> caches;
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        caches.push_back(pool.get_new_cache_nts());
+        ASSERT_NE(nullptr, caches.back());
+    }
+
+    for (Cache* cache : caches)
+    {
+        pool.release_cache_nts(cache);
+    }
+}
+
+} // namespace
+
+TEST(SamplePoolTests, grows_up_to_max_size)
+{
+    SamplePool<Cache> pool(pool_options());
+    std::vector<Cache*> caches;
+
+    for (std::size_t i = 0; i < 4 * SLAB_SIZE; ++i)
+    {
+        caches.push_back(pool.get_new_cache_nts());
+        ASSERT_NE(nullptr, caches.back());
+    }
+
+    EXPECT_EQ(nullptr, pool.get_new_cache_nts());
+    EXPECT_EQ(4 * SLAB_SIZE, pool.stats_nts().capacity);
+    EXPECT_EQ(1u, pool.stats_nts().exhausted_count);
+
+    for (Cache* cache : caches)
+    {
+        pool.release_cache_nts(cache);
+    }
+
+    EXPECT_EQ(0u, pool.stats_nts().in_use);
+}
+
+TEST(SamplePoolTests, steady_load_does_not_shrink)
+{
+    SamplePool<Cache> pool(pool_options());
+
+    // Every burst empties the pool, but its usage never fits in the first slab
+    for (int i = 0; i < 100; ++i)
+    {
+        burst(pool, 2 * SLAB_SIZE);
+        ASSERT_EQ(2 * SLAB_SIZE, pool.stats_nts().capacity);
+    }
+}
+
+TEST(SamplePoolTests, shrinks_after_sustained_low_usage)
+{
+    SamplePool<Cache> pool(pool_options());
+
+    burst(pool, 3 * SLAB_SIZE);
+    EXPECT_EQ(3 * SLAB_SIZE, pool.stats_nts().capacity);
+
+    // A single window of low usage is not enough
+    std::size_t releases = 0;
+
+    while (releases < SHRINK_WINDOW_SLABS * SLAB_SIZE)
+    {
+        burst(pool, 1);
+        ++releases;
+    }
+
+    EXPECT_EQ(3 * SLAB_SIZE, pool.stats_nts().capacity);
+
+    while (releases < (SHRINK_LOW_WINDOWS + 1) * SHRINK_WINDOW_SLABS * SLAB_SIZE)
+    {
+        burst(pool, 1);
+        ++releases;
+    }
+
+    EXPECT_EQ(SLAB_SIZE, pool.stats_nts().capacity);
+}
+
+TEST(SamplePoolTests, does_not_shrink_while_in_use)
+{
+    SamplePool<Cache> pool(pool_options());
+
+    burst(pool, 2 * SLAB_SIZE);
+
+    Cache* held = pool.get_new_cache_nts();
+    ASSERT_NE(nullptr, held);
+
+    for (std::size_t i = 0; i < 4 * SHRINK_LOW_WINDOWS * SHRINK_WINDOW_SLABS * SLAB_SIZE; ++i)
+    {
+        burst(pool, 1);
+    }
+
+    EXPECT_EQ(2 * SLAB_SIZE, pool.stats_nts().capacity);
+
+    pool.release_cache_nts(held);
+    EXPECT_EQ(SLAB_SIZE, pool.stats_nts().capacity);
+}
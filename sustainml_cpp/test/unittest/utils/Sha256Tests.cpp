@@ -0,0 +1,82 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <utils/Sha256.hpp>
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace sustainml::utils;
+
+namespace {
+
+std::string hex_digest(
+        const std::string& message)
+{
+    static const char hex[] = "0123456789abcdef";
+    Sha256Digest digest = sha256(reinterpret_cast<const uint8_t*>(message.data()), message.size());
+    std::string str;
+
+    for (uint8_t byte : digest)
+    {
+        str.push_back(hex[byte >> 4]);
+        str.push_back(hex[byte & 0x0f]);
+    }
+
+    return str;
+}
+
+} // namespace
+
+// Test vectors of FIPS 180-4, from the NIST examples of SHA-256
+
+TEST(Sha256Tests, empty_message)
+{
+    EXPECT_EQ("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", hex_digest(""));
+}
+
+TEST(Sha256Tests, one_block_message)
+{
+    EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", hex_digest("abc"));
+}
+
+TEST(Sha256Tests, two_block_message)
+{
+    EXPECT_EQ("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+            hex_digest("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"));
+}
+
+TEST(Sha256Tests, long_message)
+{
+    EXPECT_EQ("cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1",
+            hex_digest("abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmno"
+            "ijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu"));
+}
+
+TEST(Sha256Tests, one_million_a)
+{
+    EXPECT_EQ("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0",
+            hex_digest(std::string(1000000, 'a')));
+}
+
+TEST(Sha256Tests, padding_boundaries)
+{
+    // The length no longer fits in the last block from 56 bytes on
+    EXPECT_EQ("9f4390f8d30c2dd92ec9f095b65e2b9ae9b0a925a5258e241c9f1e910f734318", hex_digest(std::string(55, 'a')));
+    EXPECT_EQ("b35439a4ac6f0948b6d6f9e3c6af0f5f590ce20f1bde7090ef7970686ec6738a", hex_digest(std::string(56, 'a')));
+    EXPECT_EQ("7d3e74a05d7db15bce4ad9ec0658ea98e3f06eeecf16b4c6fff2da457ddc2f34", hex_digest(std::string(63, 'a')));
+    EXPECT_EQ("ffe054fe7ae0cb6dc65c3af9b61d5209f439851db43d0ba5997337df154668eb", hex_digest(std::string(64, 'a')));
+    EXPECT_EQ("635361c48bb9eab14198e76ea8ab7f1a41685d6ad62aa9146d301d4f17eb0ae0", hex_digest(std::string(65, 'a')));
+}
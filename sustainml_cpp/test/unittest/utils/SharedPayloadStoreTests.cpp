@@ -0,0 +1,166 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <core/Options.hpp>
+#include <utils/SharedPayloadStore.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+using namespace sustainml;
+using namespace sustainml::utils;
+
+namespace {
+
+constexpr std::size_t THRESHOLD = 1024;
+
+core::Options store_options(
+        std::size_t retained)
+{
+    core::Options opts;
+    opts.shared_payloads = true;
+    opts.shared_payload_threshold = THRESHOLD;
+    opts.shared_payload_retained = retained;
+    return opts;
+}
+
+std::vector<uint8_t> make_payload(
+        std::size_t size)
+{
+    std::vector<uint8_t> payload(size);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        payload[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    return payload;
+}
+
+//! Segment name carried by a descriptor, see SharedPayloadStore::export_payload
+std::string segment_name(
+        const std::vector<uint8_t>& descriptor)
+{
+    return std::string(descriptor.begin() + 8 + sizeof(uint64_t), descriptor.end());
+}
+
+} // namespace
+
+TEST(SharedPayloadStoreTests, round_trip)
+{
+    SharedPayloadStore store(store_options(4));
+    std::vector<uint8_t> payload = make_payload(4 * THRESHOLD);
+    const std::vector<uint8_t> original = payload;
+
+    ASSERT_TRUE(store.export_payload(payload));
+    EXPECT_LT(payload.size(), original.size());
+
+    EXPECT_TRUE(SharedPayloadStore::import_payload(payload));
+    EXPECT_EQ(original, payload);
+}
+
+TEST(SharedPayloadStoreTests, small_payloads_are_sent_in_band)
+{
+    SharedPayloadStore store(store_options(4));
+    std::vector<uint8_t> payload = make_payload(THRESHOLD - 1);
+    const std::vector<uint8_t> original = payload;
+
+    EXPECT_FALSE(store.export_payload(payload));
+    EXPECT_TRUE(SharedPayloadStore::import_payload(payload));
+    EXPECT_EQ(original, payload);
+}
+
+TEST(SharedPayloadStoreTests, segments_are_private)
+{
+    SharedPayloadStore store(store_options(4));
+    std::vector<uint8_t> payload = make_payload(THRESHOLD);
+
+    ASSERT_TRUE(store.export_payload(payload));
+
+    int fd = ::shm_open(segment_name(payload).c_str(), O_RDONLY, 0);
+    ASSERT_GE(fd, 0);
+
+    struct stat segment_stat;
+    ASSERT_EQ(0, ::fstat(fd, &segment_stat));
+    EXPECT_EQ(static_cast<mode_t>(0600), segment_stat.st_mode & 0777);
+    ::close(fd);
+}
+
+TEST(SharedPayloadStoreTests, rejects_size_mismatch)
+{
+    SharedPayloadStore store(store_options(4));
+    std::vector<uint8_t> payload = make_payload(THRESHOLD);
+
+    ASSERT_TRUE(store.export_payload(payload));
+
+    // A descriptor announcing more bytes than the segment holds must not be mapped
+    uint64_t size = 1024 * THRESHOLD;
+    std::memcpy(payload.data() + 8, &size, sizeof(size));
+
+    EXPECT_FALSE(SharedPayloadStore::import_payload(payload));
+    EXPECT_TRUE(payload.empty());
+}
+
+TEST(SharedPayloadStoreTests, rejects_foreign_segment_names)
+{
+    SharedPayloadStore store(store_options(4));
+    std::vector<uint8_t> payload = make_payload(THRESHOLD);
+
+    ASSERT_TRUE(store.export_payload(payload));
+
+    std::string foreign = "/other_segment";
+    payload.resize(8 + sizeof(uint64_t));
+    payload.insert(payload.end(), foreign.begin(), foreign.end());
+
+    EXPECT_FALSE(SharedPayloadStore::import_payload(payload));
+    EXPECT_TRUE(payload.empty());
+}
+
+TEST(SharedPayloadStoreTests, full_retention_falls_back_in_band)
+{
+    SharedPayloadStore store(store_options(1));
+    std::vector<uint8_t> first = make_payload(THRESHOLD);
+    std::vector<uint8_t> second = make_payload(2 * THRESHOLD);
+    const std::vector<uint8_t> original_first = first;
+    const std::vector<uint8_t> original_second = second;
+
+    ASSERT_TRUE(store.export_payload(first));
+
+    // The only segment is still young, so it is kept and the payload is sent as is
+    EXPECT_FALSE(store.export_payload(second));
+    EXPECT_EQ(original_second, second);
+
+    EXPECT_TRUE(SharedPayloadStore::import_payload(first));
+    EXPECT_EQ(original_first, first);
+}
+
+TEST(SharedPayloadStoreTests, segments_are_unlinked_on_destruction)
+{
+    std::vector<uint8_t> payload = make_payload(THRESHOLD);
+
+    {
+        SharedPayloadStore store(store_options(4));
+        ASSERT_TRUE(store.export_payload(payload));
+    }
+
+    EXPECT_FALSE(SharedPayloadStore::import_payload(payload));
+}
@@ -0,0 +1,114 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <utils/TaskIndex.hpp>
+
+#include <map>
+#include <random>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace sustainml::utils;
+
+TEST(TaskIndexTests, emplace_find_and_erase)
+{
+    TaskIndex<std::string> index(8);
+    std::string value;
+
+    auto inserted = index.emplace(1, "one");
+    ASSERT_NE(nullptr, inserted.first);
+    EXPECT_TRUE(inserted.second);
+    EXPECT_EQ("one", *inserted.first);
+
+    // An existing key keeps its value
+    inserted = index.emplace(1, "uno");
+    ASSERT_NE(nullptr, inserted.first);
+    EXPECT_FALSE(inserted.second);
+    EXPECT_EQ("one", *inserted.first);
+    EXPECT_EQ(1u, index.size());
+
+    ASSERT_NE(nullptr, index.find(1));
+    EXPECT_EQ(nullptr, index.find(2));
+
+    EXPECT_TRUE(index.erase(1, value));
+    EXPECT_EQ("one", value);
+    EXPECT_FALSE(index.erase(1, value));
+    EXPECT_EQ(nullptr, index.find(1));
+    EXPECT_EQ(0u, index.size());
+}
+
+TEST(TaskIndexTests, rejects_beyond_max_entries)
+{
+    TaskIndex<int> index(4);
+
+    for (TaskIndex<int>::Key key = 0; key < 4; ++key)
+    {
+        ASSERT_TRUE(index.emplace(key, static_cast<int>(key)).second);
+    }
+
+    auto inserted = index.emplace(4, 4);
+    EXPECT_EQ(nullptr, inserted.first);
+    EXPECT_FALSE(inserted.second);
+
+    // Existing keys are still found when full
+    inserted = index.emplace(3, 30);
+    ASSERT_NE(nullptr, inserted.first);
+    EXPECT_EQ(3, *inserted.first);
+
+    int value;
+    ASSERT_TRUE(index.erase(0, value));
+    EXPECT_TRUE(index.emplace(4, 4).second);
+}
+
+TEST(TaskIndexTests, erase_keeps_colliding_keys_reachable)
+{
+    // Keys that are a multiple of the capacity apart may share their home slot,
+    // so erasing from the middle of a probe sequence must not hide the rest
+    TaskIndex<int> index(64);
+    std::map<TaskIndex<int>::Key, int> expected;
+    std::mt19937_64 rng(42);
+
+    for (int round = 0; round < 20000; ++round)
+    {
+        TaskIndex<int>::Key key = rng() % 256;
+        int value;
+
+        if (rng() % 2 == 0 && expected.size() < 64)
+        {
+            auto inserted = index.emplace(key, round);
+            ASSERT_NE(nullptr, inserted.first);
+            EXPECT_EQ(expected.count(key) == 0, inserted.second);
+            expected.emplace(key, round);
+        }
+        else
+        {
+            EXPECT_EQ(expected.count(key) == 1, index.erase(key, value));
+            if (expected.count(key) == 1)
+            {
+                EXPECT_EQ(expected[key], value);
+                expected.erase(key);
+            }
+        }
+
+        ASSERT_EQ(expected.size(), index.size());
+    }
+
+    for (const auto& entry : expected)
+    {
+        int* value = index.find(entry.first);
+        ASSERT_NE(nullptr, value);
+        EXPECT_EQ(entry.second, *value);
+    }
+}
@@ -0,0 +1,181 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <utils/TaskReadinessTracker.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace sustainml::utils;
+
+namespace {
+
+constexpr uint32_t TWO_QUEUES = 0x3;
+
+} // namespace
+
+TEST(TaskReadinessTrackerTests, completes_once_every_queue_received)
+{
+    TaskReadinessTracker tracker(16);
+
+    EXPECT_EQ(TaskReadinessTracker::PENDING, tracker.mark(1, 0x1, 0x7));
+    EXPECT_EQ(TaskReadinessTracker::PENDING, tracker.mark(1, 0x4, 0x7));
+    EXPECT_EQ(1u, tracker.size());
+    EXPECT_EQ(TaskReadinessTracker::COMPLETED, tracker.mark(1, 0x2, 0x7));
+    EXPECT_EQ(0u, tracker.size());
+
+    // A single queue completes the task on its first arrival
+    EXPECT_EQ(TaskReadinessTracker::COMPLETED, tracker.mark(2, 0x1, 0x1));
+    EXPECT_EQ(0u, tracker.size());
+}
+
+TEST(TaskReadinessTrackerTests, full_shard_grows)
+{
+    // A single shard with the minimum number of slots
+    TaskReadinessTracker tracker(1, 1);
+    constexpr TaskReadinessTracker::Key N_TASKS = 500;
+
+    for (TaskReadinessTracker::Key key = 1; key <= N_TASKS; ++key)
+    {
+        ASSERT_EQ(TaskReadinessTracker::PENDING, tracker.mark(key, 0x1, TWO_QUEUES));
+    }
+
+    EXPECT_EQ(N_TASKS, tracker.size());
+
+    for (TaskReadinessTracker::Key key = 1; key <= N_TASKS; ++key)
+    {
+        ASSERT_EQ(TaskReadinessTracker::COMPLETED, tracker.mark(key, 0x2, TWO_QUEUES));
+    }
+
+    EXPECT_EQ(0u, tracker.size());
+}
+
+TEST(TaskReadinessTrackerTests, overflows_beyond_max_growth)
+{
+    TaskReadinessTracker tracker(1, 1);
+    const std::size_t max_slots = 16 * TaskReadinessTracker::MAX_SHARD_GROWTH;
+
+    for (TaskReadinessTracker::Key key = 1; key <= 2 * max_slots; ++key)
+    {
+        ASSERT_EQ(TaskReadinessTracker::PENDING, tracker.mark(key, 0x1, TWO_QUEUES));
+    }
+
+    EXPECT_EQ(2 * max_slots, tracker.size());
+
+    // Tasks completing free slots, but those already overflowed stay in the overflow map
+    for (TaskReadinessTracker::Key key = 1; key <= max_slots; ++key)
+    {
+        ASSERT_EQ(TaskReadinessTracker::COMPLETED, tracker.mark(key, 0x2, TWO_QUEUES));
+    }
+
+    EXPECT_EQ(max_slots, tracker.size());
+
+    // Every task completes exactly once, whether it was kept in the slots or not
+    for (TaskReadinessTracker::Key key = max_slots + 1; key <= 2 * max_slots; ++key)
+    {
+        ASSERT_EQ(TaskReadinessTracker::COMPLETED, tracker.mark(key, 0x2, TWO_QUEUES));
+        ASSERT_EQ(TaskReadinessTracker::PENDING, tracker.mark(key, 0x1, TWO_QUEUES));
+        ASSERT_EQ(TaskReadinessTracker::COMPLETED, tracker.mark(key, 0x2, TWO_QUEUES));
+    }
+
+    EXPECT_EQ(0u, tracker.size());
+}
+
+TEST(TaskReadinessTrackerTests, tombstones_are_reclaimed)
+{
+    TaskReadinessTracker tracker(1, 1);
+    const std::size_t max_slots = 16 * TaskReadinessTracker::MAX_SHARD_GROWTH;
+
+    // Far more tasks than slots go through the shard, a few of them staying partial
+    for (TaskReadinessTracker::Key key = 1; key <= 50 * max_slots; ++key)
+    {
+        ASSERT_EQ(TaskReadinessTracker::PENDING, tracker.mark(key, 0x1, TWO_QUEUES));
+
+        if (key % 100 != 0)
+        {
+            ASSERT_EQ(TaskReadinessTracker::COMPLETED, tracker.mark(key, 0x2, TWO_QUEUES));
+        }
+    }
+
+    EXPECT_EQ(50 * max_slots / 100, tracker.size());
+
+    for (TaskReadinessTracker::Key key = 100; key <= 50 * max_slots; key += 100)
+    {
+        ASSERT_EQ(TaskReadinessTracker::COMPLETED, tracker.mark(key, 0x2, TWO_QUEUES));
+    }
+
+    EXPECT_EQ(0u, tracker.size());
+}
+
+namespace {
+
+void concurrent_mark_and_erase(
+        TaskReadinessTracker& tracker)
+{
+    constexpr std::size_t N_THREADS = 4;
+    constexpr TaskReadinessTracker::Key N_TASKS = 8000;
+    constexpr uint32_t ALL_QUEUES = (1u << N_THREADS) - 1;
+
+    std::vector<std::atomic<int>> completed(N_TASKS + 1);
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < N_THREADS; ++t)
+    {
+        threads.emplace_back([&, t]()
+                {
+                    // Every thread is a queue, marking the tasks in a different order
+                    for (TaskReadinessTracker::Key i = 0; i < N_TASKS; ++i)
+                    {
+                        TaskReadinessTracker::Key key = (t % 2 == 0) ? i + 1 : N_TASKS - i;
+                        auto result = tracker.mark(key, 1u << t, ALL_QUEUES);
+
+                        if (TaskReadinessTracker::COMPLETED == result)
+                        {
+                            completed[key].fetch_add(1);
+                        }
+                    }
+                });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(0u, tracker.size());
+
+    for (TaskReadinessTracker::Key key = 1; key <= N_TASKS; ++key)
+    {
+        EXPECT_EQ(1, completed[key].load()) << "task " << key;
+    }
+}
+
+} // namespace
+
+TEST(TaskReadinessTrackerTests, concurrent_mark_and_erase)
+{
+    // Small shards, so that they are rebuilt while being marked
+    TaskReadinessTracker tracker(500, 2);
+    concurrent_mark_and_erase(tracker);
+}
+
+TEST(TaskReadinessTrackerTests, concurrent_mark_and_erase_with_overflow)
+{
+    // A single shard that cannot hold every partial task
+    TaskReadinessTracker tracker(1, 1);
+    concurrent_mark_and_erase(tracker);
+}
@@ -0,0 +1,99 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <utils/TaskStatusTracker.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace sustainml;
+using namespace sustainml::utils;
+
+TEST(TaskStatusTrackerTests, node_status_follows_the_tasks_in_flight)
+{
+    TaskStatusTracker tracker;
+    Status node_status = Status::NODE_RUNNING;
+
+    EXPECT_TRUE(tracker.start_nts(types::TaskId(1, 1)));
+    EXPECT_FALSE(tracker.start_nts(types::TaskId(2, 1)));
+    EXPECT_EQ(2u, tracker.in_flight_nts());
+
+    EXPECT_FALSE(tracker.finish_nts(types::TaskId(1, 1), true, node_status));
+    EXPECT_EQ(TaskStatus::TASK_ERROR, tracker.status_nts(types::TaskId(1, 1)));
+    EXPECT_EQ(TaskStatus::TASK_RUNNING, tracker.status_nts(types::TaskId(2, 1)));
+
+    EXPECT_TRUE(tracker.finish_nts(types::TaskId(2, 1), false, node_status));
+    EXPECT_EQ(Status::NODE_ERROR, node_status);
+
+    EXPECT_TRUE(tracker.start_nts(types::TaskId(3, 1)));
+    EXPECT_TRUE(tracker.finish_nts(types::TaskId(3, 1), false, node_status));
+    EXPECT_EQ(Status::NODE_IDLE, node_status);
+}
+
+TEST(TaskStatusTrackerTests, starting_a_running_task_is_idempotent)
+{
+    TaskStatusTracker tracker;
+    Status node_status = Status::NODE_RUNNING;
+
+    EXPECT_TRUE(tracker.start_nts(types::TaskId(1, 1)));
+    EXPECT_FALSE(tracker.start_nts(types::TaskId(1, 1)));
+    EXPECT_EQ(1u, tracker.in_flight_nts());
+
+    EXPECT_TRUE(tracker.finish_nts(types::TaskId(1, 1), false, node_status));
+    EXPECT_EQ(0u, tracker.in_flight_nts());
+    EXPECT_EQ(Status::NODE_IDLE, node_status);
+
+    // Finishing it twice has no effect either
+    EXPECT_FALSE(tracker.finish_nts(types::TaskId(1, 1), false, node_status));
+}
+
+TEST(TaskStatusTrackerTests, retains_the_last_finished_tasks)
+{
+    TaskStatusTracker tracker(2);
+    Status node_status = Status::NODE_RUNNING;
+
+    for (uint32_t problem_id = 1; problem_id <= 3; ++problem_id)
+    {
+        tracker.start_nts(types::TaskId(problem_id, 1));
+        tracker.finish_nts(types::TaskId(problem_id, 1), false, node_status);
+    }
+
+    EXPECT_EQ(TaskStatus::TASK_WAITING, tracker.status_nts(types::TaskId(1, 1)));
+    EXPECT_EQ(TaskStatus::TASK_SUCCEEDED, tracker.status_nts(types::TaskId(2, 1)));
+    EXPECT_EQ(TaskStatus::TASK_SUCCEEDED, tracker.status_nts(types::TaskId(3, 1)));
+}
+
+TEST(TaskStatusTrackerTests, never_forgets_a_task_run_again)
+{
+    TaskStatusTracker tracker(2);
+    Status node_status = Status::NODE_RUNNING;
+
+    tracker.start_nts(types::TaskId(1, 1));
+    tracker.finish_nts(types::TaskId(1, 1), true, node_status);
+
+    // Run again while other tasks finish and push the oldest ones out
+    tracker.start_nts(types::TaskId(1, 1));
+
+    for (uint32_t problem_id = 2; problem_id <= 4; ++problem_id)
+    {
+        tracker.start_nts(types::TaskId(problem_id, 1));
+        tracker.finish_nts(types::TaskId(problem_id, 1), false, node_status);
+    }
+
+    EXPECT_EQ(TaskStatus::TASK_RUNNING, tracker.status_nts(types::TaskId(1, 1)));
+    EXPECT_EQ(1u, tracker.in_flight_nts());
+
+    EXPECT_TRUE(tracker.finish_nts(types::TaskId(1, 1), false, node_status));
+    EXPECT_EQ(TaskStatus::TASK_SUCCEEDED, tracker.status_nts(types::TaskId(1, 1)));
+    EXPECT_EQ(Status::NODE_IDLE, node_status);
+}
@@ -0,0 +1,238 @@
+// Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <utils/WorkStealingThreadPool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace sustainml::utils;
+
+namespace {
+
+//! Counts the tasks run, and waits for a given number of them
+struct Counter
+{
+    void add(
+            std::size_t n)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        count += n;
+        cv.notify_all();
+    }
+
+    bool wait(
+            std::size_t expected)
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        return cv.wait_for(lock, std::chrono::seconds(10), [&]()
+                       {
+                           return count >= expected;
+                       });
+    }
+
+    std::size_t count{0};
+    std::mutex mtx;
+    std::condition_variable cv;
+};
+
+} // namespace
+
+TEST(WorkStealingThreadPoolTests, push_fails_when_disabled)
+{
+    WorkStealingThreadPool<int> pool(2, [](int&)
+            {
+            });
+
+    EXPECT_FALSE(pool.push(1));
+    EXPECT_FALSE(pool.push(std::vector<int>{1, 2}));
+
+    pool.enable();
+    EXPECT_TRUE(pool.is_enabled());
+    EXPECT_TRUE(pool.push(1));
+
+    pool.disable();
+    EXPECT_FALSE(pool.is_enabled());
+    EXPECT_FALSE(pool.push(1));
+}
+
+TEST(WorkStealingThreadPoolTests, every_task_runs_once)
+{
+    constexpr std::size_t N_PRODUCERS = 4;
+    constexpr std::size_t N_TASKS = 10000;
+
+    std::vector<std::atomic<int>> runs(N_PRODUCERS * N_TASKS);
+    Counter counter;
+
+    WorkStealingThreadPool<std::size_t> pool(4, [&](std::size_t& task)
+            {
+                runs[task].fetch_add(1);
+                counter.add(1);
+            });
+    pool.enable();
+
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p < N_PRODUCERS; ++p)
+    {
+        producers.emplace_back([&, p]()
+                {
+                    for (std::size_t i = 0; i < N_TASKS; i += 2)
+                    {
+                        if (i % 4 == 0)
+                        {
+                            ASSERT_TRUE(pool.push(p * N_TASKS + i));
+                            ASSERT_TRUE(pool.push(p * N_TASKS + i + 1));
+                        }
+                        else
+                        {
+                            ASSERT_TRUE(pool.push(std::vector<std::size_t>{p * N_TASKS + i, p * N_TASKS + i + 1}));
+                        }
+                    }
+                });
+    }
+
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+
+    ASSERT_TRUE(counter.wait(N_PRODUCERS * N_TASKS));
+    pool.disable();
+
+    for (const auto& run : runs)
+    {
+        EXPECT_EQ(1, run.load());
+    }
+}
+
+TEST(WorkStealingThreadPoolTests, tasks_pushed_from_workers_are_stolen)
+{
+    constexpr std::size_t N_CHILDREN = 64;
+
+    Counter counter;
+    std::atomic<int> busy_workers{0};
+    WorkStealingThreadPool<int>* pool_ptr = nullptr;
+
+    WorkStealingThreadPool<int> pool(4, [&](int& task)
+            {
+                if (task < 0)
+                {
+                    // Every child goes to the deque of this worker, the others must steal them
+                    for (std::size_t i = 0; i < N_CHILDREN; ++i)
+                    {
+                        pool_ptr->push(static_cast<int>(i));
+                    }
+                    return;
+                }
+
+                busy_workers.fetch_add(1);
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                busy_workers.fetch_sub(1);
+                counter.add(1);
+            });
+    pool_ptr = &pool;
+    pool.enable();
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(pool.push(-1));
+    ASSERT_TRUE(counter.wait(N_CHILDREN));
+
+    // A single worker would need N_CHILDREN * 5 ms
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(N_CHILDREN * 5));
+    pool.disable();
+}
+
+TEST(WorkStealingThreadPoolTests, idle_workers_sleep)
+{
+    Counter counter;
+    WorkStealingThreadPool<int> pool(8, [&](int&)
+            {
+                counter.add(1);
+            });
+    pool.enable();
+
+    ASSERT_TRUE(pool.push(std::vector<int>(100, 0)));
+    ASSERT_TRUE(counter.wait(100));
+
+    // Workers spinning for work would burn several CPUs meanwhile
+    std::clock_t cpu_start = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    double cpu_ms = 1000.0 * static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+    EXPECT_LT(cpu_ms, 100.0);
+    pool.disable();
+}
+
+TEST(WorkStealingThreadPoolTests, pushes_racing_with_disable)
+{
+    Counter counter;
+    WorkStealingThreadPool<int> pool(4, [&](int&)
+            {
+                counter.add(1);
+            });
+
+    for (int round = 0; round < 20; ++round)
+    {
+        pool.enable();
+
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> producers;
+        for (int p = 0; p < 4; ++p)
+        {
+            producers.emplace_back([&pool, &stop, p]()
+                    {
+                        while (!stop.load())
+                        {
+                            if (p % 2 == 0)
+                            {
+                                pool.push(0);
+                            }
+                            else
+                            {
+                                pool.push(std::vector<int>(3, 0));
+                            }
+                        }
+                    });
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        pool.disable();
+        stop.store(true);
+
+        for (auto& th : producers)
+        {
+            th.join();
+        }
+
+        EXPECT_FALSE(pool.push(0));
+    }
+
+    // The pool keeps working after the discarded tasks
+    pool.enable();
+    std::size_t before;
+    {
+        std::lock_guard<std::mutex> lock(counter.mtx);
+        before = counter.count;
+    }
+    ASSERT_TRUE(pool.push(std::vector<int>(100, 0)));
+    EXPECT_TRUE(counter.wait(before + 100));
+    pool.disable();
+}
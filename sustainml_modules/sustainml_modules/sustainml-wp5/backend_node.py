@@ -486,7 +486,8 @@ class ServerThread(threading.Thread):
         self.orchestrator_thread = threading.Thread(target=orchestrator.run)
         # Create Flask server
         threading.Thread.__init__(self)
-        self.srv = make_server(server_ip_address, server_port, server)
+        # Serve every request in its own thread, the bindings release the GIL while they wait for the nodes
+        self.srv = make_server(server_ip_address, server_port, server, threaded=True)
         self.ctx = server.app_context()
         self.ctx.push()
 
@@ -14,15 +14,20 @@
 """SustainML Orchestrator Node API specification."""
 
 from . import utils
-import numpy as np
 
 from sustainml_swig import OrchestratorNodeHandle as cpp_OrchestratorNodeHandle
 from sustainml_swig import OrchestratorNode as cpp_OrchestratorNode
 from sustainml_swig import NodeStatus
 import sustainml_swig
 import threading
+import time
 import json
 
+# Slices in which the output of a node is waited for, the orchestrator wakes waiters up when it terminates
+RESULTS_WAIT_MS = 1000
+# Total time the output of a node is waited for before giving up on it
+RESULTS_TIMEOUT_S = 300
+
 class OrchestratorNodeHandle(cpp_OrchestratorNodeHandle):
 
     def __init__(self, orchestrator):
@@ -77,15 +82,12 @@ class OrchestratorNodeHandle(cpp_OrchestratorNodeHandle):
             if utils.string_task(task_id) not in self.result_status:
                 self.register_task(task_id)
             self.result_status[utils.string_task(task_id)][node_id] = True
-            self.condition.notify_all()
 
             # If the node is CarbonTracker and its output extra_data is non-empty, print a message
             if node_id == utils.node_id.CARBONTRACKER.value:
                 carbon_data = sustainml_swig.get_carbontracker_task_data(self.orchestrator.node_, task_id)
                 try:
-                    extra_data_vector = carbon_data.extra_data()  # Vector de uint8_t
-                    extra_data_list = [s for s in extra_data_vector]
-                    extra_data_bytes = bytes(extra_data_list)
+                    extra_data_bytes = carbon_data.extra_data()
                     extra_data_str = extra_data_bytes.decode('utf-8')
                     extra_data = json.loads(extra_data_str)
                 except AttributeError:
@@ -116,6 +118,7 @@ class Orchestrator:
         self.node_ = cpp_OrchestratorNode(self.handler_)
         self._txn_lock = threading.Lock()
         self._txn_counter = 0
+        self._terminated = threading.Event()
 
     # Proxy method to run the node
     def run(self):
@@ -125,8 +128,22 @@ class Orchestrator:
     # Proxy method to manually terminate
     def terminate(self):
 
+        self._terminated.set()
         self.node_.terminate()
 
+    # Wait for the output of a node for a task, only woken up when it arrives
+    # Returns False if it did not arrive within RESULTS_TIMEOUT_S or the node was terminated
+    def wait_for_results(self, task_id, node_id):
+        deadline = time.monotonic() + RESULTS_TIMEOUT_S
+        while not self._terminated.is_set():
+            remaining_ms = int((deadline - time.monotonic()) * 1000)
+            if remaining_ms <= 0:
+                break
+            ret = self.node_.wait_for_task_data(task_id, node_id, min(RESULTS_WAIT_MS, remaining_ms))
+            if ret() != sustainml_swig.RetCode_t.RETCODE_TIMEOUT:
+                return ret() == sustainml_swig.RetCode_t.RETCODE_OK
+        return False
+
     def get_last_task_id(self):
         return self.handler_.last_task_id
 
@@ -146,9 +163,8 @@ class Orchestrator:
                 return utils.string_status(utils.node_status.INACTIVE.value)
 
     def get_app_requirements_task_data(self, task_id):
-        with self.handler_.condition:
-            while not self.handler_.results_available(task_id, utils.node_id.APP_REQUIREMENTS.value):
-                self.handler_.condition.wait()
+        if not self.wait_for_results(task_id, utils.node_id.APP_REQUIREMENTS.value):
+            return {'Error': f"No {utils.string_node(utils.node_id.APP_REQUIREMENTS.value)} data arrived for task {utils.string_task(task_id)}"}
 
         # retrieve node data
         node_data = sustainml_swig.get_app_requirements_task_data(self.node_, task_id)
@@ -163,9 +179,8 @@ class Orchestrator:
         return json_output
 
     def get_model_metadata_task_data(self, task_id):
-        with self.handler_.condition:
-            while not self.handler_.results_available(task_id, utils.node_id.ML_MODEL_METADATA.value):
-                self.handler_.condition.wait()
+        if not self.wait_for_results(task_id, utils.node_id.ML_MODEL_METADATA.value):
+            return {'Error': f"No {utils.string_node(utils.node_id.ML_MODEL_METADATA.value)} data arrived for task {utils.string_task(task_id)}"}
 
         # retrieve node data
         node_data = sustainml_swig.get_model_metadata_task_data(self.node_, task_id)
@@ -182,9 +197,8 @@ class Orchestrator:
         return json_output
 
     def get_hw_constraints_task_data(self, task_id):
-        with self.handler_.condition:
-            while not self.handler_.results_available(task_id, utils.node_id.HW_CONSTRAINTS.value):
-                self.handler_.condition.wait()
+        if not self.wait_for_results(task_id, utils.node_id.HW_CONSTRAINTS.value):
+            return {'Error': f"No {utils.string_node(utils.node_id.HW_CONSTRAINTS.value)} data arrived for task {utils.string_task(task_id)}"}
 
         # retrieve node data
         node_data = sustainml_swig.get_hw_constraints_task_data(self.node_, task_id)
@@ -201,9 +215,8 @@ class Orchestrator:
         return json_output
 
     def get_model_provider_task_data(self, task_id):
-        with self.handler_.condition:
-            while not self.handler_.results_available(task_id, utils.node_id.ML_MODEL_PROVIDER.value):
-                self.handler_.condition.wait()
+        if not self.wait_for_results(task_id, utils.node_id.ML_MODEL_PROVIDER.value):
+            return {'Error': f"No {utils.string_node(utils.node_id.ML_MODEL_PROVIDER.value)} data arrived for task {utils.string_task(task_id)}"}
 
         # retrieve node data
         node_data = sustainml_swig.get_model_provider_task_data(self.node_, task_id)
@@ -228,9 +241,8 @@ class Orchestrator:
         return json_output
 
     def get_hw_provider_task_data(self, task_id):
-        with self.handler_.condition:
-            while not self.handler_.results_available(task_id, utils.node_id.HW_PROVIDER.value):
-                self.handler_.condition.wait()
+        if not self.wait_for_results(task_id, utils.node_id.HW_PROVIDER.value):
+            return {'Error': f"No {utils.string_node(utils.node_id.HW_PROVIDER.value)} data arrived for task {utils.string_task(task_id)}"}
 
         # retrieve node data
         node_data = sustainml_swig.get_hw_provider_task_data(self.node_, task_id)
@@ -251,9 +263,8 @@ class Orchestrator:
         return json_output
 
     def get_carbontracker_task_data(self, task_id):
-        with self.handler_.condition:
-            while not self.handler_.results_available(task_id, utils.node_id.CARBONTRACKER.value):
-                self.handler_.condition.wait()
+        if not self.wait_for_results(task_id, utils.node_id.CARBONTRACKER.value):
+            return {'Error': f"No {utils.string_node(utils.node_id.CARBONTRACKER.value)} data arrived for task {utils.string_task(task_id)}"}
 
         # retrieve node data
         node_data = sustainml_swig.get_carbontracker_task_data(self.node_, task_id)
@@ -265,9 +276,7 @@ class Orchestrator:
         carbon_footprint = node_data.carbon_footprint()
         energy_consumption = node_data.energy_consumption()
         carbon_intensity = node_data.carbon_intensity()
-        extra_data_vector = node_data.extra_data()
-        extra_data_list = [s for s in extra_data_vector]
-        extra_data_bytes = bytes(extra_data_list)
+        extra_data_bytes = node_data.extra_data()
         extra_data_str = extra_data_bytes.decode('utf-8')
         extra_data = json.loads(extra_data_str)
         json_output = {'task_id': task_json,
@@ -300,9 +309,7 @@ class Orchestrator:
         desired_carbon_footprint = node_data.desired_carbon_footprint()
         geo_location_continent = node_data.geo_location_continent()
         geo_location_region = node_data.geo_location_region()
-        extra_data_vector = node_data.extra_data()
-        extra_data_list = [s for s in extra_data_vector]
-        extra_data_bytes = bytes(extra_data_list)
+        extra_data_bytes = node_data.extra_data()
         extra_data_str = extra_data_bytes.decode('utf-8')
         extra_data = json.loads(extra_data_str)
         json_output = {'task_id': task_json,
@@ -439,8 +446,7 @@ class Orchestrator:
             extra_data['model_family'] = type
 
         json_obj = utils.json_dict(extra_data)
-        data_array = np.frombuffer(json_obj.encode(), dtype=np.uint8)
-        user_input.extra_data(sustainml_swig.uint8_t_vector(data_array.tolist()))
+        user_input.extra_data(json_obj.encode())
 
         if self.node_.start_task(task_id, user_input):
             return task_id
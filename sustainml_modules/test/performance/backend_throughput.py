@@ -0,0 +1,164 @@
+# Copyright 2024 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Script to measure the throughput of a running Back-end node under concurrent requests.
+
+Every client thread alternates /config_request and /results requests. The throughput
+should scale with the number of threads as long as the Back-end node does not
+serialize them, for instance by holding the GIL while waiting for the nodes.
+"""
+
+import argparse
+import json
+import threading
+import time
+import urllib.error
+import urllib.request
+
+
+class ParseOptions():
+    """Parse arguments."""
+
+    def __init__(self):
+        """Object constructor."""
+        self.args = self.__parse_args()
+
+    def __parse_args(self):
+        """
+        Parse the input arguments.
+
+        :return: A dictionary containing the arguments parsed.
+        """
+        parser = argparse.ArgumentParser(
+            formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+            add_help=True,
+            description=(
+                'Script to measure the throughput of a running Back-end node under concurrent requests'),
+        )
+        parser.add_argument(
+            '-u',
+            '--url',
+            type=str,
+            default='http://127.0.0.1:5001',
+            help='Address of the Back-end node.'
+        )
+        parser.add_argument(
+            '-t',
+            '--threads',
+            type=int,
+            nargs='+',
+            default=[1, 2, 4, 8],
+            help='Numbers of client threads to measure.'
+        )
+        parser.add_argument(
+            '-d',
+            '--duration',
+            type=float,
+            default=10.0,
+            help='Seconds to measure every number of threads.'
+        )
+        parser.add_argument(
+            '-c',
+            '--configuration',
+            type=str,
+            default='hardwares',
+            help='Configuration sent on every /config_request.'
+        )
+        parser.add_argument(
+            '--timeout',
+            type=float,
+            default=60.0,
+            help='Seconds to wait for every response.'
+        )
+
+        return parser.parse_args()
+
+
+def request(url, payload, timeout):
+    """
+    Send a request and wait for its response.
+
+    :return: Whether the request succeeded.
+    """
+    data = None
+    headers = {}
+
+    if payload is not None:
+        data = json.dumps(payload).encode('utf-8')
+        headers['Content-Type'] = 'application/json'
+
+    try:
+        with urllib.request.urlopen(urllib.request.Request(url, data=data, headers=headers), timeout=timeout) as res:
+            res.read()
+            return 200 == res.status
+    except (urllib.error.URLError, OSError):
+        return False
+
+
+def percentile(values, fraction):
+    """Return the value below which the given fraction of the sorted values fall."""
+    if not values:
+        return 0.0
+    return values[min(len(values) - 1, int(fraction * len(values)))]
+
+
+def run(args, n_threads):
+    """Measure the Back-end node with the given number of client threads."""
+    endpoints = [
+        ('config_request', args.url + '/config_request', {'configuration': args.configuration}),
+        ('results', args.url + '/results', None),
+    ]
+    latencies = {name: [] for name, _, _ in endpoints}
+    errors = {name: 0 for name, _, _ in endpoints}
+    lock = threading.Lock()
+    deadline = time.monotonic() + args.duration
+
+    def client(index):
+        i = index
+        while time.monotonic() < deadline:
+            name, url, payload = endpoints[i % len(endpoints)]
+            i += 1
+            start = time.monotonic()
+            ok = request(url, payload, args.timeout)
+            elapsed = time.monotonic() - start
+            with lock:
+                if ok:
+                    latencies[name].append(elapsed)
+                else:
+                    errors[name] += 1
+
+    threads = [threading.Thread(target=client, args=(i,)) for i in range(n_threads)]
+    start = time.monotonic()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.monotonic() - start
+
+    for name, _, _ in endpoints:
+        values = sorted(latencies[name])
+        print(f"{n_threads:>7} {name:>15} {len(values) / elapsed:>10.1f} "
+              f"{percentile(values, 0.5) * 1000:>9.2f} {percentile(values, 0.99) * 1000:>9.2f} {errors[name]:>7}")
+
+
+def main():
+    """Measure every number of threads requested."""
+    args = ParseOptions().args
+
+    print(f"{'threads':>7} {'endpoint':>15} {'req/s':>10} {'p50 ms':>9} {'p99 ms':>9} {'errors':>7}")
+    for n_threads in args.threads:
+        run(args, n_threads)
+
+
+if __name__ == '__main__':
+    main()
@@ -42,12 +42,13 @@ class AppRequirementsTaskListener(cpp_AppRequirementsTaskListener):
 class RequestReplyListener(cpp_RequestReplyListener):
 
     def __init__(self,
-                 callback):
+                 callback,
+                 concurrent = False):
 
         self.callback_ = callback
 
         # Parent class constructor
-        super().__init__()
+        super().__init__(concurrent)
 
     # Callback
     def on_configuration_request(
@@ -63,7 +64,8 @@ class AppRequirementsNode:
 
     def __init__(self,
                  callback = None,
-                 service_callback = None):
+                 service_callback = None,
+                 concurrent_requests = False):
 
         if callback == None:
             raise ValueError(
@@ -74,7 +76,7 @@ class AppRequirementsNode:
                 'AppRequirementsNode constructor expects a service callback.')
 
         self.listener_ = AppRequirementsTaskListener(callback)
-        self.listener_service_ = RequestReplyListener(service_callback)
+        self.listener_service_ = RequestReplyListener(service_callback, concurrent_requests)
         self.node_ = cpp_AppRequirementsNode(self.listener_, self.listener_service_)
 
     # Proxy method to run the node
@@ -47,12 +47,13 @@ class CarbonFootprintTaskListener(cpp_CarbonFootprintTaskListener):
 class RequestReplyListener(cpp_RequestReplyListener):
 
     def __init__(self,
-                 callback):
+                 callback,
+                 concurrent = False):
 
         self.callback_ = callback
 
         # Parent class constructor
-        super().__init__()
+        super().__init__(concurrent)
 
     # Callback
     def on_configuration_request(
@@ -68,7 +69,8 @@ class CarbonFootprintNode:
 
     def __init__(self,
                  callback = None,
-                 service_callback = None):
+                 service_callback = None,
+                 concurrent_requests = False):
 
         if callback == None:
             raise ValueError(
@@ -79,7 +81,7 @@ class CarbonFootprintNode:
                 'CarbonFootprintNode constructor expects a service callback.')
 
         self.listener_ = CarbonFootprintTaskListener(callback)
-        self.listener_service_ = RequestReplyListener(service_callback)
+        self.listener_service_ = RequestReplyListener(service_callback, concurrent_requests)
         self.node_ = cpp_CarbonFootprintNode(self.listener_, self.listener_service_)
 
     # Proxy method to run the node
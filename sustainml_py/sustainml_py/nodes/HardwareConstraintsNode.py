@@ -42,12 +42,13 @@ class HardwareConstraintsTaskListener(cpp_HardwareConstraintsTaskListener):
 class RequestReplyListener(cpp_RequestReplyListener):
 
     def __init__(self,
-                 callback):
+                 callback,
+                 concurrent = False):
 
         self.callback_ = callback
 
         # Parent class constructor
-        super().__init__()
+        super().__init__(concurrent)
 
     # Callback
     def on_configuration_request(
@@ -64,7 +65,8 @@ class HardwareConstraintsNode:
 
     def __init__(self,
                  callback = None,
-                 service_callback = None):
+                 service_callback = None,
+                 concurrent_requests = False):
 
         if callback == None:
             raise ValueError(
@@ -75,7 +77,7 @@ class HardwareConstraintsNode:
                 'HardwareConstraintsNode constructor expects a service callback.')
 
         self.listener_ = HardwareConstraintsTaskListener(callback)
-        self.listener_service_ = RequestReplyListener(service_callback)
+        self.listener_service_ = RequestReplyListener(service_callback, concurrent_requests)
         self.node_ = cpp_HardwareConstraintsNode(self.listener_, self.listener_service_)
 
     # Proxy method to run the node
@@ -44,12 +44,13 @@ class HardwareResourcesTaskListener(cpp_HardwareResourcesTaskListener):
 class RequestReplyListener(cpp_RequestReplyListener):
 
     def __init__(self,
-                 callback):
+                 callback,
+                 concurrent = False):
 
         self.callback_ = callback
 
         # Parent class constructor
-        super().__init__()
+        super().__init__(concurrent)
 
     # Callback
     def on_configuration_request(
@@ -66,7 +67,8 @@ class HardwareResourcesNode:
 
     def __init__(self,
                  callback = None,
-                 service_callback = None):
+                 service_callback = None,
+                 concurrent_requests = False):
 
         if callback == None:
             raise ValueError(
@@ -77,7 +79,7 @@ class HardwareResourcesNode:
                 'HardwareResourcesNode constructor expects a service callback.')
 
         self.listener_ = HardwareResourcesTaskListener(callback)
-        self.listener_service_ = RequestReplyListener(service_callback)
+        self.listener_service_ = RequestReplyListener(service_callback, concurrent_requests)
         self.node_ = cpp_HardwareResourcesNode(self.listener_, self.listener_service_)
 
     # Proxy method to run the node
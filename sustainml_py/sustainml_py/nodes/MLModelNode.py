@@ -48,12 +48,13 @@ class MLModelTaskListener(cpp_MLModelTaskListener):
 class RequestReplyListener(cpp_RequestReplyListener):
 
     def __init__(self,
-                 callback):
+                 callback,
+                 concurrent = False):
 
         self.callback_ = callback
 
         # Parent class constructor
-        super().__init__()
+        super().__init__(concurrent)
 
     # Callback
     def on_configuration_request(
@@ -70,7 +71,8 @@ class MLModelNode:
 
     def __init__(self,
                  callback = None,
-                 service_callback = None):
+                 service_callback = None,
+                 concurrent_requests = False):
 
         if callback == None:
             raise ValueError(
@@ -81,7 +83,7 @@ class MLModelNode:
                 'MLModelNode constructor expects a service callback.')
 
         self.listener_ = MLModelTaskListener(callback)
-        self.listener_service_ = RequestReplyListener(service_callback)
+        self.listener_service_ = RequestReplyListener(service_callback, concurrent_requests)
 
         self.node_ = cpp_MLModelNode(self.listener_, self.listener_service_)
 
@@ -25,6 +25,11 @@
 // Warnings regarding equiality operators and stuff
 %ignore *::operator=;
 
+// Release the GIL while waiting for the node to finish, so that other Python threads keep running
+%thread sustainml::core::Node::spin;
+%thread sustainml::core::Node::terminate;
+%thread sustainml::core::Node::~Node;
+
 %{
 #include <sustainml_cpp/core/Node.hpp>
 %}
@@ -26,6 +26,9 @@
 
 %feature("director") sustainml::core::RequestReplyListener;
 
+// Only called by the RPC server threads of the node
+%ignore sustainml::core::RequestReplyListener::dispatch_configuration_request;
+
 %{
 #include <sustainml_cpp/core/RequestReplyListener.hpp>
 %}
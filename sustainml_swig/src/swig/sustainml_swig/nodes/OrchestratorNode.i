@@ -25,6 +25,49 @@
 
 %feature("director") sustainml::orchestrator::OrchestratorNodeHandle;
 
+// OrchestratorNodeHandle callbacks are called on DDS listener threads holding the
+// mutex of the OrchestratorNode, and wait there for the GIL. Every call that may
+// block, or take the mutexes of the OrchestratorNode or its task DB, must release
+// the GIL. Otherwise it would deadlock with a callback waiting for it.
+%thread sustainml::orchestrator::OrchestratorNode::OrchestratorNode;
+%thread sustainml::orchestrator::OrchestratorNode::~OrchestratorNode;
+%thread sustainml::orchestrator::OrchestratorNode::get_task_data;
+%thread sustainml::orchestrator::OrchestratorNode::wait_for_task_data;
+%thread sustainml::orchestrator::OrchestratorNode::get_node_status;
+%thread sustainml::orchestrator::OrchestratorNode::prepare_new_task;
+%thread sustainml::orchestrator::OrchestratorNode::prepare_new_iteration;
+%thread sustainml::orchestrator::OrchestratorNode::start_task;
+%thread sustainml::orchestrator::OrchestratorNode::start_iteration;
+%thread sustainml::orchestrator::OrchestratorNode::send_control_command;
+%thread sustainml::orchestrator::OrchestratorNode::configuration_request;
+%thread sustainml::orchestrator::OrchestratorNode::print_db;
+%thread sustainml::orchestrator::OrchestratorNode::get_task_trace;
+%thread sustainml::orchestrator::OrchestratorNode::export_task_trace;
+%thread sustainml::orchestrator::OrchestratorNode::spin;
+%thread sustainml::orchestrator::OrchestratorNode::destroy;
+%thread sustainml::orchestrator::OrchestratorNode::terminate;
+%thread get_app_requirements_task_data;
+%thread get_carbontracker_task_data;
+%thread get_hw_constraints_task_data;
+%thread get_hw_provider_task_data;
+%thread get_model_metadata_task_data;
+%thread get_model_provider_task_data;
+%thread get_user_input_data;
+
+// Shared snapshots cannot be wrapped, Python gets copies through the helpers below
+%ignore sustainml::orchestrator::OrchestratorNode::get_task_data(
+    const types::TaskId&,
+    const sustainml::NodeID&,
+    std::shared_ptr<const void>&);
+
+// std::function callbacks cannot be wrapped, Python uses configuration_request
+%ignore sustainml::orchestrator::OrchestratorNode::configuration_request_async;
+%ignore sustainml::orchestrator::OrchestratorNode::cancel_configuration_request;
+
+// Only read the task id of a sample
+%nothreadallow get_task_id;
+%nothreadallow set_task_id;
+
 %template(sustainml_pair) std::pair<types::TaskId, types::UserInput*>;
 
 %{
@@ -40,18 +83,26 @@
 %feature("director") types::MLModelMetadata;
 %feature("director") types::MLModel;
 
-// Retrieve the pointer to the C++ object
+// The helpers return a copy owned by Python, or None if there is no data
+%newobject get_app_requirements_task_data;
+%newobject get_carbontracker_task_data;
+%newobject get_hw_constraints_task_data;
+%newobject get_hw_provider_task_data;
+%newobject get_model_metadata_task_data;
+%newobject get_model_provider_task_data;
+%newobject get_user_input_data;
+
 %inline %{
     types::AppRequirements* get_app_requirements_task_data(
         sustainml::orchestrator::OrchestratorNode* orchestrator,
         const types::TaskId& task_id)
     {
-        void* data = nullptr;
-        types::AppRequirements* node = nullptr;
-        if (sustainml::RetCode_t::RETCODE_OK == orchestrator->get_task_data(
-                task_id, sustainml::NodeID::ID_APP_REQUIREMENTS, data))
+        types::AppRequirements* node = new types::AppRequirements();
+        if (sustainml::RetCode_t::RETCODE_OK != orchestrator->get_task_data(
+                task_id, sustainml::NodeID::ID_APP_REQUIREMENTS, node))
         {
-            node = static_cast<types::AppRequirements*>(data);
+            delete node;
+            node = nullptr;
         }
         return node;
     }
@@ -60,12 +111,12 @@
         sustainml::orchestrator::OrchestratorNode* orchestrator,
         const types::TaskId& task_id)
     {
-        void* data = nullptr;
-        types::CO2Footprint* node = nullptr;
-        if (sustainml::RetCode_t::RETCODE_OK == orchestrator->get_task_data(
-                task_id, sustainml::NodeID::ID_CARBON_FOOTPRINT, data))
+        types::CO2Footprint* node = new types::CO2Footprint();
+        if (sustainml::RetCode_t::RETCODE_OK != orchestrator->get_task_data(
+                task_id, sustainml::NodeID::ID_CARBON_FOOTPRINT, node))
         {
-            node = static_cast<types::CO2Footprint*>(data);
+            delete node;
+            node = nullptr;
         }
         return node;
     }
@@ -74,12 +125,12 @@
         sustainml::orchestrator::OrchestratorNode* orchestrator,
         const types::TaskId& task_id)
     {
-        void* data = nullptr;
-        types::HWConstraints* node = nullptr;
-        if (sustainml::RetCode_t::RETCODE_OK == orchestrator->get_task_data(
-                task_id, sustainml::NodeID::ID_HW_CONSTRAINTS, data))
+        types::HWConstraints* node = new types::HWConstraints();
+        if (sustainml::RetCode_t::RETCODE_OK != orchestrator->get_task_data(
+                task_id, sustainml::NodeID::ID_HW_CONSTRAINTS, node))
         {
-            node = static_cast<types::HWConstraints*>(data);
+            delete node;
+            node = nullptr;
         }
         return node;
     }
@@ -88,12 +139,12 @@
         sustainml::orchestrator::OrchestratorNode* orchestrator,
         const types::TaskId& task_id)
     {
-        void* data = nullptr;
-        types::HWResource* node = nullptr;
-        if (sustainml::RetCode_t::RETCODE_OK == orchestrator->get_task_data(
-                task_id, sustainml::NodeID::ID_HW_RESOURCES, data))
+        types::HWResource* node = new types::HWResource();
+        if (sustainml::RetCode_t::RETCODE_OK != orchestrator->get_task_data(
+                task_id, sustainml::NodeID::ID_HW_RESOURCES, node))
         {
-            node = static_cast<types::HWResource*>(data);
+            delete node;
+            node = nullptr;
         }
         return node;
     }
@@ -102,12 +153,12 @@
         sustainml::orchestrator::OrchestratorNode* orchestrator,
         const types::TaskId& task_id)
     {
-        void* data = nullptr;
-        types::MLModelMetadata* node = nullptr;
-        if (sustainml::RetCode_t::RETCODE_OK == orchestrator->get_task_data(
-                task_id, sustainml::NodeID::ID_ML_MODEL_METADATA, data))
+        types::MLModelMetadata* node = new types::MLModelMetadata();
+        if (sustainml::RetCode_t::RETCODE_OK != orchestrator->get_task_data(
+                task_id, sustainml::NodeID::ID_ML_MODEL_METADATA, node))
         {
-            node = static_cast<types::MLModelMetadata*>(data);
+            delete node;
+            node = nullptr;
         }
         return node;
     }
@@ -116,12 +167,12 @@
         sustainml::orchestrator::OrchestratorNode* orchestrator,
         const types::TaskId& task_id)
     {
-        void* data = nullptr;
-        types::MLModel* node = nullptr;
-        if (sustainml::RetCode_t::RETCODE_OK == orchestrator->get_task_data(
-                task_id, sustainml::NodeID::ID_ML_MODEL, data))
+        types::MLModel* node = new types::MLModel();
+        if (sustainml::RetCode_t::RETCODE_OK != orchestrator->get_task_data(
+                task_id, sustainml::NodeID::ID_ML_MODEL, node))
         {
-            node = static_cast<types::MLModel*>(data);
+            delete node;
+            node = nullptr;
         }
         return node;
     }
@@ -130,12 +181,12 @@
         sustainml::orchestrator::OrchestratorNode* orchestrator,
         const types::TaskId& task_id)
     {
-        void* data = nullptr;
-        types::UserInput* node = nullptr;
-        if (sustainml::RetCode_t::RETCODE_OK == orchestrator->get_task_data(
-                task_id, sustainml::NodeID::ID_ORCHESTRATOR, data))
+        types::UserInput* node = new types::UserInput();
+        if (sustainml::RetCode_t::RETCODE_OK != orchestrator->get_task_data(
+                task_id, sustainml::NodeID::ID_ORCHESTRATOR, node))
         {
-            node = static_cast<types::UserInput*>(data);
+            delete node;
+            node = nullptr;
         }
         return node;
     }
@@ -196,3 +247,5 @@
 // Include the class interfaces
 %include <sustainml_cpp/types/types.hpp>
 %include <sustainml_cpp/orchestrator/OrchestratorNode.hpp>
+
+%template(task_span_vec) std::vector<sustainml::orchestrator::TaskSpan>;
@@ -31,6 +31,10 @@
 #include <sustainml_cpp/types/types.hpp>
 %}
 
+// Plain data, whose methods never block nor take locks. Keeping the GIL avoids
+// releasing and reacquiring it around every accessor.
+%nothreadallow;
+
 %extend std::vector<uint8_t>
 {
     const uint8_t* get_buffer() const
@@ -41,5 +45,112 @@
 
 %template(uint8_t_vector) std::vector<uint8_t>;
 
+// Byte sequences, such as extra_data or raw_model, are exchanged as bytes
+// instead of element by element.
+%{
+/**
+ * @brief Copies the contents of a contiguous buffer of bytes, such as bytes,
+ * bytearray, memoryview or uint8 numpy arrays.
+ *
+ * @return false if the object is not such a buffer, leaving no error set.
+ */
+static bool sustainml_bytes_from_buffer(
+        PyObject* object,
+        std::vector<uint8_t>& bytes)
+{
+    if (!PyObject_CheckBuffer(object))
+    {
+        return false;
+    }
+
+    Py_buffer view;
+
+    if (0 != PyObject_GetBuffer(object, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT))
+    {
+        PyErr_Clear();
+        return false;
+    }
+
+    // Buffers of wider elements are converted element by element, as sequences
+    bool is_bytes = (1 == view.itemsize);
+
+    if (is_bytes)
+    {
+        const uint8_t* data = static_cast<const uint8_t*>(view.buf);
+        bytes.assign(data, data + view.len);
+    }
+
+    PyBuffer_Release(&view);
+    return is_bytes;
+}
+
+static bool sustainml_is_byte_buffer(
+        PyObject* object)
+{
+    if (!PyObject_CheckBuffer(object))
+    {
+        return false;
+    }
+
+    Py_buffer view;
+
+    if (0 != PyObject_GetBuffer(object, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT))
+    {
+        PyErr_Clear();
+        return false;
+    }
+
+    bool is_bytes = (1 == view.itemsize);
+    PyBuffer_Release(&view);
+    return is_bytes;
+}
+%}
+
+// Accept bytes-like objects, as well as uint8_t_vector and sequences of integers
+%typemap(in) const std::vector<uint8_t>& (std::vector<uint8_t> bytes, int res = SWIG_OLDOBJ)
+{
+    if (sustainml_bytes_from_buffer($input, bytes))
+    {
+        $1 = &bytes;
+    }
+    else
+    {
+        std::vector<uint8_t>* ptr = nullptr;
+        res = swig::asptr($input, &ptr);
+
+        if (!SWIG_IsOK(res) || nullptr == ptr)
+        {
+            %argument_fail(res, "$type", $symname, $argnum);
+        }
+
+        $1 = ptr;
+    }
+}
+
+%typemap(freearg) const std::vector<uint8_t>&
+{
+    if (SWIG_IsNewObj(res$argnum))
+    {
+        delete $1;
+    }
+}
+
+%typemap(typecheck, precedence=SWIG_TYPECHECK_POINTER) const std::vector<uint8_t>&
+{
+    $1 = sustainml_is_byte_buffer($input) ||
+            SWIG_IsOK(swig::asptr($input, static_cast<std::vector<uint8_t>**>(nullptr)));
+}
+
+// Return a copy of the member as bytes. A view over it would dangle as soon
+// as the member is resized or its owner destroyed. Since the copy is immutable,
+// the member is modified through its setter, e.g. raw_model(bytearray(...))
+%typemap(out) const std::vector<uint8_t>&, std::vector<uint8_t>&
+{
+    $result = PyBytes_FromStringAndSize(reinterpret_cast<const char*>($1->data()),
+            static_cast<Py_ssize_t>($1->size()));
+}
+
 // Include the class interfaces
 %include <sustainml_cpp/types/types.hpp>
+
+%clearnothreadallow;